@@ -0,0 +1,120 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Replacement of the global allocation operators.
+ *
+ * All the `operator new` variants end up in malloc() and increment a
+ * counter. The counter is atomic since the benchmarks may run in
+ * multiple threads.
+ */
+
+// self
+//
+#include    "allocation_counter.h"
+
+
+// C++
+//
+#include    <atomic>
+#include    <cstdlib>
+#include    <new>
+
+
+
+namespace
+{
+
+
+
+std::atomic<std::uint64_t>  g_allocation_count = std::atomic<std::uint64_t>();
+
+
+
+void * counted_allocation(std::size_t size)
+{
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void * ptr(malloc(size == 0 ? 1 : size));
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+
+
+}
+// no name namespace
+
+
+
+namespace versiontheca_benchmarks
+{
+
+
+
+std::uint64_t get_allocation_count()
+{
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
+
+
+
+}
+// namespace versiontheca_benchmarks
+
+
+
+void * operator new (std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+
+void * operator new [] (std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+
+void operator delete (void * ptr) noexcept
+{
+    free(ptr);
+}
+
+
+void operator delete [] (void * ptr) noexcept
+{
+    free(ptr);
+}
+
+
+void operator delete (void * ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+
+void operator delete [] (void * ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,44 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Count the number of heap allocations.
+ *
+ * The benchmarks replace the global `operator new` so each benchmark can
+ * report the number of allocations per operation along the time.
+ */
+
+// C++
+//
+#include    <cstdint>
+
+
+
+namespace versiontheca_benchmarks
+{
+
+
+
+std::uint64_t           get_allocation_count();
+
+
+
+}
+// namespace versiontheca_benchmarks
+// vim: ts=4 sw=4 et
@@ -0,0 +1,426 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Benchmarks of the versiontheca traits.
+ *
+ * For each trait, this tool measures the time and number of heap
+ * allocations of the parse(), compare(), to_string(), next(), and
+ * previous() functions against a realistic corpus (see the corpus
+ * sub-directory) and an adversarial corpus with the maximum number of
+ * parts.
+ *
+ * Use the `runbenchmarks` target to save the results in JSON and
+ * compare them between releases.
+ *
+ * With the `--check-allocations` command line option, the tool instead
+ * verifies the number of allocations per operation and exits with 1 if
+ * it is not as expected (see check_allocations()). The
+ * `checkallocations` target runs that check.
+ */
+
+// self
+//
+#include    "allocation_counter.h"
+#include    "corpus.h"
+
+
+// versiontheca
+//
+#include    <versiontheca/exception.h>
+
+
+// benchmark
+//
+#include    <benchmark/benchmark.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <cstring>
+#include    <iostream>
+#include    <list>
+
+
+
+namespace
+{
+
+
+
+struct corpus_t
+{
+    char const *                            f_trait_name = nullptr;
+    versiontheca::trait_kind_t              f_kind = versiontheca::trait_kind_t::TRAIT_KIND_BASIC;
+    char const *                            f_name = nullptr;
+    versiontheca_benchmarks::version_list_t f_versions = versiontheca_benchmarks::version_list_t();
+};
+
+
+// a list so the pointers passed to the benchmarks remain valid
+//
+std::list<corpus_t>         g_corpora = std::list<corpus_t>();
+
+
+std::vector<versiontheca::trait::pointer_t> parse_all(corpus_t const & c)
+{
+    std::vector<versiontheca::trait::pointer_t> result;
+    for(auto const & v : c.f_versions)
+    {
+        versiontheca::trait::pointer_t t(versiontheca::create_trait(c.f_kind));
+        t->parse(v);
+        result.push_back(t);
+    }
+    return result;
+}
+
+
+void report_allocations(benchmark::State & state, std::uint64_t start)
+{
+    state.counters["allocs/op"] = benchmark::Counter(
+              static_cast<double>(versiontheca_benchmarks::get_allocation_count() - start)
+            , benchmark::Counter::kAvgIterations);
+}
+
+
+void bm_parse(benchmark::State & state, corpus_t const * c)
+{
+    versiontheca::trait::pointer_t t(versiontheca::create_trait(c->f_kind));
+    std::size_t const max(c->f_versions.size());
+    std::size_t idx(0);
+    std::uint64_t const start(versiontheca_benchmarks::get_allocation_count());
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(t->parse(c->f_versions[idx]));
+        idx = (idx + 1) % max;
+    }
+    report_allocations(state, start);
+}
+
+
+void bm_compare(benchmark::State & state, corpus_t const * c)
+{
+    std::vector<versiontheca::trait::pointer_t> const traits(parse_all(*c));
+    std::size_t const max(traits.size());
+    std::size_t idx(0);
+    std::uint64_t const start(versiontheca_benchmarks::get_allocation_count());
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(traits[idx]->compare(traits[(idx + 1) % max]));
+        idx = (idx + 1) % max;
+    }
+    report_allocations(state, start);
+}
+
+
+void bm_to_string(benchmark::State & state, corpus_t const * c)
+{
+    std::vector<versiontheca::trait::pointer_t> const traits(parse_all(*c));
+    std::size_t const max(traits.size());
+    std::size_t idx(0);
+    std::uint64_t const start(versiontheca_benchmarks::get_allocation_count());
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(traits[idx]->to_string());
+        idx = (idx + 1) % max;
+    }
+    report_allocations(state, start);
+}
+
+
+void bm_next_previous(benchmark::State & state, corpus_t const * c, bool next)
+{
+    // the last part is incremented or decremented; when that fails (i.e.
+    // a limit was reached) the original version is parsed again
+    //
+    std::vector<versiontheca::trait::pointer_t> const traits(parse_all(*c));
+    std::vector<int> positions;
+    for(auto const & t : traits)
+    {
+        positions.push_back(std::max(static_cast<int>(t->size()) - 1, 0));
+    }
+    std::size_t const max(traits.size());
+    std::size_t idx(0);
+    std::uint64_t const start(versiontheca_benchmarks::get_allocation_count());
+    for(auto _ : state)
+    {
+        versiontheca::trait::pointer_t const & t(traits[idx]);
+        bool const r(next
+                ? t->next(positions[idx], versiontheca::trait::pointer_t())
+                : t->previous(positions[idx], versiontheca::trait::pointer_t()));
+        if(!r)
+        {
+            t->parse(c->f_versions[idx]);
+        }
+        idx = (idx + 1) % max;
+    }
+    report_allocations(state, start);
+}
+
+
+/** \brief Count the parts which do not fit in a string without allocating.
+ *
+ * \param[in] t  The trait to check.
+ *
+ * \return The number of string parts longer than the SSO capacity.
+ */
+std::size_t long_strings(versiontheca::trait const & t)
+{
+    std::size_t const sso(std::string().capacity());
+    std::size_t count(0);
+    for(std::size_t idx(0); idx < t.size(); ++idx)
+    {
+        versiontheca::part const & p(t.at(idx));
+        if(!p.is_integer()
+        && p.get_string().length() > sso)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+
+/** \brief Verify the number of allocations of one corpus.
+ *
+ * The parts of a trait are saved inline but their strings are
+ * std::string. So the following is expected:
+ *
+ * \li parse() in a trait which already parsed the corpus once does not
+ * allocate; the strings of the parts keep their buffers;
+ * \li compare() and to_chars() do not allocate;
+ * \li parse() in a new trait allocates the trait and one buffer per
+ * string part longer than the SSO capacity, and nothing else.
+ *
+ * \param[in] c  The corpus to check.
+ *
+ * \return true if the counts are as expected.
+ */
+bool check_corpus_allocations(corpus_t const & c)
+{
+    versiontheca::trait::pointer_t t(versiontheca::create_trait(c.f_kind));
+    for(auto const & v : c.f_versions)
+    {
+        t->parse(v);
+    }
+    std::uint64_t start(versiontheca_benchmarks::get_allocation_count());
+    for(auto const & v : c.f_versions)
+    {
+        t->parse(v);
+    }
+    std::uint64_t const parse(versiontheca_benchmarks::get_allocation_count() - start);
+
+    std::vector<versiontheca::trait::pointer_t> const traits(parse_all(c));
+    std::size_t const max(traits.size());
+    start = versiontheca_benchmarks::get_allocation_count();
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        benchmark::DoNotOptimize(traits[idx]->compare(traits[(idx + 1) % max]));
+    }
+    std::uint64_t const compare(versiontheca_benchmarks::get_allocation_count() - start);
+
+    std::size_t length(0);
+    for(auto const & v : c.f_versions)
+    {
+        length = std::max(length, v.length());
+    }
+    std::vector<char> buffer(length * 2 + 16);
+    start = versiontheca_benchmarks::get_allocation_count();
+    for(auto const & p : traits)
+    {
+        benchmark::DoNotOptimize(p->to_chars(buffer.data(), buffer.data() + buffer.size()));
+    }
+    std::uint64_t const to_chars(versiontheca_benchmarks::get_allocation_count() - start);
+
+    std::uint64_t fresh(0);
+    std::uint64_t expected(0);
+    for(auto const & v : c.f_versions)
+    {
+        start = versiontheca_benchmarks::get_allocation_count();
+        {
+            versiontheca::trait::pointer_t n(versiontheca::create_trait(c.f_kind));
+            n->parse(v);
+            fresh += versiontheca_benchmarks::get_allocation_count() - start;
+            expected += 1 + long_strings(*n);
+        }
+    }
+
+    std::cout
+        << c.f_trait_name << "/" << c.f_name << ": "
+        << "parse " << parse
+        << ", compare " << compare
+        << ", to_chars " << to_chars
+        << ", new trait parse " << fresh
+        << " (expected " << expected
+        << " for " << c.f_versions.size()
+        << " versions)\n";
+
+    return parse == 0
+        && compare == 0
+        && to_chars == 0
+        && fresh == expected;
+}
+
+
+bool check_allocations()
+{
+    bool result(true);
+    for(auto const & c : g_corpora)
+    {
+        if(!check_corpus_allocations(c))
+        {
+            result = false;
+        }
+    }
+    if(!result)
+    {
+        std::cerr << "error: the number of allocations is not as expected.\n";
+    }
+    return result;
+}
+
+
+void add_corpus(
+      char const * trait_name
+    , versiontheca::trait_kind_t kind
+    , char const * name
+    , versiontheca_benchmarks::version_list_t const & versions)
+{
+    versiontheca_benchmarks::version_list_t valid(versiontheca_benchmarks::keep_valid(kind, versions));
+    if(valid.size() != versions.size())
+    {
+        std::cerr
+            << "warning: "
+            << versions.size() - valid.size()
+            << " versions of the "
+            << trait_name
+            << "/"
+            << name
+            << " corpus are not valid and were ignored.\n";
+    }
+    if(valid.empty())
+    {
+        return;
+    }
+    g_corpora.push_back(corpus_t{ trait_name, kind, name, valid });
+}
+
+
+void load_corpora()
+{
+    std::string const dir(VERSIONTHECA_CORPUS_DIR "/");
+
+    struct trait_corpus_t
+    {
+        char const *                f_trait_name = nullptr;
+        versiontheca::trait_kind_t  f_kind = versiontheca::trait_kind_t::TRAIT_KIND_BASIC;
+        char const *                f_filename = nullptr;
+        char const *                f_name = nullptr;
+    };
+    trait_corpus_t const corpora[] =
+    {
+        { "basic",   versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   "basic.txt",   "releases" },
+        { "debian",  versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  "debian.txt",  "packages" },
+        { "decimal", versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, "decimal.txt", "releases" },
+        { "roman",   versiontheca::trait_kind_t::TRAIT_KIND_ROMAN,   "roman.txt",   "numerals" },
+        { "rpm",     versiontheca::trait_kind_t::TRAIT_KIND_RPM,     "rpm.txt",     "nevras" },
+        { "unicode", versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, "unicode.txt", "free-form" },
+    };
+    for(auto const & c : corpora)
+    {
+        versiontheca_benchmarks::version_list_t versions(
+                versiontheca_benchmarks::load_corpus(dir + c.f_filename));
+        if(c.f_kind == versiontheca::trait_kind_t::TRAIT_KIND_RPM)
+        {
+            versions = versiontheca_benchmarks::nevra_to_evr(versions);
+        }
+        add_corpus(c.f_trait_name, c.f_kind, c.f_name, versions);
+        add_corpus(
+              c.f_trait_name
+            , c.f_kind
+            , "adversarial"
+            , versiontheca_benchmarks::adversarial_versions(c.f_kind));
+    }
+}
+
+
+void register_benchmarks()
+{
+    for(auto const & c : g_corpora)
+    {
+        std::string const suffix(std::string("/") + c.f_trait_name + "/" + c.f_name);
+        corpus_t const * p(&c);
+        benchmark::RegisterBenchmark(("parse" + suffix).c_str(), bm_parse, p);
+        benchmark::RegisterBenchmark(("compare" + suffix).c_str(), bm_compare, p);
+        benchmark::RegisterBenchmark(("to_string" + suffix).c_str(), bm_to_string, p);
+        benchmark::RegisterBenchmark(("next" + suffix).c_str(), bm_next_previous, p, true);
+        benchmark::RegisterBenchmark(("previous" + suffix).c_str(), bm_next_previous, p, false);
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+int main(int argc, char * argv[])
+{
+    bool check(false);
+    for(int idx(1); idx < argc; ++idx)
+    {
+        if(strcmp(argv[idx], "--check-allocations") == 0)
+        {
+            check = true;
+            std::copy(argv + idx + 1, argv + argc + 1, argv + idx);
+            --argc;
+            break;
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    try
+    {
+        load_corpora();
+    }
+    catch(versiontheca::versiontheca_exception const & e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    if(check)
+    {
+        return check_allocations() ? 0 : 1;
+    }
+    register_benchmarks();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
+
+
+// vim: ts=4 sw=4 et
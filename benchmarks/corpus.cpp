@@ -0,0 +1,241 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the corpus loaders.
+ */
+
+// self
+//
+#include    "corpus.h"
+
+
+// versiontheca
+//
+#include    <versiontheca/exception.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <fstream>
+
+
+
+namespace versiontheca_benchmarks
+{
+
+
+
+namespace
+{
+
+
+
+struct pattern_t
+{
+    versiontheca::trait_kind_t  f_kind = versiontheca::trait_kind_t::TRAIT_KIND_BASIC;
+    char const *                f_start = nullptr;
+    char const *                f_segment = nullptr;
+};
+
+
+constexpr pattern_t const g_patterns[] =
+{
+    { versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   "4294967295",   ".4294967295" },
+    { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  "4294967295:9", ".zz~~a9" },
+    { versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, "4294967295",   ".4294967295" },
+    { versiontheca::trait_kind_t::TRAIT_KIND_ROMAN,   "MMMCMXCIX",    ".MMMCMXCIX" },
+    { versiontheca::trait_kind_t::TRAIT_KIND_RPM,     "4294967295:9", ".zz~a_9" },
+    { versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, "4294967295",   ".ζ4294967295" },
+};
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Load a corpus file.
+ *
+ * \exception versiontheca::invalid_parameter
+ * The function raises this exception if the file cannot be opened.
+ *
+ * \param[in] filename  The name of the file to load.
+ *
+ * \return The list of versions found in the file.
+ */
+version_list_t load_corpus(std::string const & filename)
+{
+    std::ifstream in(filename);
+    if(!in)
+    {
+        throw versiontheca::invalid_parameter("could not open corpus \"" + filename + "\".");
+    }
+
+    version_list_t result;
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.empty()
+        || line[0] == '#')
+        {
+            continue;
+        }
+        result.push_back(line);
+    }
+
+    return result;
+}
+
+
+/** \brief Extract the version from a list of NEVRAs.
+ *
+ * A Fedora package is named using its NEVRA: name, epoch, version,
+ * release, and architecture, as in `name-[epoch:]version-release.arch`.
+ * This function removes the name and the architecture, leaving the
+ * `[epoch:]version-release` which is what the RPM trait parses.
+ *
+ * \param[in] nevras  The list of NEVRAs to convert.
+ *
+ * \return The list of versions.
+ */
+version_list_t nevra_to_evr(version_list_t const & nevras)
+{
+    version_list_t result;
+    for(auto const & n : nevras)
+    {
+        std::string evr(n);
+        std::string::size_type const arch(evr.find_last_of('.'));
+        if(arch != std::string::npos)
+        {
+            evr = evr.substr(0, arch);
+        }
+        std::string::size_type const release(evr.find_last_of('-'));
+        if(release == std::string::npos
+        || release == 0)
+        {
+            continue;
+        }
+        std::string::size_type const version(evr.find_last_of('-', release - 1));
+        if(version == std::string::npos)
+        {
+            continue;
+        }
+        result.push_back(evr.substr(version + 1));
+    }
+
+    return result;
+}
+
+
+/** \brief Generate versions using as many parts as possible.
+ *
+ * The function appends segments to a version until the trait refuses
+ * it (i.e. the maximum number of parts is reached). The last character
+ * of the longest valid version is then changed to create a few versions
+ * that only differ at the very end, which is the worst case of the
+ * compare functions.
+ *
+ * \param[in] kind  The kind of trait to generate versions for.
+ *
+ * \return The list of adversarial versions.
+ */
+version_list_t adversarial_versions(versiontheca::trait_kind_t kind)
+{
+    version_list_t result;
+    for(auto const & p : g_patterns)
+    {
+        if(p.f_kind != kind)
+        {
+            continue;
+        }
+
+        versiontheca::trait::pointer_t t(versiontheca::create_trait(kind));
+        std::string longest(p.f_start);
+        for(int idx(0); idx < 100; ++idx)
+        {
+            // the traits throw once MAX_PARTS is reached
+            //
+            std::string const v(longest + p.f_segment);
+            try
+            {
+                if(!t->parse(v))
+                {
+                    break;
+                }
+            }
+            catch(versiontheca::versiontheca_exception const &)
+            {
+                break;
+            }
+            longest = v;
+        }
+
+        char const variants[] = "0123456789abzIVX";
+        for(char const * s(variants); *s != '\0'; ++s)
+        {
+            std::string v(longest);
+            v.back() = *s;
+            if(std::find(result.begin(), result.end(), v) == result.end())
+            {
+                result.push_back(v);
+            }
+        }
+        break;
+    }
+
+    return keep_valid(kind, result);
+}
+
+
+/** \brief Remove the versions which the trait does not accept.
+ *
+ * \param[in] kind  The kind of trait used to parse the versions.
+ * \param[in] versions  The versions to check.
+ *
+ * \return The list of valid versions.
+ */
+version_list_t keep_valid(versiontheca::trait_kind_t kind, version_list_t const & versions)
+{
+    version_list_t result;
+    versiontheca::trait::pointer_t t(versiontheca::create_trait(kind));
+    for(auto const & v : versions)
+    {
+        try
+        {
+            if(t->parse(v))
+            {
+                result.push_back(v);
+            }
+        }
+        catch(versiontheca::versiontheca_exception const &)
+        {
+            // too many parts
+        }
+    }
+
+    return result;
+}
+
+
+
+}
+// namespace versiontheca_benchmarks
+// vim: ts=4 sw=4 et
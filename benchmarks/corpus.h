@@ -0,0 +1,57 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Load the versions used by the benchmarks.
+ *
+ * The corpora are text files with one version per line. Empty lines and
+ * lines starting with '#' are ignored. The adversarial corpora are
+ * generated so they use the maximum number of parts each trait accepts.
+ */
+
+// versiontheca
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <string>
+#include    <vector>
+
+
+
+namespace versiontheca_benchmarks
+{
+
+
+
+typedef std::vector<std::string>        version_list_t;
+
+
+version_list_t          load_corpus(std::string const & filename);
+version_list_t          nevra_to_evr(version_list_t const & nevras);
+version_list_t          adversarial_versions(versiontheca::trait_kind_t kind);
+version_list_t          keep_valid(versiontheca::trait_kind_t kind, version_list_t const & versions);
+
+
+
+}
+// namespace versiontheca_benchmarks
+// vim: ts=4 sw=4 et
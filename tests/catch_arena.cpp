@@ -0,0 +1,134 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// tested file
+//
+#include    "versiontheca/arena.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/debian.h"
+#include    "versiontheca/exception.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+CATCH_TEST_CASE("arena_versions", "[arena][valid]")
+{
+    CATCH_START_SECTION("arena_versions: parse a batch of versions in an arena")
+    {
+        versiontheca::version_arena arena(64 * 1024);
+        CATCH_REQUIRE(arena.get_live_allocations() == 0);
+        CATCH_REQUIRE(arena.get_allocated_bytes() == 0);
+
+        {
+            std::vector<versiontheca::versiontheca::pointer_t> versions;
+            for(int i(0); i < 1'000; ++i)
+            {
+                versions.push_back(arena.create_version(
+                          versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                        , "1." + std::to_string(i) + "-1"));
+            }
+            CATCH_REQUIRE(arena.get_live_allocations() == 2'000);
+            CATCH_REQUIRE(arena.get_allocated_bytes() > 1'000 * sizeof(versiontheca::debian));
+
+            for(int i(0); i < 1'000; ++i)
+            {
+                CATCH_REQUIRE(versions[i]->is_valid());
+                CATCH_REQUIRE(versions[i]->get_version() == "1." + std::to_string(i) + "-1");
+                CATCH_REQUIRE(std::dynamic_pointer_cast<versiontheca::debian>(versions[i]->get_trait()) != nullptr);
+                if(i > 0)
+                {
+                    CATCH_REQUIRE(*versions[i - 1] < *versions[i]);
+                }
+            }
+
+            CATCH_REQUIRE_THROWS_MATCHES(
+                      arena.release()
+                    , versiontheca::logic_error
+                    , Catch::Matchers::ExceptionMessage(
+                              "logic_error: version_arena::release() called with 2000 allocation(s) still in use."));
+        }
+
+        CATCH_REQUIRE(arena.get_live_allocations() == 0);
+        arena.release();
+        CATCH_REQUIRE(arena.get_allocated_bytes() == 0);
+
+        // the arena can be reused after a release()
+        //
+        versiontheca::versiontheca::pointer_t v(arena.create_version(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "2.0-3.fc39"));
+        CATCH_REQUIRE(v->is_valid());
+        CATCH_REQUIRE(arena.get_live_allocations() == 2);
+        v.reset();
+        arena.release();
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("arena_versions: a copy does not depend on the arena")
+    {
+        versiontheca::versiontheca copy(nullptr);
+        {
+            versiontheca::version_arena arena;
+            versiontheca::versiontheca v(arena.create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "3:1.2~rc1-1");
+            CATCH_REQUIRE(arena.get_live_allocations() == 1);
+            copy = v;
+            CATCH_REQUIRE(arena.get_live_allocations() == 1);
+        }
+        CATCH_REQUIRE(copy.is_valid());
+        CATCH_REQUIRE(copy.get_version() == "3:1.2~rc1-1");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("arena_versions: create_trait() with a null resource uses the heap")
+    {
+        versiontheca::trait::pointer_t t(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, nullptr));
+        CATCH_REQUIRE(t->parse("1.2.3"));
+        CATCH_REQUIRE(t->to_string() == "1.2.3");
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("arena_errors", "[arena][invalid]")
+{
+    CATCH_START_SECTION("arena_errors: invalid kind")
+    {
+        versiontheca::version_arena arena;
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  arena.create_trait(static_cast<versiontheca::trait_kind_t>(100))
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: unknown trait kind (100)."));
+        CATCH_REQUIRE(arena.get_live_allocations() == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
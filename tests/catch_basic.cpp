@@ -61,9 +61,9 @@ void invalid_version(char const * version, char const * errmsg)
     versiontheca::basic::pointer_t t(std::make_shared<versiontheca::basic>());
     versiontheca::versiontheca::pointer_t v(std::make_shared<versiontheca::versiontheca>(t, version));
     CATCH_REQUIRE_FALSE(v->is_valid());
-    CATCH_REQUIRE(v->get_last_error(false) == errmsg);
     CATCH_REQUIRE(v->get_last_error() == errmsg);
-    CATCH_REQUIRE(v->get_last_error().empty());
+    CATCH_REQUIRE(v->take_last_error() == errmsg);
+    CATCH_REQUIRE(v->take_last_error().empty());
 }
 
 
@@ -345,6 +345,43 @@ CATCH_TEST_CASE("compare_basic_versions", "[valid][compare]")
         }
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_basic_versions: sort keys agree with compare()")
+    {
+        char const * versions[] =
+        {
+            "0",
+            "0.0.1",
+            "1",
+            "1.0",
+            "1.0.0.0",
+            "1.0.1",
+            "1.1",
+            "1.2.3",
+            "1.10",
+            "2",
+            "10.0.0",
+            "4294967295",
+            "1.4294967295",
+        };
+        for(auto const & l : versions)
+        {
+            versiontheca::versiontheca a(std::make_shared<versiontheca::basic>(), l);
+            CATCH_REQUIRE(a.is_valid());
+            std::string const ka(a.sort_key());
+            for(auto const & r : versions)
+            {
+                versiontheca::versiontheca b(std::make_shared<versiontheca::basic>(), r);
+                CATCH_REQUIRE(b.is_valid());
+                std::string const kb(b.sort_key());
+                int const c(a.compare(b));
+                int const k(ka.compare(kb));
+                CATCH_REQUIRE((c < 0) == (k < 0));
+                CATCH_REQUIRE((c == 0) == (k == 0));
+            }
+        }
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -360,10 +397,17 @@ CATCH_TEST_CASE("invalid_basic_versions", "[invalid]")
         versiontheca::basic::pointer_t t(std::make_shared<versiontheca::basic>());
         versiontheca::versiontheca v(t, "");
         CATCH_REQUIRE_FALSE(v.is_valid());
-        CATCH_REQUIRE(v.get_last_error().empty());
+        CATCH_REQUIRE(v.take_last_error().empty());
 
         CATCH_REQUIRE(v.get_version().empty());
-        CATCH_REQUIRE(v.get_last_error() == "no parts to output.");
+
+        // a const function does not record an error, the failure
+        // is only reported by the return value of append_version()
+        //
+        CATCH_REQUIRE(v.take_last_error().empty());
+        std::string canonical;
+        CATCH_REQUIRE_FALSE(v.append_version(canonical));
+        CATCH_REQUIRE(canonical.empty());
     }
     CATCH_END_SECTION()
 
@@ -400,7 +444,7 @@ CATCH_TEST_CASE("invalid_basic_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->next(2));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "maximum limit reached; cannot increment version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "maximum limit reached; cannot increment version any further.");
     }
     CATCH_END_SECTION()
 
@@ -410,7 +454,7 @@ CATCH_TEST_CASE("invalid_basic_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->previous(2));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 }
@@ -423,7 +467,7 @@ CATCH_TEST_CASE("bad_basic_calls", "[invalid]")
         versiontheca::basic::pointer_t t(std::make_shared<versiontheca::basic>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE(v.next(0));
-        CATCH_REQUIRE(v.get_last_error() == "");
+        CATCH_REQUIRE(v.take_last_error() == "");
         CATCH_REQUIRE(v.get_version() == "1.0");
     }
     CATCH_END_SECTION()
@@ -433,7 +477,7 @@ CATCH_TEST_CASE("bad_basic_calls", "[invalid]")
         versiontheca::basic::pointer_t t(std::make_shared<versiontheca::basic>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE_FALSE(v.previous(0));
-        CATCH_REQUIRE(v.get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(v.take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 
@@ -0,0 +1,253 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/basic_version.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/basic.h"
+#include    "versiontheca/debian.h"
+#include    "versiontheca/exception.h"
+#include    "versiontheca/rpm.h"
+
+
+// C++
+//
+#include    <algorithm>
+#include    <vector>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+// the compare functions can be used at compile time
+//
+static_assert(versiontheca::detail::debian_compare_strings("~", "") < 0);
+static_assert(versiontheca::detail::debian_compare_strings("a", "B") > 0);
+static_assert(versiontheca::detail::rpm_compare_strings("a_b", "ab") == 0);
+static_assert(versiontheca::detail::rpm_compare_strings("^", "z") > 0);
+
+
+std::string generate_ascii_version()
+{
+    char const common[] = "0123456789012345678901234567.....--::++~~__^^aAzZ";
+    std::size_t const length(rand() % 30 + 1);
+    std::string v;
+    for(std::size_t idx(0); idx < length; ++idx)
+    {
+        if(rand() % 20 == 0)
+        {
+            v += static_cast<char>(rand() % 0x80);
+        }
+        else
+        {
+            v += common[rand() % (sizeof(common) - 1)];
+        }
+    }
+    return v;
+}
+
+
+template<typename T>
+bool parse_trait(T & t, std::string const & v)
+{
+    try
+    {
+        return t.parse(v);
+    }
+    catch(versiontheca::versiontheca_exception const &)
+    {
+        // too many parts
+        //
+        return false;
+    }
+}
+
+
+// verify that the policy gives the same results as the trait
+//
+template<typename Policy, typename Trait>
+void verify_against_trait(std::size_t count)
+{
+    std::vector<std::string> valid;
+    for(std::size_t i(0); i < count; ++i)
+    {
+        std::string const v(generate_ascii_version());
+        versiontheca::basic_version<Policy> const version(v);
+        Trait t;
+        bool const r(parse_trait(t, v));
+        CATCH_REQUIRE(version.is_valid() == r);
+        if(!r)
+        {
+            CATCH_REQUIRE_FALSE(version.get_last_error().empty());
+            continue;
+        }
+        CATCH_REQUIRE(version.get_last_error().empty());
+        CATCH_REQUIRE(version.size() == t.size());
+        versiontheca::version_parts const & parts(version.get_parts());
+        for(std::size_t idx(0); idx < t.size(); ++idx)
+        {
+            CATCH_REQUIRE(parts.is_integer(idx) == t.at(idx).is_integer());
+            CATCH_REQUIRE(parts.get_type(idx) == t.at(idx).get_type());
+            CATCH_REQUIRE(static_cast<char32_t>(parts.get_separator(idx)) == t.at(idx).get_separator());
+            if(parts.is_integer(idx))
+            {
+                CATCH_REQUIRE(parts.get_integer(idx) == t.at(idx).get_integer());
+            }
+            else
+            {
+                CATCH_REQUIRE(parts.get_string(idx) == t.at(idx).get_string());
+            }
+        }
+        valid.push_back(v);
+    }
+
+    for(std::size_t i(0); i < count; ++i)
+    {
+        std::string const & l(valid[rand() % valid.size()]);
+        std::string const & r(valid[rand() % valid.size()]);
+        std::shared_ptr<Trait> lt(std::make_shared<Trait>());
+        std::shared_ptr<Trait> rt(std::make_shared<Trait>());
+        CATCH_REQUIRE(lt->parse(l));
+        CATCH_REQUIRE(rt->parse(r));
+        versiontheca::basic_version<Policy> const lv(l);
+        versiontheca::basic_version<Policy> const rv(r);
+        CATCH_REQUIRE(lv.compare(rv) == lt->compare(rt));
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("basic_version", "[basic_version][valid]")
+{
+    CATCH_START_SECTION("basic_version: Debian versions by value")
+    {
+        versiontheca::debian_version a("1:2.3-rc1");
+        versiontheca::debian_version b("1:2.3");
+        versiontheca::debian_version c("2.3~beta");
+        CATCH_REQUIRE(a.is_valid());
+        CATCH_REQUIRE(b.is_valid());
+        CATCH_REQUIRE(c.is_valid());
+        CATCH_REQUIRE(a > b);
+        CATCH_REQUIRE(c < b);
+        CATCH_REQUIRE(a.get_version() == "1:2.3-rc1");
+        CATCH_REQUIRE(a.size() == 5);
+
+        // copies are independent from the original
+        //
+        versiontheca::debian_version d(a);
+        CATCH_REQUIRE(d == a);
+        d.set_version("1:2.4");
+        CATCH_REQUIRE(d > a);
+        CATCH_REQUIRE(a.get_version() == "1:2.3-rc1");
+
+        std::vector<versiontheca::debian_version> list{ a, b, c, d };
+        std::sort(list.begin(), list.end());
+        CATCH_REQUIRE(list[0].get_version() == "2.3~beta");
+        CATCH_REQUIRE(list[1].get_version() == "1:2.3");
+        CATCH_REQUIRE(list[2].get_version() == "1:2.3-rc1");
+        CATCH_REQUIRE(list[3].get_version() == "1:2.4");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("basic_version: numeric and RPM versions")
+    {
+        versiontheca::numeric_version a("1.2.0");
+        versiontheca::numeric_version b("1.2");
+        CATCH_REQUIRE(a == b);
+        CATCH_REQUIRE_FALSE(a < b);
+        CATCH_REQUIRE(a <= b);
+        CATCH_REQUIRE(a >= b);
+
+        versiontheca::rpm_version c("1.0^git5");
+        versiontheca::rpm_version d("1.0");
+        versiontheca::rpm_version e("1.0~rc1");
+        CATCH_REQUIRE(c > d);
+        CATCH_REQUIRE(d > e);
+        CATCH_REQUIRE(c != e);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("basic_version: same results as the traits")
+    {
+        verify_against_trait<versiontheca::basic_policy, versiontheca::basic>(5'000);
+        verify_against_trait<versiontheca::debian_policy, versiontheca::debian>(5'000);
+        verify_against_trait<versiontheca::rpm_policy, versiontheca::rpm>(5'000);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_basic_version", "[basic_version][invalid]")
+{
+    CATCH_START_SECTION("invalid_basic_version: errors")
+    {
+        CATCH_REQUIRE(versiontheca::numeric_version().get_last_error().empty());
+        CATCH_REQUIRE(versiontheca::numeric_version("").get_last_error() == "an empty input string cannot represent a valid version.");
+        CATCH_REQUIRE(versiontheca::numeric_version("1.a").get_last_error() == "basic versions only support integers separated by periods (.).");
+        CATCH_REQUIRE(versiontheca::numeric_version("1..2").get_last_error() == "a version value cannot be an empty string.");
+        CATCH_REQUIRE(versiontheca::numeric_version("4294967296").get_last_error() == "integer too large for a valid version.");
+        CATCH_REQUIRE(versiontheca::debian_version("a1.0").get_last_error() == "a Debian version must always start with a number.");
+        CATCH_REQUIRE(versiontheca::debian_version("1a:1.0").get_last_error() == "epoch must be a valid integer.");
+        CATCH_REQUIRE(versiontheca::debian_version("1-3:5").get_last_error() == "position of ':' and/or '-' is invalid.");
+        CATCH_REQUIRE(versiontheca::debian_version("1.0-r_c").get_last_error() == "found unexpected character in input.");
+        CATCH_REQUIRE(versiontheca::rpm_version("1.\xC3\xA9").get_last_error() == "found unexpected character in input.");
+        CATCH_REQUIRE(versiontheca::rpm_version(std::string(70'000, '1')).get_last_error() == "version string is too long.");
+        CATCH_REQUIRE(versiontheca::rpm_version("1.2.3.4.5.6.7.8.9.10.11.12.13.14.15.16.17.18.19.20.21.22.23.24.25.26").get_last_error()
+                                == "trying to append more parts when maximum was already reached.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_basic_version: invalid versions sort first")
+    {
+        versiontheca::rpm_version const a("1.0");
+        versiontheca::rpm_version const b("1..0");
+        versiontheca::rpm_version const c("");
+        CATCH_REQUIRE_FALSE(b.is_valid());
+        CATCH_REQUIRE(b.size() == 0);
+        CATCH_REQUIRE(b < a);
+        CATCH_REQUIRE(a > c);
+        CATCH_REQUIRE(b == c);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,252 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/batch.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/debian.h"
+#include    "versiontheca/exception.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// C++
+//
+#include    <atomic>
+#include    <string_view>
+#include    <thread>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+CATCH_TEST_CASE("batch_versions", "[batch][valid]")
+{
+    CATCH_START_SECTION("batch_versions: parse many Debian versions")
+    {
+        std::vector<std::string> const versions =
+        {
+            "1.0",
+            "",
+            "2:3.5-rc1",
+            "1.0~beta",
+            "bad version",
+            "1.0.0",
+        };
+        versiontheca::batch b(versiontheca::parse_many(
+                  versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                , versions));
+
+        CATCH_REQUIRE(b.get_kind() == versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        CATCH_REQUIRE(b.size() == versions.size());
+        CATCH_REQUIRE_FALSE(b.empty());
+        CATCH_REQUIRE(b.get_error_count() == 2);
+
+        CATCH_REQUIRE(b.get_status(0) == versiontheca::batch_status_t::BATCH_STATUS_VALID);
+        CATCH_REQUIRE(b.get_status(1) == versiontheca::batch_status_t::BATCH_STATUS_EMPTY);
+        CATCH_REQUIRE(b.get_status(2) == versiontheca::batch_status_t::BATCH_STATUS_VALID);
+        CATCH_REQUIRE(b.get_status(3) == versiontheca::batch_status_t::BATCH_STATUS_VALID);
+        CATCH_REQUIRE(b.get_status(4) == versiontheca::batch_status_t::BATCH_STATUS_INVALID);
+        CATCH_REQUIRE(b.get_status(5) == versiontheca::batch_status_t::BATCH_STATUS_VALID);
+
+        // the results must match what a versiontheca object gives us
+        //
+        for(std::size_t idx(0); idx < versions.size(); ++idx)
+        {
+            versiontheca::versiontheca v(std::make_shared<versiontheca::debian>(), versions[idx]);
+            CATCH_REQUIRE(b.is_valid(idx) == v.is_valid());
+            if(v.is_valid())
+            {
+                CATCH_REQUIRE(b.get_last_error(idx).empty());
+                CATCH_REQUIRE(b.get_version(idx) == v.get_version());
+                CATCH_REQUIRE(b.get_part_count(idx) == v.size());
+                CATCH_REQUIRE(b.sort_key(idx) == v.sort_key());
+            }
+            else
+            {
+                CATCH_REQUIRE(b.get_part_count(idx) == 0);
+                CATCH_REQUIRE(b.get_version(idx).empty());
+                CATCH_REQUIRE_FALSE(b.get_last_error(idx).empty());
+            }
+        }
+        CATCH_REQUIRE(b.get_last_error(1) == "a version value cannot be an empty string.");
+
+        CATCH_REQUIRE(b.get_part_count(2) == 5);
+        CATCH_REQUIRE(b.get_parts(2)[0].get_integer() == 2);
+        CATCH_REQUIRE(b.get_parts(2)[0].get_type() == ':');
+        CATCH_REQUIRE(b.get_part(2, 3).get_string() == "rc");
+        CATCH_REQUIRE(b.get_parts(2) == b.get_parts_pool().data() + b.get_part_count(0));
+
+        CATCH_REQUIRE(b.compare(0, 5) == 0);
+        CATCH_REQUIRE(b.compare(0, 2) < 0);
+        CATCH_REQUIRE(b.compare(3, 0) < 0);
+        CATCH_REQUIRE(b.compare(2, 3) > 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("batch_versions: parse string views and reuse the batch")
+    {
+        std::string_view const versions[] =
+        {
+            "1.2.3",
+            "1.2.3.4",
+            "v1",
+        };
+        versiontheca::batch b(versiontheca::parse_many(
+                  versiontheca::trait_kind_t::TRAIT_KIND_BASIC
+                , versions));
+
+        CATCH_REQUIRE(b.size() == 3);
+        CATCH_REQUIRE(b.get_error_count() == 1);
+        CATCH_REQUIRE(b.get_parts_pool().size() == 7);
+        CATCH_REQUIRE(b.get_last_error(2) == "basic versions only support integers separated by periods (.).");
+        CATCH_REQUIRE(b.compare(0, 1) < 0);
+
+        b.clear();
+        CATCH_REQUIRE(b.empty());
+        CATCH_REQUIRE(b.get_error_count() == 0);
+        CATCH_REQUIRE(b.get_parts_pool().empty());
+
+        b.reserve(2);
+        CATCH_REQUIRE(b.add("5.6") == 0);
+        CATCH_REQUIRE(b.add("5.6.1") == 1);
+        CATCH_REQUIRE(b.compare(1, 0) > 0);
+        CATCH_REQUIRE(b.get_version(1) == "5.6.1");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("batch_versions: create each kind of trait")
+    {
+        versiontheca::trait_kind_t const kinds[] =
+        {
+            versiontheca::trait_kind_t::TRAIT_KIND_BASIC,
+            versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,
+            versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL,
+            versiontheca::trait_kind_t::TRAIT_KIND_ROMAN,
+            versiontheca::trait_kind_t::TRAIT_KIND_RPM,
+            versiontheca::trait_kind_t::TRAIT_KIND_UNICODE,
+        };
+        for(auto const k : kinds)
+        {
+            versiontheca::batch b(k);
+            CATCH_REQUIRE(b.add("1.5") == 0);
+            CATCH_REQUIRE(b.is_valid(0));
+            CATCH_REQUIRE(b.get_version(0) == "1.5");
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("batch_versions: concurrent const reads of a batch")
+    {
+        versiontheca::batch b(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        std::vector<std::string> expected;
+        for(int i(0); i < 50; ++i)
+        {
+            expected.push_back("1." + std::to_string(i) + "-1");
+            b.add(expected.back());
+        }
+
+        std::vector<std::thread> threads;
+        std::atomic<int> failures(0);
+        for(int t(0); t < 4; ++t)
+        {
+            threads.emplace_back([&b, &expected, &failures]()
+                {
+                    for(int i(0); i < 2'000; ++i)
+                    {
+                        int const l(i % 50);
+                        int const r(i % 37);
+                        int const order(l == r ? 0 : (l < r ? -1 : 1));
+                        if(b.compare(l, r) != order
+                        || b.get_version(l) != expected[l]
+                        || b.sort_key(l) != b.sort_key(l))
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+        }
+        for(auto & t : threads)
+        {
+            t.join();
+        }
+        CATCH_REQUIRE(failures == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("bad_batch_calls", "[batch][invalid]")
+{
+    CATCH_START_SECTION("bad_batch_calls: indexes out of bounds")
+    {
+        versiontheca::batch b(versiontheca::trait_kind_t::TRAIT_KIND_RPM);
+        b.add("1.0");
+        b.add("");
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+              b.get_status(2)
+            , versiontheca::invalid_parameter
+            , Catch::Matchers::ExceptionMessage(
+                      "versiontheca_exception: version index 2 is out of bounds."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+              b.get_part(0, 2)
+            , versiontheca::invalid_parameter
+            , Catch::Matchers::ExceptionMessage(
+                      "versiontheca_exception: part position 2 is out of bounds for version 0."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+              b.compare(0, 1)
+            , versiontheca::invalid_version
+            , Catch::Matchers::ExceptionMessage(
+                      "versiontheca_exception: one or both of the input versions are not valid."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+              b.sort_key(1)
+            , versiontheca::invalid_version
+            , Catch::Matchers::ExceptionMessage(
+                      "versiontheca_exception: cannot compute the sort key of an invalid version."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("bad_batch_calls: unknown trait kind")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+              versiontheca::create_trait(static_cast<versiontheca::trait_kind_t>(100))
+            , versiontheca::invalid_parameter
+            , Catch::Matchers::ExceptionMessage(
+                      "versiontheca_exception: unknown trait kind (100)."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,198 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/character_class.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/basic.h"
+#include    "versiontheca/debian.h"
+#include    "versiontheca/decimal.h"
+#include    "versiontheca/exception.h"
+#include    "versiontheca/rpm.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+// the same traits without a table of character classes so the parser
+// falls back to calling is_valid_character() and is_separator()
+//
+template<typename T>
+class no_table
+    : public T
+{
+public:
+    virtual versiontheca::character_classes_t const * get_character_classes() const override
+    {
+        return nullptr;
+    }
+};
+
+
+std::string generate_ascii_version(std::size_t max)
+{
+    // favor characters that appear in versions so most of the
+    // strings get parsed further than the first few characters
+    //
+    char const common[] = "0123456789012345678901234567.....--::++~~__^^aAzZ";
+    std::size_t const length(rand() % max + 1);
+    std::string v;
+    for(std::size_t idx(0); idx < length; ++idx)
+    {
+        if(rand() % 10 == 0)
+        {
+            v += static_cast<char>(rand() % 0x80);
+        }
+        else
+        {
+            v += common[rand() % (sizeof(common) - 1)];
+        }
+    }
+    return v;
+}
+
+
+template<typename T>
+void verify_same_results(std::string const & v)
+{
+    T with_table;
+    no_table<T> without_table;
+    auto parse = [&v](versiontheca::trait & t, std::string & exception)
+    {
+        try
+        {
+            return t.parse(v);
+        }
+        catch(versiontheca::versiontheca_exception const & e)
+        {
+            // too many parts throws
+            //
+            exception = e.what();
+            return false;
+        }
+    };
+    std::string e1;
+    std::string e2;
+    bool const r1(parse(with_table, e1));
+    bool const r2(parse(without_table, e2));
+    CATCH_REQUIRE(r1 == r2);
+    CATCH_REQUIRE(e1 == e2);
+    CATCH_REQUIRE(with_table.get_last_error() == without_table.get_last_error());
+    CATCH_REQUIRE(with_table.size() == without_table.size());
+    for(std::size_t idx(0); idx < with_table.size(); ++idx)
+    {
+        CATCH_REQUIRE(with_table.at(idx).compare(without_table.at(idx)) == 0);
+        CATCH_REQUIRE(with_table.at(idx).get_separator() == without_table.at(idx).get_separator());
+        CATCH_REQUIRE(with_table.at(idx).get_type() == without_table.at(idx).get_type());
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("character_class", "[parse]")
+{
+    CATCH_START_SECTION("character_class: tables match the virtual functions")
+    {
+        versiontheca::basic b;
+        versiontheca::decimal d;
+        versiontheca::rpm r;
+        versiontheca::trait const * traits[] = { &b, &d, &r };
+        for(auto const t : traits)
+        {
+            versiontheca::character_classes_t const * classes(t->get_character_classes());
+            CATCH_REQUIRE(classes != nullptr);
+            for(char32_t c(0); c < 128; ++c)
+            {
+                CATCH_REQUIRE(((classes->f_class[c] & versiontheca::CHARACTER_CLASS_VALID) != 0) == t->is_valid_character(c));
+                CATCH_REQUIRE(((classes->f_class[c] & versiontheca::CHARACTER_CLASS_SEPARATOR) != 0) == t->is_separator(c));
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("character_class: classify characters")
+    {
+        versiontheca::rpm r;
+        versiontheca::character_classes_t const & classes(*r.get_character_classes());
+        for(int i(0); i < 1'000; ++i)
+        {
+            std::string const v(generate_ascii_version(versiontheca::MAX_CLASSIFIED_LENGTH));
+            versiontheca::character_masks_t masks;
+            versiontheca::classify_characters(v, classes, masks);
+            for(std::size_t idx(0); idx < versiontheca::MAX_CLASSIFIED_LENGTH; ++idx)
+            {
+                std::uint64_t const bit(1ULL << idx);
+                if(idx >= v.length())
+                {
+                    CATCH_REQUIRE((masks.f_digits & bit) == 0);
+                    CATCH_REQUIRE((masks.f_separators & bit) == 0);
+                    CATCH_REQUIRE((masks.f_invalid & bit) == 0);
+                    continue;
+                }
+                char const c(v[idx]);
+                bool const digit(c >= '0' && c <= '9');
+                CATCH_REQUIRE(((masks.f_digits & bit) != 0) == digit);
+                CATCH_REQUIRE(((masks.f_separators & bit) != 0) == r.is_separator(c));
+                CATCH_REQUIRE(((masks.f_invalid & bit) != 0) == (!digit && !r.is_valid_character(c)));
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("character_class: parsing with and without tables gives the same results")
+    {
+        // lengths over MAX_CLASSIFIED_LENGTH exercise the table lookup
+        // without the masks
+        //
+        for(int i(0); i < 10'000; ++i)
+        {
+            std::string const v(generate_ascii_version(versiontheca::MAX_CLASSIFIED_LENGTH + 20));
+            verify_same_results<versiontheca::basic>(v);
+            verify_same_results<versiontheca::debian>(v);
+            verify_same_results<versiontheca::decimal>(v);
+            verify_same_results<versiontheca::rpm>(v);
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,275 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/compare.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/debian.h"
+#include    "versiontheca/rpm.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// C++
+//
+#include    <string>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+std::string generate_string(std::size_t max_length)
+{
+    char const chars[] = "abcxyzABCXYZ0123456789.+-~_";
+    std::size_t const length(rand() % (max_length + 1));
+    std::string s;
+    for(std::size_t idx(0); idx < length; ++idx)
+    {
+        s += chars[rand() % (sizeof(chars) - 1)];
+    }
+    return s;
+}
+
+
+void verify_scan(std::string const & l, std::string const & r)
+{
+    CATCH_REQUIRE(versiontheca::detail::debian_compare_strings_scan(l, r)
+                    == versiontheca::detail::debian_compare_strings(l, r));
+    CATCH_REQUIRE(versiontheca::detail::rpm_compare_strings_scan(l, r)
+                    == versiontheca::detail::rpm_compare_strings(l, r));
+}
+
+
+// the template is made of 'N' (a number), 'S' (a string) and separators
+// so all the versions generated from one template share the same shape
+//
+std::string generate_from_template(std::string const & t)
+{
+    std::string v;
+    for(char const c : t)
+    {
+        switch(c)
+        {
+        case 'N':
+            v += std::to_string(rand() % 4 == 0 ? rand() % 3 : rand() % 200);
+            break;
+
+        case 'S':
+            v += "abz"[rand() % 3];
+            if(rand() % 2 == 0)
+            {
+                v += "abz"[rand() % 3];
+            }
+            break;
+
+        default:
+            v += c;
+            break;
+
+        }
+    }
+    return v;
+}
+
+
+template<typename T>
+void verify_same_shape(std::vector<std::string> const & templates)
+{
+    for(std::size_t i(0); i < 2'000; ++i)
+    {
+        std::string const & t(templates[rand() % templates.size()]);
+        std::string const l(generate_from_template(t));
+        std::string const r(generate_from_template(t));
+        CATCH_INFO("comparing \"" << l << "\" and \"" << r << "\"");
+
+        std::shared_ptr<T> lt(std::make_shared<T>());
+        std::shared_ptr<T> rt(std::make_shared<T>());
+        CATCH_REQUIRE(lt->parse(l));
+        CATCH_REQUIRE(rt->parse(r));
+
+        int expected(0);
+        if constexpr (std::is_same_v<T, versiontheca::debian>)
+        {
+            expected = versiontheca::detail::debian_compare_parts(
+                              versiontheca::detail::trait_parts<T>(*lt)
+                            , versiontheca::detail::trait_parts<T>(*rt));
+        }
+        else
+        {
+            expected = versiontheca::detail::rpm_compare_parts(
+                              versiontheca::detail::trait_parts<T>(*lt)
+                            , versiontheca::detail::trait_parts<T>(*rt));
+        }
+        CATCH_REQUIRE(lt->compare(rt) == expected);
+        CATCH_REQUIRE(rt->compare(lt) == -expected);
+
+        // the non-const at() resets the shape, the result is the same
+        //
+        lt->at(0);
+        CATCH_REQUIRE(lt->compare(rt) == expected);
+        CATCH_REQUIRE(rt->compare(lt) == -expected);
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("compare_find_mismatch", "[compare][valid]")
+{
+    CATCH_START_SECTION("compare_find_mismatch: every position of a 40 byte buffer")
+    {
+        std::string const a("0123456789abcdefghijklmnopqrstuvwxyzABCD");
+        CATCH_REQUIRE(versiontheca::detail::find_mismatch(a.data(), a.data(), a.length()) == a.length());
+        for(std::size_t pos(0); pos < a.length(); ++pos)
+        {
+            std::string b(a);
+            b[pos] = '~';
+            CATCH_REQUIRE(versiontheca::detail::find_mismatch(a.data(), b.data(), a.length()) == pos);
+            CATCH_REQUIRE(versiontheca::detail::find_mismatch(a.data(), b.data(), pos) == pos);
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("compare_strings_scan", "[compare][valid]")
+{
+    CATCH_START_SECTION("compare_strings_scan: prefixes and tildes")
+    {
+        verify_scan("", "");
+        verify_scan("abc", "abc");
+        verify_scan("abc", "abcd");
+        verify_scan("abc", "abc~");
+        verify_scan("abc~", "abc~~");
+        verify_scan("~", "");
+        verify_scan("a_b", "ab");
+        verify_scan("ab_", "ab");
+        verify_scan("abcdefghijklmnopqrstuvwxyz", "abcdefghijklmnopqrstuvwxyZ");
+        verify_scan("abcdefghijklmnopqrstuvwxyz", "abcdefghijklmnopqrstuvwxyz~");
+        verify_scan("abcdefghijklmnopqrstuvwxyz+", "abcdefghijklmnopqrstuvwxyz.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_strings_scan: random strings")
+    {
+        for(int i(0); i < 20'000; ++i)
+        {
+            std::string const l(generate_string(40));
+            std::string r(l);
+            switch(rand() % 4)
+            {
+            case 0:
+                r = generate_string(40);
+                break;
+
+            case 1:
+                if(!r.empty())
+                {
+                    r[rand() % r.length()] = "a0.~_Z"[rand() % 6];
+                }
+                break;
+
+            case 2:
+                r += generate_string(4);
+                break;
+
+            default:
+                // keep equal strings
+                break;
+
+            }
+            verify_scan(l, r);
+            verify_scan(r, l);
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("compare_same_shape", "[compare][valid]")
+{
+    CATCH_START_SECTION("compare_same_shape: Debian versions")
+    {
+        verify_same_shape<versiontheca::debian>({
+                "N.N",
+                "N.N.N",
+                "N.N.N-N",
+                "N:N.N.N-N",
+                "N.N~S-N",
+                "N.N+S.N-NS",
+                "N:N.NS.N-N.N",
+                "N.N.N.N.N.N.N.N",
+            });
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_same_shape: RPM versions")
+    {
+        verify_same_shape<versiontheca::rpm>({
+                "N.N",
+                "N.N.N",
+                "N.N.N-N",
+                "N:N.N.N-N.S",
+                "N.N~S-N",
+                "N.N^S.N-N",
+                "N:N.S.N-N.N",
+                "N.N.N.N.N.N.N.N",
+            });
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_same_shape: modified versions")
+    {
+        versiontheca::versiontheca a(std::make_shared<versiontheca::debian>(), "1.2.3-1");
+        versiontheca::versiontheca b(std::make_shared<versiontheca::debian>(), "1.2.4-1");
+        CATCH_REQUIRE(a < b);
+        a.get_trait()->at(2).set_integer(5);
+        CATCH_REQUIRE(a > b);
+        CATCH_REQUIRE(a.next(2));
+        CATCH_REQUIRE(a.get_version() == "1.2.6-1");
+        CATCH_REQUIRE(a > b);
+        CATCH_REQUIRE(b.previous(2));
+        CATCH_REQUIRE(b.get_version() == "1.2.3-1");
+        CATCH_REQUIRE(a > b);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,288 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/compare_strings.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/exception.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+std::string generate_version()
+{
+    char const common[] = "0123456789012345678901234567.....--::++~~__^^aAzZ";
+    std::size_t const length(rand() % 12 + 1);
+    std::string v;
+    for(std::size_t idx(0); idx < length; ++idx)
+    {
+        v += common[rand() % (sizeof(common) - 1)];
+    }
+    return v;
+}
+
+
+void verify_kind(versiontheca::trait_kind_t kind)
+{
+    std::vector<std::string> valid;
+    while(valid.size() < 200)
+    {
+        std::string const v(generate_version());
+        if(versiontheca::create_trait(kind)->parse(v))
+        {
+            valid.push_back(v);
+        }
+    }
+    for(std::size_t i(0); i < 10'000; ++i)
+    {
+        std::string const & l(valid[rand() % valid.size()]);
+        std::string const & r(valid[rand() % valid.size()]);
+        versiontheca::versiontheca lv(versiontheca::create_trait(kind), l);
+        versiontheca::versiontheca rv(versiontheca::create_trait(kind), r);
+        CATCH_REQUIRE(versiontheca::compare_strings(kind, l, r) == lv.compare(rv));
+
+        std::size_t const limit(rand() % 6 + 1);
+        CATCH_REQUIRE(versiontheca::compare_strings(kind, l, r, limit) == lv.compare(rv, limit));
+        CATCH_REQUIRE(versiontheca::compare_strings(kind, l, r, versiontheca::MAX_PARTS) == lv.compare(rv));
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("compare_strings", "[compare][valid]")
+{
+    CATCH_START_SECTION("compare_strings: simple comparisons")
+    {
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.2", "1.2.0") == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.2", "1.10") == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1:1.0", "2.0") == 1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0~rc1", "1.0") == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0-2", "1.0-10") == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.0^git1", "1.0") == 1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.0a_b", "1.0ab") == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, "1.\xC3\xA9", "1.e") == 1);
+
+        // non-ASCII input goes through the trait
+        //
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_ROMAN, "IV", "\xE2\x85\xA4") == -1);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_strings: first parts only")
+    {
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.2.3", "1.2.9", 2) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.2.3", "1.2.9", 3) == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1", "1.0.7", 2) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.3", "1.2.7", 2) == 1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1:2.3-1", "1:2.3.4-5", 2) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1:2.3", "2:2.3", 1) == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0~rc1", "1.0", 2) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0~rc1", "1.0", 3) == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.2-3", "1.2-4", 2) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.2-3", "1.2-4", 3) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.2-3", "1.2-4") == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, "1.2.a", "1.2.b", 2) == 0);
+
+        versiontheca::versiontheca const a(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "3.14.1-2");
+        versiontheca::versiontheca const b(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "3.14.7-1");
+        CATCH_REQUIRE(a.compare(b, 2) == 0);
+        CATCH_REQUIRE(a.compare(b, 3) == -1);
+        CATCH_REQUIRE(b.compare(a, 3) == 1);
+        CATCH_REQUIRE(a.compare(b, versiontheca::MAX_PARTS) == a.compare(b));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_strings: the limit applies to the upstream version only")
+    {
+        struct limited_t
+        {
+            versiontheca::trait_kind_t  f_kind = versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN;
+            char const *                f_lhs = nullptr;
+            char const *                f_rhs = nullptr;
+            std::size_t                 f_limit = 0;
+            int                         f_expected = 0;
+        };
+        limited_t const limited[] =
+        {
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "2.0-1",       "2-9",          2,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0-3",       "1-5",          2,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1-5",         "1.0-3",        2,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1-5",         "1.1-3",        2, -1 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1:1-5",       "1:1.0.0-3",    3,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "2:1-5",       "1:1.0.0-3",    3,  1 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.3.0-3.el2", "1.3-2ubuntu0", 3,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.3.0-3.el2", "1.3-2ubuntu0", 4,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_RPM,    "2.0-1",       "2-9",          2,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_RPM,    "1.0-3",       "1-5",          2,  0 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_RPM,    "1-5",         "1.1-3",        2, -1 },
+            { versiontheca::trait_kind_t::TRAIT_KIND_RPM,    "1.3.0-3.el2", "1.3-2.fc39",   3,  0 },
+        };
+        for(auto const & l : limited)
+        {
+            CATCH_INFO("comparing \"" << l.f_lhs << "\" with \"" << l.f_rhs << "\" limit " << l.f_limit);
+            CATCH_REQUIRE(versiontheca::compare_strings(l.f_kind, l.f_lhs, l.f_rhs, l.f_limit) == l.f_expected);
+            CATCH_REQUIRE(versiontheca::compare_strings(l.f_kind, l.f_rhs, l.f_lhs, l.f_limit) == -l.f_expected);
+            versiontheca::versiontheca const a(versiontheca::create_trait(l.f_kind), l.f_lhs);
+            versiontheca::versiontheca const b(versiontheca::create_trait(l.f_kind), l.f_rhs);
+            CATCH_REQUIRE(a.compare(b, l.f_limit) == l.f_expected);
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_strings: a limited compare never contradicts the full compare")
+    {
+        versiontheca::trait_kind_t const kinds[] =
+        {
+            versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,
+            versiontheca::trait_kind_t::TRAIT_KIND_RPM,
+        };
+        for(auto const kind : kinds)
+        {
+            std::vector<std::string> valid;
+            while(valid.size() < 200)
+            {
+                std::string const v(generate_version());
+                if(versiontheca::create_trait(kind)->parse(v))
+                {
+                    valid.push_back(v);
+                }
+            }
+            for(std::size_t i(0); i < 10'000; ++i)
+            {
+                std::string const & l(valid[rand() % valid.size()]);
+                std::string const & r(valid[rand() % valid.size()]);
+                int const full(versiontheca::compare_strings(kind, l, r));
+                for(std::size_t limit(1); limit <= 6; ++limit)
+                {
+                    int const limited(versiontheca::compare_strings(kind, l, r, limit));
+                    CATCH_INFO("comparing \"" << l << "\" with \"" << r << "\" limit " << limit);
+                    CATCH_REQUIRE((limited == 0 || limited == full));
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_strings: same results as the traits")
+    {
+        verify_kind(versiontheca::trait_kind_t::TRAIT_KIND_BASIC);
+        verify_kind(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        verify_kind(versiontheca::trait_kind_t::TRAIT_KIND_RPM);
+        verify_kind(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_compare_strings", "[compare][invalid]")
+{
+    CATCH_START_SECTION("invalid_compare_strings: invalid versions")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "a1.0", "1.0")
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the left hand side version is not valid: a Debian version must always start with a number \"a1.0\"."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.0", "")
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the right hand side version is not valid: an empty input string cannot represent a valid version."));
+        CATCH_REQUIRE_THROWS_AS(
+                  versiontheca::compare_strings(static_cast<versiontheca::trait_kind_t>(100), "1.0", "1.0")
+                , versiontheca::invalid_parameter);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_compare_strings: the input after the first difference is not read")
+    {
+        std::string too_many_parts("2");
+        for(int idx(0); idx < 30; ++idx)
+        {
+            too_many_parts += ".1";
+        }
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.0", too_many_parts) == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0", too_many_parts) == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, too_many_parts, "1.0") == 1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0-1", "1.1-!") == -1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.a", "1.b..", 1) == 0);
+
+        // an error found before the first difference is still reported
+        //
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0-1", "1.0-!")
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the right hand side version is not valid: found unexpected character: \\U000021 in input."));
+        CATCH_REQUIRE_THROWS_AS(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, too_many_parts, too_many_parts)
+                , versiontheca::versiontheca_exception);
+        CATCH_REQUIRE_THROWS_AS(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1..0", "1.1")
+                , versiontheca::invalid_version);
+        CATCH_REQUIRE_THROWS_AS(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.0", "1.0-")
+                , versiontheca::invalid_version);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_compare_strings: a limit of zero")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.0", "1.0", 0)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the compare limit must be at least 1."));
+
+        versiontheca::versiontheca const a(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_RPM), "1.0");
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  a.compare(a, 0)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the compare limit must be at least 1."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
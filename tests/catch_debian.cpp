@@ -106,19 +106,19 @@ void check_version(std::string const & version, std::string const & error_msg)
         if(error_msg.empty())
         {
 if(!v.is_valid())
-std::cerr << "--- BAD: checked version [" << version << "], expected to be valid; err = [" << v.get_last_error(false) << "]\n";
+std::cerr << "--- BAD: checked version [" << version << "], expected to be valid; err = [" << v.get_last_error() << "]\n";
             // in this case it must be valid
             CATCH_REQUIRE(v.is_valid());
-            CATCH_REQUIRE(v.get_last_error().empty());
+            CATCH_REQUIRE(v.take_last_error().empty());
         }
         else
         {
 if(v.is_valid())
 std::cerr << "--- BAD: checked version [" << version << "], expected to be invalid; message: [" << error_msg << "]\n";
-else if(v.get_last_error(false) != error_msg)
-std::cerr << "--- BAD: checked version [" << version << "] invalid as expected, error message do not match, however: [" << v.get_last_error(false) << "] instead of [" << error_msg << "]\n";
+else if(v.get_last_error() != error_msg)
+std::cerr << "--- BAD: checked version [" << version << "] invalid as expected, error message do not match, however: [" << v.get_last_error() << "] instead of [" << error_msg << "]\n";
             CATCH_REQUIRE_FALSE(v.is_valid());
-            CATCH_REQUIRE(error_msg == v.get_last_error());
+            CATCH_REQUIRE(error_msg == v.take_last_error());
         }
     }
 }
@@ -257,6 +257,17 @@ CATCH_TEST_CASE("debian_versions", "[valid]")
     }
     CATCH_END_SECTION()
 
+    CATCH_START_SECTION("debian_versions: parse another version with the same object")
+    {
+        versiontheca::debian::pointer_t t(std::make_shared<versiontheca::debian>());
+        versiontheca::versiontheca::pointer_t v(std::make_shared<versiontheca::versiontheca>(t, "1:1.0-3"));
+        CATCH_REQUIRE(v->get_version() == "1:1.0-3");
+        CATCH_REQUIRE(v->set_version("2.5"));
+        CATCH_REQUIRE(v->get_version() == "2.5");
+        CATCH_REQUIRE(v->size() == 2);
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("debian_versions: many valid versions")
     {
         // many valid versions generated randomly to increase the likelyhood
@@ -745,6 +756,81 @@ CATCH_TEST_CASE("compare_debian_versions", "[valid][compare]")
         CATCH_REQUIRE(a->get_build() == 0);
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_debian_versions: upstream '-' sorts after the letters like in dpkg")
+    {
+        versiontheca::versiontheca::pointer_t a(create("1z6"));
+        versiontheca::versiontheca::pointer_t b(create("1z-8-z6"));
+
+        // dpkg compares "z" against "z-" and the end of string is first
+        //
+        CATCH_REQUIRE(a->compare(*b) == -1);
+        CATCH_REQUIRE(b->compare(*a) == 1);
+
+        a = create("1a-b-1");
+        b = create("1a+b-1");
+        CATCH_REQUIRE(a->compare(*b) == 1);
+
+        a = create("1a-1");
+        b = create("1a-b-1");
+        CATCH_REQUIRE(a->compare(*b) == -1);
+
+        a = create("1Z-8-1");
+        b = create("1z-8-1");
+        CATCH_REQUIRE(a->compare(*b) == -1);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("compare_debian_versions: sort keys agree with compare()")
+    {
+        char const * versions[] =
+        {
+            "1.0",
+            "1",
+            "1.0.0",
+            "1.0~rc1",
+            "1.0~~",
+            "1.0~",
+            "1.0.1",
+            "1.0a",
+            "1.0A",
+            "1.0+",
+            "1.0-1",
+            "1.0-0",
+            "1.0-1~",
+            "1.0-1a",
+            "1:1.0",
+            "2:0.1",
+            "1.1",
+            "1.01",
+            "1.a",
+            "1.0b1",
+            "1.0+git",
+            "1.0-+1",
+            "1z6",
+            "1z-8-z6",
+            "1a-b-1",
+            "1a+b-1",
+            "1a-1",
+        };
+        for(auto const & l : versions)
+        {
+            versiontheca::versiontheca a(std::make_shared<versiontheca::debian>(), l);
+            CATCH_REQUIRE(a.is_valid());
+            std::string const ka(a.sort_key());
+            for(auto const & r : versions)
+            {
+                versiontheca::versiontheca b(std::make_shared<versiontheca::debian>(), r);
+                CATCH_REQUIRE(b.is_valid());
+                std::string const kb(b.sort_key());
+                int const c(a.compare(b));
+                int const k(ka.compare(kb));
+                CATCH_REQUIRE((c < 0) == (k < 0));
+                CATCH_REQUIRE((c == 0) == (k == 0));
+            }
+        }
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -763,10 +849,17 @@ CATCH_TEST_CASE("invalid_debian_versions", "[invalid]")
         versiontheca::debian::pointer_t t(std::make_shared<versiontheca::debian>());
         versiontheca::versiontheca v(t, "");
         CATCH_REQUIRE_FALSE(v.is_valid());
-        CATCH_REQUIRE(v.get_last_error().empty());
+        CATCH_REQUIRE(v.take_last_error().empty());
 
         CATCH_REQUIRE(v.get_version().empty());
-        CATCH_REQUIRE(v.get_last_error() == "no parts to output.");
+
+        // a const function does not record an error, the failure
+        // is only reported by the return value of append_version()
+        //
+        CATCH_REQUIRE(v.take_last_error().empty());
+        std::string canonical;
+        CATCH_REQUIRE_FALSE(v.append_version(canonical));
+        CATCH_REQUIRE(canonical.empty());
     }
     CATCH_END_SECTION()
 
@@ -939,7 +1032,7 @@ CATCH_TEST_CASE("invalid_debian_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->next(2));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "maximum limit reached; cannot increment version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "maximum limit reached; cannot increment version any further.");
     }
     CATCH_END_SECTION()
 
@@ -949,7 +1042,7 @@ CATCH_TEST_CASE("invalid_debian_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->previous(2));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 }
@@ -962,7 +1055,7 @@ CATCH_TEST_CASE("bad_debian_calls", "[invalid]")
         versiontheca::debian::pointer_t t(std::make_shared<versiontheca::debian>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE_FALSE(v.next(0));
-        CATCH_REQUIRE(v.get_last_error() == "no parts in this Debian version; cannot compute upstream start/end.");
+        CATCH_REQUIRE(v.take_last_error() == "no parts in this Debian version; cannot compute upstream start/end.");
     }
     CATCH_END_SECTION()
 
@@ -971,7 +1064,7 @@ CATCH_TEST_CASE("bad_debian_calls", "[invalid]")
         versiontheca::debian::pointer_t t(std::make_shared<versiontheca::debian>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE_FALSE(v.previous(0));
-        CATCH_REQUIRE(v.get_last_error() == "no parts in this Debian version; cannot compute upstream start/end.");
+        CATCH_REQUIRE(v.take_last_error() == "no parts in this Debian version; cannot compute upstream start/end.");
     }
     CATCH_END_SECTION()
 
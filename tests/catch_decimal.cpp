@@ -29,12 +29,15 @@
 
 // versiontheca
 //
+#include    "versiontheca/compare_strings.h"
 #include    "versiontheca/exception.h"
+#include    "versiontheca/frozen.h"
 #include    "versiontheca/versiontheca.h"
 
 
 // C++
 //
+#include    <cmath>
 #include    <cstring>
 #include    <iomanip>
 #include    <stdexcept>
@@ -69,13 +72,13 @@ void invalid_version(char const * version, char const * errmsg)
     versiontheca::decimal::pointer_t t(std::make_shared<versiontheca::decimal>());
     versiontheca::versiontheca::pointer_t v(std::make_shared<versiontheca::versiontheca>(t, version));
     CATCH_REQUIRE_FALSE(v->is_valid());
-    if(v->get_last_error(false) != errmsg)
+    if(v->get_last_error() != errmsg)
     {
         std::cerr << "--- verifying invalid version [" << version << "]\n";
     }
-    CATCH_REQUIRE(v->get_last_error(false) == errmsg);
     CATCH_REQUIRE(v->get_last_error() == errmsg);
-    CATCH_REQUIRE(v->get_last_error().empty());
+    CATCH_REQUIRE(v->take_last_error() == errmsg);
+    CATCH_REQUIRE(v->take_last_error().empty());
 }
 
 
@@ -264,6 +267,135 @@ CATCH_TEST_CASE("compare_decimal_versions", "[valid][compare]")
 }
 
 
+CATCH_TEST_CASE("fixed_decimal_versions", "[valid][compare][fixed]")
+{
+    CATCH_START_SECTION("fixed_decimal_versions: compare as fixed-point numbers")
+    {
+        struct order_t
+        {
+            char const *    f_lhs = nullptr;
+            char const *    f_rhs = nullptr;
+            int             f_expected = 0;
+        };
+        order_t const orders[] =
+        {
+            { "1.5",    "1.50",     0 },
+            { "1.05",   "1.5",     -1 },
+            { "1.9",    "1.10",     1 },
+            { "2",      "2.0",      0 },
+            { "2",      "2.000",    0 },
+            { "1.999",  "2",       -1 },
+            { "3.1",    "3.01",     1 },
+            { "10.0",   "9.99999", 1 },
+        };
+        for(auto const & o : orders)
+        {
+            CATCH_INFO("comparing \"" << o.f_lhs << "\" with \"" << o.f_rhs << "\"");
+            versiontheca::versiontheca::pointer_t a(std::make_shared<versiontheca::versiontheca>(std::make_shared<versiontheca::decimal>(), o.f_lhs));
+            versiontheca::versiontheca::pointer_t b(std::make_shared<versiontheca::versiontheca>(std::make_shared<versiontheca::decimal>(), o.f_rhs));
+            CATCH_REQUIRE(a->is_valid());
+            CATCH_REQUIRE(b->is_valid());
+            CATCH_REQUIRE(a->compare(*b) == o.f_expected);
+            CATCH_REQUIRE(b->compare(*a) == -o.f_expected);
+            CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, o.f_lhs, o.f_rhs) == o.f_expected);
+
+            int const key(a->get_trait()->sort_key().compare(b->get_trait()->sort_key()));
+            CATCH_REQUIRE((key < 0 ? -1 : (key > 0 ? 1 : 0)) == o.f_expected);
+
+            versiontheca::frozen_version const fa(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, o.f_lhs);
+            versiontheca::frozen_version const fb(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, o.f_rhs);
+            CATCH_REQUIRE(fa.compare(fb) == o.f_expected);
+
+            versiontheca::fixed_decimal_t fixed_a;
+            versiontheca::fixed_decimal_t fixed_b;
+            CATCH_REQUIRE(versiontheca::parse_fixed_decimal(o.f_lhs, fixed_a));
+            CATCH_REQUIRE(versiontheca::parse_fixed_decimal(o.f_rhs, fixed_b));
+            CATCH_REQUIRE(fixed_a.compare(fixed_b) == o.f_expected);
+        }
+
+        // with a limit of 1, only the integers are compared
+        //
+        versiontheca::versiontheca::pointer_t a(create("1.9"));
+        versiontheca::versiontheca::pointer_t b(create("1.1"));
+        CATCH_REQUIRE(a->compare(*b, 1) == 0);
+        CATCH_REQUIRE(a->compare(*b, 2) == 1);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, "1.9", "1.1", 1) == 0);
+        CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, "1.9", "1.1", 2) == 1);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("fixed_decimal_versions: parse_fixed_decimal() matches the trait")
+    {
+        char const chars[] = "0123456789.";
+        for(int i(0); i < 10'000; ++i)
+        {
+            std::string v;
+            std::size_t const length(rand() % 12 + 1);
+            for(std::size_t idx(0); idx < length; ++idx)
+            {
+                v += chars[rand() % (sizeof(chars) - 1)];
+            }
+            CATCH_INFO("parsing \"" << v << "\"");
+
+            versiontheca::decimal t;
+            bool const valid(t.parse(v));
+            versiontheca::fixed_decimal_t value;
+            CATCH_REQUIRE(versiontheca::parse_fixed_decimal(v, value) == valid);
+            if(valid)
+            {
+                versiontheca::fixed_decimal_t expected;
+                CATCH_REQUIRE(t.get_fixed_decimal(expected));
+                CATCH_REQUIRE(value == expected);
+                CATCH_REQUIRE_FLOATING_POINT(value.to_double(), strtod(v.c_str(), nullptr));
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("fixed_decimal_versions: precision")
+    {
+        versiontheca::fixed_decimal_t value;
+        CATCH_REQUIRE(versiontheca::parse_fixed_decimal("4294967295.000000000000000001", value));
+        CATCH_REQUIRE(value.f_integer == 4294967295);
+        CATCH_REQUIRE(value.f_fraction == 1);
+        create("4294967295.000000000000000001");
+
+        CATCH_REQUIRE_FALSE(versiontheca::parse_fixed_decimal("1.0000000000000000001", value));
+        invalid_version("1.0000000000000000001", "integer too large for a valid version.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("fixed_decimal_versions: bulk conversions")
+    {
+        std::vector<std::string> const versions{ "1.5", "bad", "2", "3.25", "", "1.2.3" };
+
+        std::vector<double> const doubles(versiontheca::decimal_versions_to_double(versions));
+        CATCH_REQUIRE(doubles.size() == versions.size());
+        CATCH_REQUIRE_FLOATING_POINT(doubles[0], 1.5);
+        CATCH_REQUIRE(std::isnan(doubles[1]));
+        CATCH_REQUIRE_FLOATING_POINT(doubles[2], 2.0);
+        CATCH_REQUIRE_FLOATING_POINT(doubles[3], 3.25);
+        CATCH_REQUIRE(std::isnan(doubles[4]));
+        CATCH_REQUIRE(std::isnan(doubles[5]));
+
+        std::vector<std::size_t> invalid;
+        std::vector<versiontheca::fixed_decimal_t> const fixed(versiontheca::decimal_versions_to_fixed(versions, &invalid));
+        CATCH_REQUIRE(fixed.size() == versions.size());
+        CATCH_REQUIRE(fixed[0].f_integer == 1);
+        CATCH_REQUIRE(fixed[0].f_fraction == 500'000'000'000'000'000ULL);
+        CATCH_REQUIRE(fixed[1] == versiontheca::fixed_decimal_t());
+        CATCH_REQUIRE(fixed[2].f_integer == 2);
+        CATCH_REQUIRE(fixed[2].f_fraction == 0);
+        CATCH_REQUIRE(fixed[3].f_integer == 3);
+        CATCH_REQUIRE(fixed[3].f_fraction == 250'000'000'000'000'000ULL);
+        CATCH_REQUIRE(invalid == std::vector<std::size_t>{ 1, 4, 5 });
+
+        CATCH_REQUIRE(versiontheca::decimal_versions_to_fixed(versions).size() == versions.size());
+    }
+    CATCH_END_SECTION()
+}
+
+
 CATCH_TEST_CASE("invalid_decimal_versions", "[invalid]")
 {
     CATCH_START_SECTION("invalid_debian_versions: empty")
@@ -276,10 +408,17 @@ CATCH_TEST_CASE("invalid_decimal_versions", "[invalid]")
         versiontheca::decimal::pointer_t t(std::make_shared<versiontheca::decimal>());
         versiontheca::versiontheca v(t, "");
         CATCH_REQUIRE_FALSE(v.is_valid());
-        CATCH_REQUIRE(v.get_last_error().empty());
+        CATCH_REQUIRE(v.take_last_error().empty());
 
         CATCH_REQUIRE(v.get_version().empty());
-        CATCH_REQUIRE(v.get_last_error() == "no parts to output.");
+
+        // a const function does not record an error, the failure
+        // is only reported by the return value of append_version()
+        //
+        CATCH_REQUIRE(v.take_last_error().empty());
+        std::string canonical;
+        CATCH_REQUIRE_FALSE(v.append_version(canonical));
+        CATCH_REQUIRE(canonical.empty());
     }
     CATCH_END_SECTION()
 
@@ -337,7 +476,7 @@ CATCH_TEST_CASE("invalid_decimal_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->next(1));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "maximum limit reached; cannot increment version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "maximum limit reached; cannot increment version any further.");
     }
     CATCH_END_SECTION()
 
@@ -347,7 +486,7 @@ CATCH_TEST_CASE("invalid_decimal_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->previous(1));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 }
@@ -360,7 +499,7 @@ CATCH_TEST_CASE("bad_decimal_calls", "[invalid]")
         versiontheca::decimal::pointer_t t(std::make_shared<versiontheca::decimal>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE(v.next(0));
-        CATCH_REQUIRE(v.get_last_error() == "");
+        CATCH_REQUIRE(v.take_last_error() == "");
         CATCH_REQUIRE(v.get_version() == "1.0");
     }
     CATCH_END_SECTION()
@@ -370,7 +509,7 @@ CATCH_TEST_CASE("bad_decimal_calls", "[invalid]")
         versiontheca::decimal::pointer_t t(std::make_shared<versiontheca::decimal>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE_FALSE(v.previous(0));
-        CATCH_REQUIRE(v.get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(v.take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 
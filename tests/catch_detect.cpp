@@ -0,0 +1,195 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// tested file
+//
+#include    "versiontheca/detect.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/arena.h"
+#include    "versiontheca/debian.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+struct detected_t
+{
+    char const *                f_version = nullptr;
+    versiontheca::trait_kind_t  f_kind = versiontheca::trait_kind_t::TRAIT_KIND_UNICODE;
+};
+
+
+detected_t const g_detected[] =
+{
+    { "1",              versiontheca::trait_kind_t::TRAIT_KIND_BASIC },
+    { "1.5",            versiontheca::trait_kind_t::TRAIT_KIND_BASIC },
+    { "1.2.3",          versiontheca::trait_kind_t::TRAIT_KIND_BASIC },
+    { "01.2",           versiontheca::trait_kind_t::TRAIT_KIND_BASIC },
+    { "IV",             versiontheca::trait_kind_t::TRAIT_KIND_ROMAN },
+    { "iv.ii",          versiontheca::trait_kind_t::TRAIT_KIND_ROMAN },
+    { "MMXXIII.10",     versiontheca::trait_kind_t::TRAIT_KIND_ROMAN },
+    { "1.0a",           versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN },
+    { "1.0-1",          versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN },
+    { "1:1.0",          versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN },
+    { "1.0~rc1",        versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN },
+    { "2.0+dfsg-3",     versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN },
+    { "1.0-1-2",        versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN },
+    { "1.0^git",        versiontheca::trait_kind_t::TRAIT_KIND_RPM },
+    { "1.0_1",          versiontheca::trait_kind_t::TRAIT_KIND_RPM },
+    { "v1",             versiontheca::trait_kind_t::TRAIT_KIND_RPM },
+    { "X.Y.Z",          versiontheca::trait_kind_t::TRAIT_KIND_RPM },
+    { "1:a",            versiontheca::trait_kind_t::TRAIT_KIND_RPM },
+    { "1.ß",            versiontheca::trait_kind_t::TRAIT_KIND_UNICODE },
+    { "a:1",            versiontheca::trait_kind_t::TRAIT_KIND_UNICODE },
+    { "1.2-",           versiontheca::trait_kind_t::TRAIT_KIND_UNICODE },
+};
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("detect_trait", "[detect][valid]")
+{
+    CATCH_START_SECTION("detect_trait: most specific trait")
+    {
+        for(auto const & d : g_detected)
+        {
+            CATCH_INFO("detecting \"" << d.f_version << "\"");
+            versiontheca::trait_kind_t kind(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL);
+            versiontheca::trait::pointer_t t(versiontheca::detect_trait(d.f_version, &kind));
+            CATCH_REQUIRE(t != nullptr);
+            CATCH_REQUIRE(kind == d.f_kind);
+            CATCH_REQUIRE((versiontheca::classify_version(d.f_version) & versiontheca::trait_kind_to_mask(kind)) != 0);
+
+            // the trait is already parsed
+            //
+            versiontheca::trait::pointer_t expected(versiontheca::create_trait(kind));
+            CATCH_REQUIRE(expected->parse(d.f_version));
+            CATCH_REQUIRE(t->size() == expected->size());
+            CATCH_REQUIRE(t->to_string() == expected->to_string());
+            CATCH_REQUIRE(t->compare(expected) == 0);
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("detect_trait: a rejected trait is never a candidate")
+    {
+        for(auto const & d : g_detected)
+        {
+            versiontheca::trait_kind_mask_t const mask(versiontheca::classify_version(d.f_version));
+            for(int k(0); k <= static_cast<int>(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE); ++k)
+            {
+                versiontheca::trait_kind_t const kind(static_cast<versiontheca::trait_kind_t>(k));
+                // the roman trait also accepts any unicode version
+                //
+                if((mask & versiontheca::trait_kind_to_mask(kind)) == 0
+                && kind != versiontheca::trait_kind_t::TRAIT_KIND_ROMAN)
+                {
+                    CATCH_INFO("trait \"" << versiontheca::trait_kind_to_string(kind) << "\" with \"" << d.f_version << "\"");
+                    CATCH_REQUIRE_FALSE(versiontheca::create_trait(kind)->parse(d.f_version));
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("detect_trait: decimal candidates")
+    {
+        versiontheca::trait_kind_mask_t const decimal(versiontheca::trait_kind_to_mask(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL));
+        CATCH_REQUIRE((versiontheca::classify_version("1") & decimal) != 0);
+        CATCH_REQUIRE((versiontheca::classify_version("1.25") & decimal) != 0);
+        CATCH_REQUIRE((versiontheca::classify_version("1.2.3") & decimal) == 0);
+        CATCH_REQUIRE((versiontheca::classify_version("1.2a") & decimal) == 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("detect_trait: allocate the trait in an arena")
+    {
+        versiontheca::version_arena arena;
+        versiontheca::trait::pointer_t t(versiontheca::detect_trait("3:1.2-1", nullptr, &arena));
+        CATCH_REQUIRE(std::dynamic_pointer_cast<versiontheca::debian>(t) != nullptr);
+        CATCH_REQUIRE(arena.get_live_allocations() == 1);
+        t.reset();
+        arena.release();
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("detect_trait: kind names")
+    {
+        CATCH_REQUIRE(std::string(versiontheca::trait_kind_to_string(versiontheca::trait_kind_t::TRAIT_KIND_BASIC)) == "basic");
+        CATCH_REQUIRE(std::string(versiontheca::trait_kind_to_string(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN)) == "debian");
+        CATCH_REQUIRE(std::string(versiontheca::trait_kind_to_string(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL)) == "decimal");
+        CATCH_REQUIRE(std::string(versiontheca::trait_kind_to_string(versiontheca::trait_kind_t::TRAIT_KIND_ROMAN)) == "roman");
+        CATCH_REQUIRE(std::string(versiontheca::trait_kind_to_string(versiontheca::trait_kind_t::TRAIT_KIND_RPM)) == "rpm");
+        CATCH_REQUIRE(std::string(versiontheca::trait_kind_to_string(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE)) == "unicode");
+        CATCH_REQUIRE(versiontheca::trait_kind_to_string(static_cast<versiontheca::trait_kind_t>(100)) == nullptr);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("detect_trait: kinds with keys matching compare()")
+    {
+        CATCH_REQUIRE(versiontheca::sort_key_matches_compare(versiontheca::trait_kind_t::TRAIT_KIND_BASIC));
+        CATCH_REQUIRE(versiontheca::sort_key_matches_compare(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN));
+        CATCH_REQUIRE(versiontheca::sort_key_matches_compare(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL));
+        CATCH_REQUIRE_FALSE(versiontheca::sort_key_matches_compare(versiontheca::trait_kind_t::TRAIT_KIND_ROMAN));
+        CATCH_REQUIRE_FALSE(versiontheca::sort_key_matches_compare(versiontheca::trait_kind_t::TRAIT_KIND_RPM));
+        CATCH_REQUIRE_FALSE(versiontheca::sort_key_matches_compare(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE));
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("detect_trait_errors", "[detect][invalid]")
+{
+    CATCH_START_SECTION("detect_trait_errors: nothing accepts these")
+    {
+        char const * const invalid[] = { "", "1..2", "1.", ".1" };
+        for(char const * v : invalid)
+        {
+            CATCH_INFO("detecting \"" << v << "\"");
+            versiontheca::trait_kind_t kind(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL);
+            CATCH_REQUIRE(versiontheca::detect_trait(v, &kind) == nullptr);
+            CATCH_REQUIRE(kind == versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL);
+        }
+        CATCH_REQUIRE(versiontheca::classify_version("") == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,647 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+/** \file
+ * \brief Differential tests of the Debian and RPM traits.
+ *
+ * The versions are compared with the traits and with the reference
+ * implementations of dpkg and rpm (see differential.h). The versions come
+ * from the benchmark corpora, from a random generator, and from mutations
+ * of those, which generate pairs differing by a single character.
+ *
+ * Each pair is compared with all the compare functions of the library:
+ * trait::compare(), compare_strings(), basic_version, frozen_version,
+ * compare_encoded(), and trait::sort_key(). The generators use a fixed
+ * seed so the pairs are always the same and the number of documented
+ * divergences of each function is pinned: a change in the order of any
+ * version makes the tests fail until the new counts get reviewed.
+ *
+ * The throughput test cases time both sides on the same pairs so an
+ * optimization of the compare functions can be shown to keep the same
+ * order and to be faster. Run them with:
+ *
+ * \code
+ *     differential "[throughput]"
+ * \endcode
+ */
+
+// self
+//
+#include    "catch_main.h"
+#include    "differential.h"
+
+
+// versiontheca
+//
+#include    <versiontheca/basic_version.h>
+#include    <versiontheca/compare_strings.h>
+#include    <versiontheca/encoding.h>
+#include    <versiontheca/exception.h>
+#include    <versiontheca/frozen.h>
+#include    <versiontheca/versiontheca.h>
+
+
+// C++
+//
+#include    <array>
+#include    <cctype>
+#include    <functional>
+#include    <iomanip>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+typedef std::pair<std::string, std::string>     pair_t;
+typedef std::vector<pair_t>                     pair_list_t;
+typedef std::function<int(std::string const &, std::string const &)>
+                                                oracle_t;
+
+
+// the compare functions of the library checked against the reference
+//
+enum api_t
+{
+    API_COMPARE,
+    API_COMPARE_STRINGS,
+    API_BASIC_VERSION,
+    API_FROZEN_VERSION,
+    API_COMPARE_ENCODED,
+    API_SORT_KEY,
+
+    API_COUNT
+};
+
+
+constexpr char const *  g_api_names[API_COUNT] =
+{
+    "compare()",
+    "compare_strings()",
+    "basic_version",
+    "frozen_version",
+    "compare_encoded()",
+    "sort_key()",
+};
+
+
+typedef std::array<std::size_t, API_COUNT>      api_counts_t;
+
+
+/** \brief The pinned results of the comparison of a set of pairs.
+ *
+ * The mismatches are the comparable pairs (see is_comparable()) for which
+ * a function does not return the same result as the reference. The
+ * divergences are the other pairs for which the results differ.
+ */
+struct expected_t
+{
+    std::size_t         f_pairs = 0;
+    std::size_t         f_comparable = 0;
+    api_counts_t        f_mismatches = api_counts_t();
+    api_counts_t        f_divergences = api_counts_t();
+};
+
+
+// the seeds of the generators; changing them changes the pinned counts
+//
+constexpr differential::random_t::result_type const     g_debian_seed = 1;
+constexpr differential::random_t::result_type const     g_rpm_seed = 2;
+
+
+// the divergences are the separator cases documented in versiontheca.cpp
+// and the README.md
+//
+expected_t const        g_debian_expected =
+{
+    102'916,
+    24'737,
+    { 0, 0, 0, 0, 0, 0 },
+    { 2'178, 2'178, 2'178, 2'178, 2'178, 2'178 },
+};
+
+
+// the sort key of the RPM versions has 92 more divergences because it
+// does not follow compare() where that one is not transitive
+//
+expected_t const        g_rpm_expected =
+{
+    102'304,
+    23'768,
+    { 0, 0, 0, 0, 0, 0 },
+    { 3'404, 3'404, 3'404, 3'404, 3'404, 3'496 },
+};
+
+
+// the characters used to mutate the versions
+//
+constexpr char const    g_debian_alphabet[] = "0123456789abzAZ.+~-:";
+constexpr char const    g_rpm_alphabet[] = "0123456789abzAZ._+~^-:";
+
+
+bool is_valid(versiontheca::trait_kind_t kind, std::string const & v)
+{
+    try
+    {
+        return versiontheca::create_trait(kind)->parse(v);
+    }
+    catch(versiontheca::versiontheca_exception const &)
+    {
+        // too many parts
+        //
+        return false;
+    }
+}
+
+
+/** \brief Generate the pairs to compare.
+ *
+ * The list includes all the pairs of the corpus, random pairs, and pairs
+ * of a version with a mutation of itself. Versions which the trait does
+ * not accept are skipped.
+ */
+pair_list_t generate_pairs(
+      versiontheca::trait_kind_t kind
+    , versiontheca_benchmarks::version_list_t const & corpus
+    , std::function<std::string(differential::random_t &)> random_version
+    , char const * alphabet
+    , std::size_t count
+    , differential::random_t::result_type seed)
+{
+    differential::random_t rng(seed);
+
+    pair_list_t result;
+    for(auto const & l : corpus)
+    {
+        for(auto const & r : corpus)
+        {
+            result.emplace_back(l, r);
+        }
+    }
+
+    versiontheca_benchmarks::version_list_t versions(corpus);
+    while(versions.size() < corpus.size() + count / 4)
+    {
+        std::string const v(random_version(rng));
+        if(is_valid(kind, v))
+        {
+            versions.push_back(v);
+        }
+    }
+
+    while(result.size() < corpus.size() * corpus.size() + count)
+    {
+        std::string const & l(versions[rng() % versions.size()]);
+        std::string r;
+        if(rng() % 2 == 0)
+        {
+            r = versions[rng() % versions.size()];
+        }
+        else
+        {
+            r = differential::mutate_version(l, alphabet, rng);
+            if(!is_valid(kind, r))
+            {
+                continue;
+            }
+        }
+        result.emplace_back(l, r);
+    }
+
+    return result;
+}
+
+
+std::vector<std::string> tokenize(std::string const & v)
+{
+    auto kind([](char c)
+        {
+            if(c >= '0' && c <= '9')
+            {
+                return 'N';
+            }
+            if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+            {
+                return 'A';
+            }
+            return c;
+        });
+
+    std::vector<std::string> result;
+    for(std::size_t idx(0); idx < v.length(); ++idx)
+    {
+        char const k(kind(v[idx]));
+        if(result.empty()
+        || (k != 'N' && k != 'A')
+        || kind(result.back()[0]) != k)
+        {
+            result.emplace_back();
+        }
+        result.back() += v[idx];
+    }
+    return result;
+}
+
+
+/** \brief Check whether the trait is expected to match the reference.
+ *
+ * The traits view the separators as the boundaries of the parts whereas
+ * dpkg and rpm compare them as characters (dpkg) or skip them (rpm). This
+ * results in documented divergences (see the note in versiontheca.cpp)
+ * in two cases:
+ *
+ * \li the versions do not have the same skeleton, i.e. the same runs of
+ * digits and letters separated by the same separators;
+ * \li the first runs which differ are strings, one being a prefix of the
+ * other and followed by a separator, which the references compare
+ * against the letter found in the other string.
+ *
+ * The other pairs must compare the same way.
+ */
+bool is_comparable(std::string const & lhs, std::string const & rhs)
+{
+    std::vector<std::string> const l(tokenize(lhs));
+    std::vector<std::string> const r(tokenize(rhs));
+    if(l.size() != r.size())
+    {
+        return false;
+    }
+    for(std::size_t idx(0); idx < l.size(); ++idx)
+    {
+        bool const l_digit(l[idx][0] >= '0' && l[idx][0] <= '9');
+        bool const r_digit(r[idx][0] >= '0' && r[idx][0] <= '9');
+        bool const l_alpha(!l_digit && std::isalpha(static_cast<unsigned char>(l[idx][0])));
+        bool const r_alpha(!r_digit && std::isalpha(static_cast<unsigned char>(r[idx][0])));
+        if(l_digit != r_digit
+        || l_alpha != r_alpha
+        || (!l_digit && !l_alpha && l[idx] != r[idx]))
+        {
+            return false;
+        }
+    }
+    for(std::size_t idx(0); idx < l.size(); ++idx)
+    {
+        if(l[idx] == r[idx])
+        {
+            continue;
+        }
+        if(std::isalpha(static_cast<unsigned char>(l[idx][0]))
+        && idx + 1 < l.size()
+        && (l[idx].compare(0, r[idx].length(), r[idx]) == 0
+            || r[idx].compare(0, l[idx].length(), l[idx]) == 0))
+        {
+            return false;
+        }
+        break;
+    }
+    return true;
+}
+
+
+int key_compare(std::string const & lhs, std::string const & rhs)
+{
+    return differential::sign(lhs.compare(rhs));
+}
+
+
+template<typename V>
+int basic_version_compare(std::string const & lhs, std::string const & rhs)
+{
+    return V(lhs).compare(V(rhs));
+}
+
+
+/** \brief Compare a pair with each function of the library.
+ *
+ * \param[in] kind  The kind of versions (Debian or RPM).
+ * \param[in] p  The pair to compare.
+ *
+ * \return The result of each function, in the order of api_t.
+ */
+std::array<int, API_COUNT> library_compare(versiontheca::trait_kind_t kind, pair_t const & p)
+{
+    versiontheca::versiontheca const l(versiontheca::create_trait(kind), p.first);
+    versiontheca::versiontheca const r(versiontheca::create_trait(kind), p.second);
+
+    std::array<int, API_COUNT> result;
+    result[API_COMPARE] = l.compare(r);
+    result[API_COMPARE_STRINGS] = versiontheca::compare_strings(kind, p.first, p.second);
+    result[API_BASIC_VERSION] = kind == versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                ? basic_version_compare<versiontheca::debian_version>(p.first, p.second)
+                : basic_version_compare<versiontheca::rpm_version>(p.first, p.second);
+    result[API_FROZEN_VERSION] = versiontheca::frozen_version(kind, l)
+                .compare(versiontheca::frozen_version(kind, r));
+    result[API_COMPARE_ENCODED] = versiontheca::compare_encoded(
+                  kind
+                , versiontheca::encode_parts(*l.get_trait())
+                , versiontheca::encode_parts(*r.get_trait()));
+    result[API_SORT_KEY] = key_compare(l.sort_key(), r.sort_key());
+    return result;
+}
+
+
+/** \brief Compare the pairs with the library and the reference.
+ *
+ * Each pair is compared with all the compare functions of the library
+ * (see library_compare()) and with the reference. The number of pairs
+ * which compare differently is counted for each function, separately
+ * for the comparable pairs (see is_comparable()) and the others, and
+ * the counts must be the ones found in \p expected.
+ *
+ * compare(), compare_strings(), basic_version, frozen_version, and
+ * compare_encoded() share the same compare functions so they must
+ * return the same result as compare() on every pair, comparable or not.
+ * The sort_key() is a total order and it cannot follow the RPM compare()
+ * where that one is not transitive (see rpm::sort_key()) so its counts
+ * differ for RPM versions.
+ */
+void verify_pairs(
+      char const * name
+    , versiontheca::trait_kind_t kind
+    , pair_list_t const & pairs
+    , oracle_t oracle
+    , expected_t const & expected)
+{
+    std::size_t comparable(0);
+    std::size_t inconsistencies(0);
+    api_counts_t mismatches = api_counts_t();
+    api_counts_t divergences = api_counts_t();
+    for(auto const & p : pairs)
+    {
+        int const reference(oracle(p.first, p.second));
+        std::array<int, API_COUNT> const got(library_compare(kind, p));
+        bool const strict(is_comparable(p.first, p.second));
+        if(strict)
+        {
+            ++comparable;
+        }
+        for(std::size_t api(0); api < API_COUNT; ++api)
+        {
+            if(api != API_SORT_KEY
+            && got[api] != got[API_COMPARE])
+            {
+                ++inconsistencies;
+                if(inconsistencies <= 10)
+                {
+                    CATCH_INFO(g_api_names[api] << " and compare() on \"" << p.first << "\" with \"" << p.second << "\"");
+                    CATCH_CHECK(got[api] == got[API_COMPARE]);
+                }
+            }
+            if(got[api] == reference)
+            {
+                continue;
+            }
+            if(!strict)
+            {
+                ++divergences[api];
+                continue;
+            }
+            ++mismatches[api];
+            if(mismatches[api] > expected.f_mismatches[api]
+            && mismatches[api] <= expected.f_mismatches[api] + 10)
+            {
+                CATCH_INFO(g_api_names[api] << " comparing \"" << p.first << "\" with \"" << p.second << "\"");
+                CATCH_CHECK(got[api] == reference);
+            }
+        }
+    }
+
+    std::cout << name << ": " << pairs.size() << " pairs, " << comparable << " comparable\n";
+    for(std::size_t api(0); api < API_COUNT; ++api)
+    {
+        std::cout
+            << "  " << std::setw(20) << std::left << g_api_names[api]
+            << mismatches[api] << " mismatches, "
+            << divergences[api] << " documented divergences\n";
+    }
+
+    CATCH_REQUIRE(inconsistencies == 0);
+    CATCH_REQUIRE(pairs.size() == expected.f_pairs);
+    CATCH_REQUIRE(comparable == expected.f_comparable);
+    for(std::size_t api(0); api < API_COUNT; ++api)
+    {
+        CATCH_INFO("checking the counts of " << g_api_names[api]);
+        CATCH_REQUIRE(mismatches[api] == expected.f_mismatches[api]);
+        CATCH_REQUIRE(divergences[api] == expected.f_divergences[api]);
+    }
+}
+
+
+/** \brief Time the traits and the reference implementation.
+ *
+ * The trait is timed twice: parsing and comparing the versions, which
+ * is what a user of the library does with strings, and comparing
+ * versions parsed beforehand. The results are printed in millions of
+ * compares per second.
+ */
+void measure_throughput(
+      char const * name
+    , char const * reference
+    , versiontheca::trait_kind_t kind
+    , pair_list_t const & pairs
+    , oracle_t oracle)
+{
+    std::vector<std::pair<versiontheca::versiontheca::pointer_t, versiontheca::versiontheca::pointer_t>> parsed;
+    parsed.reserve(pairs.size());
+    for(auto const & p : pairs)
+    {
+        parsed.emplace_back(
+              std::make_shared<versiontheca::versiontheca>(versiontheca::create_trait(kind), p.first)
+            , std::make_shared<versiontheca::versiontheca>(versiontheca::create_trait(kind), p.second));
+    }
+
+    auto mps([&pairs](double seconds)
+        {
+            return static_cast<double>(pairs.size()) / seconds / 1'000'000.0;
+        });
+
+    // the sums make sure the compilers do not optimize out the loops
+    //
+    long sum(0);
+
+    differential::timer const oracle_timer;
+    for(auto const & p : pairs)
+    {
+        sum += oracle(p.first, p.second);
+    }
+    double const oracle_seconds(oracle_timer.seconds());
+
+    differential::timer const string_timer;
+    for(auto const & p : pairs)
+    {
+        sum += versiontheca::compare_strings(kind, p.first, p.second);
+    }
+    double const string_seconds(string_timer.seconds());
+
+    differential::timer const parse_timer;
+    for(auto const & p : pairs)
+    {
+        versiontheca::versiontheca const l(versiontheca::create_trait(kind), p.first);
+        versiontheca::versiontheca const r(versiontheca::create_trait(kind), p.second);
+        sum += l.compare(r);
+    }
+    double const parse_seconds(parse_timer.seconds());
+
+    differential::timer const compare_timer;
+    for(auto const & p : parsed)
+    {
+        sum += p.first->compare(*p.second);
+    }
+    double const compare_seconds(compare_timer.seconds());
+
+    std::cout
+        << std::fixed << std::setprecision(3)
+        << name << ": " << pairs.size() << " pairs (checksum: " << sum << ")\n"
+        << "  " << std::setw(28) << std::left << reference << mps(oracle_seconds) << " M/s\n"
+        << "  " << std::setw(28) << std::left << "compare_strings()" << mps(string_seconds) << " M/s\n"
+        << "  " << std::setw(28) << std::left << "parse() + compare()" << mps(parse_seconds) << " M/s\n"
+        << "  " << std::setw(28) << std::left << "compare() (pre-parsed)" << mps(compare_seconds) << " M/s\n";
+
+    CATCH_REQUIRE(oracle_seconds > 0.0);
+}
+
+
+pair_list_t debian_pairs(std::size_t count)
+{
+    return generate_pairs(
+          versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+        , differential::debian_versions()
+        , differential::random_debian_version
+        , g_debian_alphabet
+        , count
+        , g_debian_seed);
+}
+
+
+pair_list_t rpm_pairs(std::size_t count)
+{
+    return generate_pairs(
+          versiontheca::trait_kind_t::TRAIT_KIND_RPM
+        , differential::rpm_versions()
+        , differential::random_rpm_version
+        , g_rpm_alphabet
+        , count
+        , g_rpm_seed);
+}
+
+
+int dpkg_oracle(std::string const & lhs, std::string const & rhs)
+{
+    return differential::dpkg_compare(lhs, rhs);
+}
+
+
+int rpm_oracle(std::string const & lhs, std::string const & rhs)
+{
+    return differential::rpm_compare(lhs, rhs);
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("differential_debian", "[differential][debian]")
+{
+    CATCH_START_SECTION("differential_debian: the dpkg port matches dpkg --compare-versions")
+    {
+        if(!differential::has_dpkg())
+        {
+            CATCH_WARN("dpkg not found, the dpkg port is not verified.");
+        }
+        else
+        {
+            // each compare runs dpkg so only use a small sample
+            //
+            pair_list_t const pairs(debian_pairs(100));
+            for(std::size_t idx(0); idx < pairs.size(); idx += pairs.size() / 250 + 1)
+            {
+                auto const & p(pairs[idx]);
+                CATCH_INFO("comparing \"" << p.first << "\" with \"" << p.second << "\"");
+                CATCH_REQUIRE(differential::dpkg_command_compare(p.first, p.second)
+                                == differential::dpkg_compare(p.first, p.second));
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("differential_debian: trait versus dpkg")
+    {
+        verify_pairs(
+              "debian"
+            , versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+            , debian_pairs(100'000)
+            , dpkg_oracle
+            , g_debian_expected);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("differential_rpm", "[differential][rpm]")
+{
+    CATCH_START_SECTION("differential_rpm: trait versus rpmvercmp")
+    {
+        verify_pairs(
+              "rpm"
+            , versiontheca::trait_kind_t::TRAIT_KIND_RPM
+            , rpm_pairs(100'000)
+            , rpm_oracle
+            , g_rpm_expected);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("differential_throughput", "[differential][throughput]")
+{
+    CATCH_START_SECTION("differential_throughput: debian")
+    {
+        measure_throughput(
+              "debian"
+            , "dpkg_version_compare()"
+            , versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+            , debian_pairs(200'000)
+            , dpkg_oracle);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("differential_throughput: rpm")
+    {
+        measure_throughput(
+              "rpm"
+            , "rpmverCmp()"
+            , versiontheca::trait_kind_t::TRAIT_KIND_RPM
+            , rpm_pairs(200'000)
+            , rpm_oracle);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
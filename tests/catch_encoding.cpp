@@ -0,0 +1,264 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/encoding.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/exception.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// C++
+//
+#include    <fstream>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+struct kind_versions_t
+{
+    versiontheca::trait_kind_t  f_kind = versiontheca::trait_kind_t::TRAIT_KIND_BASIC;
+    std::vector<char const *>   f_versions = std::vector<char const *>();
+};
+
+
+std::vector<kind_versions_t> const g_versions =
+{
+    { versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   { "1", "1.0", "1.2", "1.10.3", "2", "4294967295.0.1" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  { "1.0", "1.0~rc1", "1.0-1", "1:0.9", "2.0+dfsg-3ubuntu1", "2.0~~", "1.0a", "1.0-1~bpo1" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, { "1", "1.5", "2.25", "10.0" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_ROMAN,   { "I", "IV.II", "MMXXIII.X", "V" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_RPM,     { "1.0", "1.0~rc1", "1.0-1", "1:0.9", "2.0.a_b-3.fc39", "1.0a", "1.0_1" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, { "1.0", "1.0.ß", "1.A", "2.zeta", "10" } },
+};
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("encoding_round_trip", "[encoding][valid]")
+{
+    CATCH_START_SECTION("encoding_round_trip: decode gives back the same parts")
+    {
+        for(auto const & k : g_versions)
+        {
+            for(auto const & v : k.f_versions)
+            {
+                versiontheca::versiontheca original(versiontheca::create_trait(k.f_kind), v);
+                CATCH_REQUIRE(original.is_valid());
+                std::string const encoded(versiontheca::encode_parts(*original.get_trait()));
+
+                versiontheca::encoded_parts const view(encoded);
+                CATCH_REQUIRE(view.size() == original.size());
+                CATCH_REQUIRE(view.encoded_size() == encoded.length());
+                for(std::size_t idx(0); idx < view.size(); ++idx)
+                {
+                    versiontheca::part const & p(original.get_trait()->at(idx));
+                    CATCH_REQUIRE(view.get_separator(idx) == p.get_separator());
+                    CATCH_REQUIRE(view.get_type(idx) == p.get_type());
+                    CATCH_REQUIRE(view.get_width(idx) == p.get_width());
+                    CATCH_REQUIRE(view.is_integer(idx) == p.is_integer());
+                    if(p.is_integer())
+                    {
+                        CATCH_REQUIRE(view.get_integer(idx) == p.get_integer());
+                    }
+                    else
+                    {
+                        CATCH_REQUIRE(view.get_string(idx) == p.get_string());
+                    }
+                }
+
+                versiontheca::trait::pointer_t t(versiontheca::create_trait(k.f_kind));
+                versiontheca::decode_parts(encoded, *t);
+                CATCH_REQUIRE(t->to_string() == original.get_version());
+            }
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("encoding_compare", "[encoding][valid]")
+{
+    CATCH_START_SECTION("encoding_compare: same results as the traits")
+    {
+        for(auto const & k : g_versions)
+        {
+            versiontheca::encoded_version_list list(k.f_kind);
+            for(auto const & v : k.f_versions)
+            {
+                versiontheca::trait::pointer_t t(versiontheca::create_trait(k.f_kind));
+                CATCH_REQUIRE(t->parse(v));
+                list.add(*t);
+            }
+            CATCH_REQUIRE(list.size() == k.f_versions.size());
+            for(std::size_t l(0); l < k.f_versions.size(); ++l)
+            {
+                for(std::size_t r(0); r < k.f_versions.size(); ++r)
+                {
+                    versiontheca::versiontheca lv(versiontheca::create_trait(k.f_kind), k.f_versions[l]);
+                    versiontheca::versiontheca rv(versiontheca::create_trait(k.f_kind), k.f_versions[r]);
+                    CATCH_REQUIRE(list.compare(l, r) == lv.compare(rv));
+                    CATCH_REQUIRE(versiontheca::compare_encoded(k.f_kind, list.get_encoded(l), list.get_encoded(r)) == lv.compare(rv));
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("encoding_file", "[encoding][valid]")
+{
+    CATCH_START_SECTION("encoding_file: save and load")
+    {
+        std::string const filename(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/versions.enc");
+        kind_versions_t const & k(g_versions[1]);
+        {
+            versiontheca::encoded_version_list list(k.f_kind);
+            for(auto const & v : k.f_versions)
+            {
+                versiontheca::trait::pointer_t t(versiontheca::create_trait(k.f_kind));
+                CATCH_REQUIRE(t->parse(v));
+                list.add(*t);
+            }
+            list.save(filename);
+        }
+
+        versiontheca::encoded_version_list const list(versiontheca::encoded_version_list::load(filename));
+        CATCH_REQUIRE(list.get_kind() == k.f_kind);
+        CATCH_REQUIRE(list.size() == k.f_versions.size());
+        for(std::size_t idx(0); idx < list.size(); ++idx)
+        {
+            versiontheca::trait::pointer_t t(versiontheca::create_trait(k.f_kind));
+            versiontheca::decode_parts(list.get_encoded(idx), *t);
+            versiontheca::versiontheca v(versiontheca::create_trait(k.f_kind), k.f_versions[idx]);
+            CATCH_REQUIRE(t->to_string() == v.get_version());
+        }
+        CATCH_REQUIRE(list.compare(0, 1) == 1);
+        CATCH_REQUIRE(list.compare(3, 0) == 1);
+
+        // saving a loaded list works too
+        //
+        std::string const copy(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/versions-copy.enc");
+        list.save(copy);
+        CATCH_REQUIRE(versiontheca::encoded_version_list::load(copy).size() == list.size());
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("encoding_errors", "[encoding][invalid]")
+{
+    CATCH_START_SECTION("encoding_errors: invalid encoded versions")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::encoded_parts(std::string_view())
+                , versiontheca::invalid_encoding
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: encoded version is truncated."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::encoded_parts(std::string_view("\x1A", 1))
+                , versiontheca::invalid_encoding
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: encoded version has too many parts."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::encoded_parts(std::string_view("\x01\x10\x01", 3))
+                , versiontheca::invalid_encoding
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: encoded version includes unknown flags."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::encoded_parts(std::string_view("\x01\x00\x05" "abc", 6))
+                , versiontheca::invalid_encoding
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: encoded version is truncated."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::encoded_parts(std::string_view("\x01\x01\xFF\xFF\xFF\xFF\x7F", 7))
+                , versiontheca::invalid_encoding
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: encoded version includes a varint which is too large."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::compare_encoded(
+                          versiontheca::trait_kind_t::TRAIT_KIND_BASIC
+                        , std::string_view("\x00", 1)
+                        , std::string_view("\x01\x01\x01", 3))
+                , versiontheca::empty_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: one or both of the input versions are empty."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("encoding_errors: invalid lists")
+    {
+        versiontheca::encoded_version_list list(versiontheca::trait_kind_t::TRAIT_KIND_BASIC);
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  list.get_encoded(0)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: index 0 is out of range for a list of 0 encoded versions."));
+
+        std::string const filename(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/basic.enc");
+        list.save(filename);
+        versiontheca::encoded_version_list loaded(versiontheca::encoded_version_list::load(filename));
+        CATCH_REQUIRE(loaded.empty());
+        versiontheca::trait::pointer_t t(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC));
+        CATCH_REQUIRE(t->parse("1.2"));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  loaded.add(*t)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: a list of encoded versions loaded from a file cannot be modified."));
+
+        std::string const bad(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/not-encoded.enc");
+        {
+            std::ofstream out(bad);
+            out << "this is just a text file and not a list of encoded versions at all\n";
+        }
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::encoded_version_list::load(bad)
+                , versiontheca::invalid_encoding
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: this is not a list of encoded versions or it was created on a computer with a different byte order."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
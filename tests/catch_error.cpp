@@ -0,0 +1,167 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/error.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/basic.h"
+#include    "versiontheca/batch.h"
+#include    "versiontheca/debian.h"
+#include    "versiontheca/rpm.h"
+#include    "versiontheca/unicode.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+template<typename T>
+versiontheca::version_error_t parse_error(std::string const & v)
+{
+    T t;
+    CATCH_REQUIRE_FALSE(t.parse(v));
+    return t.get_error();
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("version_errors", "[error]")
+{
+    CATCH_START_SECTION("version_errors: codes and offsets")
+    {
+        versiontheca::version_error_t e(parse_error<versiontheca::unicode>(""));
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_EMPTY_INPUT);
+        CATCH_REQUIRE(e.f_offset == 0);
+
+        e = parse_error<versiontheca::unicode>("1.2..3");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_EMPTY_VALUE);
+        CATCH_REQUIRE(e.f_offset == 4);
+
+        e = parse_error<versiontheca::unicode>("1.2.99999999999");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_INTEGER_TOO_LARGE);
+        CATCH_REQUIRE(e.f_offset == 4);
+
+        e = parse_error<versiontheca::unicode>("1.2\x7F");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER);
+        CATCH_REQUIRE(e.f_offset == 3);
+        CATCH_REQUIRE(e.f_character == U'\x7F');
+
+        e = parse_error<versiontheca::unicode>("1.\xC3\xA9\x7F");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER);
+        CATCH_REQUIRE(e.f_offset == 4);
+        CATCH_REQUIRE(e.f_character == U'\x7F');
+
+        e = parse_error<versiontheca::unicode>("1.\xC3");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_INVALID_UTF8);
+        CATCH_REQUIRE(e.f_offset == 2);
+
+        e = parse_error<versiontheca::basic>("1.2a");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_BASIC_NOT_INTEGER);
+
+        e = parse_error<versiontheca::debian>("1-2:3");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_INVALID_SEPARATOR_POSITION);
+        CATCH_REQUIRE(e.f_offset == 1);
+
+        e = parse_error<versiontheca::debian>("1a:3");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_INVALID_EPOCH);
+        CATCH_REQUIRE(e.f_offset == 0);
+
+        e = parse_error<versiontheca::debian>("5:a3");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_DEBIAN_NOT_NUMBER);
+        CATCH_REQUIRE(e.f_offset == 2);
+
+        e = parse_error<versiontheca::rpm>("1.0-r!c");
+        CATCH_REQUIRE(e.f_code == versiontheca::error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER);
+        CATCH_REQUIRE(e.f_offset == 5);
+        CATCH_REQUIRE(e.f_character == U'!');
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("version_errors: the message is generated on request")
+    {
+        versiontheca::debian t;
+        CATCH_REQUIRE_FALSE(t.parse("5:a3"));
+        CATCH_REQUIRE(t.get_error().f_code == versiontheca::error_code_t::ERROR_CODE_DEBIAN_NOT_NUMBER);
+        CATCH_REQUIRE(t.get_last_error() == "a Debian version must always start with a number \"5:a3\".");
+
+        // the input is kept even if the parser gets reused
+        //
+        CATCH_REQUIRE(t.parse("1.0"));
+        CATCH_REQUIRE(t.take_last_error() == "a Debian version must always start with a number \"5:a3\".");
+        CATCH_REQUIRE(t.get_error().f_code == versiontheca::error_code_t::ERROR_CODE_NONE);
+        CATCH_REQUIRE(t.take_last_error().empty());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("version_errors: batch errors")
+    {
+        versiontheca::batch b(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        b.add("1.0");
+        b.add("1-2:3");
+        b.add("1.0-r_c");
+        CATCH_REQUIRE(b.get_error(0).f_code == versiontheca::error_code_t::ERROR_CODE_NONE);
+        CATCH_REQUIRE(b.get_error(1).f_code == versiontheca::error_code_t::ERROR_CODE_INVALID_SEPARATOR_POSITION);
+        CATCH_REQUIRE(b.get_last_error(1) == "position of ':' and/or '-' is invalid in \"1-2:3\".");
+        CATCH_REQUIRE(b.get_error(2).f_code == versiontheca::error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER);
+        CATCH_REQUIRE(b.get_error(2).f_offset == 5);
+        CATCH_REQUIRE(b.get_last_error(2) == "found unexpected character: \\U00005F in input.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("version_errors: all messages")
+    {
+        versiontheca::version_error_t e;
+        CATCH_REQUIRE(versiontheca::error_message(e).empty());
+        for(int code(static_cast<int>(versiontheca::error_code_t::ERROR_CODE_EMPTY_INPUT));
+            code <= static_cast<int>(versiontheca::error_code_t::ERROR_CODE_OUT_OF_RANGE);
+            ++code)
+        {
+            e.f_code = static_cast<versiontheca::error_code_t>(code);
+            std::string const msg(versiontheca::error_message(e, "1.0"));
+            CATCH_REQUIRE_FALSE(msg.empty());
+            CATCH_REQUIRE(msg.back() == '.');
+            CATCH_REQUIRE((msg.find("\"1.0\"") != std::string::npos) == versiontheca::error_message_includes_input(e.f_code));
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
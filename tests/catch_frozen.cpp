@@ -0,0 +1,253 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/frozen.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/debian.h"
+#include    "versiontheca/exception.h"
+
+
+// C++
+//
+#include    <atomic>
+#include    <thread>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+struct kind_versions_t
+{
+    versiontheca::trait_kind_t  f_kind = versiontheca::trait_kind_t::TRAIT_KIND_BASIC;
+    std::vector<char const *>   f_versions = std::vector<char const *>();
+};
+
+
+std::vector<kind_versions_t> const g_versions =
+{
+    { versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   { "1", "1.0", "1.2", "1.10.3", "2", "4294967295.0.1" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  { "1.0", "1.0~rc1", "1.0-1", "1:0.9", "2.0+dfsg-3ubuntu1", "2.0~~", "1.0a", "1.0-1~bpo1" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, { "1", "1.5", "2.25", "10.0" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_ROMAN,   { "I", "IV.II", "MMXXIII.X", "V" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_RPM,     { "1.0", "1.0~rc1", "1.0-1", "1:0.9", "2.0.a_b-3.fc39", "1.0a", "1.0_1" } },
+    { versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, { "1.0", "1.0.ß", "1.A", "2.zeta", "10" } },
+};
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("frozen_versions", "[frozen][valid]")
+{
+    CATCH_START_SECTION("frozen_versions: same order as versiontheca::compare()")
+    {
+        for(auto const & k : g_versions)
+        {
+            for(char const * l : k.f_versions)
+            {
+                versiontheca::versiontheca const lv(versiontheca::create_trait(k.f_kind), l);
+                versiontheca::frozen_version const lf(k.f_kind, l);
+                CATCH_REQUIRE(lf.is_valid());
+                CATCH_REQUIRE(lf.get_kind() == k.f_kind);
+                CATCH_REQUIRE(lf.get_version() == lv.get_version());
+                CATCH_REQUIRE(lf.get_last_error().empty());
+                CATCH_REQUIRE(lf.get_error().f_code == versiontheca::error_code_t::ERROR_CODE_NONE);
+                CATCH_REQUIRE(lf.size() == lv.size());
+                for(std::size_t idx(0); idx < lf.size(); ++idx)
+                {
+                    CATCH_REQUIRE(lf.at(idx).compare(lv.get_trait()->at(idx)) == 0);
+                }
+
+                for(char const * r : k.f_versions)
+                {
+                    versiontheca::versiontheca const rv(versiontheca::create_trait(k.f_kind), r);
+                    versiontheca::frozen_version const rf(k.f_kind, r);
+                    int const expected(lv.compare(rv));
+                    CATCH_REQUIRE(lf.compare(rf) == expected);
+                    CATCH_REQUIRE((lf == rf) == (expected == 0));
+                    CATCH_REQUIRE((lf != rf) == (expected != 0));
+                    CATCH_REQUIRE((lf <  rf) == (expected <  0));
+                    CATCH_REQUIRE((lf <= rf) == (expected <= 0));
+                    CATCH_REQUIRE((lf >  rf) == (expected >  0));
+                    CATCH_REQUIRE((lf >= rf) == (expected >= 0));
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("frozen_versions: a snapshot does not follow the original")
+    {
+        versiontheca::debian::pointer_t t(std::make_shared<versiontheca::debian>());
+        versiontheca::versiontheca v(t, "1.2.3-1");
+        versiontheca::frozen_version const f(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, v);
+        CATCH_REQUIRE(f.get_version() == "1.2.3-1");
+
+        CATCH_REQUIRE(v.next(2));
+        CATCH_REQUIRE(v.get_version() != "1.2.3-1");
+        CATCH_REQUIRE(f.get_version() == "1.2.3-1");
+
+        versiontheca::frozen_version const g(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, v);
+        CATCH_REQUIRE(f < g);
+
+        std::stringstream ss;
+        ss << f;
+        CATCH_REQUIRE(ss.str() == "1.2.3-1");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("frozen_versions: concurrent compare of shared versions")
+    {
+        versiontheca::frozen_version::vector_t versions;
+        for(int i(0); i < 50; ++i)
+        {
+            versions.emplace_back(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1." + std::to_string(i) + "-1");
+        }
+
+        std::vector<std::thread> threads;
+        std::atomic<int> failures(0);
+        for(int t(0); t < 4; ++t)
+        {
+            threads.emplace_back([&versions, &failures]()
+                {
+                    for(int i(0); i < 5'000; ++i)
+                    {
+                        int const l(i % 50);
+                        int const r(i % 37);
+                        int const expected(l == r ? 0 : (l < r ? -1 : 1));
+                        if(versions[l].compare(versions[r]) != expected)
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+        }
+        for(auto & t : threads)
+        {
+            t.join();
+        }
+        CATCH_REQUIRE(failures == 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("frozen_versions: concurrent const reads of a versiontheca")
+    {
+        versiontheca::versiontheca const a(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.0-3");
+        versiontheca::versiontheca const b(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.0~rc1-3");
+
+        std::vector<std::thread> threads;
+        std::atomic<int> failures(0);
+        for(int t(0); t < 4; ++t)
+        {
+            threads.emplace_back([&a, &b, &failures]()
+                {
+                    for(int i(0); i < 2'000; ++i)
+                    {
+                        if(a.compare(b) != 1
+                        || b.compare(a) != -1
+                        || a.get_version() != "1.0-3"
+                        || a.get_error().f_code != versiontheca::error_code_t::ERROR_CODE_NONE)
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+        }
+        for(auto & t : threads)
+        {
+            t.join();
+        }
+        CATCH_REQUIRE(failures == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_frozen_versions", "[frozen][invalid]")
+{
+    CATCH_START_SECTION("invalid_frozen_versions: the error is part of the snapshot")
+    {
+        versiontheca::frozen_version const f(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "a1.0");
+        CATCH_REQUIRE_FALSE(f.is_valid());
+        CATCH_REQUIRE(f.size() == 0);
+        CATCH_REQUIRE(f.get_version().empty());
+        CATCH_REQUIRE(f.get_error().f_code == versiontheca::error_code_t::ERROR_CODE_DEBIAN_NOT_NUMBER);
+        CATCH_REQUIRE(f.get_last_error() == "a Debian version must always start with a number \"a1.0\".");
+
+        // the error is never cleared
+        //
+        CATCH_REQUIRE(f.get_last_error() == "a Debian version must always start with a number \"a1.0\".");
+
+        versiontheca::frozen_version const v(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0");
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  f.compare(v)
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: one or both of the input versions are not valid."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  v < f
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: one or both of the input versions are not valid."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_frozen_versions: kinds must match")
+    {
+        versiontheca::frozen_version const d(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0");
+        versiontheca::frozen_version const r(versiontheca::trait_kind_t::TRAIT_KIND_RPM, "1.0");
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  d.compare(r)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: cannot compare frozen versions of different kinds."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_frozen_versions: part index out of range")
+    {
+        versiontheca::frozen_version const f(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "1.2");
+        CATCH_REQUIRE(f.size() == 2);
+        CATCH_REQUIRE_THROWS_AS(f.at(2), std::out_of_range);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
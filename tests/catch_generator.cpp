@@ -0,0 +1,167 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/generator.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/exception.h"
+#include    "versiontheca/kind.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+CATCH_TEST_CASE("version_generator", "[generator][valid]")
+{
+    CATCH_START_SECTION("version_generator: same versions as versiontheca::next()")
+    {
+        for(versiontheca::trait_kind_t const kind : {
+                      versiontheca::trait_kind_t::TRAIT_KIND_BASIC
+                    , versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                    , versiontheca::trait_kind_t::TRAIT_KIND_RPM
+                    , versiontheca::trait_kind_t::TRAIT_KIND_UNICODE })
+        {
+            versiontheca::versiontheca v(versiontheca::create_trait(kind), "1.2.3");
+            versiontheca::versiontheca const format(versiontheca::create_trait(kind), "9.9.9");
+            v.set_format(format);
+
+            versiontheca::version_range_generator g(v, 2);
+            g.set_format(format);
+            std::vector<std::string> const generated(g.generate(70));
+            CATCH_REQUIRE(generated.size() == 70);
+            CATCH_REQUIRE(g.get_steps() == 70);
+            for(auto const & s : generated)
+            {
+                CATCH_REQUIRE(v.next(2));
+                CATCH_REQUIRE(s == v.get_version());
+            }
+            CATCH_REQUIRE(g.get_version() == v.get_version());
+            CATCH_REQUIRE(g.get_trait().compare(v.get_trait()) == 0);
+            CATCH_REQUIRE(g.get_last_error().empty());
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("version_generator: step backward")
+    {
+        versiontheca::versiontheca const v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC), "1.2");
+        versiontheca::versiontheca const format(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC), "9.9");
+        versiontheca::version_range_generator g(v, 1, versiontheca::step_direction_t::STEP_DIRECTION_PREVIOUS);
+        g.set_format(format);
+        std::vector<std::string> const generated(g.generate(5));
+        CATCH_REQUIRE(generated == std::vector<std::string>({ "1.1", "1.0", "0.9", "0.8", "0.7" }));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("version_generator: stop at the end of a range")
+    {
+        versiontheca::versiontheca const v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.2.7");
+        versiontheca::version_range_generator g(v, 2);
+        g.set_range(versiontheca::version_range(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 1.2.10"));
+        std::vector<std::string> const generated(g.generate(100));
+        CATCH_REQUIRE(generated == std::vector<std::string>({ "1.2.8", "1.2.9" }));
+        CATCH_REQUIRE(g.get_version() == "1.2.9");
+        CATCH_REQUIRE(g.get_error().f_code == versiontheca::error_code_t::ERROR_CODE_OUT_OF_RANGE);
+        CATCH_REQUIRE(g.get_last_error() == "the version is out of the generator range.");
+
+        // trying again fails the same way and does not change the version
+        //
+        CATCH_REQUIRE_FALSE(g.step());
+        CATCH_REQUIRE(g.get_version() == "1.2.9");
+        CATCH_REQUIRE(g.get_steps() == 2);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("version_generator: the start version is copied")
+    {
+        versiontheca::versiontheca v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE), "3.1");
+        versiontheca::version_range_generator g(v, 1);
+        CATCH_REQUIRE(v.set_version("7.0"));
+        CATCH_REQUIRE(g.step());
+        CATCH_REQUIRE(g.get_version() == "3.2");
+        CATCH_REQUIRE(v.get_version() == "7.0");
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_version_generator", "[generator][invalid]")
+{
+    CATCH_START_SECTION("invalid_version_generator: a failed step keeps the current version")
+    {
+        versiontheca::versiontheca const v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC), "1.1");
+        versiontheca::versiontheca const format(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC), "1.1");
+        versiontheca::version_range_generator g(v, 1);
+        g.set_format(format);
+        CATCH_REQUIRE_FALSE(g.step());
+        CATCH_REQUIRE(g.get_version() == "1.1");
+        CATCH_REQUIRE(g.get_error().f_code == versiontheca::error_code_t::ERROR_CODE_MAXIMUM_REACHED);
+        CATCH_REQUIRE(g.get_last_error() == "maximum limit reached; cannot increment version any further.");
+        CATCH_REQUIRE(g.get_steps() == 0);
+
+        // compare with versiontheca which clears the version on failure
+        //
+        versiontheca::versiontheca w(v);
+        w.set_format(format);
+        CATCH_REQUIRE_FALSE(w.next(1));
+        CATCH_REQUIRE_FALSE(w.is_valid());
+
+        versiontheca::version_range_generator p(v, 0, versiontheca::step_direction_t::STEP_DIRECTION_PREVIOUS);
+        CATCH_REQUIRE(p.step());
+        CATCH_REQUIRE(p.get_version() == "0.1");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_version_generator: invalid parameters")
+    {
+        versiontheca::versiontheca const invalid(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC), "1.a");
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_range_generator(invalid, 0)
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the start version of a generator must be valid."));
+
+        versiontheca::versiontheca const v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_BASIC), "1.0");
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_range_generator(v, -1)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the position of a generator must be between 0 and 24."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_range_generator(v, versiontheca::MAX_PARTS)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the position of a generator must be between 0 and 24."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
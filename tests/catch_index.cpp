@@ -0,0 +1,256 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/index.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/exception.h"
+
+
+// C++
+//
+#include    <fstream>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+std::vector<std::string> const g_versions =
+{
+    "2.0",
+    "1.0",
+    "1:0.5",
+    "1.0~rc1",
+    "bad version",
+    "1.2",
+    "1.0.0",
+    "3.0-1",
+    "1.10",
+    "2.0-0",
+};
+
+
+versiontheca::batch make_batch()
+{
+    return versiontheca::parse_many(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, g_versions);
+}
+
+
+void verify_sorted(versiontheca::version_index const & index)
+{
+    CATCH_REQUIRE(index.get_kind() == versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+    CATCH_REQUIRE(index.size() == g_versions.size() - 1);
+
+    // "1.0" and "1.0.0" as well as "2.0" and "2.0-0" are equal and keep
+    // their input order; the index holds the canonicalized versions
+    //
+    char const * expected[] =
+    {
+        "1.0~rc1",
+        "1.0",
+        "1.0",
+        "1.2",
+        "1.10",
+        "2.0",
+        "2.0-0",
+        "3.0-1",
+        "1:0.5",
+    };
+    std::size_t const sources[] = { 3, 1, 6, 5, 8, 0, 9, 7, 2 };
+    for(std::size_t idx(0); idx < std::size(expected); ++idx)
+    {
+        CATCH_REQUIRE(index.get_version(idx) == expected[idx]);
+        CATCH_REQUIRE(index.get_source(idx) == sources[idx]);
+        if(idx > 0)
+        {
+            CATCH_REQUIRE(index.get_key(idx - 1) <= index.get_key(idx));
+        }
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("index_queries", "[index][valid]")
+{
+    CATCH_START_SECTION("index_queries: build from a batch")
+    {
+        versiontheca::version_index const index(make_batch());
+        verify_sorted(index);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("index_queries: bounds")
+    {
+        versiontheca::version_index const index(make_batch());
+        CATCH_REQUIRE(index.lower_bound("0.1") == 0);
+        CATCH_REQUIRE(index.lower_bound("1.0") == 1);
+        CATCH_REQUIRE(index.upper_bound("1.0") == 3);
+        CATCH_REQUIRE(index.lower_bound("1.5") == 4);
+        CATCH_REQUIRE(index.lower_bound("9:0") == index.size());
+
+        versiontheca::version_index::span_t const equal(index.equal_range("2.0"));
+        CATCH_REQUIRE(equal.first == 5);
+        CATCH_REQUIRE(equal.second == 7);
+
+        versiontheca::version_index::span_t const none(index.equal_range("1.1"));
+        CATCH_REQUIRE(none.first == none.second);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("index_queries: ranges")
+    {
+        versiontheca::version_index const index(make_batch());
+
+        versiontheca::version_range const r(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= 1.0, << 2.0 | >> 3.0");
+        versiontheca::version_index::span_vector_t const spans(index.find(r));
+        CATCH_REQUIRE(spans.size() == 2);
+        CATCH_REQUIRE(spans[0] == versiontheca::version_index::span_t(1, 5));
+        CATCH_REQUIRE(spans[1] == versiontheca::version_index::span_t(7, 9));
+
+        CATCH_REQUIRE(index.newest(r) == 8);
+        CATCH_REQUIRE(index.newest(versiontheca::version_constraint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 2.0")) == 4);
+        CATCH_REQUIRE(index.newest(versiontheca::version_constraint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 1.0~rc1")) == versiontheca::version_index::npos);
+        CATCH_REQUIRE(index.find(versiontheca::version_range(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN)).empty());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("index_queries: empty index")
+    {
+        versiontheca::version_index const index(versiontheca::batch(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN));
+        CATCH_REQUIRE(index.empty());
+        CATCH_REQUIRE(index.lower_bound("1.0") == 0);
+        CATCH_REQUIRE(index.newest(versiontheca::version_range::all(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN)) == versiontheca::version_index::npos);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("index_file", "[index][valid]")
+{
+    CATCH_START_SECTION("index_file: save and load")
+    {
+        std::string const filename(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/versions.idx");
+        versiontheca::version_index(make_batch()).save(filename);
+        versiontheca::version_index const index(versiontheca::version_index::load(filename));
+        verify_sorted(index);
+        CATCH_REQUIRE(index.newest(versiontheca::version_constraint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 2.0")) == 4);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("index_errors", "[index][invalid]")
+{
+    CATCH_START_SECTION("index_errors: invalid queries")
+    {
+        versiontheca::version_index const index(make_batch());
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  index.get_version(index.size())
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: index 9 is out of range for a version index of 9 versions."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  index.lower_bound("a1.0")
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: version \"a1.0\" is not valid: a Debian version must always start with a number \"a1.0\"."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  index.find(versiontheca::version_range::all(versiontheca::trait_kind_t::TRAIT_KIND_RPM))
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the version range and index are not of the same kind."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("index_errors: invalid files")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_index::load("/this/file/does/not/exist.idx")
+                , versiontheca::io_error
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: could not open index file \"/this/file/does/not/exist.idx\"."));
+
+        std::string const filename(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/not-an-index.idx");
+        {
+            std::ofstream out(filename);
+            out << "this is just a text file and not a version index at all, even"
+                   " though it is larger than the header of a version index\n";
+        }
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_index::load(filename)
+                , versiontheca::invalid_index
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: this is not a version index or it was created on a computer with a different byte order."));
+
+        {
+            std::ofstream out(filename);
+            out << "short";
+        }
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_index::load(filename)
+                , versiontheca::invalid_index
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: index file \"" + filename + "\" is too small."));
+
+        // a truncated index
+        //
+        std::string const full(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/versions.idx");
+        versiontheca::version_index(make_batch()).save(full);
+        std::string data;
+        {
+            std::ifstream in(full, std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream out(filename, std::ios::binary);
+            out.write(data.data(), data.length() - 1);
+        }
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_index::load(filename)
+                , versiontheca::invalid_index
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the version index is corrupted (invalid header)."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
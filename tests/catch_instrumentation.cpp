@@ -0,0 +1,180 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// tested file
+//
+#include    "versiontheca/instrumentation.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/debian.h"
+#include    "versiontheca/rpm.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// C++
+//
+#include    <numeric>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+std::size_t     g_trace_parses = 0;
+std::size_t     g_trace_failures = 0;
+std::size_t     g_trace_compares = 0;
+
+
+void trace(versiontheca::trace_event_t const & event)
+{
+    switch(event.f_operation)
+    {
+    case versiontheca::trace_operation_t::TRACE_OPERATION_PARSE:
+        ++g_trace_parses;
+        if(!event.f_success)
+        {
+            ++g_trace_failures;
+        }
+        break;
+
+    case versiontheca::trace_operation_t::TRACE_OPERATION_COMPARE:
+        ++g_trace_compares;
+        break;
+
+    }
+}
+
+
+std::size_t slot(versiontheca::trait_kind_t kind)
+{
+    return static_cast<std::size_t>(kind);
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("instrumentation_slots", "[instrumentation][valid]")
+{
+    CATCH_START_SECTION("instrumentation_slots: name of each slot")
+    {
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(slot(versiontheca::trait_kind_t::TRAIT_KIND_BASIC))) == "basic");
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(slot(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN))) == "debian");
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(slot(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL))) == "decimal");
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(slot(versiontheca::trait_kind_t::TRAIT_KIND_ROMAN))) == "roman");
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(slot(versiontheca::trait_kind_t::TRAIT_KIND_RPM))) == "rpm");
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(slot(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE))) == "unicode");
+        CATCH_REQUIRE(std::string(versiontheca::get_statistics_slot_name(versiontheca::STATISTICS_SLOT_OTHER)) == "other");
+        CATCH_REQUIRE(versiontheca::get_statistics_slot_name(versiontheca::STATISTICS_SLOT_COUNT) == nullptr);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("instrumentation_counters", "[instrumentation][valid]")
+{
+    CATCH_START_SECTION("instrumentation_counters: parse, compare, next and errors")
+    {
+        versiontheca::reset_statistics();
+        versiontheca::set_timing(true);
+        g_trace_parses = 0;
+        g_trace_failures = 0;
+        g_trace_compares = 0;
+        versiontheca::set_trace_callback(trace);
+
+        versiontheca::versiontheca a(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.2.3-1");
+        versiontheca::versiontheca const b(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.2.4-1");
+        versiontheca::versiontheca const bad(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "-1");
+        CATCH_REQUIRE(a.is_valid());
+        CATCH_REQUIRE(!bad.is_valid());
+        CATCH_REQUIRE(a.compare(b) == -1);
+        CATCH_REQUIRE(a.next(2));
+        CATCH_REQUIRE(a.compare(b) == 0);
+        CATCH_REQUIRE(a.previous(2));
+
+        versiontheca::versiontheca const r(std::make_shared<versiontheca::rpm>(), "1.0");
+        CATCH_REQUIRE(r.is_valid());
+
+        versiontheca::set_trace_callback(nullptr);
+        versiontheca::set_timing(false);
+
+        versiontheca::statistics_t const statistics(versiontheca::get_statistics());
+        versiontheca::trait_statistics_t const & d(statistics.f_traits[slot(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN)]);
+        versiontheca::trait_statistics_t const & p(statistics.f_traits[slot(versiontheca::trait_kind_t::TRAIT_KIND_RPM)]);
+        if(versiontheca::is_instrumentation_enabled())
+        {
+            CATCH_REQUIRE(versiontheca::get_timing() == false);
+
+            CATCH_REQUIRE(d.f_parses == 3);
+            CATCH_REQUIRE(d.f_parse_failures == 1);
+            CATCH_REQUIRE(d.f_parts == 8);
+            CATCH_REQUIRE(d.f_compares == 2);
+            CATCH_REQUIRE(d.f_nexts == 1);
+            CATCH_REQUIRE(d.f_previouses == 1);
+            CATCH_REQUIRE(d.f_allocations == 3);
+            CATCH_REQUIRE(std::accumulate(d.f_errors.begin(), d.f_errors.end(), std::uint64_t()) >= 1);
+            CATCH_REQUIRE(std::accumulate(d.f_parse_times.begin(), d.f_parse_times.end(), std::uint64_t()) == 3);
+            CATCH_REQUIRE(std::accumulate(d.f_compare_times.begin(), d.f_compare_times.end(), std::uint64_t()) == 2);
+
+            // the rpm trait was not allocated by the library
+            //
+            CATCH_REQUIRE(p.f_parses == 1);
+            CATCH_REQUIRE(p.f_parse_failures == 0);
+            CATCH_REQUIRE(p.f_allocations == 0);
+
+            CATCH_REQUIRE(g_trace_parses == 4);
+            CATCH_REQUIRE(g_trace_failures == 1);
+            CATCH_REQUIRE(g_trace_compares == 2);
+        }
+        else
+        {
+            CATCH_REQUIRE(versiontheca::get_timing() == false);
+            CATCH_REQUIRE(d.f_parses == 0);
+            CATCH_REQUIRE(d.f_compares == 0);
+            CATCH_REQUIRE(p.f_parses == 0);
+            CATCH_REQUIRE(g_trace_parses == 0);
+            CATCH_REQUIRE(g_trace_compares == 0);
+        }
+
+        versiontheca::reset_statistics();
+        versiontheca::statistics_t const cleared(versiontheca::get_statistics());
+        CATCH_REQUIRE(cleared.f_traits[slot(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN)].f_parses == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
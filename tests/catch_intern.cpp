@@ -0,0 +1,211 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/intern.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/exception.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// C++
+//
+#include    <thread>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+CATCH_TEST_CASE("intern_versions", "[intern][valid]")
+{
+    CATCH_START_SECTION("intern_versions: same string, same entry")
+    {
+        versiontheca::intern_pool pool(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        CATCH_REQUIRE(pool.get_kind() == versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        CATCH_REQUIRE(pool.size() == 0);
+        CATCH_REQUIRE(pool.get_compare_cache_size() == versiontheca::intern_pool::DEFAULT_COMPARE_CACHE_SIZE);
+
+        versiontheca::interned_version const a(pool.intern("1:2.3-rc1"));
+        versiontheca::interned_version const b(pool.intern(std::string("1:2.3-rc1")));
+        versiontheca::interned_version const c(pool.intern("1:2.3"));
+        CATCH_REQUIRE(pool.size() == 2);
+        CATCH_REQUIRE(a.is_valid());
+        CATCH_REQUIRE(a.get_id() == 1);
+        CATCH_REQUIRE(b.get_id() == 1);
+        CATCH_REQUIRE(c.get_id() == 2);
+        CATCH_REQUIRE(&a.get_trait() == &b.get_trait());
+        CATCH_REQUIRE(a.get_pool() == &pool);
+        CATCH_REQUIRE(a.get_version() == "1:2.3-rc1");
+        CATCH_REQUIRE(a.get_last_error().empty());
+
+        // same entry: no trait call, no cache access
+        //
+        CATCH_REQUIRE(a == b);
+        CATCH_REQUIRE(pool.get_compare_cache_hits() == 0);
+        CATCH_REQUIRE(pool.get_compare_cache_misses() == 0);
+
+        CATCH_REQUIRE(a > c);
+        CATCH_REQUIRE(pool.get_compare_cache_misses() == 1);
+        CATCH_REQUIRE(c < a);
+        CATCH_REQUIRE(c <= b);
+        CATCH_REQUIRE(a >= c);
+        CATCH_REQUIRE(a != c);
+        CATCH_REQUIRE(pool.get_compare_cache_hits() == 4);
+        CATCH_REQUIRE(pool.get_compare_cache_misses() == 1);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("intern_versions: cached results match the trait")
+    {
+        char const * versions[] =
+        {
+            "1.0",
+            "1.0~rc1",
+            "1.0+b1",
+            "1.0-1",
+            "1:0.9",
+            "2.0a",
+            "2.0",
+            "0.1~~",
+        };
+        versiontheca::intern_pool pool(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, 5);
+        CATCH_REQUIRE(pool.get_compare_cache_size() == 8);
+        for(int repeat(0); repeat < 3; ++repeat)
+        {
+            for(auto const l : versions)
+            {
+                versiontheca::versiontheca lv(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), l);
+                for(auto const r : versions)
+                {
+                    versiontheca::versiontheca rv(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), r);
+                    CATCH_REQUIRE(pool.intern(l).compare(pool.intern(r)) == lv.compare(rv));
+                }
+            }
+        }
+        CATCH_REQUIRE(pool.size() == std::size(versions));
+        CATCH_REQUIRE(pool.get_compare_cache_hits() > 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("intern_versions: no compare cache and multiple pools")
+    {
+        versiontheca::intern_pool p1(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, 0);
+        versiontheca::intern_pool p2(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, 0);
+        CATCH_REQUIRE(p1.get_compare_cache_size() == 0);
+
+        versiontheca::interned_version const a(p1.intern("1.2"));
+        versiontheca::interned_version const b(p1.intern("1.3"));
+        versiontheca::interned_version const c(p2.intern("1.2.0"));
+        CATCH_REQUIRE(a < b);
+        CATCH_REQUIRE(a == c);
+        CATCH_REQUIRE(c < b);
+        CATCH_REQUIRE(p1.get_compare_cache_hits() == 0);
+        CATCH_REQUIRE(p1.get_compare_cache_misses() == 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("intern_versions: concurrent use")
+    {
+        versiontheca::intern_pool pool(versiontheca::trait_kind_t::TRAIT_KIND_RPM, 64);
+        std::vector<std::thread> threads;
+        std::atomic<int> failures(0);
+        for(int t(0); t < 4; ++t)
+        {
+            threads.emplace_back([&pool, &failures]()
+                {
+                    for(int i(0); i < 2'000; ++i)
+                    {
+                        versiontheca::interned_version const l(pool.intern("1." + std::to_string(i % 50)));
+                        versiontheca::interned_version const r(pool.intern("1." + std::to_string(i % 37)));
+                        int const expected(i % 50 == i % 37 ? 0 : (i % 50 < i % 37 ? -1 : 1));
+                        if(l.compare(r) != expected)
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+        }
+        for(auto & t : threads)
+        {
+            t.join();
+        }
+        CATCH_REQUIRE(failures == 0);
+        CATCH_REQUIRE(pool.size() == 50);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_intern_versions", "[intern][invalid]")
+{
+    CATCH_START_SECTION("invalid_intern_versions: invalid versions are interned")
+    {
+        versiontheca::intern_pool pool(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        versiontheca::interned_version const a(pool.intern("a1.0"));
+        versiontheca::interned_version const b(pool.intern("1.0"));
+        CATCH_REQUIRE_FALSE(a.is_valid());
+        CATCH_REQUIRE(a.get_id() == 1);
+        CATCH_REQUIRE_FALSE(a.get_last_error().empty());
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  a.compare(b)
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: one or both of the input versions are not valid."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_intern_versions: default handle")
+    {
+        versiontheca::interned_version const v;
+        CATCH_REQUIRE_FALSE(v.is_valid());
+        CATCH_REQUIRE(v.get_id() == 0);
+        CATCH_REQUIRE(v.get_pool() == nullptr);
+        CATCH_REQUIRE(v.get_version().empty());
+        CATCH_REQUIRE(v.get_last_error().empty());
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  v.get_trait()
+                , versiontheca::missing_pointer
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: this interned version is not attached to a pool."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_intern_versions: bad kind")
+    {
+        CATCH_REQUIRE_THROWS_AS(
+                  versiontheca::intern_pool(static_cast<versiontheca::trait_kind_t>(100))
+                , versiontheca::invalid_parameter);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,168 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/literal.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/debian.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+using namespace versiontheca::literals;
+
+
+namespace
+{
+
+
+
+constexpr auto g_minimum = "1.2.3"_vbasic;
+constexpr auto g_debian = "1:2.30~rc1-5"_vdebian;
+
+
+static_assert(g_minimum.is_valid());
+static_assert(g_minimum.size() == 3);
+static_assert(g_minimum.get_parts().get_integer(2) == 3);
+static_assert(g_minimum == "1.2.3.0"_vbasic);
+static_assert(g_minimum < "1.10"_vbasic);
+static_assert(g_minimum > "1.2.2.999"_vbasic);
+
+static_assert(g_debian.get_version() == "1:2.30~rc1-5");
+static_assert(g_debian.get_parts().get_type(0) == ':');
+static_assert(g_debian < "1:2.30-5"_vdebian);
+static_assert(g_debian > "1:2.30~beta-5"_vdebian);
+static_assert(g_debian > "2.31"_vdebian);
+static_assert("1.0a"_vdebian < "1.0b"_vdebian);
+
+static_assert(!versiontheca::static_numeric_version("1.a").is_valid());
+static_assert(!versiontheca::static_debian_version("a1.0").is_valid());
+
+
+// a reference to a constexpr version can be used as a template parameter
+//
+template<versiontheca::static_numeric_version const & Minimum>
+constexpr bool is_supported(versiontheca::static_numeric_version const & v)
+{
+    return v >= Minimum;
+}
+
+static_assert(is_supported<g_minimum>("1.3"_vbasic));
+static_assert(!is_supported<g_minimum>("1.2"_vbasic));
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("literal_versions", "[literal][valid]")
+{
+    CATCH_START_SECTION("literal_versions: same results as the debian trait")
+    {
+        char const * versions[] =
+        {
+            "0",
+            "1.0",
+            "1.0~rc1",
+            "1.0~~",
+            "1.0+b1",
+            "1.0a",
+            "1.0-1",
+            "1.0-1~bpo1",
+            "1:0.9",
+            "2:0.1-3",
+            "1.0.0",
+        };
+        for(auto const l : versions)
+        {
+            versiontheca::static_debian_version const sl(l);
+            CATCH_REQUIRE(sl.is_valid());
+            versiontheca::debian_version const dl(l);
+            versiontheca::trait::pointer_t tl(std::make_shared<versiontheca::debian>());
+            versiontheca::versiontheca vl(tl, l);
+            for(auto const r : versions)
+            {
+                versiontheca::static_debian_version const sr(r);
+                versiontheca::debian_version const dr(r);
+                versiontheca::trait::pointer_t tr(std::make_shared<versiontheca::debian>());
+                versiontheca::versiontheca vr(tr, r);
+                int const expected(vl.compare(vr));
+                CATCH_REQUIRE(sl.compare(sr) == expected);
+                CATCH_REQUIRE(sl.compare(dr) == expected);
+                CATCH_REQUIRE((dl < sr) == (expected < 0));
+                CATCH_REQUIRE((dl == sr) == (expected == 0));
+                CATCH_REQUIRE((dl >= sr) == (expected >= 0));
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("literal_versions: runtime use")
+    {
+        versiontheca::numeric_version const peer("1.2.10");
+        CATCH_REQUIRE(peer > g_minimum);
+        CATCH_REQUIRE(peer != g_minimum);
+        CATCH_REQUIRE_FALSE(peer <= g_minimum);
+        CATCH_REQUIRE(g_minimum.compare(peer) < 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_literal_versions", "[literal][invalid]")
+{
+    CATCH_START_SECTION("invalid_literal_versions: runtime errors")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  operator ""_vbasic("1..2", 4)
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: invalid basic version literal: a version value cannot be an empty string."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  operator ""_vdebian("1.0-r_c", 7)
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: invalid Debian version literal: found unexpected character in input."));
+
+        std::string const too_long(versiontheca::MAX_LITERAL_LENGTH + 1, '1');
+        versiontheca::static_numeric_version const v(too_long);
+        CATCH_REQUIRE_FALSE(v.is_valid());
+        CATCH_REQUIRE(std::string(v.get_last_error()) == "version string is too long.");
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -78,7 +78,7 @@ CATCH_TEST_CASE("part_integer", "[part][integer][valid]")
         //CATCH_REQUIRE(p.get_string()); -- would throw
         CATCH_REQUIRE(p.get_integer() == 0);
         CATCH_REQUIRE(p.to_string() == "0");
-        CATCH_REQUIRE(p.get_last_error().empty());
+        CATCH_REQUIRE(p.take_last_error().empty());
         CATCH_REQUIRE(p.is_zero());
 
         CATCH_REQUIRE(p.next());
@@ -99,7 +99,7 @@ CATCH_TEST_CASE("part_integer", "[part][integer][valid]")
         //CATCH_REQUIRE(p.get_string()); -- would throw
         CATCH_REQUIRE(p.get_integer() == 0);
         CATCH_REQUIRE(p.to_string() == "0");
-        CATCH_REQUIRE(p.get_last_error().empty());
+        CATCH_REQUIRE(p.take_last_error().empty());
         CATCH_REQUIRE(p.is_zero());
     }
     CATCH_END_SECTION()
@@ -123,7 +123,7 @@ CATCH_TEST_CASE("part_integer", "[part][integer][valid]")
             std::stringstream ss;
             ss << value;
             CATCH_REQUIRE(p.to_string() == ss.str());
-            CATCH_REQUIRE(p.get_last_error().empty());
+            CATCH_REQUIRE(p.take_last_error().empty());
             if(value == 0)
             {
                 CATCH_REQUIRE(p.is_zero());
@@ -155,7 +155,7 @@ CATCH_TEST_CASE("part_integer", "[part][integer][valid]")
             //CATCH_REQUIRE(p.get_string() == value); -- would throw
             CATCH_REQUIRE(p.get_integer() == value);
             CATCH_REQUIRE(p.to_string() == ss.str());
-            CATCH_REQUIRE(p.get_last_error().empty());
+            CATCH_REQUIRE(p.take_last_error().empty());
             if(value == 0)
             {
                 CATCH_REQUIRE(p.is_zero());
@@ -215,7 +215,7 @@ CATCH_TEST_CASE("part_string", "[part][integer][valid]")
             CATCH_REQUIRE(p.get_string() == ss.str());
             //CATCH_REQUIRE(p.get_integer() == value); -- would throw
             CATCH_REQUIRE(p.to_string() == ss.str());
-            CATCH_REQUIRE(p.get_last_error().empty());
+            CATCH_REQUIRE(p.take_last_error().empty());
             CATCH_REQUIRE_FALSE(p.is_zero());
         }
     }
@@ -238,7 +238,7 @@ CATCH_TEST_CASE("part_string", "[part][integer][valid]")
             CATCH_REQUIRE(p.get_string() == value);
             //CATCH_REQUIRE(p.get_integer() == value); -- would throw
             CATCH_REQUIRE(p.to_string() == value);
-            CATCH_REQUIRE(p.get_last_error().empty());
+            CATCH_REQUIRE(p.take_last_error().empty());
             CATCH_REQUIRE_FALSE(p.is_zero());
         }
     }
@@ -265,7 +265,7 @@ CATCH_TEST_CASE("part_string", "[part][integer][valid]")
             CATCH_REQUIRE(p.get_string() == value);
             //CATCH_REQUIRE(p.get_integer() == value); -- would throw
             CATCH_REQUIRE(p.to_string() == value);
-            CATCH_REQUIRE(p.get_last_error().empty());
+            CATCH_REQUIRE(p.take_last_error().empty());
             CATCH_REQUIRE_FALSE(p.is_zero());
         }
     }
@@ -407,6 +407,27 @@ CATCH_TEST_CASE("part_string", "[part][integer][valid]")
     }
     CATCH_END_SECTION()
 
+    CATCH_START_SECTION("part_string: next and previous leave the string unchanged on failure")
+    {
+        versiontheca::part p;
+        p.set_string("z+zz");
+        CATCH_REQUIRE_FALSE(p.next());
+        CATCH_REQUIRE(p.get_string() == "z+zz");
+        p.set_string("+~");
+        CATCH_REQUIRE_FALSE(p.next());
+        CATCH_REQUIRE_FALSE(p.previous());
+        CATCH_REQUIRE(p.get_string() == "+~");
+        p.set_string("AA+A");
+        CATCH_REQUIRE_FALSE(p.previous());
+        CATCH_REQUIRE(p.get_string() == "AA+A");
+        p.set_string("Az+z");
+        CATCH_REQUIRE(p.next());
+        CATCH_REQUIRE(p.get_string() == "BA+A");
+        CATCH_REQUIRE(p.previous());
+        CATCH_REQUIRE(p.get_string() == "Az+z");
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("part_string: previous on two letters up to min.")
     {
         char buf[3] = { 'z', 'z', '\0' };
@@ -572,6 +593,53 @@ CATCH_TEST_CASE("part_compare", "[part][compare][valid]")
         CATCH_REQUIRE(b.compare(a) == 1);
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("part_compare: mix gives the same result as comparing strings")
+    {
+        char const * strings[] =
+        {
+            "",
+            "0",
+            "1",
+            "10",
+            "123",
+            "1234",
+            "123a",
+            "4294967295",
+            "4294967296",
+            "9",
+            "a",
+            "A",
+            "~",
+            "+",
+            "\xC3\xA9",
+        };
+        versiontheca::part_integer_t const integers[] =
+        {
+            0,
+            1,
+            9,
+            10,
+            123,
+            1234,
+            4294967295,
+        };
+        for(auto const str : strings)
+        {
+            versiontheca::part a;
+            a.set_string(str);
+            for(auto const i : integers)
+            {
+                versiontheca::part b;
+                b.set_integer(i);
+                int const r(std::to_string(i).compare(str));
+                int const expected(r == 0 ? 0 : (r < 0 ? -1 : 1));
+                CATCH_REQUIRE(b.compare(a) == expected);
+                CATCH_REQUIRE(a.compare(b) == -expected);
+            }
+        }
+    }
+    CATCH_END_SECTION()
 }
 
 
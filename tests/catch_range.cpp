@@ -0,0 +1,419 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/range.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/exception.h"
+#include    "versiontheca/versiontheca.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+std::vector<std::string_view> const g_debian_versions =
+{
+    "0.9",
+    "1.0~rc1",
+    "1.0",
+    "1.0-1",
+    "1.0-1ubuntu1",
+    "1.2~rc1",
+    "1.2",
+    "1.2.1",
+    "2.0~~a",
+    "2.0",
+    "2.10",
+    "1:0.1",
+    "1:1.0",
+    "2:3.0-1",
+    "2:3.0-2",
+};
+
+
+// pairs of these versions have keys which disagree with compare()
+//
+std::vector<std::string_view> const g_unicode_versions =
+{
+    "1",
+    "1.0",
+    "1.1",
+    "1.A",
+    "1A",
+    "1AA",
+    "1A0",
+    "1.1Z",
+    "1.0~",
+    "1A.1~",
+    "2",
+};
+
+
+std::vector<std::string_view> const g_rpm_versions =
+{
+    "1",
+    "1.0",
+    "1.a",
+    "1.0~",
+    "1^A~",
+    "1._+1",
+    "1_0",
+    "1a~",
+    "2",
+};
+
+
+int kind_compare(versiontheca::trait_kind_t kind, std::string_view const & lhs, std::string_view const & rhs)
+{
+    versiontheca::versiontheca l(versiontheca::create_trait(kind), lhs);
+    versiontheca::versiontheca r(versiontheca::create_trait(kind), rhs);
+    return l.compare(r);
+}
+
+
+int debian_compare(std::string_view const & lhs, std::string_view const & rhs)
+{
+    return kind_compare(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, lhs, rhs);
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("range_operators", "[range][valid]")
+{
+    CATCH_START_SECTION("range_operators: all the operator strings")
+    {
+        CATCH_REQUIRE(versiontheca::get_operator("==") == versiontheca::operator_t::OPERATOR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("=") == versiontheca::operator_t::OPERATOR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("eq") == versiontheca::operator_t::OPERATOR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("!=") == versiontheca::operator_t::OPERATOR_NOT_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("<>") == versiontheca::operator_t::OPERATOR_NOT_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("ne") == versiontheca::operator_t::OPERATOR_NOT_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("<") == versiontheca::operator_t::OPERATOR_LESS);
+        CATCH_REQUIRE(versiontheca::get_operator("<<") == versiontheca::operator_t::OPERATOR_LESS);
+        CATCH_REQUIRE(versiontheca::get_operator("lt") == versiontheca::operator_t::OPERATOR_LESS);
+        CATCH_REQUIRE(versiontheca::get_operator("<=") == versiontheca::operator_t::OPERATOR_LESS_OR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("le") == versiontheca::operator_t::OPERATOR_LESS_OR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator(">") == versiontheca::operator_t::OPERATOR_GREATER);
+        CATCH_REQUIRE(versiontheca::get_operator(">>") == versiontheca::operator_t::OPERATOR_GREATER);
+        CATCH_REQUIRE(versiontheca::get_operator("gt") == versiontheca::operator_t::OPERATOR_GREATER);
+        CATCH_REQUIRE(versiontheca::get_operator(">=") == versiontheca::operator_t::OPERATOR_GREATER_OR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("ge") == versiontheca::operator_t::OPERATOR_GREATER_OR_EQUAL);
+        CATCH_REQUIRE(versiontheca::get_operator("=<") == versiontheca::operator_t::OPERATOR_UNKNOWN);
+        CATCH_REQUIRE(versiontheca::get_operator("") == versiontheca::operator_t::OPERATOR_UNKNOWN);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("range_constraint", "[range][valid]")
+{
+    CATCH_START_SECTION("range_constraint: parse constraints")
+    {
+        versiontheca::version_constraint c1(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= 1.2~rc1");
+        CATCH_REQUIRE(c1.get_operator() == versiontheca::operator_t::OPERATOR_GREATER_OR_EQUAL);
+        CATCH_REQUIRE(c1.get_version() == "1.2~rc1");
+        CATCH_REQUIRE(c1.to_string() == ">= 1.2~rc1");
+
+        versiontheca::version_constraint c2(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "(<< 2:3.0-1)");
+        CATCH_REQUIRE(c2.get_operator() == versiontheca::operator_t::OPERATOR_LESS);
+        CATCH_REQUIRE(c2.get_version() == "2:3.0-1");
+
+        versiontheca::version_constraint c3(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "  1.0  ");
+        CATCH_REQUIRE(c3.get_operator() == versiontheca::operator_t::OPERATOR_EQUAL);
+        CATCH_REQUIRE(c3.get_version() == "1.0");
+
+        versiontheca::version_constraint c4(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, "ge 1.5");
+        CATCH_REQUIRE(c4.get_operator() == versiontheca::operator_t::OPERATOR_GREATER_OR_EQUAL);
+        CATCH_REQUIRE(c4.get_version() == "1.5");
+
+        versiontheca::version_constraint c5(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, ">=1.5");
+        CATCH_REQUIRE(c5.get_operator() == versiontheca::operator_t::OPERATOR_GREATER_OR_EQUAL);
+        CATCH_REQUIRE(c5.get_version() == "1.5");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_constraint: matches agree with compare()")
+    {
+        char const * operators[] = { "==", "!=", "<<", "<=", ">>", ">=" };
+        for(auto const op : operators)
+        {
+            for(auto const & bound : g_debian_versions)
+            {
+                versiontheca::version_constraint const c(
+                          versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                        , std::string(op) + " " + std::string(bound));
+                versiontheca::index_vector_t const matches(c.filter(g_debian_versions));
+                std::size_t pos(0);
+                for(std::size_t idx(0); idx < g_debian_versions.size(); ++idx)
+                {
+                    bool const expected(versiontheca::apply_operator(
+                              c.get_operator()
+                            , debian_compare(g_debian_versions[idx], bound)));
+                    CATCH_REQUIRE(c.matches(g_debian_versions[idx]) == expected);
+                    bool const found(pos < matches.size() && matches[pos] == idx);
+                    CATCH_REQUIRE(found == expected);
+                    if(found)
+                    {
+                        ++pos;
+                    }
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_constraint: fall back to compare() when the keys disagree")
+    {
+        versiontheca::version_constraint const c(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, ">= 1.1");
+        CATCH_REQUIRE(c.matches("1.A"));
+        CATCH_REQUIRE_FALSE(c.matches_key(versiontheca::versiontheca(
+                      versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE)
+                    , "1.A").sort_key()));
+        CATCH_REQUIRE(versiontheca::version_range(c).contains("1.A"));
+
+        struct kind_versions_t
+        {
+            versiontheca::trait_kind_t              f_kind;
+            std::vector<std::string_view> const &   f_versions;
+        };
+        kind_versions_t const kinds[] =
+        {
+            { versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, g_unicode_versions },
+            { versiontheca::trait_kind_t::TRAIT_KIND_RPM, g_rpm_versions },
+        };
+        char const * operators[] = { "==", "!=", "<<", "<=", ">>", ">=" };
+        for(auto const & k : kinds)
+        {
+            CATCH_REQUIRE_FALSE(versiontheca::sort_key_matches_compare(k.f_kind));
+            for(auto const op : operators)
+            {
+                for(auto const & bound : k.f_versions)
+                {
+                    versiontheca::version_constraint const constraint(
+                              k.f_kind
+                            , std::string(op) + " " + std::string(bound));
+                    versiontheca::version_range const range(constraint);
+                    versiontheca::index_vector_t const matches(constraint.filter(k.f_versions));
+                    versiontheca::index_vector_t const contained(range.filter(k.f_versions));
+                    std::size_t mpos(0);
+                    std::size_t cpos(0);
+                    for(std::size_t idx(0); idx < k.f_versions.size(); ++idx)
+                    {
+                        CATCH_INFO("\"" << k.f_versions[idx] << "\" " << op << " \"" << bound << "\"");
+                        bool const expected(versiontheca::apply_operator(
+                                  constraint.get_operator()
+                                , kind_compare(k.f_kind, k.f_versions[idx], bound)));
+                        CATCH_REQUIRE(constraint.matches(k.f_versions[idx]) == expected);
+                        CATCH_REQUIRE(range.contains(k.f_versions[idx]) == expected);
+                        bool const found(mpos < matches.size() && matches[mpos] == idx);
+                        CATCH_REQUIRE(found == expected);
+                        if(found)
+                        {
+                            ++mpos;
+                        }
+                        bool const in(cpos < contained.size() && contained[cpos] == idx);
+                        CATCH_REQUIRE(in == expected);
+                        if(in)
+                        {
+                            ++cpos;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_constraint: invalid candidates never match")
+    {
+        versiontheca::version_constraint c(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "!= 1.0");
+        CATCH_REQUIRE_FALSE(c.matches("a1.0"));
+        CATCH_REQUIRE_FALSE(c.matches(""));
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("range_intervals", "[range][valid]")
+{
+    CATCH_START_SECTION("range_intervals: empty and all")
+    {
+        versiontheca::version_range const none(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN);
+        CATCH_REQUIRE(none.is_empty());
+        CATCH_REQUIRE_FALSE(none.is_all());
+        CATCH_REQUIRE_FALSE(none.contains("1.0"));
+
+        versiontheca::version_range const all(versiontheca::version_range::all(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN));
+        CATCH_REQUIRE_FALSE(all.is_empty());
+        CATCH_REQUIRE(all.is_all());
+        CATCH_REQUIRE(all.contains("1.0"));
+        CATCH_REQUIRE(all.filter(g_debian_versions).size() == g_debian_versions.size());
+
+        CATCH_REQUIRE((all & none).is_empty());
+        CATCH_REQUIRE((all | none).is_all());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_intervals: intersection")
+    {
+        versiontheca::version_range const r(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= 1.0, << 2.0");
+        CATCH_REQUIRE(r.get_intervals().size() == 1);
+        CATCH_REQUIRE_FALSE(r.contains("1.0~rc1"));
+        CATCH_REQUIRE(r.contains("1.0"));
+        CATCH_REQUIRE(r.contains("1.2.1"));
+        CATCH_REQUIRE(r.contains("2.0~~a"));
+        CATCH_REQUIRE_FALSE(r.contains("2.0"));
+        CATCH_REQUIRE_FALSE(r.contains("1:0.1"));
+
+        versiontheca::version_range const disjoint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 1.0, >> 2.0");
+        CATCH_REQUIRE(disjoint.is_empty());
+
+        versiontheca::version_range const one(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<= 1.0, >= 1.0");
+        CATCH_REQUIRE(one.get_intervals().size() == 1);
+        CATCH_REQUIRE(one.contains("1.0"));
+        CATCH_REQUIRE(one.contains("1.0-0"));
+        CATCH_REQUIRE_FALSE(one.contains("1.0-1"));
+
+        versiontheca::version_range const open(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 1.0, >= 1.0");
+        CATCH_REQUIRE(open.is_empty());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_intervals: union")
+    {
+        versiontheca::version_range const r(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= 1.0, << 1.2 | >= 2.0");
+        CATCH_REQUIRE(r.get_intervals().size() == 2);
+        CATCH_REQUIRE_FALSE(r.contains("0.9"));
+        CATCH_REQUIRE(r.contains("1.0-1"));
+        CATCH_REQUIRE_FALSE(r.contains("1.2"));
+        CATCH_REQUIRE(r.contains("2.0"));
+        CATCH_REQUIRE(r.contains("1:0.1"));
+
+        // touching intervals get merged
+        //
+        versiontheca::version_range const merged(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< 1.0 | >= 1.0");
+        CATCH_REQUIRE(merged.is_all());
+
+        // != leaves a hole
+        //
+        versiontheca::version_range const hole(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "!= 1.0");
+        CATCH_REQUIRE(hole.get_intervals().size() == 2);
+        CATCH_REQUIRE_FALSE(hole.contains("1.0"));
+        CATCH_REQUIRE(hole.contains("1.0-1"));
+        CATCH_REQUIRE((hole | versiontheca::version_range(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "1.0")).is_all());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_intervals: combined ranges agree with the constraints")
+    {
+        for(auto const & a : g_debian_versions)
+        {
+            for(auto const & b : g_debian_versions)
+            {
+                versiontheca::version_constraint const lower(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= " + std::string(a));
+                versiontheca::version_constraint const upper(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "<< " + std::string(b));
+                versiontheca::version_range const both(versiontheca::version_range(lower) & versiontheca::version_range(upper));
+                versiontheca::version_range const either(versiontheca::version_range(lower) | versiontheca::version_range(upper));
+                for(auto const & v : g_debian_versions)
+                {
+                    CATCH_REQUIRE(both.contains(v) == (lower.matches(v) && upper.matches(v)));
+                    CATCH_REQUIRE(either.contains(v) == (lower.matches(v) || upper.matches(v)));
+                }
+            }
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("range_errors", "[range][invalid]")
+{
+    CATCH_START_SECTION("range_errors: invalid constraints")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_constraint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, "=> 1.0")
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: unknown operator \"=>\" in constraint \"=> 1.0\"."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_constraint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">=")
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: constraint \">=\" is missing a version."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_constraint(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= a1.0")
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: version \"a1.0\" is not valid: a Debian version must always start with a number \"a1.0\"."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::version_constraint(
+                          versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                        , versiontheca::operator_t::OPERATOR_UNKNOWN
+                        , "1.0")
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: a version constraint cannot use OPERATOR_UNKNOWN."));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("range_errors: mixing kinds")
+    {
+        versiontheca::version_range const a(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, ">= 1.0");
+        versiontheca::version_range const b(versiontheca::trait_kind_t::TRAIT_KIND_RPM, ">= 1.0");
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  a & b
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: version ranges of different kinds cannot be combined."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  a | b
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: version ranges of different kinds cannot be combined."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
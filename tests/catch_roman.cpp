@@ -150,6 +150,58 @@ std::string value_to_roman(int v)
 
 
 
+// the algorithm used before the table lookup, kept to verify that loosely
+// written numerals still give the same value
+//
+versiontheca::part_integer_t reference_from_roman(std::string const & value)
+{
+    std::size_t const max(value.length());
+    std::vector<int> number(max);
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        switch(value[idx] & ~0x20)
+        {
+        case 'I': number[idx] = 1; break;
+        case 'V': number[idx] = 5; break;
+        case 'X': number[idx] = 10; break;
+        case 'L': number[idx] = 50; break;
+        case 'C': number[idx] = 100; break;
+        case 'D': number[idx] = 500; break;
+        case 'M': number[idx] = 1000; break;
+        default: return 0;
+        }
+    }
+    versiontheca::part_integer_t result(number[max - 1]);
+    bool subtract(false);
+    for(ssize_t idx(max - 2); idx >= 0; --idx)
+    {
+        if(number[idx] == number[idx + 1])
+        {
+            if(subtract)
+            {
+                result -= number[idx];
+            }
+            else
+            {
+                result += number[idx];
+            }
+        }
+        else if(number[idx] < number[idx + 1])
+        {
+            result -= number[idx];
+            subtract = true;
+        }
+        else
+        {
+            result += number[idx];
+            subtract = false;
+        }
+    }
+    return result;
+}
+
+
+
 }
 // no name namespace
 
@@ -166,6 +218,46 @@ CATCH_TEST_CASE("roman_numerals", "[roman][valid]")
         }
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("roman_numerals: loosely written numerals")
+    {
+        char const digits[] = "IVXLCDMivxlcdm";
+        for(int count(0); count < 10'000; ++count)
+        {
+            std::string numeral;
+            int const length(rand() % 8 + 1);
+            for(int idx(0); idx < length; ++idx)
+            {
+                numeral += digits[rand() % (sizeof(digits) - 1)];
+            }
+            CATCH_REQUIRE(versiontheca::from_roman_number(numeral) == reference_from_roman(numeral));
+        }
+        CATCH_REQUIRE(versiontheca::from_roman_number("IIX") == 8);
+        CATCH_REQUIRE(versiontheca::from_roman_number("mmmm") == 4000);
+        CATCH_REQUIRE(versiontheca::from_roman_number(std::string_view("XIVZ", 3)) == 14);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("roman_numerals: write numerals in a buffer")
+    {
+        char buf[versiontheca::ROMAN_NUMBER_MAX_LENGTH];
+        std::to_chars_result r(versiontheca::to_roman_chars(buf, buf + sizeof(buf), 3888));
+        CATCH_REQUIRE(r.ec == std::errc());
+        CATCH_REQUIRE(std::string(buf, r.ptr) == "MMMDCCCLXXXVIII");
+
+        r = versiontheca::to_roman_chars(buf, buf + 3, 14);
+        CATCH_REQUIRE(r.ec == std::errc());
+        CATCH_REQUIRE(std::string(buf, r.ptr) == "XIV");
+
+        r = versiontheca::to_roman_chars(buf, buf + 2, 14);
+        CATCH_REQUIRE(r.ec == std::errc::value_too_large);
+        CATCH_REQUIRE(r.ptr == buf + 2);
+
+        std::string result("v");
+        versiontheca::append_roman_number(result, 2023);
+        CATCH_REQUIRE(result == "vMMXXIII");
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -232,10 +324,17 @@ CATCH_TEST_CASE("roman_invalid", "[roman][invalid]")
     {
         versiontheca::roman::pointer_t t(std::make_shared<versiontheca::roman>());
         versiontheca::versiontheca::pointer_t v(std::make_shared<versiontheca::versiontheca>(t, ""));
-        CATCH_REQUIRE(v->get_last_error().empty());
+        CATCH_REQUIRE(v->take_last_error().empty());
         CATCH_REQUIRE(v->get_version().empty());
-        CATCH_REQUIRE(v->get_last_error() == "no parts to output.");
-        CATCH_REQUIRE(v->get_last_error().empty());
+
+        // a const function does not record an error, the failure
+        // is only reported by the return value of append_version()
+        //
+        CATCH_REQUIRE(v->take_last_error().empty());
+        std::string canonical;
+        CATCH_REQUIRE_FALSE(v->append_version(canonical));
+        CATCH_REQUIRE(canonical.empty());
+        CATCH_REQUIRE(v->take_last_error().empty());
     }
     CATCH_END_SECTION()
 
@@ -244,8 +343,8 @@ CATCH_TEST_CASE("roman_invalid", "[roman][invalid]")
         versiontheca::roman::pointer_t t(std::make_shared<versiontheca::roman>());
         versiontheca::versiontheca::pointer_t v(std::make_shared<versiontheca::versiontheca>(t, ""));
         CATCH_REQUIRE_FALSE(v->set_version("1..2"));
-        CATCH_REQUIRE(v->get_last_error() == "a version value cannot be an empty string.");
-        CATCH_REQUIRE(v->get_last_error().empty());
+        CATCH_REQUIRE(v->take_last_error() == "a version value cannot be an empty string.");
+        CATCH_REQUIRE(v->take_last_error().empty());
     }
     CATCH_END_SECTION()
 
@@ -258,6 +357,15 @@ CATCH_TEST_CASE("roman_invalid", "[roman][invalid]")
         }
 
         CATCH_REQUIRE(versiontheca::from_roman_number("") == 0);
+        CATCH_REQUIRE(versiontheca::from_roman_number("XIVZ") == 0);
+        CATCH_REQUIRE(versiontheca::from_roman_number("ZXIV") == 0);
+
+        char buf[versiontheca::ROMAN_NUMBER_MAX_LENGTH];
+        std::to_chars_result r(versiontheca::to_roman_chars(buf, buf + sizeof(buf), 0));
+        CATCH_REQUIRE(r.ec == std::errc::invalid_argument);
+        CATCH_REQUIRE(r.ptr == buf);
+        r = versiontheca::to_roman_chars(buf, buf + sizeof(buf), 4000);
+        CATCH_REQUIRE(r.ec == std::errc::invalid_argument);
     }
     CATCH_END_SECTION()
 }
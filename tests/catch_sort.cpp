@@ -0,0 +1,183 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/sort.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/compare_strings.h"
+#include    "versiontheca/exception.h"
+
+
+// C++
+//
+#include    <algorithm>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+std::vector<std::string> generate_versions(std::size_t count)
+{
+    char const * suffixes[] =
+    {
+        "",
+        "~rc1",
+        "+b1",
+        "-1",
+        "-2",
+        "a",
+    };
+    std::vector<std::string> result;
+    result.reserve(count);
+    for(std::size_t idx(0); idx < count; ++idx)
+    {
+        std::string v;
+        if(rand() % 10 == 0)
+        {
+            v += std::to_string(rand() % 3);
+            v += ':';
+        }
+        v += std::to_string(rand() % 20);
+        v += '.';
+        v += std::to_string(rand() % 50);
+        v += suffixes[rand() % std::size(suffixes)];
+        result.push_back(v);
+    }
+    return result;
+}
+
+
+void verify_sorted(std::vector<std::string> const & sorted, bool unique)
+{
+    for(std::size_t idx(1); idx < sorted.size(); ++idx)
+    {
+        int const r(versiontheca::compare_strings(
+                              versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                            , sorted[idx - 1]
+                            , sorted[idx]));
+        if(unique)
+        {
+            CATCH_REQUIRE(r < 0);
+        }
+        else
+        {
+            CATCH_REQUIRE(r <= 0);
+        }
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("sort_versions", "[sort][valid]")
+{
+    CATCH_START_SECTION("sort_versions: small set")
+    {
+        std::vector<std::string> const versions{ "1.0", "1:0.5", "1.0~rc1", "0.9", "1.0.0", "1.0-1" };
+        std::vector<std::string> const sorted(versiontheca::sort_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions));
+        std::vector<std::string> const expected{ "0.9", "1.0~rc1", "1.0", "1.0.0", "1.0-1", "1:0.5" };
+        CATCH_REQUIRE(sorted == expected);
+
+        std::vector<std::string> const unique(versiontheca::unique_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions));
+        std::vector<std::string> const expected_unique{ "0.9", "1.0~rc1", "1.0", "1.0-1", "1:0.5" };
+        CATCH_REQUIRE(unique == expected_unique);
+
+        CATCH_REQUIRE(versiontheca::max_version(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions) == "1:0.5");
+
+        char const * basic[] = { "1.10", "1.9", "1.9.0", "2" };
+        CATCH_REQUIRE(versiontheca::max_version(versiontheca::trait_kind_t::TRAIT_KIND_BASIC, basic) == "2");
+        CATCH_REQUIRE(versiontheca::sort_version_indexes(
+                      versiontheca::trait_kind_t::TRAIT_KIND_BASIC
+                    , std::vector<std::string_view>(std::begin(basic), std::end(basic))) == versiontheca::index_vector_t{ 1, 2, 0, 3 });
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("sort_versions: large set with threads")
+    {
+        std::vector<std::string> const versions(generate_versions(versiontheca::PARALLEL_SORT_THRESHOLD * 3 + 17));
+
+        for(std::size_t const threads : { 1, 3, 4, 0 })
+        {
+            std::vector<std::string> const sorted(versiontheca::sort_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions, threads));
+            CATCH_REQUIRE(sorted.size() == versions.size());
+            CATCH_REQUIRE(std::is_permutation(sorted.begin(), sorted.end(), versions.begin()));
+            verify_sorted(sorted, false);
+
+            std::vector<std::string> const unique(versiontheca::unique_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions, threads));
+            verify_sorted(unique, true);
+
+            std::string const max(versiontheca::max_version(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions, threads));
+            CATCH_REQUIRE(versiontheca::compare_strings(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, max, sorted.back()) == 0);
+            CATCH_REQUIRE(max == unique.back());
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_sort_versions", "[sort][invalid]")
+{
+    CATCH_START_SECTION("invalid_sort_versions: invalid and empty sets")
+    {
+        std::vector<std::string> versions(generate_versions(versiontheca::PARALLEL_SORT_THRESHOLD * 2));
+        versions[versions.size() - 3] = "a1.0";
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::sort_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions, 4)
+                , versiontheca::invalid_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: version \"a1.0\" is not valid: a Debian version must always start with a number \"a1.0\"."));
+        CATCH_REQUIRE_THROWS_AS(
+                  versiontheca::max_version(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, versions, 4)
+                , versiontheca::invalid_version);
+
+        std::vector<std::string> const empty;
+        CATCH_REQUIRE(versiontheca::sort_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, empty).empty());
+        CATCH_REQUIRE(versiontheca::unique_versions(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, empty).empty());
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  versiontheca::max_version(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN, empty)
+                , versiontheca::empty_version
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: cannot search the largest version of an empty set."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,170 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Run the command line tools on small inputs.
+ *
+ * The tools are started with std::system() and their output is saved
+ * in files of the temporary directory.
+ */
+
+// self
+//
+#include    "catch_main.h"
+
+
+// C++
+//
+#include    <fstream>
+#include    <sstream>
+
+
+// C
+//
+#include    <sys/wait.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+struct run_result_t
+{
+    int                 f_exit_code = -1;
+    std::string         f_output = std::string();
+    std::string         f_errors = std::string();
+};
+
+
+std::string read_file(std::string const & filename)
+{
+    std::ifstream in(filename);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+
+run_result_t run(std::string const & command, std::string const & input)
+{
+    std::string const base(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/tools");
+    {
+        std::ofstream out(base + ".in");
+        out << input;
+    }
+    int const status(std::system((command
+                + " <" + base + ".in"
+                + " >" + base + ".out"
+                + " 2>" + base + ".err").c_str()));
+
+    run_result_t result;
+    if(WIFEXITED(status))
+    {
+        result.f_exit_code = WEXITSTATUS(status);
+    }
+    result.f_output = read_file(base + ".out");
+    result.f_errors = read_file(base + ".err");
+    return result;
+}
+
+
+// a version with more parts than MAX_PARTS makes the library throw
+//
+std::string too_many_parts()
+{
+    std::string result("1");
+    for(int idx(2); idx <= 30; ++idx)
+    {
+        result += '.';
+        result += std::to_string(idx);
+    }
+    return result;
+}
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("tool_stdin", "[tools]")
+{
+    CATCH_START_SECTION("tool_stdin: a version with too many parts is one failing record")
+    {
+        for(char const * option : { "--stdin", "--batch" })
+        {
+            run_result_t const r(run(
+                      std::string(VERSIONTHECA_TOOL) + " " + option
+                    , "1.0 < 2.0\n"
+                      "1.0 < " + too_many_parts() + "\n"
+                      "3.0 > 2.0\n"));
+            CATCH_REQUIRE(r.f_exit_code == 1);
+            CATCH_REQUIRE(r.f_output == "true\n\ntrue\n");
+            CATCH_REQUIRE(r.f_errors == "error:2: versiontheca_exception: trying to append more parts when maximum was already reached.\n");
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("tool_stdin: canonicalize around a version with too many parts")
+    {
+        run_result_t const r(run(
+                  std::string(VERSIONTHECA_TOOL) + " --stdin --canonicalize"
+                , "1.0.0\n" + too_many_parts() + "\n2.0\n"));
+        CATCH_REQUIRE(r.f_exit_code == 1);
+        CATCH_REQUIRE(r.f_output == "1.0\n\n2.0\n");
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("tool_scan", "[tools]")
+{
+    CATCH_START_SECTION("tool_scan: a version with too many parts does not cancel the file")
+    {
+        std::string const filename(SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/Packages");
+        {
+            std::ofstream out(filename);
+            out << "Package: a\n"
+                   "Version: 1.0\n"
+                   "\n"
+                   "Package: b\n"
+                   "Version: " << too_many_parts() << "\n"
+                   "\n"
+                   "Package: a\n"
+                   "Version: 2.0\n";
+        }
+        run_result_t const r(run(std::string(VERSIONTHECA_SCAN) + " " + filename, std::string()));
+        CATCH_REQUIRE(r.f_exit_code == 1);
+        CATCH_REQUIRE(r.f_output ==
+                  "newest\ta\t2.0\n"
+                  "invalid\tb\t" + too_many_parts() + "\tversiontheca_exception: trying to append more parts when maximum was already reached.\n");
+        CATCH_REQUIRE(r.f_errors.find("3 version(s) in 1 package(s), 1 invalid") != std::string::npos);
+    }
+    CATCH_END_SECTION()
+}
+
+
+// vim: ts=4 sw=4 et
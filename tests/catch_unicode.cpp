@@ -77,9 +77,9 @@ std::cerr << "--- testing invalid versions, but [" << version << "] is considere
 }
 
     CATCH_REQUIRE_FALSE(v->is_valid());
-    CATCH_REQUIRE(v->get_last_error(false) == errmsg);
     CATCH_REQUIRE(v->get_last_error() == errmsg);
-    CATCH_REQUIRE(v->get_last_error().empty());
+    CATCH_REQUIRE(v->take_last_error() == errmsg);
+    CATCH_REQUIRE(v->take_last_error().empty());
 
     return v;
 }
@@ -213,6 +213,47 @@ CATCH_TEST_CASE("unicode_versions", "[valid]")
         }
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("unicode_versions: parse a view in a larger buffer")
+    {
+        // the view is not null terminated, only the first 9 bytes are used
+        //
+        char const buffer[] = "1.\xC3\xA9t\xC3\xA9.3 and some more 5.7";
+        std::string_view const v(buffer, 9);
+        versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
+        CATCH_REQUIRE(t->parse(v));
+        CATCH_REQUIRE(t->size() == 3);
+        CATCH_REQUIRE(t->at(1).get_string() == "\xC3\xA9t\xC3\xA9");
+        CATCH_REQUIRE(t->at(2).get_integer() == 3);
+        CATCH_REQUIRE(t->to_string() == "1.\xC3\xA9t\xC3\xA9.3");
+
+        // a view cutting a multi-byte character is invalid
+        //
+        CATCH_REQUIRE_FALSE(t->parse(std::string_view(buffer, 3)));
+        CATCH_REQUIRE(t->take_last_error() == "input string includes an invalid code not representing a valid UTF-8 character.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("unicode_versions: ASCII detection")
+    {
+        // try the high byte at every position so each path of the scan
+        // (16 bytes, 8 bytes, and bytes) gets tested
+        //
+        for(std::size_t len(0); len < 40; ++len)
+        {
+            std::string v(len, 'a');
+            CATCH_REQUIRE(versiontheca::trait::is_ascii(v));
+            for(std::size_t pos(0); pos < len; ++pos)
+            {
+                v[pos] = '\xC3';
+                CATCH_REQUIRE_FALSE(versiontheca::trait::is_ascii(v));
+                v[pos] = '\x7F';
+                CATCH_REQUIRE(versiontheca::trait::is_ascii(v));
+                v[pos] = 'a';
+            }
+        }
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -390,10 +431,17 @@ CATCH_TEST_CASE("invalid_unicode_versions", "[invalid]")
         versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
         versiontheca::versiontheca v(t, "");
         CATCH_REQUIRE_FALSE(v.is_valid());
-        CATCH_REQUIRE(v.get_last_error().empty());
+        CATCH_REQUIRE(v.take_last_error().empty());
 
         CATCH_REQUIRE(v.get_version().empty());
-        CATCH_REQUIRE(v.get_last_error() == "no parts to output.");
+
+        // a const function does not record an error, the failure
+        // is only reported by the return value of append_version()
+        //
+        CATCH_REQUIRE(v.take_last_error().empty());
+        std::string canonical;
+        CATCH_REQUIRE_FALSE(v.append_version(canonical));
+        CATCH_REQUIRE(canonical.empty());
     }
     CATCH_END_SECTION()
 
@@ -484,7 +532,7 @@ CATCH_TEST_CASE("invalid_unicode_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->next(2));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "maximum limit reached; cannot increment version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "maximum limit reached; cannot increment version any further.");
     }
     CATCH_END_SECTION()
 
@@ -494,7 +542,7 @@ CATCH_TEST_CASE("invalid_unicode_versions", "[invalid]")
         CATCH_REQUIRE(a->is_valid());
         CATCH_REQUIRE_FALSE(a->previous(2));
         CATCH_REQUIRE_FALSE(a->is_valid());
-        CATCH_REQUIRE(a->get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(a->take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 }
@@ -507,7 +555,7 @@ CATCH_TEST_CASE("bad_unicode_calls", "[invalid]")
         versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE(v.next(0));
-        CATCH_REQUIRE(v.get_last_error() == "");
+        CATCH_REQUIRE(v.take_last_error() == "");
         CATCH_REQUIRE(v.get_version() == "1.0");
     }
     CATCH_END_SECTION()
@@ -517,7 +565,7 @@ CATCH_TEST_CASE("bad_unicode_calls", "[invalid]")
         versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
         versiontheca::versiontheca v(t);
         CATCH_REQUIRE_FALSE(v.previous(0));
-        CATCH_REQUIRE(v.get_last_error() == "minimum limit reached; cannot decrement version any further.");
+        CATCH_REQUIRE(v.take_last_error() == "minimum limit reached; cannot decrement version any further.");
     }
     CATCH_END_SECTION()
 
@@ -653,8 +701,84 @@ CATCH_TEST_CASE("bad_unicode_calls", "[invalid]")
     {
         versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
         CATCH_REQUIRE_FALSE(t->parse(std::string()));
-        CATCH_REQUIRE(t->get_last_error() == "an empty input string cannot represent a valid version.");
-        CATCH_REQUIRE(t->get_last_error().empty());
+        CATCH_REQUIRE(t->take_last_error() == "an empty input string cannot represent a valid version.");
+        CATCH_REQUIRE(t->take_last_error().empty());
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("unicode_parts", "[valid][parts]")
+{
+    CATCH_START_SECTION("unicode_parts: insert, erase, resize on the inline parts")
+    {
+        versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
+        CATCH_REQUIRE(t->empty());
+        CATCH_REQUIRE(t->size() == 0);
+
+        for(versiontheca::part_integer_t idx(0); idx < 5; ++idx)
+        {
+            versiontheca::part p;
+            p.set_integer(idx * 10);
+            t->push_back(p);
+        }
+        CATCH_REQUIRE(t->size() == 5);
+
+        versiontheca::part s;
+        s.set_string("rc");
+        t->insert(2, s);
+        CATCH_REQUIRE(t->size() == 6);
+        CATCH_REQUIRE(t->at(0).get_integer() == 0);
+        CATCH_REQUIRE(t->at(1).get_integer() == 10);
+        CATCH_REQUIRE(t->at(2).get_string() == "rc");
+        CATCH_REQUIRE(t->at(3).get_integer() == 20);
+        CATCH_REQUIRE(t->at(5).get_integer() == 40);
+
+        t->erase(0);
+        CATCH_REQUIRE(t->size() == 5);
+        CATCH_REQUIRE(t->at(0).get_integer() == 10);
+        CATCH_REQUIRE(t->at(1).get_string() == "rc");
+        CATCH_REQUIRE(t->at(4).get_integer() == 40);
+
+        t->resize(2);
+        CATCH_REQUIRE(t->size() == 2);
+        CATCH_REQUIRE_THROWS_AS(t->at(2), std::out_of_range);
+
+        // growing again must give us default parts, not stale ones
+        //
+        t->resize(4);
+        CATCH_REQUIRE(t->size() == 4);
+        CATCH_REQUIRE(t->at(2).is_integer());
+        CATCH_REQUIRE(t->at(2).get_integer() == 0);
+        CATCH_REQUIRE(t->at(3).is_integer());
+        CATCH_REQUIRE(t->at(3).get_integer() == 0);
+
+        t->clear();
+        CATCH_REQUIRE(t->empty());
+        CATCH_REQUIRE_THROWS_AS(t->at(0), std::out_of_range);
+
+        // the trait can be reused after a clear()
+        //
+        CATCH_REQUIRE(t->parse("3.7.b"));
+        CATCH_REQUIRE(t->size() == 3);
+        CATCH_REQUIRE(t->to_string() == "3.7.b");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("unicode_parts: insert limits")
+    {
+        versiontheca::unicode::pointer_t t(std::make_shared<versiontheca::unicode>());
+        versiontheca::part p;
+        CATCH_REQUIRE_THROWS_AS(t->insert(1, p), std::out_of_range);
+        for(std::size_t idx(0); idx < versiontheca::MAX_PARTS; ++idx)
+        {
+            t->insert(0, p);
+        }
+        CATCH_REQUIRE_THROWS_MATCHES(
+              t->insert(0, p)
+            , versiontheca::invalid_parameter
+            , Catch::Matchers::ExceptionMessage(
+                      "versiontheca_exception: trying to insert more parts when maximum was already reached."));
     }
     CATCH_END_SECTION()
 }
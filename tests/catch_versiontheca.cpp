@@ -0,0 +1,354 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// tested file
+//
+#include    "versiontheca/versiontheca.h"
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// versiontheca
+//
+#include    "versiontheca/basic.h"
+#include    "versiontheca/debian.h"
+#include    "versiontheca/exception.h"
+#include    "versiontheca/kind.h"
+#include    "versiontheca/rpm.h"
+
+
+// C++
+//
+#include    <algorithm>
+#include    <unordered_map>
+#include    <unordered_set>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace
+{
+
+
+
+// a trait defined outside of the library only overrides compare(rhs)
+//
+class reversed_trait
+    : public versiontheca::basic
+{
+public:
+    virtual versiontheca::trait::pointer_t
+                        clone() const override
+                        {
+                            return std::make_shared<reversed_trait>(*this);
+                        }
+
+    virtual int         compare(versiontheca::trait::pointer_t const & rhs) const override
+                        {
+                            return -basic::compare(rhs);
+                        }
+};
+
+
+
+}
+// no name namespace
+
+
+
+CATCH_TEST_CASE("versiontheca_copy", "[versiontheca][valid]")
+{
+    CATCH_START_SECTION("versiontheca_copy: clone keeps the trait type")
+    {
+        for(versiontheca::trait_kind_t const kind : {
+                      versiontheca::trait_kind_t::TRAIT_KIND_BASIC
+                    , versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+                    , versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL
+                    , versiontheca::trait_kind_t::TRAIT_KIND_ROMAN
+                    , versiontheca::trait_kind_t::TRAIT_KIND_RPM
+                    , versiontheca::trait_kind_t::TRAIT_KIND_UNICODE })
+        {
+            versiontheca::trait::pointer_t const t(versiontheca::create_trait(kind));
+            versiontheca::trait::pointer_t const c(t->clone());
+            CATCH_REQUIRE(c != t);
+            CATCH_REQUIRE(typeid(*c) == typeid(*t));
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_copy: copies are independent")
+    {
+        versiontheca::debian::pointer_t t(std::make_shared<versiontheca::debian>());
+        versiontheca::versiontheca v(t, "1:2.3-4");
+        versiontheca::versiontheca copy(v);
+        CATCH_REQUIRE(copy.is_valid());
+        CATCH_REQUIRE(copy.get_version() == "1:2.3-4");
+        CATCH_REQUIRE(copy.get_trait() != v.get_trait());
+        CATCH_REQUIRE(dynamic_cast<versiontheca::debian *>(copy.get_trait().get()) != nullptr);
+        CATCH_REQUIRE(copy == v);
+
+        CATCH_REQUIRE(copy.next(1));
+        CATCH_REQUIRE(copy.get_version() == "1:2.4-4");
+        CATCH_REQUIRE(v.get_version() == "1:2.3-4");
+        CATCH_REQUIRE(v < copy);
+
+        v = copy;
+        CATCH_REQUIRE(v.get_version() == "1:2.4-4");
+        CATCH_REQUIRE(v.get_trait() != copy.get_trait());
+
+        v = v;
+        CATCH_REQUIRE(v.get_version() == "1:2.4-4");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_copy: move")
+    {
+        versiontheca::rpm::pointer_t t(std::make_shared<versiontheca::rpm>());
+        versiontheca::versiontheca v(t, "3.1-2.fc39");
+        versiontheca::versiontheca moved(std::move(v));
+        CATCH_REQUIRE(moved.get_trait() == t);
+        CATCH_REQUIRE(moved.get_version() == "3.1-2.fc39");
+
+        versiontheca::versiontheca other(std::make_shared<versiontheca::rpm>(), "1.0");
+        other = std::move(moved);
+        CATCH_REQUIRE(other.get_trait() == t);
+        CATCH_REQUIRE(other.get_version() == "3.1-2.fc39");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_copy: keep versions by value in containers")
+    {
+        std::vector<versiontheca::versiontheca> versions;
+        for(int i(0); i < 20; ++i)
+        {
+            versions.emplace_back(
+                      versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN)
+                    , "1." + std::to_string(19 - i) + "-1");
+        }
+        std::vector<versiontheca::versiontheca> sorted(versions);
+        std::sort(sorted.begin(), sorted.end());
+        for(int i(0); i < 20; ++i)
+        {
+            CATCH_REQUIRE(sorted[i].get_version() == "1." + std::to_string(i) + "-1");
+            CATCH_REQUIRE(versions[i].get_version() == "1." + std::to_string(19 - i) + "-1");
+        }
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("versiontheca_hash", "[versiontheca][valid]")
+{
+    CATCH_START_SECTION("versiontheca_hash: equal versions have the same hash")
+    {
+        struct equal_t
+        {
+            char const *    f_kind_name = nullptr;
+            versiontheca::trait_kind_t
+                            f_kind = versiontheca::trait_kind_t::TRAIT_KIND_UNICODE;
+            char const *    f_lhs = nullptr;
+            char const *    f_rhs = nullptr;
+        };
+        equal_t const equals[] =
+        {
+            { "basic",   versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   "1.0",   "1.0.0" },
+            { "debian",  versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  "1.0",   "0:1.0.0" },
+            { "rpm",     versiontheca::trait_kind_t::TRAIT_KIND_RPM,     "2.1",   "0:2.1.0" },
+            { "unicode", versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, "1.A",   "1.A.0" },
+        };
+        for(auto const & e : equals)
+        {
+            CATCH_INFO("kind: " << e.f_kind_name);
+            versiontheca::versiontheca const l(versiontheca::create_trait(e.f_kind), e.f_lhs);
+            versiontheca::versiontheca const r(versiontheca::create_trait(e.f_kind), e.f_rhs);
+            CATCH_REQUIRE(l == r);
+            CATCH_REQUIRE(l.hash() == r.hash());
+            CATCH_REQUIRE(std::hash<versiontheca::versiontheca>()(l) == l.hash());
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_hash: versions as keys of an unordered_map")
+    {
+        std::unordered_map<versiontheca::versiontheca, int> counts;
+        for(char const * v : { "1.0", "1.0.0", "1.1", "2.0~rc1", "2.0", "1.1.0.0" })
+        {
+            versiontheca::versiontheca const key(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), v);
+            ++counts[key];
+        }
+        CATCH_REQUIRE(counts.size() == 4);
+
+        std::unordered_set<versiontheca::versiontheca> set;
+        set.insert(versiontheca::versiontheca(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.1"));
+        CATCH_REQUIRE(set.count(versiontheca::versiontheca(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.1.0")) == 1);
+        CATCH_REQUIRE(set.count(versiontheca::versiontheca(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "1.2")) == 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_hash: invalid versions hash to 0")
+    {
+        versiontheca::versiontheca const v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN), "a1.0");
+        CATCH_REQUIRE_FALSE(v.is_valid());
+        CATCH_REQUIRE(v.hash() == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("versiontheca_append", "[versiontheca][valid]")
+{
+    CATCH_START_SECTION("versiontheca_append: same as get_version()")
+    {
+        struct kind_version_t
+        {
+            versiontheca::trait_kind_t
+                            f_kind = versiontheca::trait_kind_t::TRAIT_KIND_UNICODE;
+            char const *    f_version = nullptr;
+        };
+        kind_version_t const versions[] =
+        {
+            { versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   "1.2.3.0" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_BASIC,   "4294967295" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  "3:1.0.0~rc1-2ubuntu1" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN,  "5" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, "1.05" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL, "12" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_ROMAN,   "MMXXIII.IV" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_RPM,     "1:2.0.a_b-3.fc39" },
+            { versiontheca::trait_kind_t::TRAIT_KIND_UNICODE, "1.0.ß" },
+        };
+        std::string buffer;
+        for(auto const & kv : versions)
+        {
+            versiontheca::versiontheca const v(versiontheca::create_trait(kv.f_kind), kv.f_version);
+            CATCH_REQUIRE(v.is_valid());
+            std::string const expected(v.get_version());
+
+            buffer = "prefix:";
+            CATCH_REQUIRE(v.append_version(buffer));
+            CATCH_REQUIRE(buffer == "prefix:" + expected);
+
+            char buf[64];
+            std::to_chars_result r(v.get_trait()->to_chars(buf, buf + sizeof(buf)));
+            CATCH_REQUIRE(r.ec == std::errc());
+            CATCH_REQUIRE(std::string(buf, r.ptr) == expected);
+
+            r = v.get_trait()->to_chars(buf, buf + expected.length());
+            CATCH_REQUIRE(r.ec == std::errc());
+            CATCH_REQUIRE(r.ptr == buf + expected.length());
+
+            // nothing gets written past the end of a buffer too small
+            //
+            for(std::size_t length(0); length < expected.length(); ++length)
+            {
+                std::fill(buf, buf + sizeof(buf), '#');
+                r = v.get_trait()->to_chars(buf, buf + length);
+                CATCH_REQUIRE(r.ec == std::errc::value_too_large);
+                CATCH_REQUIRE(r.ptr == buf + length);
+                CATCH_REQUIRE(std::all_of(buf + length, buf + sizeof(buf), [](char c) { return c == '#'; }));
+            }
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_append: separators are written in UTF-8")
+    {
+        versiontheca::trait::pointer_t t(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE));
+        versiontheca::part p;
+        p.set_integer(1);
+        t->push_back(p);
+        p.set_separator(U'\u00B7');
+        p.set_string("a");
+        t->push_back(p);
+        p.set_separator(U'\U0001F680');
+        p.set_integer(3);
+        t->push_back(p);
+        std::string const expected("1\xC2\xB7" "a\xF0\x9F\x9A\x80" "3");
+        CATCH_REQUIRE(t->to_string() == expected);
+
+        char buf[16];
+        std::to_chars_result r(t->to_chars(buf, buf + sizeof(buf)));
+        CATCH_REQUIRE(r.ec == std::errc());
+        CATCH_REQUIRE(std::string(buf, r.ptr) == expected);
+
+        r = t->to_chars(buf, buf + 5);
+        CATCH_REQUIRE(r.ec == std::errc::value_too_large);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_append: empty version")
+    {
+        versiontheca::versiontheca const v(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL));
+        std::string buffer("keep");
+        CATCH_REQUIRE_FALSE(v.append_version(buffer));
+        CATCH_REQUIRE(buffer == "keep");
+        CATCH_REQUIRE(v.get_last_error().empty());
+
+        char buf[16];
+        std::to_chars_result const r(v.get_trait()->to_chars(buf, buf + sizeof(buf)));
+        CATCH_REQUIRE(r.ec == std::errc::invalid_argument);
+        CATCH_REQUIRE(r.ptr == buf);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("versiontheca_compare_prefix", "[versiontheca][compare][valid]")
+{
+    CATCH_START_SECTION("versiontheca_compare_prefix: the limit forwards to the virtual compare()")
+    {
+        versiontheca::trait::pointer_t a(std::make_shared<reversed_trait>());
+        versiontheca::trait::pointer_t b(std::make_shared<reversed_trait>());
+        CATCH_REQUIRE(a->parse("1.2.3"));
+        CATCH_REQUIRE(b->parse("1.3.1"));
+
+        CATCH_REQUIRE(a->compare(b) == 1);
+        CATCH_REQUIRE(a->compare_prefix(b, versiontheca::MAX_PARTS) == 1);
+        CATCH_REQUIRE(a->compare_prefix(b, 2) == 1);
+        CATCH_REQUIRE(a->compare_prefix(b, 1) == 0);
+
+        // the versions are not modified
+        //
+        CATCH_REQUIRE(a->size() == 3);
+        CATCH_REQUIRE(b->size() == 3);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("versiontheca_compare_prefix: a limit of zero")
+    {
+        versiontheca::trait::pointer_t a(std::make_shared<reversed_trait>());
+        CATCH_REQUIRE(a->parse("1.0"));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  a->compare_prefix(a, 0)
+                , versiontheca::invalid_parameter
+                , Catch::Matchers::ExceptionMessage(
+                          "versiontheca_exception: the compare limit must be at least 1."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,676 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the differential tests helpers.
+ */
+
+// self
+//
+#include    "differential.h"
+
+
+// versiontheca
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <cstdlib>
+#include    <cstring>
+
+
+// C
+//
+#include    <spawn.h>
+#include    <sys/wait.h>
+#include    <unistd.h>
+
+
+#ifdef HAVE_RPMVERCMP
+// rpm
+//
+#include    <rpm/rpmver.h>
+#endif
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+extern char ** environ;
+
+
+namespace differential
+{
+
+
+
+namespace
+{
+
+
+
+bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+
+bool is_alpha(char c)
+{
+    return (c >= 'a' && c <= 'z')
+        || (c >= 'A' && c <= 'Z');
+}
+
+
+/** \brief The order of a character in a dpkg version.
+ *
+ * Letters sort first, then the other characters; the tilde sorts
+ * before the end of the string.
+ */
+int dpkg_order(char c)
+{
+    if(is_digit(c))
+    {
+        return 0;
+    }
+    if(is_alpha(c))
+    {
+        return static_cast<unsigned char>(c);
+    }
+    if(c == '~')
+    {
+        return -1;
+    }
+    if(c != '\0')
+    {
+        return static_cast<unsigned char>(c) + 256;
+    }
+    return 0;
+}
+
+
+/** \brief Port of dpkg's verrevcmp().
+ *
+ * The strings are accessed through a helper returning '\0' at the end so
+ * the loops can use string_views exactly as dpkg uses C strings.
+ */
+int dpkg_verrevcmp(std::string_view const & a, std::string_view const & b)
+{
+    std::size_t i(0);
+    std::size_t j(0);
+    auto ca([&a](std::size_t pos) { return pos < a.length() ? a[pos] : '\0'; });
+    auto cb([&b](std::size_t pos) { return pos < b.length() ? b[pos] : '\0'; });
+
+    while(ca(i) != '\0' || cb(j) != '\0')
+    {
+        int first_diff(0);
+        while((ca(i) != '\0' && !is_digit(ca(i)))
+           || (cb(j) != '\0' && !is_digit(cb(j))))
+        {
+            int const ac(dpkg_order(ca(i)));
+            int const bc(dpkg_order(cb(j)));
+            if(ac != bc)
+            {
+                return ac - bc;
+            }
+            ++i;
+            ++j;
+        }
+        while(ca(i) == '0')
+        {
+            ++i;
+        }
+        while(cb(j) == '0')
+        {
+            ++j;
+        }
+        while(is_digit(ca(i)) && is_digit(cb(j)))
+        {
+            if(first_diff == 0)
+            {
+                first_diff = ca(i) - cb(j);
+            }
+            ++i;
+            ++j;
+        }
+        if(is_digit(ca(i)))
+        {
+            return 1;
+        }
+        if(is_digit(cb(j)))
+        {
+            return -1;
+        }
+        if(first_diff != 0)
+        {
+            return first_diff;
+        }
+    }
+
+    return 0;
+}
+
+
+struct evr_t
+{
+    std::string_view    f_epoch = std::string_view();
+    std::string_view    f_version = std::string_view();
+    std::string_view    f_release = std::string_view();
+    bool                f_has_release = false;
+};
+
+
+/** \brief Split a version the way dpkg and rpm do.
+ *
+ * The epoch is the part before the first colon and the release (Debian
+ * revision) is the part after the last dash.
+ */
+evr_t split_evr(std::string_view v)
+{
+    evr_t result;
+    std::string_view::size_type const colon(v.find(':'));
+    if(colon != std::string_view::npos)
+    {
+        result.f_epoch = v.substr(0, colon);
+        v = v.substr(colon + 1);
+    }
+    std::string_view::size_type const dash(v.rfind('-'));
+    if(dash != std::string_view::npos)
+    {
+        result.f_release = v.substr(dash + 1);
+        result.f_has_release = true;
+        v = v.substr(0, dash);
+    }
+    result.f_version = v;
+    return result;
+}
+
+
+long epoch_value(std::string_view const & epoch)
+{
+    long result(0);
+    for(char const c : epoch)
+    {
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+
+
+std::string random_segments(
+      std::size_t max_segments
+    , char const * separators
+    , random_t & rng)
+{
+    char const letters[] = "abcxyzABXYZ";
+    std::size_t const separator_count(strlen(separators));
+    std::size_t const count(rng() % max_segments + 1);
+    std::string result;
+    for(std::size_t idx(0); idx < count; ++idx)
+    {
+        if(idx != 0)
+        {
+            result += separators[rng() % separator_count];
+        }
+        if(idx == 0 || rng() % 4 != 0)
+        {
+            // numbers, sometimes with leading zeroes
+            //
+            if(rng() % 8 == 0)
+            {
+                result += '0';
+            }
+            // two statements so the calls to rng() are sequenced
+            //
+            std::uint32_t const max(rng() % 2 == 0 ? 10 : 10000);
+            result += std::to_string(rng() % max);
+        }
+        else
+        {
+            std::size_t const length(rng() % 3 + 1);
+            for(std::size_t l(0); l < length; ++l)
+            {
+                result += letters[rng() % (sizeof(letters) - 1)];
+            }
+        }
+    }
+    return result;
+}
+
+
+versiontheca_benchmarks::version_list_t load(char const * filename)
+{
+    return versiontheca_benchmarks::load_corpus(
+            std::string(VERSIONTHECA_CORPUS_DIR "/") + filename);
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Compare two Debian versions like `dpkg --compare-versions`.
+ *
+ * \param[in] lhs  The left hand side version.
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1 as lhs is smaller, equal, or larger than rhs.
+ */
+int dpkg_compare(std::string_view const & lhs, std::string_view const & rhs)
+{
+    evr_t const l(split_evr(lhs));
+    evr_t const r(split_evr(rhs));
+
+    long const le(epoch_value(l.f_epoch));
+    long const re(epoch_value(r.f_epoch));
+    if(le != re)
+    {
+        return le < re ? -1 : 1;
+    }
+
+    int const rc(dpkg_verrevcmp(l.f_version, r.f_version));
+    if(rc != 0)
+    {
+        return sign(rc);
+    }
+
+    return sign(dpkg_verrevcmp(l.f_release, r.f_release));
+}
+
+
+/** \brief Check whether the dpkg command is available.
+ *
+ * \return true if `dpkg --compare-versions` can be used.
+ */
+bool has_dpkg()
+{
+    static int const available(dpkg_command_compare("1", "1") == 0 ? 1 : 0);
+    return available != 0;
+}
+
+
+/** \brief Compare two versions with the dpkg command.
+ *
+ * Each call starts one or two processes so this is only used on a
+ * sample of the pairs, to prove that dpkg_compare() is a valid oracle.
+ *
+ * \param[in] lhs  The left hand side version.
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1, or -2 if dpkg cannot be run.
+ */
+int dpkg_command_compare(std::string const & lhs, std::string const & rhs)
+{
+    auto run([&lhs, &rhs](char const * op)
+        {
+            char const * argv[] = {
+                "dpkg",
+                "--compare-versions",
+                lhs.c_str(),
+                op,
+                rhs.c_str(),
+                nullptr,
+            };
+            pid_t pid(0);
+            if(posix_spawnp(&pid, "dpkg", nullptr, nullptr, const_cast<char **>(argv), environ) != 0)
+            {
+                return -1;
+            }
+            int status(0);
+            if(waitpid(pid, &status, 0) != pid
+            || !WIFEXITED(status))
+            {
+                return -1;
+            }
+            return WEXITSTATUS(status);
+        });
+
+    int const lt(run("lt"));
+    if(lt == 0)
+    {
+        return -1;
+    }
+    if(lt != 1)
+    {
+        return -2;
+    }
+    return run("gt") == 0 ? 1 : 0;
+}
+
+
+/** \brief Compare two version strings like rpmvercmp().
+ *
+ * This is a port of rpmvercmp() from rpmio/rpmvercmp.c, including the
+ * support of the '~' and '^' characters.
+ *
+ * \param[in] lhs  The left hand side string.
+ * \param[in] rhs  The right hand side string.
+ *
+ * \return -1, 0, or 1 as lhs is smaller, equal, or larger than rhs.
+ */
+int rpmvercmp(std::string const & lhs, std::string const & rhs)
+{
+#ifdef HAVE_RPMVERCMP
+    return sign(::rpmvercmp(lhs.c_str(), rhs.c_str()));
+#else
+    if(lhs == rhs)
+    {
+        return 0;
+    }
+
+    auto is_alnum([](char c) { return is_digit(c) || is_alpha(c); });
+
+    char const * one(lhs.c_str());
+    char const * two(rhs.c_str());
+    while(*one != '\0' || *two != '\0')
+    {
+        while(*one != '\0' && !is_alnum(*one) && *one != '~' && *one != '^')
+        {
+            ++one;
+        }
+        while(*two != '\0' && !is_alnum(*two) && *two != '~' && *two != '^')
+        {
+            ++two;
+        }
+
+        // '~' sorts before anything, even the end of the string
+        //
+        if(*one == '~' || *two == '~')
+        {
+            if(*one != '~')
+            {
+                return 1;
+            }
+            if(*two != '~')
+            {
+                return -1;
+            }
+            ++one;
+            ++two;
+            continue;
+        }
+
+        // '^' sorts after the end of the string but before anything else
+        //
+        if(*one == '^' || *two == '^')
+        {
+            if(*one == '\0')
+            {
+                return -1;
+            }
+            if(*two == '\0')
+            {
+                return 1;
+            }
+            if(*one != '^')
+            {
+                return 1;
+            }
+            if(*two != '^')
+            {
+                return -1;
+            }
+            ++one;
+            ++two;
+            continue;
+        }
+
+        if(*one == '\0' || *two == '\0')
+        {
+            break;
+        }
+
+        char const * str1(one);
+        char const * str2(two);
+        bool const isnum(is_digit(*str1));
+        if(isnum)
+        {
+            while(is_digit(*str1))
+            {
+                ++str1;
+            }
+            while(is_digit(*str2))
+            {
+                ++str2;
+            }
+        }
+        else
+        {
+            while(is_alpha(*str1))
+            {
+                ++str1;
+            }
+            while(is_alpha(*str2))
+            {
+                ++str2;
+            }
+        }
+
+        // rpm considers a number larger than a string
+        //
+        if(one == str1)
+        {
+            return -1;
+        }
+        if(two == str2)
+        {
+            return isnum ? 1 : -1;
+        }
+
+        std::string_view a(one, str1 - one);
+        std::string_view b(two, str2 - two);
+        if(isnum)
+        {
+            while(!a.empty() && a.front() == '0')
+            {
+                a.remove_prefix(1);
+            }
+            while(!b.empty() && b.front() == '0')
+            {
+                b.remove_prefix(1);
+            }
+            if(a.length() != b.length())
+            {
+                return a.length() > b.length() ? 1 : -1;
+            }
+        }
+        int const rc(a.compare(b));
+        if(rc != 0)
+        {
+            return rc < 0 ? -1 : 1;
+        }
+
+        one = str1;
+        two = str2;
+    }
+
+    if(*one == '\0' && *two == '\0')
+    {
+        return 0;
+    }
+    return *one == '\0' ? -1 : 1;
+#endif
+}
+
+
+/** \brief Compare two RPM versions like rpmverCmp().
+ *
+ * A missing epoch is "0" and the releases are only compared when both
+ * versions have one.
+ *
+ * \param[in] lhs  The left hand side version.
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1 as lhs is smaller, equal, or larger than rhs.
+ */
+int rpm_compare(std::string_view const & lhs, std::string_view const & rhs)
+{
+    evr_t const l(split_evr(lhs));
+    evr_t const r(split_evr(rhs));
+
+    int rc(rpmvercmp(
+              l.f_epoch.empty() ? std::string("0") : std::string(l.f_epoch)
+            , r.f_epoch.empty() ? std::string("0") : std::string(r.f_epoch)));
+    if(rc == 0)
+    {
+        rc = rpmvercmp(std::string(l.f_version), std::string(r.f_version));
+        if(rc == 0
+        && l.f_has_release
+        && r.f_has_release)
+        {
+            rc = rpmvercmp(std::string(l.f_release), std::string(r.f_release));
+        }
+    }
+    return rc;
+}
+
+
+/** \brief Generate a random Debian version.
+ *
+ * The version has an optional epoch, an upstream version made of
+ * numbers and letters separated by '.', '+', and '~', and an optional
+ * revision.
+ *
+ * \param[in,out] rng  The random number generator.
+ *
+ * \return A new version string.
+ */
+std::string random_debian_version(random_t & rng)
+{
+    std::string result;
+    if(rng() % 4 == 0)
+    {
+        result += std::to_string(rng() % 5);
+        result += ':';
+    }
+    result += random_segments(6, ".+~", rng);
+    if(rng() % 2 == 0)
+    {
+        result += '-';
+        result += random_segments(3, ".+~", rng);
+    }
+    return result;
+}
+
+
+/** \brief Generate a random RPM version.
+ *
+ * The version has an optional epoch, a version made of numbers and
+ * letters separated by '.', '_', '+', '~', and '^', and an optional
+ * release.
+ *
+ * \param[in,out] rng  The random number generator.
+ *
+ * \return A new version string.
+ */
+std::string random_rpm_version(random_t & rng)
+{
+    std::string result;
+    if(rng() % 4 == 0)
+    {
+        result += std::to_string(rng() % 5);
+        result += ':';
+    }
+    result += random_segments(6, "._+~^", rng);
+    if(rng() % 4 != 0)
+    {
+        result += '-';
+        result += random_segments(3, "._+~^", rng);
+    }
+    return result;
+}
+
+
+/** \brief Create a version close to another one.
+ *
+ * The function replaces, inserts, or removes one character. This
+ * generates pairs which only differ in one place, which is where the
+ * compare functions are the most likely to differ.
+ *
+ * \param[in] v  The version to mutate.
+ * \param[in] alphabet  The characters to use for the replacement.
+ * \param[in,out] rng  The random number generator.
+ *
+ * \return The mutated version.
+ */
+std::string mutate_version(std::string const & v, char const * alphabet, random_t & rng)
+{
+    std::string result(v);
+    if(result.empty())
+    {
+        return result;
+    }
+    std::size_t const pos(rng() % result.length());
+    char const c(alphabet[rng() % strlen(alphabet)]);
+    switch(rng() % 3)
+    {
+    case 0:
+        result[pos] = c;
+        break;
+
+    case 1:
+        result.insert(pos, 1, c);
+        break;
+
+    default:
+        result.erase(pos, 1);
+        break;
+
+    }
+    return result;
+}
+
+
+/** \brief Load the Debian corpus of the benchmarks.
+ *
+ * \return The valid Debian versions of the corpus.
+ */
+versiontheca_benchmarks::version_list_t debian_versions()
+{
+    return versiontheca_benchmarks::keep_valid(
+              versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN
+            , load("debian.txt"));
+}
+
+
+/** \brief Load the RPM corpus of the benchmarks.
+ *
+ * The corpus is a list of NEVRAs so the name and architecture get
+ * removed first.
+ *
+ * \return The valid RPM versions of the corpus.
+ */
+versiontheca_benchmarks::version_list_t rpm_versions()
+{
+    return versiontheca_benchmarks::keep_valid(
+              versiontheca::trait_kind_t::TRAIT_KIND_RPM
+            , versiontheca_benchmarks::nevra_to_evr(load("rpm.txt")));
+}
+
+
+
+}
+// namespace differential
+// vim: ts=4 sw=4 et
@@ -0,0 +1,104 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Reference implementations used by the differential tests.
+ *
+ * The Debian and RPM traits are close to, but not exactly, the dpkg and
+ * rpm implementations. The differential tests compare the results of
+ * the traits against the algorithms used by those tools:
+ *
+ * \li dpkg_compare() is a port of `dpkg_version_compare()` (lib/dpkg/version.c)
+ * which is what `dpkg --compare-versions` uses;
+ * \li rpm_compare() is `rpmvercmp()` applied to the epoch, version, and
+ * release as `rpmverCmp()` does; when the tests are linked against
+ * librpmio, the real rpmvercmp() is used instead of the port.
+ *
+ * The header also offers the version generators and a small timer used
+ * to compare the throughput of both sides. The generators use their own
+ * random_t engine, not rand(), so a given seed always generates the same
+ * versions on all computers and the results of the tests can be pinned.
+ */
+
+// benchmarks
+//
+#include    "../benchmarks/corpus.h"
+
+
+// C++
+//
+#include    <chrono>
+#include    <random>
+#include    <string>
+#include    <string_view>
+
+
+
+namespace differential
+{
+
+
+
+typedef std::mt19937    random_t;
+
+
+int                     dpkg_compare(std::string_view const & lhs, std::string_view const & rhs);
+bool                    has_dpkg();
+int                     dpkg_command_compare(std::string const & lhs, std::string const & rhs);
+int                     rpmvercmp(std::string const & lhs, std::string const & rhs);
+int                     rpm_compare(std::string_view const & lhs, std::string_view const & rhs);
+
+std::string             random_debian_version(random_t & rng);
+std::string             random_rpm_version(random_t & rng);
+std::string             mutate_version(std::string const & v, char const * alphabet, random_t & rng);
+versiontheca_benchmarks::version_list_t
+                        debian_versions();
+versiontheca_benchmarks::version_list_t
+                        rpm_versions();
+
+
+inline int sign(int r)
+{
+    return r < 0 ? -1 : (r > 0 ? 1 : 0);
+}
+
+
+class timer
+{
+public:
+                        timer()
+                            : f_start(std::chrono::steady_clock::now())
+                        {
+                        }
+
+    double              seconds() const
+                        {
+                            return std::chrono::duration<double>(std::chrono::steady_clock::now() - f_start).count();
+                        }
+
+private:
+    std::chrono::steady_clock::time_point
+                        f_start;
+};
+
+
+
+}
+// namespace differential
+// vim: ts=4 sw=4 et
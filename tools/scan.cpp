@@ -0,0 +1,695 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief The implementation of the versiontheca-scan tool.
+ *
+ * This tool reads Debian `Packages` and `Sources` files and RPM
+ * `primary.xml` files and checks all the versions found in them. For
+ * each package, it reports the newest version, the versions which do
+ * not parse, and the versions which are not canonical (i.e. to_string()
+ * returns a different string).
+ *
+ * The files are mapped in memory and the names and versions are used
+ * in place, without being copied. The file is cut in chunks aligned on
+ * the package boundaries and a pool of threads processes the chunks,
+ * each thread taking the next available chunk until none are left, so
+ * a thread which gets faster chunks simply processes more of them.
+ */
+
+// versiontheca
+//
+#include    <versiontheca/exception.h>
+#include    <versiontheca/kind.h>
+#include    <versiontheca/mapped_file.h>
+#include    <versiontheca/version.h>
+
+
+// snapdev
+//
+#include    <snapdev/pathinfo.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <atomic>
+#include    <cstring>
+#include    <future>
+#include    <iostream>
+#include    <thread>
+#include    <unordered_map>
+#include    <vector>
+
+
+
+namespace
+{
+
+
+
+enum class format_t
+{
+    FORMAT_AUTO,
+
+    FORMAT_DEBIAN,
+    FORMAT_RPM,
+};
+
+
+// a chunk is at least this size, it gets extended to the next package
+//
+constexpr std::size_t const     CHUNK_SIZE = 256 * 1024;
+
+
+struct newest_t
+{
+    versiontheca::trait::pointer_t
+                        f_trait = versiontheca::trait::pointer_t();
+    std::string         f_version = std::string();
+};
+
+
+struct report_t
+{
+    std::string_view    f_package = std::string_view();
+    std::string         f_version = std::string();
+    std::string         f_message = std::string();
+};
+
+
+typedef std::unordered_map<std::string_view, newest_t>  newest_map_t;
+
+
+struct scan_result_t
+{
+    std::size_t         f_count = 0;
+    newest_map_t        f_newest = newest_map_t();
+    std::vector<report_t>
+                        f_invalid = std::vector<report_t>();
+    std::vector<report_t>
+                        f_non_canonical = std::vector<report_t>();
+};
+
+
+format_t                    g_format = format_t::FORMAT_AUTO;
+std::size_t                 g_threads = 0;
+bool                        g_show_newest = true;
+bool                        g_show_invalid = true;
+bool                        g_show_non_canonical = true;
+int                         g_errcnt = 0;
+std::string                 g_progname = std::string();
+std::vector<std::string>    g_filenames = std::vector<std::string>();
+
+
+std::string_view trim(std::string_view v)
+{
+    while(!v.empty() && (v.front() == ' ' || v.front() == '\t'))
+    {
+        v.remove_prefix(1);
+    }
+    while(!v.empty() && (v.back() == ' ' || v.back() == '\t' || v.back() == '\r'))
+    {
+        v.remove_suffix(1);
+    }
+    return v;
+}
+
+
+/** \brief Check one version and save the results.
+ *
+ * The \p work trait is reused for each version. When the version is
+ * the newest of its package so far, the trait gets cloned.
+ *
+ * A version which makes the library throw (i.e. it has more than
+ * MAX_PARTS parts) is reported as invalid so it does not cancel the
+ * scan of the rest of the file.
+ */
+void check_version(
+      std::string_view const & package
+    , std::string_view const & version
+    , versiontheca::trait::pointer_t & work
+    , std::string & canonical
+    , scan_result_t & result)
+{
+    ++result.f_count;
+    try
+    {
+        if(!work->parse(version))
+        {
+            result.f_invalid.push_back({ package, std::string(version), work->get_last_error() });
+            return;
+        }
+    }
+    catch(versiontheca::versiontheca_exception const & e)
+    {
+        result.f_invalid.push_back({ package, std::string(version), e.what() });
+        return;
+    }
+
+    canonical.clear();
+    if(work->append_to_string(canonical)
+    && canonical != version)
+    {
+        result.f_non_canonical.push_back({ package, std::string(version), canonical });
+    }
+
+    newest_t & newest(result.f_newest[package]);
+    if(newest.f_trait == nullptr
+    || work->compare(newest.f_trait) > 0)
+    {
+        newest.f_trait = work->clone();
+        newest.f_version = version;
+    }
+}
+
+
+/** \brief Extract the Package and Version fields of Debian stanzas.
+ *
+ * Stanzas are separated by empty lines. The fields of interest are
+ * expected at the start of a line; continuation lines start with a
+ * space so they never match.
+ */
+void scan_debian(
+      char const * start
+    , char const * end
+    , scan_result_t & result)
+{
+    versiontheca::trait::pointer_t work(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN));
+    std::string canonical;
+    std::string_view package;
+    std::string_view version;
+    for(char const * s(start); s <= end;)
+    {
+        char const * eol(s < end ? static_cast<char const *>(memchr(s, '\n', end - s)) : nullptr);
+        if(eol == nullptr)
+        {
+            eol = end;
+        }
+        std::string_view const line(s, eol - s);
+        if(trim(line).empty())
+        {
+            if(!version.empty())
+            {
+                check_version(package, version, work, canonical, result);
+            }
+            package = std::string_view();
+            version = std::string_view();
+        }
+        else if(line.compare(0, 8, "Package:") == 0)
+        {
+            package = trim(line.substr(8));
+        }
+        else if(line.compare(0, 8, "Version:") == 0)
+        {
+            version = trim(line.substr(8));
+        }
+        s = eol + 1;
+    }
+    if(!version.empty())
+    {
+        check_version(package, version, work, canonical, result);
+    }
+}
+
+
+std::string_view get_attribute(std::string_view const & tag, std::string_view const & name)
+{
+    for(std::size_t pos(tag.find(name)); pos != std::string_view::npos; pos = tag.find(name, pos + 1))
+    {
+        // make sure we do not match the end of another name
+        //
+        if(pos > 0
+        && tag[pos - 1] != ' '
+        && tag[pos - 1] != '\t'
+        && tag[pos - 1] != '\n')
+        {
+            continue;
+        }
+        std::size_t p(pos + name.length());
+        if(p + 1 >= tag.length()
+        || tag[p] != '='
+        || tag[p + 1] != '"')
+        {
+            continue;
+        }
+        p += 2;
+        std::size_t const q(tag.find('"', p));
+        if(q == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+        return tag.substr(p, q - p);
+    }
+    return std::string_view();
+}
+
+
+/** \brief Extract the name and version of the packages of a primary.xml.
+ *
+ * The RPM metadata saves the version in three attributes:
+ *
+ * \code
+ *     <version epoch="0" ver="1.2.3" rel="4.fc39"/>
+ * \endcode
+ *
+ * The version checked is "[epoch:]ver-rel" where the epoch is omitted
+ * when 0, which is how rpm itself presents versions. This is the only
+ * case where the version gets copied, in a buffer reused for each
+ * package.
+ */
+void scan_rpm(
+      char const * start
+    , char const * end
+    , scan_result_t & result)
+{
+    versiontheca::trait::pointer_t work(versiontheca::create_trait(versiontheca::trait_kind_t::TRAIT_KIND_RPM));
+    std::string canonical;
+    std::string version;
+    std::string_view const input(start, end - start);
+    for(std::size_t pos(input.find("<package")); pos != std::string_view::npos; pos = input.find("<package", pos))
+    {
+        std::size_t const package_end(input.find("</package>", pos));
+        std::string_view const package(input.substr(pos, package_end == std::string_view::npos ? std::string_view::npos : package_end - pos));
+        pos += package.length();
+
+        std::string_view name;
+        std::size_t const n(package.find("<name>"));
+        if(n != std::string_view::npos)
+        {
+            std::size_t const e(package.find("</name>", n));
+            if(e != std::string_view::npos)
+            {
+                name = trim(package.substr(n + 6, e - n - 6));
+            }
+        }
+
+        std::size_t const v(package.find("<version "));
+        if(v == std::string_view::npos)
+        {
+            continue;
+        }
+        std::size_t const e(package.find('>', v));
+        std::string_view const tag(package.substr(v, e == std::string_view::npos ? std::string_view::npos : e - v));
+        std::string_view const epoch(get_attribute(tag, "epoch"));
+        std::string_view const ver(get_attribute(tag, "ver"));
+        std::string_view const rel(get_attribute(tag, "rel"));
+
+        version.clear();
+        if(!epoch.empty() && epoch != "0")
+        {
+            version += epoch;
+            version += ':';
+        }
+        version += ver;
+        if(!rel.empty())
+        {
+            version += '-';
+            version += rel;
+        }
+        check_version(name, version, work, canonical, result);
+    }
+}
+
+
+format_t detect_format(char const * data, std::size_t size)
+{
+    std::string_view const head(data, std::min<std::size_t>(size, 1024));
+    if(head.find("<?xml") != std::string_view::npos
+    || head.find("<metadata") != std::string_view::npos)
+    {
+        return format_t::FORMAT_RPM;
+    }
+    return format_t::FORMAT_DEBIAN;
+}
+
+
+/** \brief Cut the file in chunks aligned on packages.
+ *
+ * Each boundary, except the first and last, is moved forward to the
+ * start of the next package: after an empty line in a Debian file or at
+ * the next `<package` tag in a primary.xml file.
+ */
+std::vector<char const *> get_chunks(char const * data, std::size_t size, format_t format)
+{
+    std::vector<char const *> bounds;
+    bounds.push_back(data);
+    std::string_view const input(data, size);
+    for(std::size_t pos(CHUNK_SIZE); pos < size; pos += CHUNK_SIZE)
+    {
+        std::size_t const previous(bounds.back() - data);
+        if(pos <= previous)
+        {
+            continue;
+        }
+        std::size_t next(std::string_view::npos);
+        if(format == format_t::FORMAT_RPM)
+        {
+            next = input.find("<package", pos);
+        }
+        else
+        {
+            next = input.find("\n\n", pos);
+            if(next != std::string_view::npos)
+            {
+                next += 2;
+            }
+        }
+        if(next == std::string_view::npos)
+        {
+            break;
+        }
+        bounds.push_back(data + next);
+    }
+    bounds.push_back(data + size);
+    return bounds;
+}
+
+
+void merge(scan_result_t & to, scan_result_t & from)
+{
+    to.f_count += from.f_count;
+    for(auto & n : from.f_newest)
+    {
+        newest_t & newest(to.f_newest[n.first]);
+        if(newest.f_trait == nullptr
+        || n.second.f_trait->compare(newest.f_trait) > 0)
+        {
+            newest = std::move(n.second);
+        }
+    }
+    std::move(from.f_invalid.begin(), from.f_invalid.end(), std::back_inserter(to.f_invalid));
+    std::move(from.f_non_canonical.begin(), from.f_non_canonical.end(), std::back_inserter(to.f_non_canonical));
+}
+
+
+/** \brief Scan one file.
+ *
+ * The Debian and RPM versions do not compare the same way, so the caller
+ * keeps one result per format and this function returns the format of
+ * the file so the caller knows where to merge the results.
+ */
+format_t scan_file(char const * data, std::size_t size, scan_result_t & result)
+{
+    format_t const format(g_format == format_t::FORMAT_AUTO
+                            ? detect_format(data, size)
+                            : g_format);
+    std::vector<char const *> const bounds(get_chunks(data, size, format));
+    std::size_t const chunks(bounds.size() - 1);
+
+    std::size_t threads(g_threads == 0 ? std::max(1U, std::thread::hardware_concurrency()) : g_threads);
+    threads = std::max<std::size_t>(1, std::min(threads, chunks));
+
+    std::atomic<std::size_t> next_chunk(0);
+    std::vector<scan_result_t> results(threads);
+    auto worker([&](std::size_t id)
+        {
+            for(;;)
+            {
+                std::size_t const idx(next_chunk.fetch_add(1, std::memory_order_relaxed));
+                if(idx >= chunks)
+                {
+                    return;
+                }
+                if(format == format_t::FORMAT_RPM)
+                {
+                    scan_rpm(bounds[idx], bounds[idx + 1], results[id]);
+                }
+                else
+                {
+                    scan_debian(bounds[idx], bounds[idx + 1], results[id]);
+                }
+            }
+        });
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(threads - 1);
+    for(std::size_t id(1); id < threads; ++id)
+    {
+        futures.push_back(std::async(std::launch::async, worker, id));
+    }
+    worker(0);
+    for(auto & f : futures)
+    {
+        f.get();
+    }
+
+    for(auto & r : results)
+    {
+        merge(result, r);
+    }
+
+    return format;
+}
+
+
+void print_reports(char const * what, std::vector<report_t> & reports)
+{
+    std::sort(
+          reports.begin()
+        , reports.end()
+        , [](report_t const & a, report_t const & b)
+        {
+            return a.f_package == b.f_package
+                    ? a.f_version < b.f_version
+                    : a.f_package < b.f_package;
+        });
+    for(auto const & r : reports)
+    {
+        std::cout
+            << what << '\t'
+            << r.f_package << '\t'
+            << r.f_version << '\t'
+            << r.f_message << '\n';
+    }
+}
+
+
+void print_results(scan_result_t & result)
+{
+    if(g_show_newest)
+    {
+        std::vector<std::string_view> names;
+        names.reserve(result.f_newest.size());
+        for(auto const & n : result.f_newest)
+        {
+            names.push_back(n.first);
+        }
+        std::sort(names.begin(), names.end());
+        for(auto const & n : names)
+        {
+            std::cout
+                << "newest\t"
+                << n << '\t'
+                << result.f_newest[n].f_version << '\n';
+        }
+    }
+    if(g_show_invalid)
+    {
+        print_reports("invalid", result.f_invalid);
+    }
+    if(g_show_non_canonical)
+    {
+        print_reports("non-canonical", result.f_non_canonical);
+    }
+}
+
+
+void print_summary(scan_result_t const & result, char const * what)
+{
+    std::cerr
+        << g_progname
+        << ": "
+        << what
+        << ": "
+        << result.f_count
+        << " version(s) in "
+        << result.f_newest.size()
+        << " package(s), "
+        << result.f_invalid.size()
+        << " invalid, "
+        << result.f_non_canonical.size()
+        << " not canonical.\n";
+}
+
+
+
+}
+// no name namespace
+
+
+void usage()
+{
+    std::cout
+        << "Usage: " << g_progname << " [--opts] <file> ...\n"
+           "where <file> is a Debian Packages or Sources file or an RPM primary.xml file\n"
+           "and --opts is one or more of:\n"
+           "  -d | --debian           the files are Debian Packages or Sources files\n"
+           "  -h | --help             print out this help screen\n"
+           "  -i | --invalid          only report the versions which are not valid\n"
+           "  -c | --non-canonical    only report the versions which are not canonical\n"
+           "  -n | --newest           only report the newest version of each package\n"
+           "  -r | --rpm              the files are RPM primary.xml files\n"
+           "  -t | --threads <N>      use N threads (default: one per CPU)\n"
+           "  -V | --version          print out the version\n"
+           "\n"
+           "by default the format is detected from the first bytes of each file and\n"
+           "all the reports are printed, one per line, with tab separated fields:\n"
+           "  newest         <package> <version>\n"
+           "  invalid        <package> <version> <error>\n"
+           "  non-canonical  <package> <version> <canonical version>\n";
+}
+
+
+int main(int argc, char * argv[])
+{
+    g_progname = snapdev::pathinfo::basename(std::string(argv[0]));
+
+    bool only(false);
+    auto set_only([&only](bool & show)
+        {
+            if(!only)
+            {
+                only = true;
+                g_show_newest = false;
+                g_show_invalid = false;
+                g_show_non_canonical = false;
+            }
+            show = true;
+        });
+
+    for(int i(1); i < argc; ++i)
+    {
+        if(argv[i][0] == '-')
+        {
+            if(strcmp(argv[i], "--version") == 0
+            || strcmp(argv[i], "-V") == 0)
+            {
+                std::cout << VERSIONTHECA_VERSION_STRING << '\n';
+                return 0;
+            }
+            if(strcmp(argv[i], "--help") == 0
+            || strcmp(argv[i], "-h") == 0)
+            {
+                usage();
+                return 0;
+            }
+            if(strcmp(argv[i], "--debian") == 0
+            || strcmp(argv[i], "-d") == 0)
+            {
+                g_format = format_t::FORMAT_DEBIAN;
+                continue;
+            }
+            if(strcmp(argv[i], "--rpm") == 0
+            || strcmp(argv[i], "-r") == 0)
+            {
+                g_format = format_t::FORMAT_RPM;
+                continue;
+            }
+            if(strcmp(argv[i], "--newest") == 0
+            || strcmp(argv[i], "-n") == 0)
+            {
+                set_only(g_show_newest);
+                continue;
+            }
+            if(strcmp(argv[i], "--invalid") == 0
+            || strcmp(argv[i], "-i") == 0)
+            {
+                set_only(g_show_invalid);
+                continue;
+            }
+            if(strcmp(argv[i], "--non-canonical") == 0
+            || strcmp(argv[i], "-c") == 0)
+            {
+                set_only(g_show_non_canonical);
+                continue;
+            }
+            if(strcmp(argv[i], "--threads") == 0
+            || strcmp(argv[i], "-t") == 0)
+            {
+                ++i;
+                if(i >= argc)
+                {
+                    std::cerr << "error: the --threads option must be followed by a number.\n";
+                    return 2;
+                }
+                g_threads = std::atol(argv[i]);
+                continue;
+            }
+            std::cerr << "error: unknown option \"" << argv[i] << "\".\n";
+            return 2;
+        }
+        g_filenames.push_back(argv[i]);
+    }
+
+    if(g_filenames.empty())
+    {
+        std::cerr << "error: at least one filename is required.\n";
+        return 2;
+    }
+
+    // the names saved in the results point to the file data so the files
+    // remain mapped until the results are printed
+    //
+    std::vector<std::shared_ptr<char const>> files;
+    scan_result_t debian_result;
+    scan_result_t rpm_result;
+    for(auto const & filename : g_filenames)
+    {
+        try
+        {
+            std::size_t size(0);
+            files.push_back(versiontheca::detail::map_file(filename, "input", 1, size));
+            scan_result_t result;
+            if(scan_file(files.back().get(), size, result) == format_t::FORMAT_RPM)
+            {
+                merge(rpm_result, result);
+            }
+            else
+            {
+                merge(debian_result, result);
+            }
+        }
+        catch(versiontheca::versiontheca_exception const & e)
+        {
+            std::cerr << "error: " << e.what() << '\n';
+            ++g_errcnt;
+        }
+    }
+
+    if(debian_result.f_count > 0)
+    {
+        print_results(debian_result);
+        print_summary(debian_result, "debian");
+    }
+    if(rpm_result.f_count > 0)
+    {
+        print_results(rpm_result);
+        print_summary(rpm_result, "rpm");
+    }
+
+    if(g_errcnt > 0)
+    {
+        return 2;
+    }
+    return debian_result.f_invalid.empty()
+        && rpm_result.f_invalid.empty() ? 0 : 1;
+}
+
+
+// vim: ts=4 sw=4 et
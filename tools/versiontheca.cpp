@@ -27,11 +27,16 @@
 // versiontheca
 //
 #include    <versiontheca/basic.h>
+#include    <versiontheca/compare_strings.h>
 #include    <versiontheca/debian.h>
 #include    <versiontheca/decimal.h>
+#include    <versiontheca/detect.h>
 #include    <versiontheca/exception.h>
+#include    <versiontheca/instrumentation.h>
+#include    <versiontheca/range.h>
 #include    <versiontheca/roman.h>
 #include    <versiontheca/rpm.h>
+#include    <versiontheca/sort.h>
 #include    <versiontheca/unicode.h>
 #include    <versiontheca/version.h>
 #include    <versiontheca/versiontheca.h>
@@ -42,6 +47,7 @@
 //
 #include    <snapdev/pathinfo.h>
 #include    <snapdev/not_reached.h>
+#include    <snapdev/tokenize_string.h>
 
 
 // C++
@@ -74,12 +80,19 @@ enum class function_t
 
     FUNCTION_CANONICALIZE,
     FUNCTION_COMPARE,
+    FUNCTION_DETECT,
+    FUNCTION_MAX,
     FUNCTION_NEXT,
     FUNCTION_PREVIOUS,
+    FUNCTION_SORT,
+    FUNCTION_UNIQUE,
     FUNCTION_VALIDATE,
 };
 
+
 function_t                  g_function = function_t::FUNCTION_COMPARE;
+bool                        g_stdin = false;
+char                        g_delimiter = '\n';
 int                         g_limit = 0;
 int                         g_errcnt = 0;
 int                         g_position = -1;
@@ -94,7 +107,7 @@ void set_function(function_t f)
     if(g_function != function_t::FUNCTION_DEFAULT)
     {
         ++g_errcnt;
-        std::cerr << "error: only one of --canonicalize, --compare, --next, --previous, --validate can be used on the command line.\n";
+        std::cerr << "error: only one of --canonicalize, --compare, --detect, --max, --next, --previous, --sort, --unique, --validate can be used on the command line.\n";
         exit(1);
     }
     g_function = f;
@@ -127,13 +140,22 @@ void usage()
            "  -c | --compare       compare versions (this is the default)\n"
            "  -d | --debian        read versions as Debian versions\n"
            "  -F | --decimal       read versions as decimal numbers\n"
+           "  -D | --detect        print the trait detected for each version\n"
            "  -h | --help          print out this help screen\n"
-           "  -l | --limit <N>     compare the first N parts\n"
+           "  -l | --limit <N>     compare the first N upstream parts (no release)\n"
+           "  -M | --max           print out the largest version\n"
+           "  -0 | --null          with --stdin, records are separated by '\\0'\n"
            "       --maximum-parts print out the MAX_PARTS parameter\n"
            "  -n | --next <N>      compute next versions\n"
            "  -p | --previous <N>  compute previous versions\n"
            "  -R | --roman         read versions as Unicode allowing roman numerals\n"
            "  -r | --rpm           read versions as RPM versions\n"
+           "  -S | --sort          print out the versions sorted\n"
+           "       --statistics    print the library counters to stderr on exit\n"
+           "  -s | --stdin | --batch\n"
+           "                       read the versions from stdin, one per line; with\n"
+           "                       --compare, each line is <version1> <operator> <version2>\n"
+           "  -U | --unique        print out the versions sorted without duplicates\n"
            "  -u | --unicode       read versions as Unicode versions\n"
            "  -v | --validate      validate versions (instead of comparing)\n"
            "  -V | --version       print out the version\n"
@@ -145,7 +167,12 @@ void usage()
            "  <  | lt              return true if version1 is before version2\n"
            "  <= | le              return true if version1 is before or equal to version2\n"
            "  >  | gt              return true if version1 is after version2\n"
-           "  >= | ge              return true if version1 is after or equal to version2\n";
+           "  >= | ge              return true if version1 is after or equal to version2\n"
+           "\n"
+           "with --stdin, one result is written per record: the version for --canonicalize,\n"
+           "--next, and --previous, \"valid\" or \"invalid\" for --validate, and \"true\" or\n"
+           "\"false\" for --compare; records with errors output an empty line and the\n"
+           "error is written to stderr.\n";
 }
 
 
@@ -186,89 +213,87 @@ versiontheca::versiontheca::pointer_t create_version(std::string const & v)
 }
 
 
-void compare()
+versiontheca::trait_kind_t get_trait_kind()
 {
-    if(g_versions.size() != 3)
+    switch(g_version_type)
     {
-        std::cerr << "error: in --compare mode, you must specified exactly three parameters: <version1> <operator> <version2>\n";
-        ++g_errcnt;
-        return;
-    }
+    case version_type_t::VERSION_TYPE_DEFAULT:
+        throw versiontheca::logic_error("get_trait_kind() called with version type still set to 'DEFAULT'.");
 
-    versiontheca::versiontheca::pointer_t version1(create_version(g_versions[0]));
-    if(!version1->is_valid())
-    {
-        std::cerr
-            << "error: invalid left hand side version \""
-            << g_versions[0]
-            << "\n";
-        ++g_errcnt;
-        return;
-    }
+    case version_type_t::VERSION_TYPE_BASIC:
+        return versiontheca::trait_kind_t::TRAIT_KIND_BASIC;
 
-    versiontheca::versiontheca::pointer_t version2(create_version(g_versions[2]));
-    if(!version2->is_valid())
-    {
-        std::cerr
-            << "error: invalid right hand side version \""
-            << g_versions[2]
-            << "\n";
-        ++g_errcnt;
-        return;
-    }
+    case version_type_t::VERSION_TYPE_DEBIAN:
+        return versiontheca::trait_kind_t::TRAIT_KIND_DEBIAN;
 
-    std::string op(g_versions[1]);
+    case version_type_t::VERSION_TYPE_ROMAN:
+        return versiontheca::trait_kind_t::TRAIT_KIND_ROMAN;
 
-    if(op == "=="
-    || op == "="        // extension, there is assignment so just one '=' is fine
-    || op == "eq")
-    {
-        exit(*version1 == *version2 ? 0 : 1);
-        return;
-    }
+    case version_type_t::VERSION_TYPE_RPM:
+        return versiontheca::trait_kind_t::TRAIT_KIND_RPM;
+
+    case version_type_t::VERSION_TYPE_UNICODE:
+        return versiontheca::trait_kind_t::TRAIT_KIND_UNICODE;
+
+    case version_type_t::VERSION_TYPE_DECIMAL:
+        return versiontheca::trait_kind_t::TRAIT_KIND_DECIMAL;
 
-    if(op == "!="
-    || op == "<>"       // extension, like SQL
-    || op == "ne")
-    {
-        exit(*version1 != *version2 ? 0 : 1);
-        return;
     }
+    snapdev::NOT_REACHED();
+}
 
-    if(op == "<"
-    || op == "lt")
+
+void compare()
+{
+    if(g_versions.size() != 3)
     {
-        exit(*version1 < *version2 ? 0 : 1);
+        std::cerr << "error: in --compare mode, you must specified exactly three parameters: <version1> <operator> <version2>\n";
+        ++g_errcnt;
         return;
     }
 
-    if(op == "<="
-    || op == "le")
+    // compare_strings() avoids allocating the two versions
+    //
+    int r(0);
+    try
     {
-        exit(*version1 <= *version2 ? 0 : 1);
-        return;
+        r = g_limit > 0
+                ? versiontheca::compare_strings(get_trait_kind(), g_versions[0], g_versions[2], static_cast<std::size_t>(g_limit))
+                : versiontheca::compare_strings(get_trait_kind(), g_versions[0], g_versions[2]);
     }
-
-    if(op == ">"
-    || op == "gt")
+    catch(versiontheca::invalid_version const &)
     {
-        exit(*version1 > *version2 ? 0 : 1);
+        versiontheca::versiontheca::pointer_t version1(create_version(g_versions[0]));
+        if(!version1->is_valid())
+        {
+            std::cerr
+                << "error: invalid left hand side version \""
+                << g_versions[0]
+                << "\n";
+        }
+        else
+        {
+            std::cerr
+                << "error: invalid right hand side version \""
+                << g_versions[2]
+                << "\n";
+        }
+        ++g_errcnt;
         return;
     }
 
-    if(op == ">="
-    || op == "ge")
+    versiontheca::operator_t const op(versiontheca::get_operator(g_versions[1]));
+    if(op == versiontheca::operator_t::OPERATOR_UNKNOWN)
     {
-        exit(*version1 >= *version2 ? 0 : 1);
+        std::cerr
+            << "error: unrecognized operator \""
+            << g_versions[1]
+            << "\".\n";
+        ++g_errcnt;
         return;
     }
 
-    std::cerr
-        << "error: unrecognized operator \""
-        << op
-        << "\".\n";
-
-    ++g_errcnt;
+    exit(versiontheca::apply_operator(op, r) ? 0 : 1);
 }
 
 
@@ -281,6 +306,9 @@ void canonicalize(bool display)
         return;
     }
 
+    // the same buffer is reused for all the versions
+    //
+    std::string canonical;
     for(auto const & v : g_versions)
     {
         versiontheca::versiontheca::pointer_t version(create_version(v));
@@ -296,7 +324,40 @@ void canonicalize(bool display)
         }
         else if(display)
         {
-            std::cout << version->get_version() << '\n';
+            canonical.clear();
+            version->append_version(canonical);
+            canonical += '\n';
+            std::cout.write(canonical.data(), canonical.length());
+        }
+    }
+
+    exit(g_errcnt > 0 ? 1 : 0);
+}
+
+
+void detect()
+{
+    if(g_versions.empty())
+    {
+        std::cerr << "error: in --detect mode, you must specified at least one version.\n";
+        ++g_errcnt;
+        return;
+    }
+
+    for(auto const & v : g_versions)
+    {
+        versiontheca::trait_kind_t kind(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE);
+        if(versiontheca::detect_trait(v, &kind) == nullptr)
+        {
+            std::cerr
+                << "error: version \""
+                << v
+                << "\" is not accepted by any trait.\n";
+            ++g_errcnt;
+        }
+        else
+        {
+            std::cout << versiontheca::trait_kind_to_string(kind) << '\n';
         }
     }
 
@@ -432,6 +493,291 @@ void previous()
 }
 
 
+void sort(bool unique)
+{
+    if(g_versions.empty())
+    {
+        std::cerr << "error: in --sort or --unique mode, you must specified at least one version.\n";
+        ++g_errcnt;
+        return;
+    }
+
+    try
+    {
+        std::vector<std::string> const sorted(unique
+                ? versiontheca::unique_versions(get_trait_kind(), g_versions)
+                : versiontheca::sort_versions(get_trait_kind(), g_versions));
+        for(auto const & v : sorted)
+        {
+            std::cout << v << '\n';
+        }
+    }
+    catch(versiontheca::invalid_version const & e)
+    {
+        std::cerr << "error: " << e.what() << "\n";
+        ++g_errcnt;
+        return;
+    }
+
+    exit(0);
+}
+
+
+void maximum()
+{
+    if(g_versions.empty())
+    {
+        std::cerr << "error: in --max mode, you must specified at least one version.\n";
+        ++g_errcnt;
+        return;
+    }
+
+    try
+    {
+        std::cout << versiontheca::max_version(get_trait_kind(), g_versions) << '\n';
+    }
+    catch(versiontheca::invalid_version const & e)
+    {
+        std::cerr << "error: " << e.what() << "\n";
+        ++g_errcnt;
+        return;
+    }
+
+    exit(0);
+}
+
+
+void record_error(std::size_t record, std::string const & msg)
+{
+    std::cerr
+        << "error:"
+        << record
+        << ": "
+        << msg
+        << '\n';
+    ++g_errcnt;
+}
+
+
+void process_record(
+      std::size_t record
+    , std::string const & line
+    , versiontheca::versiontheca & lhs
+    , versiontheca::versiontheca & rhs)
+{
+    switch(g_function)
+    {
+    case function_t::FUNCTION_DEFAULT:
+    case function_t::FUNCTION_MAX:
+    case function_t::FUNCTION_SORT:
+    case function_t::FUNCTION_UNIQUE:
+        throw versiontheca::logic_error("process_record() called with a function which works on the whole set of versions.");
+
+    case function_t::FUNCTION_COMPARE:
+        {
+            std::vector<std::string> params;
+            snapdev::tokenize_string(params, line, " \t\r\n", true);
+            if(params.size() != 3)
+            {
+                record_error(record, "expected exactly three parameters: <version1> <operator> <version2>.");
+                break;
+            }
+            versiontheca::operator_t const op(versiontheca::get_operator(params[1]));
+            if(op == versiontheca::operator_t::OPERATOR_UNKNOWN)
+            {
+                record_error(record, "unrecognized operator \"" + params[1] + "\".");
+                break;
+            }
+            if(!lhs.set_version(params[0]))
+            {
+                record_error(record, "invalid left hand side version \"" + params[0] + "\": " + lhs.get_last_error());
+                break;
+            }
+            if(!rhs.set_version(params[2]))
+            {
+                record_error(record, "invalid right hand side version \"" + params[2] + "\": " + rhs.get_last_error());
+                break;
+            }
+            int const r(g_limit > 0 ? lhs.compare(rhs, static_cast<std::size_t>(g_limit)) : lhs.compare(rhs));
+            std::cout << (versiontheca::apply_operator(op, r) ? "true\n" : "false\n");
+        }
+        return;
+
+    case function_t::FUNCTION_CANONICALIZE:
+        if(!lhs.set_version(line))
+        {
+            record_error(record, "version \"" + line + "\" is not considered valid: " + lhs.get_last_error());
+            break;
+        }
+        std::cout << lhs.get_version() << '\n';
+        return;
+
+    case function_t::FUNCTION_DETECT:
+        {
+            versiontheca::trait_kind_t kind(versiontheca::trait_kind_t::TRAIT_KIND_UNICODE);
+            if(versiontheca::detect_trait(line, &kind) == nullptr)
+            {
+                record_error(record, "version \"" + line + "\" is not accepted by any trait.");
+                break;
+            }
+            std::cout << versiontheca::trait_kind_to_string(kind) << '\n';
+        }
+        return;
+
+    case function_t::FUNCTION_VALIDATE:
+        if(lhs.set_version(line))
+        {
+            std::cout << "valid\n";
+        }
+        else
+        {
+            std::cout << "invalid\n";
+            ++g_errcnt;
+        }
+        return;
+
+    case function_t::FUNCTION_NEXT:
+    case function_t::FUNCTION_PREVIOUS:
+        {
+            if(!lhs.set_version(line))
+            {
+                record_error(record, "version \"" + line + "\" is not valid.");
+                break;
+            }
+            int const position(g_position < 0 ? static_cast<int>(lhs.size()) - 1 : g_position);
+            bool const r(g_function == function_t::FUNCTION_NEXT
+                            ? lhs.next(position)
+                            : lhs.previous(position));
+            if(!r)
+            {
+                record_error(record, "could not compute "
+                        + std::string(g_function == function_t::FUNCTION_NEXT ? "next" : "previous")
+                        + " version for \"" + line + "\".");
+                break;
+            }
+            std::cout << lhs.get_version() << '\n';
+        }
+        return;
+
+    }
+
+    // keep one output line per record
+    //
+    std::cout << '\n';
+}
+
+
+void process_stdin()
+{
+    // the output is only flushed when the buffer is full or at the end
+    //
+    std::ios_base::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    // the same two objects (and their traits) are used for all the records
+    //
+    versiontheca::versiontheca::pointer_t lhs(create_version(std::string()));
+    versiontheca::versiontheca::pointer_t rhs(create_version(std::string()));
+
+    versiontheca::versiontheca::pointer_t format;
+    if(!g_format.empty())
+    {
+        format = create_version(g_format);
+        if(!format->is_valid())
+        {
+            std::cerr
+                << "error: format version \""
+                << g_format
+                << "\" is not valid.\n";
+            ++g_errcnt;
+            return;
+        }
+        lhs->set_format(*format);
+    }
+
+    std::string line;
+    switch(g_function)
+    {
+    case function_t::FUNCTION_MAX:
+    case function_t::FUNCTION_SORT:
+    case function_t::FUNCTION_UNIQUE:
+        // these functions need all the versions first
+        //
+        while(std::getline(std::cin, line, g_delimiter))
+        {
+            g_versions.push_back(line);
+        }
+        if(g_function == function_t::FUNCTION_MAX)
+        {
+            maximum();
+        }
+        else
+        {
+            sort(g_function == function_t::FUNCTION_UNIQUE);
+        }
+        return;
+
+    default:
+        for(std::size_t record(1); std::getline(std::cin, line, g_delimiter); ++record)
+        {
+            // a record which makes the library throw (i.e. too many parts)
+            // is an error like any other, the following records still
+            // get processed
+            //
+            try
+            {
+                process_record(record, line, *lhs, *rhs);
+            }
+            catch(versiontheca::versiontheca_exception const & e)
+            {
+                record_error(record, e.what());
+                std::cout << '\n';
+            }
+        }
+        break;
+
+    }
+    std::cout.flush();
+
+    exit(g_errcnt > 0 ? 1 : 0);
+}
+
+
+void print_statistics()
+{
+    if(!versiontheca::is_instrumentation_enabled())
+    {
+        std::cerr << "statistics: the library was compiled without VERSIONTHECA_INSTRUMENTATION.\n";
+        return;
+    }
+
+    versiontheca::statistics_t const statistics(versiontheca::get_statistics());
+    for(std::size_t slot(0); slot < versiontheca::STATISTICS_SLOT_COUNT; ++slot)
+    {
+        versiontheca::trait_statistics_t const & s(statistics.f_traits[slot]);
+        if(s.f_parses == 0
+        && s.f_compares == 0
+        && s.f_nexts == 0
+        && s.f_previouses == 0
+        && s.f_allocations == 0)
+        {
+            continue;
+        }
+        std::cerr
+            << "statistics: "
+            << versiontheca::get_statistics_slot_name(slot)
+            << ": parses=" << s.f_parses
+            << " failures=" << s.f_parse_failures
+            << " parts=" << s.f_parts
+            << " compares=" << s.f_compares
+            << " next=" << s.f_nexts
+            << " previous=" << s.f_previouses
+            << " allocations=" << s.f_allocations
+            << '\n';
+    }
+}
+
+
 int main(int argc, char * argv[])
 {
     g_progname = snapdev::pathinfo::basename(std::string(argv[0]));
@@ -467,6 +813,30 @@ int main(int argc, char * argv[])
                 set_function(function_t::FUNCTION_COMPARE);
                 continue;
             }
+            if(strcmp(argv[i], "--detect") == 0
+            || strcmp(argv[i], "-D") == 0)
+            {
+                set_function(function_t::FUNCTION_DETECT);
+                continue;
+            }
+            if(strcmp(argv[i], "--max") == 0
+            || strcmp(argv[i], "-M") == 0)
+            {
+                set_function(function_t::FUNCTION_MAX);
+                continue;
+            }
+            if(strcmp(argv[i], "--sort") == 0
+            || strcmp(argv[i], "-S") == 0)
+            {
+                set_function(function_t::FUNCTION_SORT);
+                continue;
+            }
+            if(strcmp(argv[i], "--unique") == 0
+            || strcmp(argv[i], "-U") == 0)
+            {
+                set_function(function_t::FUNCTION_UNIQUE);
+                continue;
+            }
             if(strcmp(argv[i], "--next") == 0
             || strcmp(argv[i], "-n") == 0)
             {
@@ -521,6 +891,19 @@ int main(int argc, char * argv[])
                 g_format = argv[i];
                 continue;
             }
+            if(strcmp(argv[i], "--stdin") == 0
+            || strcmp(argv[i], "--batch") == 0
+            || strcmp(argv[i], "-s") == 0)
+            {
+                g_stdin = true;
+                continue;
+            }
+            if(strcmp(argv[i], "--null") == 0
+            || strcmp(argv[i], "-0") == 0)
+            {
+                g_delimiter = '\0';
+                continue;
+            }
             if(strcmp(argv[i], "--validate") == 0
             || strcmp(argv[i], "-v") == 0)
             {
@@ -575,6 +958,11 @@ int main(int argc, char * argv[])
                 set_version_type(version_type_t::VERSION_TYPE_BASIC);
                 continue;
             }
+            if(strcmp(argv[i], "--statistics") == 0)
+            {
+                atexit(print_statistics);
+                continue;
+            }
             if(strcmp(argv[i], "--maximum-parts") == 0)
             {
                 std::cout << versiontheca::MAX_PARTS << "\n";
@@ -601,6 +989,17 @@ int main(int argc, char * argv[])
         set_version_type(version_type_t::VERSION_TYPE_DEBIAN);
     }
 
+    if(g_stdin)
+    {
+        if(!g_versions.empty())
+        {
+            std::cerr << "error: versions cannot be specified on the command line when --stdin is used.\n";
+            return 2;
+        }
+        process_stdin();
+        return g_errcnt > 0 ? 2 : 0;
+    }
+
     switch(g_function)
     {
     case function_t::FUNCTION_DEFAULT:
@@ -614,6 +1013,22 @@ int main(int argc, char * argv[])
         canonicalize(true);
         break;
 
+    case function_t::FUNCTION_DETECT:
+        detect();
+        break;
+
+    case function_t::FUNCTION_MAX:
+        maximum();
+        break;
+
+    case function_t::FUNCTION_SORT:
+        sort(false);
+        break;
+
+    case function_t::FUNCTION_UNIQUE:
+        sort(true);
+        break;
+
     case function_t::FUNCTION_VALIDATE:
         canonicalize(false);
         break;
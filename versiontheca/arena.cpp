@@ -0,0 +1,167 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the version arena.
+ *
+ * The arena forwards the allocations to a monotonic buffer resource and
+ * keeps track of the number of blocks in use so release() can verify
+ * that no trait still points to its memory.
+ */
+
+// self
+//
+#include    <versiontheca/arena.h>
+
+#include    <versiontheca/exception.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+/** \brief Initialize an arena.
+ *
+ * The \p initial_size is the size of the first block requested from
+ * \p upstream. Each following block is larger than the previous one.
+ * When 0, the monotonic buffer chooses its own initial size.
+ *
+ * \param[in] initial_size  The size of the first block in bytes.
+ * \param[in] upstream  The resource the blocks are allocated from.
+ */
+version_arena::version_arena(
+          std::size_t initial_size
+        , std::pmr::memory_resource * upstream)
+    : f_buffer(initial_size == 0
+            ? std::pmr::monotonic_buffer_resource(upstream)
+            : std::pmr::monotonic_buffer_resource(initial_size, upstream))
+{
+}
+
+
+/** \brief Allocate a trait in this arena.
+ *
+ * \param[in] kind  The kind of trait to allocate.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t version_arena::create_trait(trait_kind_t kind)
+{
+    return ::versiontheca::create_trait(kind, this);
+}
+
+
+/** \brief Allocate and parse a version in this arena.
+ *
+ * Both, the versiontheca object and its trait, are allocated in the
+ * arena. The version may be invalid, check is_valid() as usual.
+ *
+ * \param[in] kind  The kind of trait used to parse \p v.
+ * \param[in] v  The version to parse.
+ *
+ * \return A pointer to the new version.
+ */
+versiontheca::pointer_t version_arena::create_version(trait_kind_t kind, std::string_view const & v)
+{
+    return std::allocate_shared<versiontheca>(
+                  std::pmr::polymorphic_allocator<versiontheca>(this)
+                , create_trait(kind)
+                , v);
+}
+
+
+/** \brief Get the number of allocations still in use.
+ *
+ * \return The number of blocks allocated and not yet deallocated.
+ */
+std::size_t version_arena::get_live_allocations() const
+{
+    return f_live_allocations;
+}
+
+
+/** \brief Get the number of bytes allocated since the last release().
+ *
+ * The memory of deallocated blocks is not reused, so this number only
+ * grows until release() gets called.
+ *
+ * \return The number of bytes requested from the arena.
+ */
+std::size_t version_arena::get_allocated_bytes() const
+{
+    return f_allocated_bytes;
+}
+
+
+/** \brief Release all the memory at once.
+ *
+ * \exception logic_error
+ * If some traits or versions allocated in this arena are still in use,
+ * releasing the memory would leave them dangling so the function raises
+ * this exception instead.
+ */
+void version_arena::release()
+{
+    if(f_live_allocations != 0)
+    {
+        throw logic_error(
+                  "version_arena::release() called with "
+                + std::to_string(f_live_allocations)
+                + " allocation(s) still in use.");
+    }
+    f_buffer.release();
+    f_allocated_bytes = 0;
+}
+
+
+void * version_arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void * p(f_buffer.allocate(bytes, alignment));
+    ++f_live_allocations;
+    f_allocated_bytes += bytes;
+    return p;
+}
+
+
+void version_arena::do_deallocate(void * p, std::size_t bytes, std::size_t alignment)
+{
+    // this is a no-op in the monotonic buffer, the memory is reclaimed
+    // by release()
+    //
+    f_buffer.deallocate(p, bytes, alignment);
+    --f_live_allocations;
+}
+
+
+bool version_arena::do_is_equal(std::pmr::memory_resource const & other) const noexcept
+{
+    return this == &other;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,86 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Memory arena for bulk jobs.
+ *
+ * Parsing a large number of versions allocates one trait per version.
+ * With a version_arena, these traits (and their shared pointer control
+ * blocks) are carved out of large blocks of a monotonic buffer and all
+ * the memory gets released at once with release() or when the arena is
+ * destroyed, instead of being freed one trait at a time.
+ *
+ * The arena counts the allocations still in use. The traits must all be
+ * destroyed before the arena is released; release() throws otherwise.
+ *
+ * A version_arena is not thread safe. Use one arena per thread.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+#include    <versiontheca/versiontheca.h>
+
+
+// C++
+//
+#include    <memory_resource>
+
+
+
+namespace versiontheca
+{
+
+
+
+class version_arena
+    : public std::pmr::memory_resource
+{
+public:
+                        version_arena(
+                              std::size_t initial_size = 0
+                            , std::pmr::memory_resource * upstream = std::pmr::get_default_resource());
+                        version_arena(version_arena const &) = delete;
+    version_arena &     operator = (version_arena const &) = delete;
+
+    trait::pointer_t    create_trait(trait_kind_t kind);
+    versiontheca::pointer_t
+                        create_version(trait_kind_t kind, std::string_view const & v);
+
+    std::size_t         get_live_allocations() const;
+    std::size_t         get_allocated_bytes() const;
+    void                release();
+
+protected:
+    virtual void *      do_allocate(std::size_t bytes, std::size_t alignment) override;
+    virtual void        do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override;
+    virtual bool        do_is_equal(std::pmr::memory_resource const & other) const noexcept override;
+
+private:
+    std::pmr::monotonic_buffer_resource
+                        f_buffer;
+    std::size_t         f_live_allocations = 0;
+    std::size_t         f_allocated_bytes = 0;
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -35,6 +35,9 @@
 //
 #include    <versiontheca/basic.h>
 
+#include    <versiontheca/policy.h>
+#include    <versiontheca/probe.h>
+
 
 
 // C++
@@ -53,8 +56,22 @@ namespace versiontheca
 
 
 
-bool basic::parse(std::string const & v)
+/** \brief Create a copy of this basic trait.
+ *
+ * The copy includes the parts and the last error.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t basic::clone() const
 {
+    return std::make_shared<basic>(*this);
+}
+
+
+bool basic::parse(std::string_view const & v)
+{
+    VERSIONTHECA_PROBE_PARSE(*this, v);
+
     if(!trait::parse(v))
     {
         return false;
@@ -67,7 +84,7 @@ bool basic::parse(std::string const & v)
     {
         if(!at(idx).is_integer())
         {
-            f_last_error = "basic versions only support integers separated by periods (.).";
+            set_error(error_code_t::ERROR_CODE_BASIC_NOT_INTEGER);
             return false;
         }
     }
@@ -75,6 +92,12 @@ bool basic::parse(std::string const & v)
 }
 
 
+character_classes_t const * basic::get_character_classes() const
+{
+    return &basic_policy::classes;
+}
+
+
 
 }
 // namespace versiontheca
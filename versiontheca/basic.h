@@ -46,7 +46,11 @@ class basic
 public:
     typedef std::shared_ptr<basic>       pointer_t;
 
-    virtual bool        parse(std::string const & v) override;
+    virtual trait::pointer_t
+                        clone() const override;
+    virtual bool        parse(std::string_view const & v) override;
+    virtual character_classes_t const *
+                        get_character_classes() const override;
 };
 
 
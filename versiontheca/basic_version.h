@@ -0,0 +1,121 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Compile time specialized versions.
+ *
+ * The versiontheca class uses a trait through a shared pointer and virtual
+ * functions. This is flexible but each version requires a heap allocated
+ * trait and the object cannot be copied.
+ *
+ * The basic_version<Policy> template is an alternative where the policy
+ * is defined at compile time. The character classification and comparison
+ * functions get inlined. The object is regular: it can be copied, moved,
+ * compared, and stored by value in containers.
+ *
+ * \code
+ *     versiontheca::debian_version a("1:2.3-rc1");
+ *     versiontheca::debian_version b("1:2.3");
+ *     if(a < b) ...
+ *
+ *     std::vector<versiontheca::rpm_version> list;
+ *     list.emplace_back("1.0^git5");
+ *     std::sort(list.begin(), list.end());
+ * \endcode
+ *
+ * This template supports ASCII versions (Debian, RPM, and basic versions
+ * are all limited to ASCII). For Unicode versions, use the trait classes.
+ *
+ * Invalid versions are considered equal to each other and smaller than
+ * any valid version so they can still be sorted with std::sort().
+ */
+
+// self
+//
+#include    <versiontheca/policy.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+template<typename Policy>
+class basic_version
+{
+public:
+    typedef Policy      policy_t;
+
+                        basic_version() = default;
+
+    explicit            basic_version(std::string_view const & v)
+                        {
+                            set_version(v);
+                        }
+
+    bool set_version(std::string_view const & v)
+    {
+        f_valid = f_parts.assign(v) && Policy::parse(f_parts);
+        return f_valid;
+    }
+
+    bool                is_valid() const { return f_valid; }
+    std::size_t         size() const { return f_valid ? f_parts.size() : 0; }
+    std::string const & get_version() const { return f_parts.get_input(); }
+    version_parts const &
+                        get_parts() const { return f_parts; }
+
+    std::string get_last_error() const
+    {
+        char const * msg(f_parts.get_last_error());
+        return msg == nullptr ? std::string() : std::string(msg);
+    }
+
+    int compare(basic_version const & rhs) const
+    {
+        if(!f_valid || !rhs.f_valid)
+        {
+            return f_valid == rhs.f_valid ? 0 : (f_valid ? 1 : -1);
+        }
+        return Policy::compare(f_parts, rhs.f_parts);
+    }
+
+    bool                operator == (basic_version const & rhs) const { return compare(rhs) == 0; }
+    bool                operator != (basic_version const & rhs) const { return compare(rhs) != 0; }
+    bool                operator <  (basic_version const & rhs) const { return compare(rhs) <  0; }
+    bool                operator <= (basic_version const & rhs) const { return compare(rhs) <= 0; }
+    bool                operator >  (basic_version const & rhs) const { return compare(rhs) >  0; }
+    bool                operator >= (basic_version const & rhs) const { return compare(rhs) >= 0; }
+
+private:
+    version_parts       f_parts = version_parts();
+    bool                f_valid = false;
+};
+
+
+typedef basic_version<basic_policy>     numeric_version;
+typedef basic_version<debian_policy>    debian_version;
+typedef basic_version<rpm_policy>       rpm_version;
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,499 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the batch parser.
+ *
+ * The batch parser reuses one trait to parse any number of versions and
+ * saves the resulting parts in a single pool. The versions are then
+ * accessed by index.
+ */
+
+// self
+//
+#include    <versiontheca/batch.h>
+
+#include    <versiontheca/compare.h>
+#include    <versiontheca/exception.h>
+
+
+// C++
+//
+#include    <algorithm>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+/** \brief Access the parts of one version of the batch pool.
+ *
+ * This adapter lets compare() run the compare functions directly on
+ * the columns, without loading the versions in a trait.
+ */
+class pool_parts
+{
+public:
+                        pool_parts(part const * parts, std::size_t size)
+                            : f_parts(parts)
+                            , f_size(size)
+                        {
+                        }
+
+    std::size_t         size() const { return f_size; }
+    char                get_type(std::size_t idx) const { return f_parts[idx].get_type(); }
+    bool                is_integer(std::size_t idx) const { return f_parts[idx].is_integer(); }
+    part_integer_t      get_integer(std::size_t idx) const { return f_parts[idx].get_integer(); }
+    std::string_view    get_string(std::size_t idx) const { return f_parts[idx].get_string(); }
+    std::uint8_t        get_width(std::size_t idx) const { return f_parts[idx].get_width(); }
+
+private:
+    part const *        f_parts = nullptr;
+    std::size_t         f_size = 0;
+};
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Initialize a batch.
+ *
+ * The batch is assigned a trait kind which is used to parse all the
+ * versions added to it.
+ *
+ * \param[in] kind  The kind of trait used to parse the versions.
+ */
+batch::batch(trait_kind_t kind)
+    : f_kind(kind)
+    , f_trait(create_trait(kind))
+    , f_offsets{ 0 }
+{
+}
+
+
+/** \brief Retrieve the kind of trait used by this batch.
+ *
+ * \return The trait kind specified on construction.
+ */
+trait_kind_t batch::get_kind() const
+{
+    return f_kind;
+}
+
+
+/** \brief Remove all the versions from this batch.
+ *
+ * The buffers are kept allocated so the batch can be reused to parse
+ * another set of versions without reallocating.
+ */
+void batch::clear()
+{
+    f_parts.clear();
+    f_offsets.resize(1);
+    f_status.clear();
+    f_errors.clear();
+}
+
+
+/** \brief Reserve space for a number of versions.
+ *
+ * If you know how many versions you are going to add, calling this
+ * function first avoids reallocations of the columns. When \p parts
+ * is 0, the function assumes about four parts per version.
+ *
+ * \param[in] versions  The number of versions to be added.
+ * \param[in] parts  The total number of parts expected.
+ */
+void batch::reserve(std::size_t versions, std::size_t parts)
+{
+    f_offsets.reserve(versions + 1);
+    f_status.reserve(versions);
+    f_parts.reserve(parts == 0 ? versions * 4 : parts);
+}
+
+
+/** \brief Parse one version and add it to the batch.
+ *
+ * The version gets parsed with the batch trait. If valid, its parts are
+ * appended to the pool of parts. If invalid, no parts are added and the
+ * error message is saved.
+ *
+ * The version is added whether valid or not so the indexes in the batch
+ * match the indexes in your input.
+ *
+ * \param[in] v  The version to parse.
+ *
+ * \return The index of the new version in this batch.
+ */
+std::size_t batch::add(std::string_view const & v)
+{
+    std::size_t const idx(f_status.size());
+
+    batch_status_t status(batch_status_t::BATCH_STATUS_VALID);
+    if(!f_trait->parse(v))
+    {
+        status = v.empty()
+                    ? batch_status_t::BATCH_STATUS_EMPTY
+                    : batch_status_t::BATCH_STATUS_INVALID;
+
+        // the message is only generated by get_last_error()
+        //
+        error_t e;
+        e.f_index = idx;
+        e.f_error = f_trait->get_error();
+        if(error_message_includes_input(e.f_error.f_code))
+        {
+            e.f_input = v;
+        }
+        f_errors.push_back(std::move(e));
+    }
+    else
+    {
+        std::size_t const max(f_trait->size());
+        for(std::size_t pos(0); pos < max; ++pos)
+        {
+            f_parts.push_back(f_trait->at(pos));
+        }
+    }
+    f_trait->clear();
+
+    f_status.push_back(status);
+    f_offsets.push_back(static_cast<std::uint32_t>(f_parts.size()));
+
+    return idx;
+}
+
+
+/** \brief Get the number of versions in this batch.
+ *
+ * \return The number of versions added, including invalid ones.
+ */
+std::size_t batch::size() const
+{
+    return f_status.size();
+}
+
+
+/** \brief Check whether the batch is empty.
+ *
+ * \return true if no versions were added to this batch.
+ */
+bool batch::empty() const
+{
+    return f_status.empty();
+}
+
+
+/** \brief Get the status of the specified version.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p idx is out of bounds.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The status of the version at \p idx.
+ */
+batch_status_t batch::get_status(std::size_t idx) const
+{
+    verify_index(idx);
+    return f_status[idx];
+}
+
+
+/** \brief Check whether the specified version is valid.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return true if the version at \p idx was parsed successfully.
+ */
+bool batch::is_valid(std::size_t idx) const
+{
+    return get_status(idx) == batch_status_t::BATCH_STATUS_VALID;
+}
+
+
+/** \brief Get the number of versions which failed parsing.
+ *
+ * \return The number of empty or invalid versions.
+ */
+std::size_t batch::get_error_count() const
+{
+    return f_errors.size();
+}
+
+
+/** \brief Get the error message of the specified version.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The error message or an empty string if the version is valid.
+ */
+std::string batch::get_last_error(std::size_t idx) const
+{
+    error_t const * e(find_error(idx));
+    if(e == nullptr)
+    {
+        return std::string();
+    }
+    return error_message(e->f_error, e->f_input);
+}
+
+
+/** \brief Get the error of the specified version.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The error, with code ERROR_CODE_NONE if the version is valid.
+ */
+version_error_t batch::get_error(std::size_t idx) const
+{
+    error_t const * e(find_error(idx));
+    if(e == nullptr)
+    {
+        return version_error_t();
+    }
+    return e->f_error;
+}
+
+
+/** \brief Get the number of parts of the specified version.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The number of parts, 0 if the version is not valid.
+ */
+std::size_t batch::get_part_count(std::size_t idx) const
+{
+    verify_index(idx);
+    return f_offsets[idx + 1] - f_offsets[idx];
+}
+
+
+/** \brief Get a pointer to the parts of the specified version.
+ *
+ * The parts of one version are contiguous in the pool. The pointer
+ * remains valid until more versions get added to the batch.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return A pointer to the first part of the version.
+ */
+part const * batch::get_parts(std::size_t idx) const
+{
+    verify_index(idx);
+    return f_parts.data() + f_offsets[idx];
+}
+
+
+/** \brief Get one part of the specified version.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p idx or \p pos is out of bounds.
+ *
+ * \param[in] idx  The index of the version.
+ * \param[in] pos  The position of the part within that version.
+ *
+ * \return A reference to the part.
+ */
+part const & batch::get_part(std::size_t idx, std::size_t pos) const
+{
+    if(pos >= get_part_count(idx))
+    {
+        throw invalid_parameter(
+                  "part position "
+                + std::to_string(pos)
+                + " is out of bounds for version "
+                + std::to_string(idx)
+                + ".");
+    }
+    return f_parts[f_offsets[idx] + pos];
+}
+
+
+/** \brief Access the entire pool of parts.
+ *
+ * \return A reference to all the parts of all the versions.
+ */
+part::vector_t const & batch::get_parts_pool() const
+{
+    return f_parts;
+}
+
+
+/** \brief Get the canonicalized version.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The canonicalized version or an empty string if not valid.
+ */
+std::string batch::get_version(std::size_t idx) const
+{
+    if(!is_valid(idx))
+    {
+        return std::string();
+    }
+    return load(idx)->to_string();
+}
+
+
+/** \brief Append the canonicalized version to a string.
+ *
+ * \param[in] idx  The index of the version.
+ * \param[in,out] result  The string where the version gets appended.
+ *
+ * \return true if the version is valid and was appended.
+ */
+bool batch::append_version(std::size_t idx, std::string & result) const
+{
+    if(!is_valid(idx))
+    {
+        return false;
+    }
+    return load(idx)->append_to_string(result);
+}
+
+
+/** \brief Compute the sort key of the specified version.
+ *
+ * \exception invalid_version
+ * The function raises this exception if the version is not valid.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The sort key of the version.
+ *
+ * \sa trait::sort_key()
+ */
+std::string batch::sort_key(std::size_t idx) const
+{
+    if(!is_valid(idx))
+    {
+        throw invalid_version("cannot compute the sort key of an invalid version.");
+    }
+    return load(idx)->sort_key();
+}
+
+
+/** \brief Search the error of a version.
+ *
+ * The errors are saved in the order the versions were added so a binary
+ * search is enough.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return The error or nullptr if the version is valid.
+ */
+batch::error_t const * batch::find_error(std::size_t idx) const
+{
+    verify_index(idx);
+    auto const it(std::lower_bound(
+              f_errors.begin()
+            , f_errors.end()
+            , idx
+            , [](error_t const & e, std::size_t i)
+            {
+                return e.f_index < i;
+            }));
+    if(it == f_errors.end()
+    || it->f_index != idx)
+    {
+        return nullptr;
+    }
+    return &*it;
+}
+
+
+/** \brief Compare two versions of this batch.
+ *
+ * The parts are compared directly in the pool with the same rules as
+ * the trait of the batch kind, giving the same result as
+ * versiontheca::compare().
+ *
+ * \exception invalid_version
+ * The function raises this exception if either version is not valid.
+ *
+ * \param[in] lhs  The index of the left hand side version.
+ * \param[in] rhs  The index of the right hand side version.
+ *
+ * \return -1, 0, or 1 as with versiontheca::compare().
+ */
+int batch::compare(std::size_t lhs, std::size_t rhs) const
+{
+    if(!is_valid(lhs) || !is_valid(rhs))
+    {
+        throw invalid_version("one or both of the input versions are not valid.");
+    }
+    return detail::compare_parts_by_kind(
+              f_kind
+            , pool_parts(get_parts(lhs), get_part_count(lhs))
+            , pool_parts(get_parts(rhs), get_part_count(rhs)));
+}
+
+
+void batch::verify_index(std::size_t idx) const
+{
+    if(idx >= f_status.size())
+    {
+        throw invalid_parameter(
+                  "version index "
+                + std::to_string(idx)
+                + " is out of bounds.");
+    }
+}
+
+
+/** \brief Load a version in a new trait.
+ *
+ * The trait is local to the caller so several threads can convert the
+ * versions of the same batch at the same time.
+ *
+ * \param[in] idx  The index of the version to load.
+ *
+ * \return A trait with the parts of that version.
+ */
+trait::pointer_t batch::load(std::size_t idx) const
+{
+    trait::pointer_t t(create_trait(f_kind));
+    std::size_t const end(f_offsets[idx + 1]);
+    for(std::size_t pos(f_offsets[idx]); pos < end; ++pos)
+    {
+        t->push_back(f_parts[pos]);
+    }
+    return t;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
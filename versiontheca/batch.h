@@ -0,0 +1,134 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Parse many versions at once.
+ *
+ * When loading a package index, thousands of versions need to be parsed.
+ * Creating one trait and one versiontheca object per version is costly.
+ * The batch class parses all the versions with a single trait and saves
+ * the results in columns: one pool of parts, one offset and one status
+ * per version. Error messages are only kept for versions that failed.
+ *
+ * Once all the versions were added, the const functions can be called
+ * from several threads at the same time. The add(), reserve(), and
+ * clear() functions must not run while other threads read the batch.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <string_view>
+#include    <vector>
+
+
+
+namespace versiontheca
+{
+
+
+
+enum class batch_status_t : std::uint8_t
+{
+    BATCH_STATUS_VALID,
+    BATCH_STATUS_EMPTY,
+    BATCH_STATUS_INVALID,
+};
+
+
+class batch
+{
+public:
+                        batch(trait_kind_t kind);
+
+    trait_kind_t        get_kind() const;
+    void                clear();
+    void                reserve(std::size_t versions, std::size_t parts = 0);
+    std::size_t         add(std::string_view const & v);
+
+    std::size_t         size() const;
+    bool                empty() const;
+    batch_status_t      get_status(std::size_t idx) const;
+    bool                is_valid(std::size_t idx) const;
+    std::size_t         get_error_count() const;
+    std::string         get_last_error(std::size_t idx) const;
+    version_error_t     get_error(std::size_t idx) const;
+    std::size_t         get_part_count(std::size_t idx) const;
+    part const *        get_parts(std::size_t idx) const;
+    part const &        get_part(std::size_t idx, std::size_t pos) const;
+    part::vector_t const &
+                        get_parts_pool() const;
+    std::string         get_version(std::size_t idx) const;
+    bool                append_version(std::size_t idx, std::string & result) const;
+    std::string         sort_key(std::size_t idx) const;
+    int                 compare(std::size_t lhs, std::size_t rhs) const;
+
+private:
+    struct error_t
+    {
+        std::size_t         f_index = 0;
+        version_error_t     f_error = version_error_t();
+        std::string         f_input = std::string();    // only if the message includes it
+    };
+
+    error_t const *     find_error(std::size_t idx) const;
+
+    void                verify_index(std::size_t idx) const;
+    trait::pointer_t    load(std::size_t idx) const;
+
+    trait_kind_t        f_kind = trait_kind_t::TRAIT_KIND_UNICODE;
+    trait::pointer_t    f_trait = trait::pointer_t();
+    part::vector_t      f_parts = part::vector_t();
+    std::vector<std::uint32_t>
+                        f_offsets = std::vector<std::uint32_t>();
+    std::vector<batch_status_t>
+                        f_status = std::vector<batch_status_t>();
+    std::vector<error_t>
+                        f_errors = std::vector<error_t>();
+};
+
+
+template<typename Iterator>
+batch parse_many(trait_kind_t kind, Iterator begin, Iterator end)
+{
+    batch result(kind);
+    result.reserve(std::distance(begin, end));
+    for(; begin != end; ++begin)
+    {
+        result.add(*begin);
+    }
+    return result;
+}
+
+
+template<typename Container>
+batch parse_many(trait_kind_t kind, Container const & versions)
+{
+    return parse_many(kind, std::begin(versions), std::end(versions));
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,184 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Classify the characters of a version string.
+ *
+ * This file implements the classification of ASCII characters in bitmasks.
+ * One bit in each mask represents one byte of the input.
+ *
+ * The digits and separators are found using SSE2 on x86 and NEON on
+ * aarch64. Both are always available on those platforms so no runtime
+ * dispatch is required. Other platforms use the scalar implementation.
+ *
+ * \note
+ * AVX2 is not used. Versions are short (the classification is limited to
+ * MAX_CLASSIFIED_LENGTH bytes) so a 32 byte register would save one or two
+ * instructions, which is less than the cost of a runtime dispatch.
+ */
+
+// self
+//
+#include    <versiontheca/character_class.h>
+
+
+// C++
+//
+#include    <cstring>
+
+
+// C
+//
+#if defined(__SSE2__)
+#include    <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include    <arm_neon.h>
+#endif
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+/** \brief Classify the characters of a version.
+ *
+ * This function sets bit \em n of the \p masks when byte \em n of \p v is:
+ *
+ * \li f_digits -- an ASCII digit ('0' to '9');
+ * \li f_separators -- a separator as defined in \p classes;
+ * \li f_invalid -- not a digit and not a valid character.
+ *
+ * The input must be ASCII and at most MAX_CLASSIFIED_LENGTH bytes.
+ * Bits past the end of the input are always 0.
+ *
+ * \param[in] v  The version to classify.
+ * \param[in] classes  The table of character classes of the trait.
+ * \param[out] masks  The resulting masks.
+ */
+void classify_characters(
+      std::string_view const & v
+    , character_classes_t const & classes
+    , character_masks_t & masks)
+{
+    std::size_t const len(v.length());
+    std::uint64_t const used(len >= 64 ? ~0ULL : (1ULL << len) - 1);
+
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    // the padding is all zeroes which is never a digit nor a separator
+    //
+    alignas(16) std::uint8_t buffer[MAX_CLASSIFIED_LENGTH] = {};
+    std::memcpy(buffer, v.data(), len);
+
+    std::uint64_t digits(0);
+    std::uint64_t separators(0);
+    for(std::size_t idx(0); idx < len; idx += 16)
+    {
+#if defined(__SSE2__)
+        __m128i const chunk(_mm_load_si128(reinterpret_cast<__m128i const *>(buffer + idx)));
+
+        // input is ASCII so the signed comparisons are fine
+        //
+        __m128i const is_digit(_mm_and_si128(
+                  _mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1))
+                , _mm_cmplt_epi8(chunk, _mm_set1_epi8('9' + 1))));
+        __m128i is_separator(_mm_setzero_si128());
+        for(std::size_t s(0); s < MAX_CLASSIFIED_SEPARATORS && classes.f_separators[s] != '\0'; ++s)
+        {
+            is_separator = _mm_or_si128(
+                      is_separator
+                    , _mm_cmpeq_epi8(chunk, _mm_set1_epi8(classes.f_separators[s])));
+        }
+        digits |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(is_digit))) << idx;
+        separators |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(is_separator))) << idx;
+#else
+        uint8x16_t const chunk(vld1q_u8(buffer + idx));
+        uint8x16_t const is_digit(vandq_u8(
+                  vcgeq_u8(chunk, vdupq_n_u8('0'))
+                , vcleq_u8(chunk, vdupq_n_u8('9'))));
+        uint8x16_t is_separator(vdupq_n_u8(0));
+        for(std::size_t s(0); s < MAX_CLASSIFIED_SEPARATORS && classes.f_separators[s] != '\0'; ++s)
+        {
+            is_separator = vorrq_u8(
+                      is_separator
+                    , vceqq_u8(chunk, vdupq_n_u8(classes.f_separators[s])));
+        }
+
+        // NEON has no movemask, keep one bit per byte and add them up
+        //
+        static std::uint8_t const bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        uint8x16_t const weights(vld1q_u8(bits));
+        uint8x16_t const d(vandq_u8(is_digit, weights));
+        uint8x16_t const p(vandq_u8(is_separator, weights));
+        digits |= static_cast<std::uint64_t>(vaddv_u8(vget_low_u8(d))
+                    | (vaddv_u8(vget_high_u8(d)) << 8)) << idx;
+        separators |= static_cast<std::uint64_t>(vaddv_u8(vget_low_u8(p))
+                    | (vaddv_u8(vget_high_u8(p)) << 8)) << idx;
+#endif
+    }
+    masks.f_digits = digits & used;
+    masks.f_separators = separators & used;
+
+    // only the letters need to be checked against the table
+    //
+    std::uint64_t invalid(0);
+    for(std::uint64_t letters(~digits & used); letters != 0; letters &= letters - 1)
+    {
+        int const bit(__builtin_ctzll(letters));
+        if((classes.f_class[buffer[bit]] & CHARACTER_CLASS_VALID) == 0)
+        {
+            invalid |= 1ULL << bit;
+        }
+    }
+    masks.f_invalid = invalid;
+#else
+    masks = character_masks_t();
+    for(std::size_t idx(0); idx < len; ++idx)
+    {
+        std::uint8_t const c(static_cast<std::uint8_t>(v[idx]));
+        std::uint64_t const bit(1ULL << idx);
+        if(c >= '0' && c <= '9')
+        {
+            masks.f_digits |= bit;
+            continue;
+        }
+        std::uint8_t const flags(classes.f_class[c]);
+        if((flags & CHARACTER_CLASS_SEPARATOR) != 0)
+        {
+            masks.f_separators |= bit;
+        }
+        if((flags & CHARACTER_CLASS_VALID) == 0)
+        {
+            masks.f_invalid |= bit;
+        }
+    }
+    static_cast<void>(used);
+#endif
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
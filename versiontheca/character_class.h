@@ -0,0 +1,112 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Tables and functions used to classify ASCII characters.
+ *
+ * The parsers need to know whether a character is a digit, a separator,
+ * or a character the trait accepts. Calling the virtual
+ * trait::is_separator() and trait::is_valid_character() on each character
+ * is slow. A trait can instead offer a table of character classes for
+ * ASCII characters, which the parser uses to classify an entire version
+ * string at once.
+ */
+
+// C++
+//
+#include    <cstdint>
+#include    <string_view>
+
+
+
+namespace versiontheca
+{
+
+
+
+constexpr std::uint8_t const    CHARACTER_CLASS_VALID = 0x01;
+constexpr std::uint8_t const    CHARACTER_CLASS_SEPARATOR = 0x02;
+
+constexpr std::size_t const     MAX_CLASSIFIED_LENGTH = 64;
+constexpr std::size_t const     MAX_CLASSIFIED_SEPARATORS = 4;
+
+
+struct character_classes_t
+{
+    std::uint8_t        f_class[128] = {};
+    char                f_separators[MAX_CLASSIFIED_SEPARATORS] = {};
+};
+
+
+struct character_masks_t
+{
+    std::uint64_t       f_digits = 0;
+    std::uint64_t       f_separators = 0;
+    std::uint64_t       f_invalid = 0;
+};
+
+
+/** \brief Create a table of character classes.
+ *
+ * This function calls \p valid and \p separator for each ASCII character
+ * and saves the results in a table. It is expected to be used in a
+ * constexpr context so the table gets computed at compile time.
+ *
+ * The SIMD classification compares the input against each separator, so
+ * at most MAX_CLASSIFIED_SEPARATORS characters can be separators.
+ *
+ * \param[in] valid  A function returning true for valid characters.
+ * \param[in] separator  A function returning true for separators.
+ *
+ * \return The table of character classes.
+ */
+template<typename V, typename S>
+constexpr character_classes_t make_character_classes(V valid, S separator)
+{
+    character_classes_t result;
+    std::size_t count(0);
+    for(char32_t c(0); c < 128; ++c)
+    {
+        std::uint8_t flags(0);
+        if(valid(c))
+        {
+            flags |= CHARACTER_CLASS_VALID;
+        }
+        if(separator(c))
+        {
+            flags |= CHARACTER_CLASS_SEPARATOR;
+            result.f_separators[count] = static_cast<char>(c);
+            ++count;
+        }
+        result.f_class[c] = flags;
+    }
+    return result;
+}
+
+
+void                    classify_characters(
+                              std::string_view const & v
+                            , character_classes_t const & classes
+                            , character_masks_t & masks);
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,254 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Runtime implementation of the string compare kernels.
+ *
+ * The Debian and RPM string parts are compared using an order table.
+ * Two identical bytes always have the same order so the functions here
+ * first search for the first differing byte as fast as possible (16
+ * bytes at a time with SSE2, 8 bytes at a time otherwise) and only
+ * look at the table for the bytes that differ.
+ *
+ * The parser already verified that the strings only include characters
+ * valid for that version format, so there is nothing to check here.
+ */
+
+// self
+//
+#include    <versiontheca/compare.h>
+
+
+// C++
+//
+#include    <charconv>
+#include    <cstring>
+#include    <limits>
+
+
+// C
+//
+#if defined(__SSE2__)
+#include    <emmintrin.h>
+#endif
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+namespace detail
+{
+
+
+
+namespace
+{
+
+
+
+template<int (*Compare)(char, char)>
+int compare_strings_scan(std::string_view const & lhs, std::string_view const & rhs)
+{
+    char const * l(lhs.data());
+    char const * r(rhs.data());
+    std::size_t const common(std::min(lhs.length(), rhs.length()));
+    std::size_t idx(0);
+    for(;;)
+    {
+        idx += find_mismatch(l + idx, r + idx, common - idx);
+        if(idx >= common)
+        {
+            break;
+        }
+        int const c(Compare(l[idx], r[idx]));
+        if(c != 0)
+        {
+            return c;
+        }
+        ++idx;
+    }
+
+    // the longest string is compared against '\0' characters (this is
+    // required because '~' sorts before '\0')
+    //
+    for(; idx < lhs.length(); ++idx)
+    {
+        int const c(Compare(l[idx], '\0'));
+        if(c != 0)
+        {
+            return c;
+        }
+    }
+    for(; idx < rhs.length(); ++idx)
+    {
+        int const c(Compare('\0', r[idx]));
+        if(c != 0)
+        {
+            return c;
+        }
+    }
+
+    return 0;
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Compare an integer against a string.
+ *
+ * This function returns the same result as
+ * `std::to_string(integer).compare(s)` without allocating a string.
+ *
+ * The string of an integer always starts with a digit, so when \p s does
+ * not start with a digit (the usual case), the first character decides.
+ * Otherwise the integer gets formatted in a buffer on the stack.
+ *
+ * \param[in] integer  The integer to compare.
+ * \param[in] s  The string to compare against.
+ *
+ * \return -1, 0, or 1.
+ */
+int compare_integer_string(part_integer_t integer, std::string_view const & s)
+{
+    if(s.empty())
+    {
+        return 1;
+    }
+    std::uint8_t const c(s[0]);
+    if(c < '0')
+    {
+        return 1;
+    }
+    if(c > '9')
+    {
+        return -1;
+    }
+
+    char buf[std::numeric_limits<part_integer_t>::digits10 + 1];
+    std::to_chars_result const r(std::to_chars(buf, buf + sizeof(buf), integer));
+    int const result(std::string_view(buf, r.ptr - buf).compare(s));
+    return result == 0 ? 0 : (result < 0 ? -1 : 1);
+}
+
+
+/** \brief Search the first byte that differs between two buffers.
+ *
+ * \param[in] lhs  The left hand side buffer.
+ * \param[in] rhs  The right hand side buffer.
+ * \param[in] length  The number of bytes to compare.
+ *
+ * \return The position of the first differing byte or \p length if
+ * both buffers are equal.
+ */
+std::size_t find_mismatch(char const * lhs, char const * rhs, std::size_t length)
+{
+    std::size_t idx(0);
+
+#if defined(__SSE2__)
+    for(; idx + 16 <= length; idx += 16)
+    {
+        __m128i const a(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lhs + idx)));
+        __m128i const b(_mm_loadu_si128(reinterpret_cast<__m128i const *>(rhs + idx)));
+        unsigned int const mask(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF);
+        if(mask != 0)
+        {
+            return idx + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for(; idx + sizeof(std::uint64_t) <= length; idx += sizeof(std::uint64_t))
+    {
+        std::uint64_t a(0);
+        std::uint64_t b(0);
+        memcpy(&a, lhs + idx, sizeof(a));
+        memcpy(&b, rhs + idx, sizeof(b));
+        std::uint64_t const diff(a ^ b);
+        if(diff != 0)
+        {
+            return idx + __builtin_ctzll(diff) / 8;
+        }
+    }
+#endif
+
+    for(; idx < length; ++idx)
+    {
+        if(lhs[idx] != rhs[idx])
+        {
+            return idx;
+        }
+    }
+
+    return length;
+}
+
+
+/** \brief Compare two Debian strings at runtime.
+ *
+ * This function returns the same result as debian_compare_strings()
+ * but it skips equal bytes several at a time.
+ *
+ * \param[in] lhs  The left hand side string.
+ * \param[in] rhs  The right hand side string.
+ *
+ * \return -1, 0, or 1.
+ */
+int debian_compare_strings_scan(std::string_view const & lhs, std::string_view const & rhs)
+{
+    return compare_strings_scan<debian_compare_characters>(lhs, rhs);
+}
+
+
+/** \brief Compare two RPM strings at runtime.
+ *
+ * This function returns the same result as rpm_compare_strings().
+ * The '_' characters are ignored by the RPM compare so strings which
+ * include such are handled by the slow function. Otherwise the RPM
+ * order works exactly like the Debian one.
+ *
+ * \param[in] lhs  The left hand side string.
+ * \param[in] rhs  The right hand side string.
+ *
+ * \return -1, 0, or 1.
+ */
+int rpm_compare_strings_scan(std::string_view const & lhs, std::string_view const & rhs)
+{
+    if(lhs.find('_') != std::string_view::npos
+    || rhs.find('_') != std::string_view::npos)
+    {
+        return rpm_compare_strings(lhs, rhs);
+    }
+    return compare_strings_scan<rpm_compare_characters>(lhs, rhs);
+}
+
+
+
+} // namespace detail
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,883 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Comparison functions shared by the traits and basic_version.
+ *
+ * The functions found here compare the parts of two versions. They are
+ * templates so the same code is used by the dynamic traits (debian, rpm)
+ * and by the compile time basic_version<Policy> where the calls get
+ * inlined.
+ *
+ * The parts are accessed through an object offering the following
+ * functions:
+ *
+ * \code
+ *     std::size_t         size() const;
+ *     char                get_type(std::size_t idx) const;
+ *     bool                is_integer(std::size_t idx) const;
+ *     part_integer_t      get_integer(std::size_t idx) const;
+ *     std::string_view    get_string(std::size_t idx) const;
+ * \endcode
+ *
+ * An object which reads its parts on demand can also offer the following
+ * function. The compare functions then use it instead of size() while
+ * walking the parts so the parts after the first difference never get
+ * read (see has_part()):
+ *
+ * \code
+ *     bool                has_part(std::size_t idx) const;
+ * \endcode
+ *
+ * The decimal_compare_parts() function also calls the following to get
+ * the number of digits of the fraction:
+ *
+ * \code
+ *     std::uint8_t        get_width(std::size_t idx) const;
+ * \endcode
+ *
+ * The functions expect both versions to have at least one part.
+ *
+ * The string compare functions come in two flavors: the constexpr ones,
+ * used at compile time (see literal.h), and the *_scan() ones, used at
+ * runtime, which search the first differing byte several bytes at a time
+ * before looking at the order table.
+ */
+
+// self
+//
+#include    <versiontheca/fixed_decimal.h>
+#include    <versiontheca/kind.h>
+#include    <versiontheca/part.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <cstdint>
+#include    <string_view>
+#include    <type_traits>
+#include    <utility>
+
+
+
+namespace versiontheca
+{
+namespace detail
+{
+
+
+
+#include    <versiontheca/debian_order_table.ci>
+#include    <versiontheca/rpm_order_table.ci>
+
+
+int                     compare_integer_string(part_integer_t integer, std::string_view const & s);
+std::size_t             find_mismatch(char const * lhs, char const * rhs, std::size_t length);
+int                     debian_compare_strings_scan(std::string_view const & lhs, std::string_view const & rhs);
+int                     rpm_compare_strings_scan(std::string_view const & lhs, std::string_view const & rhs);
+
+
+/** \brief Compare two Debian characters.
+ *
+ * The order is defined in debian_order.cpp: '~', the end of the string,
+ * the letters, then '+', '-', and ':' as in dpkg. Characters not found
+ * in the table (i.e. invalid in a Debian string part) are given order 0.
+ *
+ * \param[in] a  The left hand side character.
+ * \param[in] b  The right hand side character.
+ *
+ * \return -1, 0, or 1.
+ */
+constexpr int debian_compare_characters(char a, char b)
+{
+    int const r(g_debian_compare_characters[static_cast<std::uint8_t>(a)]
+              - g_debian_compare_characters[static_cast<std::uint8_t>(b)]);
+    return r == 0 ? 0 : (r < 0 ? -1 : 1);
+}
+
+
+constexpr int debian_compare_strings(std::string_view const & lhs, std::string_view const & rhs)
+{
+    // because of the '~' we have to compare everything ('~' is before
+    // '\0'...)
+    //
+    std::size_t const max(std::max(lhs.length(), rhs.length()));
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        char const a(idx >= lhs.length() ? '\0' : lhs[idx]);
+        char const b(idx >= rhs.length() ? '\0' : rhs[idx]);
+        int const r(debian_compare_characters(a, b));
+        if(r != 0)
+        {
+            return r;
+        }
+    }
+    return 0;
+}
+
+
+/** \brief Compare two RPM characters.
+ *
+ * The order is defined in rpm_order.cpp. Characters not found in the
+ * table (i.e. invalid in an RPM version) are given order 0.
+ *
+ * \param[in] a  The left hand side character.
+ * \param[in] b  The right hand side character.
+ *
+ * \return -1, 0, or 1.
+ */
+constexpr int rpm_compare_characters(char a, char b)
+{
+    int const r(g_rpm_compare_characters[static_cast<std::uint8_t>(a)]
+              - g_rpm_compare_characters[static_cast<std::uint8_t>(b)]);
+    return r == 0 ? 0 : (r < 0 ? -1 : 1);
+}
+
+
+constexpr int rpm_compare_strings(std::string_view const & lhs, std::string_view const & rhs)
+{
+    // because of the '~' we have to compare everything ('~' is before
+    // '\0'...); the '_' are ignored
+    //
+    std::size_t const max(std::max(lhs.length(), rhs.length()));
+    std::size_t lidx(0);
+    std::size_t ridx(0);
+    while(lidx < max || ridx < max)
+    {
+        char a('\0');
+        do
+        {
+            if(lidx < lhs.length())
+            {
+                a = lhs[lidx];
+            }
+            ++lidx;
+        }
+        while(a == '_' && lidx < lhs.length());
+        if(a == '_')
+        {
+            a = '\0';
+        }
+
+        char b('\0');
+        do
+        {
+            if(ridx < rhs.length())
+            {
+                b = rhs[ridx];
+            }
+            ++ridx;
+        }
+        while(b == '_' && ridx < rhs.length());
+        if(b == '_')
+        {
+            b = '\0';
+        }
+
+        int const r(rpm_compare_characters(a, b));
+        if(r != 0)
+        {
+            return r;
+        }
+    }
+    return 0;
+}
+
+
+struct debian_string_compare_t
+{
+    constexpr int operator () (std::string_view const & lhs, std::string_view const & rhs) const
+    {
+        return debian_compare_strings(lhs, rhs);
+    }
+};
+
+
+struct debian_string_scan_t
+{
+    int operator () (std::string_view const & lhs, std::string_view const & rhs) const
+    {
+        return debian_compare_strings_scan(lhs, rhs);
+    }
+};
+
+
+struct rpm_string_compare_t
+{
+    constexpr int operator () (std::string_view const & lhs, std::string_view const & rhs) const
+    {
+        return rpm_compare_strings(lhs, rhs);
+    }
+};
+
+
+struct rpm_string_scan_t
+{
+    int operator () (std::string_view const & lhs, std::string_view const & rhs) const
+    {
+        return rpm_compare_strings_scan(lhs, rhs);
+    }
+};
+
+
+template<typename P, typename = void>
+struct reads_parts_on_demand
+    : std::false_type
+{
+};
+
+
+template<typename P>
+struct reads_parts_on_demand<P, std::void_t<decltype(std::declval<P const &>().has_part(std::size_t()))>>
+    : std::true_type
+{
+};
+
+
+/** \brief Check whether a part exists.
+ *
+ * The compare functions call this function to know whether they reached
+ * the end of the parts. When \p parts offers a has_part() function, it
+ * gets called so the parts can be read one at a time. Otherwise \p idx
+ * is checked against the size().
+ *
+ * \param[in] parts  The parts.
+ * \param[in] idx  The index of the part to check.
+ *
+ * \return true if \p parts has a part at \p idx.
+ */
+template<typename P>
+constexpr bool has_part(P const & parts, std::size_t idx)
+{
+    if constexpr(reads_parts_on_demand<P>::value)
+    {
+        return parts.has_part(idx);
+    }
+    else
+    {
+        return idx < parts.size();
+    }
+}
+
+
+/** \brief Compare two versions composed of integers only.
+ *
+ * Missing parts are viewed as zeroes so "1.0" and "1" are equal.
+ *
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts.
+ *
+ * \return -1, 0, or 1.
+ */
+template<typename L, typename R>
+constexpr int basic_compare_parts(L const & lhs, R const & rhs)
+{
+    for(std::size_t idx(0); has_part(lhs, idx) || has_part(rhs, idx); ++idx)
+    {
+        part_integer_t const l(has_part(lhs, idx) ? lhs.get_integer(idx) : 0);
+        part_integer_t const r(has_part(rhs, idx) ? rhs.get_integer(idx) : 0);
+        if(l != r)
+        {
+            return l < r ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+
+/** \brief Check whether a part is zero.
+ *
+ * This is the same as part::is_zero(): an integer is zero when it is 0
+ * and a string when it is only composed of 'A'.
+ *
+ * \param[in] parts  The parts.
+ * \param[in] idx  The index of the part to check.
+ *
+ * \return true if the part is zero.
+ */
+template<typename P>
+bool is_zero_part(P const & parts, std::size_t idx)
+{
+    if(parts.is_integer(idx))
+    {
+        return parts.get_integer(idx) == 0;
+    }
+    for(auto const c : parts.get_string(idx))
+    {
+        if(c != 'A')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/** \brief Compare two versions part by part.
+ *
+ * This is the algorithm of trait::compare() and part::compare(), used
+ * by the traits which do not have their own compare() function. Missing
+ * parts are viewed as zeroes.
+ *
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts.
+ *
+ * \return -1, 0, or 1.
+ */
+template<typename L, typename R>
+int generic_compare_parts(L const & lhs, R const & rhs)
+{
+    std::size_t const max(std::max(lhs.size(), rhs.size()));
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        if(idx >= lhs.size())
+        {
+            if(!is_zero_part(rhs, idx))
+            {
+                return -1;
+            }
+            continue;
+        }
+        if(idx >= rhs.size())
+        {
+            if(!is_zero_part(lhs, idx))
+            {
+                return 1;
+            }
+            continue;
+        }
+
+        int r(0);
+        if(lhs.is_integer(idx) && rhs.is_integer(idx))
+        {
+            part_integer_t const l(lhs.get_integer(idx));
+            part_integer_t const v(rhs.get_integer(idx));
+            r = l == v ? 0 : (l < v ? -1 : 1);
+        }
+        else if(lhs.is_integer(idx))
+        {
+            r = compare_integer_string(lhs.get_integer(idx), rhs.get_string(idx));
+        }
+        else if(rhs.is_integer(idx))
+        {
+            r = -compare_integer_string(rhs.get_integer(idx), lhs.get_string(idx));
+        }
+        else
+        {
+            int const c(lhs.get_string(idx).compare(rhs.get_string(idx)));
+            r = c == 0 ? 0 : (c < 0 ? -1 : 1);
+        }
+        if(r != 0)
+        {
+            return r;
+        }
+    }
+    return 0;
+}
+
+
+/** \brief Compare two Debian versions.
+ *
+ * The epoch is compared first. Then the upstream and the revision are
+ * compared one after the other as pairs of string and integer as defined
+ * by the Debian algorithm.
+ *
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts.
+ * \param[in] string_compare  The function used to compare strings.
+ *
+ * \return -1, 0, or 1.
+ */
+template<typename L, typename R, typename C = debian_string_compare_t>
+constexpr int debian_compare_parts(L const & lhs, R const & rhs, C string_compare = C())
+{
+    std::size_t lpos(0);
+    std::size_t rpos(0);
+
+    // compare epoch
+    //
+    int lepoch(0);
+    int repoch(0);
+    if(lhs.get_type(0) == ':')
+    {
+        lepoch = lhs.get_integer(0);
+        lpos = 1;
+    }
+    if(rhs.get_type(0) == ':')
+    {
+        repoch = rhs.get_integer(0);
+        rpos = 1;
+    }
+    if(lepoch != repoch)
+    {
+        return lepoch < repoch ? -1 : 1;
+    }
+
+    // compare upstream version, then switch to the release version
+    //
+    char type('\0');
+    for(;;)
+    {
+        for(bool handle_strings(true);; handle_strings = !handle_strings)
+        {
+            bool const lhas(has_part(lhs, lpos) && lhs.get_type(lpos) == type);
+            bool const rhas(has_part(rhs, rpos) && rhs.get_type(rpos) == type);
+            if(!lhas && !rhas)
+            {
+                // we reached a different type on both sides
+                // we need to explicitly break
+                //
+                break;
+            }
+
+            int lint(0);
+            std::string_view lstr;
+            int rint(0);
+            std::string_view rstr;
+
+            if(lhas
+            && (handle_strings ^ lhs.is_integer(lpos)))
+            {
+                if(handle_strings)
+                {
+                    lstr = lhs.get_string(lpos);
+                }
+                else
+                {
+                    lint = lhs.get_integer(lpos);
+                }
+                ++lpos;
+            }
+
+            if(rhas
+            && (handle_strings ^ rhs.is_integer(rpos)))
+            {
+                if(handle_strings)
+                {
+                    rstr = rhs.get_string(rpos);
+                }
+                else
+                {
+                    rint = rhs.get_integer(rpos);
+                }
+                ++rpos;
+            }
+
+            if(handle_strings)
+            {
+                int const r(string_compare(lstr, rstr));
+                if(r != 0)
+                {
+                    return r;
+                }
+            }
+            else
+            {
+                if(lint != rint)
+                {
+                    return lint < rint ? -1 : 1;
+                }
+            }
+        }
+        if(type == '-')
+        {
+            // we are done
+            //
+            return 0;
+        }
+        type = '-';
+    }
+}
+
+
+/** \brief Compare two RPM versions.
+ *
+ * The epoch is compared first. Then the upstream and the revision are
+ * compared one after the other part by part. An integer is considered
+ * larger than a string.
+ *
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts.
+ * \param[in] string_compare  The function used to compare strings.
+ *
+ * \return -1, 0, or 1.
+ */
+template<typename L, typename R, typename C = rpm_string_compare_t>
+constexpr int rpm_compare_parts(L const & lhs, R const & rhs, C string_compare = C())
+{
+    std::size_t lpos(0);
+    std::size_t rpos(0);
+
+    // compare epoch
+    //
+    int lepoch(0);
+    int repoch(0);
+    if(lhs.get_type(0) == ':')
+    {
+        lepoch = lhs.get_integer(0);
+        lpos = 1;
+    }
+    if(rhs.get_type(0) == ':')
+    {
+        repoch = rhs.get_integer(0);
+        rpos = 1;
+    }
+    if(lepoch != repoch)
+    {
+        return lepoch < repoch ? -1 : 1;
+    }
+
+    // compare upstream version, then switch to the release version
+    //
+    char type('\0');
+    for(;;)
+    {
+        for(;;)
+        {
+            bool const lhas(has_part(lhs, lpos) && lhs.get_type(lpos) == type);
+            bool const rhas(has_part(rhs, rpos) && rhs.get_type(rpos) == type);
+            if(!lhas && !rhas)
+            {
+                // we reached a different type on both sides
+                // we need to explicitly break
+                //
+                break;
+            }
+
+            int lint(0);
+            int rint(0);
+            bool linteger(false);
+            bool rinteger(false);
+            std::string_view lstr;
+            std::string_view rstr;
+
+            if(lhas)
+            {
+                linteger = lhs.is_integer(lpos);
+                if(linteger)
+                {
+                    lint = lhs.get_integer(lpos);
+                }
+                else
+                {
+                    lstr = lhs.get_string(lpos);
+                }
+                ++lpos;
+            }
+
+            if(rhas)
+            {
+                rinteger = rhs.is_integer(rpos);
+                if(rinteger)
+                {
+                    rint = rhs.get_integer(rpos);
+                }
+                else
+                {
+                    rstr = rhs.get_string(rpos);
+                }
+                ++rpos;
+            }
+
+            if(linteger == rinteger)
+            {
+                if(linteger)
+                {
+                    if(lint != rint)
+                    {
+                        return lint < rint ? -1 : 1;
+                    }
+                }
+                else
+                {
+                    int const r(string_compare(lstr, rstr));
+                    if(r != 0)
+                    {
+                        return r;
+                    }
+                }
+            }
+            else
+            {
+                if(linteger)
+                {
+                    if(lint != 0 || !rstr.empty())
+                    {
+                        return 1;
+                    }
+                }
+                else
+                {
+                    if(rint != 0 || !lstr.empty())
+                    {
+                        return -1;
+                    }
+                }
+            }
+        }
+        if(type == '-')
+        {
+            // we are done
+            //
+            return 0;
+        }
+        type = '-';
+    }
+}
+
+
+/** \brief Access the parts of a trait as expected by the compare functions.
+ *
+ * This adapter is used by the traits to call the compare functions
+ * defined in this file.
+ */
+template<typename T>
+class trait_parts
+{
+public:
+    constexpr           trait_parts(T const & t)
+                            : f_trait(t)
+                        {
+                        }
+
+    std::size_t         size() const { return f_trait.size(); }
+    char                get_type(std::size_t idx) const { return f_trait.at(idx).get_type(); }
+    bool                is_integer(std::size_t idx) const { return f_trait.at(idx).is_integer(); }
+    part_integer_t      get_integer(std::size_t idx) const { return f_trait.at(idx).get_integer(); }
+    std::string_view    get_string(std::size_t idx) const { return f_trait.at(idx).get_string(); }
+    std::uint8_t        get_width(std::size_t idx) const { return f_trait.at(idx).get_width(); }
+
+private:
+    T const &           f_trait;
+};
+
+
+/** \brief Compute the number of parts to compare with a limit.
+ *
+ * The \p limit applies to the upstream version only. An epoch (a first
+ * part of type ':') is not counted and always compared, and a release
+ * (parts of type '-') is never compared under a limit. So a limit of 2
+ * compares the epoch and the "major.minor" of a Debian or RPM version,
+ * and "2.0-1" and "2-9" are equal since the missing upstream parts are
+ * viewed as zeroes.
+ *
+ * A \p limit of MAX_PARTS or more means no limit: all the parts,
+ * including the release, are compared.
+ *
+ * \param[in] parts  The parts to limit.
+ * \param[in] limit  The maximum number of upstream parts.
+ *
+ * \return The number of parts to compare.
+ */
+template<typename P>
+constexpr std::size_t limited_size(P const & parts, std::size_t limit)
+{
+    std::size_t const size(parts.size());
+    if(limit >= MAX_PARTS)
+    {
+        return size;
+    }
+    std::size_t const start(size > 0 && parts.get_type(0) == ':' ? 1 : 0);
+    std::size_t end(start);
+    while(end < size
+       && parts.get_type(end) != '-')
+    {
+        ++end;
+    }
+    return start + std::min(end - start, limit);
+}
+
+
+/** \brief Give access to the first parts only.
+ *
+ * This adapter hides the parts after the limit from the compare
+ * functions, so they stop early and compare a prefix of the upstream
+ * versions (see limited_size()).
+ * It keeps a reference to \p parts which must outlive it.
+ */
+template<typename P>
+class limited_parts
+{
+public:
+    constexpr           limited_parts(P const & parts, std::size_t limit)
+                            : f_parts(parts)
+                            , f_size(limited_size(parts, limit))
+                        {
+                        }
+
+    constexpr std::size_t
+                        size() const { return f_size; }
+    constexpr char      get_type(std::size_t idx) const { return f_parts.get_type(idx); }
+    constexpr bool      is_integer(std::size_t idx) const { return f_parts.is_integer(idx); }
+    constexpr part_integer_t
+                        get_integer(std::size_t idx) const { return f_parts.get_integer(idx); }
+    constexpr std::string_view
+                        get_string(std::size_t idx) const { return f_parts.get_string(idx); }
+    constexpr std::uint8_t
+                        get_width(std::size_t idx) const { return f_parts.get_width(idx); }
+
+private:
+    P const &           f_parts;
+    std::size_t         f_size = 0;
+};
+
+
+/** \brief Compare two Debian or RPM versions of the same shape.
+ *
+ * When both versions have the same number of parts, the same sections,
+ * and the same integer or string kind per part, the Debian and RPM
+ * algorithms reduce to comparing the parts one to one: the integers
+ * (including the epoch) as \c int, like debian_compare_parts() and
+ * rpm_compare_parts() do, and the strings with \p string_compare.
+ *
+ * \warning
+ * The caller must verify that both shapes are equal (see
+ * trait::get_shape()), otherwise the results are undefined.
+ *
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts, of the same shape.
+ * \param[in] string_compare  The function used to compare strings.
+ *
+ * \return -1, 0, or 1.
+ */
+template<typename L, typename R, typename C>
+int same_shape_compare_parts(L const & lhs, R const & rhs, C string_compare)
+{
+    std::size_t const max(lhs.size());
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        if(lhs.is_integer(idx))
+        {
+            int const l(lhs.get_integer(idx));
+            int const r(rhs.get_integer(idx));
+            if(l != r)
+            {
+                return l < r ? -1 : 1;
+            }
+        }
+        else
+        {
+            int const r(string_compare(lhs.get_string(idx), rhs.get_string(idx)));
+            if(r != 0)
+            {
+                return r;
+            }
+        }
+    }
+    return 0;
+}
+
+
+/** \brief Convert the parts of a decimal version to a fixed-point value.
+ *
+ * \param[in] parts  The parts of the version.
+ * \param[out] value  The resulting value.
+ *
+ * \return false if the parts are not one or two integers or if the
+ * fraction uses more than DECIMAL_PRECISION digits.
+ */
+template<typename P>
+constexpr bool parts_to_fixed_decimal(P const & parts, fixed_decimal_t & value)
+{
+    std::size_t const size(parts.size());
+    if(size == 1
+    && parts.is_integer(0))
+    {
+        return make_fixed_decimal(parts.get_integer(0), 0, 0, value);
+    }
+    if(size == 2
+    && parts.is_integer(0)
+    && parts.is_integer(1))
+    {
+        return make_fixed_decimal(
+                  parts.get_integer(0)
+                , parts.get_integer(1)
+                , parts.get_width(1)
+                , value);
+    }
+    return false;
+}
+
+
+/** \brief Compare two decimal versions.
+ *
+ * The versions are compared as fixed-point numbers so "1.5" equals
+ * "1.50" and "1.05" is smaller than "1.5". Parts which do not represent
+ * a decimal number are compared with generic_compare_parts().
+ *
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts.
+ *
+ * \return -1, 0, or 1.
+ */
+template<typename L, typename R>
+int decimal_compare_parts(L const & lhs, R const & rhs)
+{
+    fixed_decimal_t l;
+    fixed_decimal_t r;
+    if(parts_to_fixed_decimal(lhs, l)
+    && parts_to_fixed_decimal(rhs, r))
+    {
+        return l.compare(r);
+    }
+    return generic_compare_parts(lhs, rhs);
+}
+
+
+/** \brief Compare two sets of parts with the rules of a trait kind.
+ *
+ * This function calls the Debian, RPM, or decimal compare functions when
+ * \p kind is one of those and the generic compare function otherwise. It
+ * gives the same result as the compare() function of a trait of that
+ * kind, without the need to create the trait objects.
+ *
+ * \param[in] kind  The kind of trait used to parse both versions.
+ * \param[in] lhs  The left hand side parts.
+ * \param[in] rhs  The right hand side parts.
+ *
+ * \return -1, 0, or 1 depending on the order of \p lhs and \p rhs.
+ */
+template<typename L, typename R>
+int compare_parts_by_kind(trait_kind_t kind, L const & lhs, R const & rhs)
+{
+    switch(kind)
+    {
+    case trait_kind_t::TRAIT_KIND_DEBIAN:
+        return debian_compare_parts(lhs, rhs, debian_string_scan_t());
+
+    case trait_kind_t::TRAIT_KIND_RPM:
+        return rpm_compare_parts(lhs, rhs, rpm_string_scan_t());
+
+    case trait_kind_t::TRAIT_KIND_DECIMAL:
+        return decimal_compare_parts(lhs, rhs);
+
+    default:
+        return generic_compare_parts(lhs, rhs);
+
+    }
+}
+
+
+
+}
+// namespace detail
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
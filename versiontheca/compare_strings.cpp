@@ -0,0 +1,503 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the direct comparison of version strings.
+ *
+ * For the basic, Debian, and RPM kinds, both versions are parsed one part
+ * at a time, in lockstep, by the compare functions used by the traits, so
+ * the results are identical. The parts reference the input strings, so
+ * no memory gets allocated, and the parsing stops at the first part which
+ * differs. Only the positions of the epoch and release delimiters get
+ * searched beforehand.
+ *
+ * Like strcmp(), the input found after the first difference is not read.
+ * This means an error in that part of a version is not reported. When
+ * the versions may be invalid, parse them with a trait first.
+ *
+ * Decimal versions are read with parse_fixed_decimal() and compared as
+ * fixed-point numbers, which also requires no memory allocation.
+ *
+ * Other kinds, non-ASCII input, and invalid versions go through the
+ * traits. In case of an invalid version, the trait gives us the error
+ * message.
+ */
+
+// self
+//
+#include    <versiontheca/compare_strings.h>
+
+#include    <versiontheca/exception.h>
+#include    <versiontheca/fixed_decimal.h>
+#include    <versiontheca/policy.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+int compare_with_traits(
+      trait_kind_t kind
+    , std::string_view const & lhs
+    , std::string_view const & rhs
+    , std::size_t limit)
+{
+    trait::pointer_t l(create_trait(kind));
+    if(!l->parse(lhs))
+    {
+        throw invalid_version(
+                  "the left hand side version is not valid: "
+                + l->get_last_error());
+    }
+    trait::pointer_t r(create_trait(kind));
+    if(!r->parse(rhs))
+    {
+        throw invalid_version(
+                  "the right hand side version is not valid: "
+                + r->get_last_error());
+    }
+    return l->compare_prefix(r, limit);
+}
+
+
+/** \brief Parse a version one part at a time.
+ *
+ * The reader parses the parts of a version when the compare functions
+ * ask for them through has_part(). The input is cut in segments: the
+ * upstream version and, when present, the release. The epoch, if any,
+ * gets parsed by the layout function when the reader starts.
+ *
+ * When an error is found, the reader stops returning parts and failed()
+ * returns true. The result of the compare is then ignored.
+ */
+class part_reader
+{
+public:
+    typedef bool (*layout_t)(part_reader & reader);
+
+                        part_reader(std::size_t limit)
+                            : f_limit(limit)
+                        {
+                        }
+
+    bool start(std::string_view const & v, layout_t layout)
+    {
+        if(!f_parts.assign(v)
+        || !layout(*this))
+        {
+            f_failed = true;
+            return false;
+        }
+        f_epoch = f_parts.size();
+        if(f_limit < MAX_PARTS)
+        {
+            // a limited compare never looks at the release
+            //
+            f_count = 1;
+        }
+        return true;
+    }
+
+    void add_segment(
+          std::size_t start
+        , std::size_t end
+        , char sep
+        , character_classes_t const & classes
+        , bool split
+        , char type)
+    {
+        segment_t & s(f_segments[f_count]);
+        s.f_start = start;
+        s.f_end = end;
+        s.f_classes = &classes;
+        s.f_separator = sep;
+        s.f_split = split;
+        s.f_type = type;
+        ++f_count;
+    }
+
+    void set_integers_only() { f_integers_only = true; }
+    void set_number_first() { f_number_first = true; }
+
+    version_parts_view &       parts() { return f_parts; }
+    version_parts_view const & parts() const { return f_parts; }
+    bool                       failed() const { return f_failed; }
+
+    bool has_part(std::size_t idx)
+    {
+        while(idx >= f_parts.size())
+        {
+            if(!next_part())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct segment_t
+    {
+        std::size_t                 f_start = 0;
+        std::size_t                 f_end = 0;
+        character_classes_t const * f_classes = nullptr;
+        char                        f_separator = '\0';
+        bool                        f_split = false;
+        char                        f_type = '\0';
+    };
+
+    bool fail()
+    {
+        f_failed = true;
+        return false;
+    }
+
+    std::size_t value_end(segment_t const & s, std::size_t pos) const
+    {
+        if(!s.f_split)
+        {
+            return s.f_end;
+        }
+        for(; pos < s.f_end; ++pos)
+        {
+            std::uint8_t const c(f_parts.get_input()[pos]);
+            if(c < 0x80
+            && (s.f_classes->f_class[c] & CHARACTER_CLASS_SEPARATOR) != 0)
+            {
+                break;
+            }
+        }
+        return pos;
+    }
+
+    bool next_part()
+    {
+        if(f_failed)
+        {
+            return false;
+        }
+        while(f_segment < f_count)
+        {
+            segment_t const & s(f_segments[f_segment]);
+            if(f_segment == 0
+            && f_limit < MAX_PARTS
+            && f_parts.size() - f_epoch >= f_limit)
+            {
+                return false;
+            }
+            if(f_pos == f_value_end)
+            {
+                if(!f_started)
+                {
+                    f_started = true;
+                    f_pos = s.f_start;
+                    f_sep = s.f_separator;
+                }
+                else if(f_value_end < s.f_end)
+                {
+                    f_sep = f_parts.get_input()[f_value_end];
+                    f_pos = f_value_end + 1;
+                }
+                else
+                {
+                    ++f_segment;
+                    f_started = false;
+                    f_pos = 0;
+                    f_value_end = 0;
+                    continue;
+                }
+                f_value_end = value_end(s, f_pos);
+                if(f_pos >= f_value_end)
+                {
+                    // empty value
+                    //
+                    return fail();
+                }
+            }
+
+            std::size_t const idx(f_parts.size());
+            if(!f_parts.parse_part(f_pos, f_value_end, f_sep, *s.f_classes))
+            {
+                return fail();
+            }
+            f_parts.set_type(idx, s.f_type);
+            if(!f_parts.is_integer(idx)
+            && (f_integers_only
+                || (f_number_first && idx == f_epoch)))
+            {
+                return fail();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    version_parts_view  f_parts = version_parts_view();
+    std::array<segment_t, 2>
+                        f_segments = std::array<segment_t, 2>();
+    std::size_t         f_count = 0;
+    std::size_t         f_segment = 0;
+    std::size_t         f_pos = 0;
+    std::size_t         f_value_end = 0;
+    std::size_t         f_epoch = 0;
+    std::size_t         f_limit = MAX_PARTS;
+    char                f_sep = '\0';
+    bool                f_started = false;
+    bool                f_integers_only = false;
+    bool                f_number_first = false;
+    bool                f_failed = false;
+};
+
+
+/** \brief Give the compare functions access to a part_reader.
+ *
+ * The compare functions take their parts by const reference. This
+ * adapter keeps a reference to the reader so asking for a part can
+ * parse it.
+ */
+class lazy_parts
+{
+public:
+                        lazy_parts(part_reader & reader)
+                            : f_reader(reader)
+                        {
+                        }
+
+    bool                has_part(std::size_t idx) const { return f_reader.has_part(idx); }
+    char                get_type(std::size_t idx) const
+                        {
+                            // the epoch check reads part 0 without has_part()
+                            //
+                            f_reader.has_part(idx);
+                            return f_reader.parts().get_type(idx);
+                        }
+    bool                is_integer(std::size_t idx) const { return f_reader.parts().is_integer(idx); }
+    part_integer_t      get_integer(std::size_t idx) const { return f_reader.parts().get_integer(idx); }
+    std::string_view    get_string(std::size_t idx) const { return f_reader.parts().get_string(idx); }
+
+private:
+    part_reader &       f_reader;
+};
+
+
+bool basic_layout(part_reader & reader)
+{
+    std::size_t const length(reader.parts().get_input().length());
+    if(length == 0)
+    {
+        return false;
+    }
+    reader.add_segment(0, length, '\0', basic_policy::classes, true, '\0');
+    reader.set_integers_only();
+    return true;
+}
+
+
+bool debian_layout(part_reader & reader)
+{
+    std::size_t colon(0);
+    std::size_t dash(0);
+    if(!detail::parse_epoch_and_revision(reader.parts(), colon, dash))
+    {
+        return false;
+    }
+    std::size_t const length(reader.parts().get_input().length());
+    reader.add_segment(colon, dash, colon == 0 ? '\0' : ':', debian_policy::upstream_classes, true, '\0');
+    if(dash < length)
+    {
+        reader.add_segment(dash + 1, length, '-', debian_policy::revision_classes, false, '-');
+    }
+    reader.set_number_first();
+    return true;
+}
+
+
+bool rpm_layout(part_reader & reader)
+{
+    std::size_t colon(0);
+    std::size_t dash(0);
+    if(!detail::parse_epoch_and_revision(reader.parts(), colon, dash))
+    {
+        return false;
+    }
+    std::size_t const length(reader.parts().get_input().length());
+    reader.add_segment(colon, dash, colon == 0 ? '\0' : ':', rpm_policy::classes, true, '\0');
+    if(dash < length)
+    {
+        reader.add_segment(dash + 1, length, '-', rpm_policy::classes, true, '-');
+    }
+    return true;
+}
+
+
+template<typename Policy>
+int compare_with_policy(
+      trait_kind_t kind
+    , std::string_view const & lhs
+    , std::string_view const & rhs
+    , std::size_t limit
+    , part_reader::layout_t layout)
+{
+    part_reader l(limit);
+    part_reader r(limit);
+    if(l.start(lhs, layout)
+    && r.start(rhs, layout))
+    {
+        int const result(Policy::compare(lazy_parts(l), lazy_parts(r)));
+        if(!l.failed()
+        && !r.failed())
+        {
+            return result;
+        }
+    }
+    return compare_with_traits(kind, lhs, rhs, limit);
+}
+
+
+
+int compare_decimal(
+      std::string_view const & lhs
+    , std::string_view const & rhs
+    , std::size_t limit)
+{
+    fixed_decimal_t l;
+    fixed_decimal_t r;
+    if(parse_fixed_decimal(lhs, l)
+    && parse_fixed_decimal(rhs, r))
+    {
+        if(limit == 1)
+        {
+            // compare the integers only
+            //
+            l.f_fraction = 0;
+            r.f_fraction = 0;
+        }
+        return l.compare(r);
+    }
+    return compare_with_traits(trait_kind_t::TRAIT_KIND_DECIMAL, lhs, rhs, limit);
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Compare two version strings.
+ *
+ * This function compares \p lhs and \p rhs as if both were parsed by a
+ * trait of the specified \p kind and then compared with trait::compare().
+ *
+ * For the basic, decimal, Debian, and RPM kinds, no trait gets allocated
+ * unless one of the versions is invalid or includes non-ASCII characters.
+ * The versions are read one part at a time and the function returns as
+ * soon as two parts differ, so the rest of the input does not get read.
+ *
+ * \exception invalid_version
+ * The versions must be valid up to the first difference. The message
+ * says which one is not.
+ *
+ * \exception invalid_parameter
+ * The \p kind is not a valid trait kind.
+ *
+ * \param[in] kind  The kind of versions to compare.
+ * \param[in] lhs  The left hand side version.
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1.
+ */
+int compare_strings(
+      trait_kind_t kind
+    , std::string_view const & lhs
+    , std::string_view const & rhs)
+{
+    return compare_strings(kind, lhs, rhs, MAX_PARTS);
+}
+
+
+/** \brief Compare the first parts of two version strings.
+ *
+ * This function compares \p lhs and \p rhs as if both were parsed by a
+ * trait of the specified \p kind and then compared with
+ * trait::compare_prefix(). Only the first \p limit parts, plus the
+ * epoch if any, are compared. The input after these parts, or after
+ * the first difference, does not get read.
+ *
+ * \exception invalid_version
+ * The versions must be valid up to the first difference. The message
+ * says which one is not.
+ *
+ * \exception invalid_parameter
+ * The \p kind is not a valid trait kind or \p limit is 0.
+ *
+ * \param[in] kind  The kind of versions to compare.
+ * \param[in] lhs  The left hand side version.
+ * \param[in] rhs  The right hand side version.
+ * \param[in] limit  The maximum number of parts to compare.
+ *
+ * \return -1, 0, or 1.
+ */
+int compare_strings(
+      trait_kind_t kind
+    , std::string_view const & lhs
+    , std::string_view const & rhs
+    , std::size_t limit)
+{
+    if(limit == 0)
+    {
+        throw invalid_parameter("the compare limit must be at least 1.");
+    }
+
+    switch(kind)
+    {
+    case trait_kind_t::TRAIT_KIND_BASIC:
+        return compare_with_policy<basic_policy>(kind, lhs, rhs, limit, basic_layout);
+
+    case trait_kind_t::TRAIT_KIND_DECIMAL:
+        return compare_decimal(lhs, rhs, limit);
+
+    case trait_kind_t::TRAIT_KIND_DEBIAN:
+        return compare_with_policy<debian_policy>(kind, lhs, rhs, limit, debian_layout);
+
+    case trait_kind_t::TRAIT_KIND_RPM:
+        return compare_with_policy<rpm_policy>(kind, lhs, rhs, limit, rpm_layout);
+
+    default:
+        return compare_with_traits(kind, lhs, rhs, limit);
+
+    }
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,62 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Compare two version strings directly.
+ *
+ * The compare_strings() function compares two versions without creating
+ * versiontheca objects. The result is the same as parsing both versions
+ * with a trait of the specified kind and calling trait::compare().
+ *
+ * The versions are read part by part and the compare stops at the first
+ * difference. Like strcmp(), the input after that difference is not
+ * read, so an error found there is not reported.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <string_view>
+
+
+
+namespace versiontheca
+{
+
+
+
+int                     compare_strings(
+                              trait_kind_t kind
+                            , std::string_view const & lhs
+                            , std::string_view const & rhs);
+int                     compare_strings(
+                              trait_kind_t kind
+                            , std::string_view const & lhs
+                            , std::string_view const & rhs
+                            , std::size_t limit);
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -36,6 +36,8 @@
 #include    <versiontheca/debian.h>
 
 #include    <versiontheca/exception.h>
+#include    <versiontheca/policy.h>
+#include    <versiontheca/probe.h>
 
 
 // libutf8
@@ -60,62 +62,18 @@ namespace versiontheca
 
 
 
-namespace
-{
-
-
-
-#include    <versiontheca/debian_order_table.ci>
-
-int compare_characters(char a, char b)
-{
-    // see order in debian_order.cpp
-    //
-    int const lidx(static_cast<int>(static_cast<std::uint8_t>(a)));
-    int const ridx(static_cast<int>(static_cast<std::uint8_t>(b)));
-#ifdef _DEBUG
-    if(g_debian_compare_characters[lidx] == 0
-    || g_debian_compare_characters[ridx] == 0)
-    {
-        // LCOV_EXCL_START
-        throw logic_error("index ("
-            + std::to_string(lidx)
-            + " and/or "
-            + std::to_string(ridx)
-            + ") in debian/compare_characters() hit a 0, which means it represents an invalid character.");
-        // LCOV_EXCL_STOP
-    }
-#endif
-    int const r(g_debian_compare_characters[lidx] - g_debian_compare_characters[ridx]);
-    return r == 0 ? 0 : (r < 0 ? -1 : 1);
-}
-
-
-int compare_strings(std::string const & lhs, std::string const & rhs)
+/** \brief Create a copy of this Debian trait.
+ *
+ * The copy includes the parts and the last error.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t debian::clone() const
 {
-    // because of the '~' we have to compare everything ('~' is before
-    // '\0'...)
-    //
-    std::size_t const max(std::max(lhs.length(), rhs.length()));
-    for(std::size_t idx(0); idx < max; ++idx)
-    {
-        char const a(idx >= lhs.length() ? '\0' : lhs[idx]);
-        char const b(idx >= rhs.length() ? '\0' : rhs[idx]);
-        int const r(compare_characters(a, b));
-        if(r != 0)
-        {
-            return r;
-        }
-    }
-    return 0;
+    return std::make_shared<debian>(*this);
 }
 
 
-
-}
-// no name namespace
-
-
 /** \brief Parse a Debian version string.
  *
  * A Debian version string is composed of three parts:
@@ -136,39 +94,43 @@ int compare_strings(std::string const & lhs, std::string const & rhs)
  *
  * \return true if the parser succeeded.
  */
-bool debian::parse(std::string const & v)
+bool debian::parse(std::string_view const & v)
 {
-    std::string::size_type colon(v.find(':'));
-    std::string::size_type dash(v.rfind('-'));
-    if((colon != std::string::npos && dash != std::string::npos && colon >= dash)
+    VERSIONTHECA_PROBE_PARSE(*this, v);
+
+    clear();
+    f_input = v;
+
+    std::string_view::size_type colon(v.find(':'));
+    std::string_view::size_type dash(v.rfind('-'));
+    if((colon != std::string_view::npos && dash != std::string_view::npos && colon >= dash)
     || colon == 0ULL
     || dash == 0ULL)
     {
         // if there is a ':' then there has to be an epoch and a dash
         // cannot appear in the epoch
         //
-        f_last_error =
-              "position of ':' and/or '-' is invalid in \""
-            + v
-            + "\".";
+        set_error(
+                  error_code_t::ERROR_CODE_INVALID_SEPARATOR_POSITION
+                , v.data() + (colon == 0 || dash == 0 ? 0 : dash));
         return false;
     }
 
     // if there is a colon we must have an epoch (there may be more colons
     // later in the version in which case "0:..." is required in that case)
     //
-    if(colon != std::string::npos)
+    if(colon != std::string_view::npos)
     {
         part p;
         f_accepted_chars = accepted_chars_t::ACCEPTED_CHARS_EPOCH;
         if(!p.set_value(v.substr(0, colon)))
         {
-            f_last_error = p.get_last_error();
+            set_error(error_code_t::ERROR_CODE_INTEGER_TOO_LARGE, v.data());
             return false;
         }
         if(!p.is_integer())
         {
-            f_last_error = "epoch must be a valid integer.";
+            set_error(error_code_t::ERROR_CODE_INVALID_EPOCH, v.data());
             return false;
         }
         p.set_type(':');
@@ -176,14 +138,14 @@ bool debian::parse(std::string const & v)
     }
     ++colon;
 
-    if(dash == std::string::npos)
+    if(dash == std::string_view::npos)
     {
         dash = v.length();
     }
 
     // the upstream can be parsed as is with parts separated by periods
     //
-    std::string const upstream_version(v.substr(colon, dash - colon));
+    std::string_view const upstream_version(v.substr(colon, dash - colon));
     f_accepted_chars = accepted_chars_t::ACCEPTED_CHARS_UPSTREAM;
     if(!trait::parse_version(upstream_version, colon == 0 ? U'\0' : U':'))
     {
@@ -192,10 +154,7 @@ bool debian::parse(std::string const & v)
 
     if(!at(colon == 0 ? 0 : 1).is_integer())
     {
-        f_last_error =
-              "a Debian version must always start with a number \""
-            + v
-            + "\".";
+        set_error(error_code_t::ERROR_CODE_DEBIAN_NOT_NUMBER, v.data() + colon);
         return false;
     }
 
@@ -219,6 +178,7 @@ bool debian::parse(std::string const & v)
         }
     }
 
+    update_shape();
     return true;
 }
 
@@ -267,12 +227,30 @@ bool debian::is_valid_character(char32_t c) const
 }
 
 
+character_classes_t const * debian::get_character_classes() const
+{
+    switch(f_accepted_chars)
+    {
+    case accepted_chars_t::ACCEPTED_CHARS_EPOCH:
+        return &debian_policy::epoch_classes;
+
+    case accepted_chars_t::ACCEPTED_CHARS_UPSTREAM:
+        return &debian_policy::upstream_classes;
+
+    case accepted_chars_t::ACCEPTED_CHARS_DEBIAN_REVISION:
+        return &debian_policy::revision_classes;
+
+    }
+
+    return nullptr; // LCOV_EXCL_LINE
+}
+
+
 bool debian::get_upstream_positions(std::size_t & start, std::size_t & end) const
 {
     std::size_t const max(size());
     if(max == 0ULL)
     {
-        f_last_error = "no parts in this Debian version; cannot compute upstream start/end.";
         return false;
     }
 
@@ -306,6 +284,8 @@ bool debian::get_upstream_positions(std::size_t & start, std::size_t & end) cons
 
 bool debian::next(int pos, trait::pointer_t format)
 {
+    VERSIONTHECA_PROBE_COUNT(*this, COUNTER_NEXT);
+
     if(pos < 0)
     {
         throw invalid_parameter("position calling next() cannot be a negative number.");
@@ -323,6 +303,7 @@ bool debian::next(int pos, trait::pointer_t format)
 
     if(!get_upstream_positions(start, end))
     {
+        set_error(error_code_t::ERROR_CODE_DEBIAN_NO_PARTS);
         return false;
     }
 
@@ -333,7 +314,7 @@ bool debian::next(int pos, trait::pointer_t format)
         part alpha;
         do
         {
-            part const f(get_format_part(format, end, true));
+            part const & f(get_format_part(format, end, true));
             if(f.is_integer())
             {
                 zero.set_separator(f.get_separator());
@@ -355,7 +336,7 @@ bool debian::next(int pos, trait::pointer_t format)
         {
             if(static_cast<std::size_t>(pos - 1) <= start)
             {
-                f_last_error = "maximum limit reached; cannot increment version any further.";
+                set_error(error_code_t::ERROR_CODE_MAXIMUM_REACHED);
                 return false;
             }
             erase(pos);
@@ -386,12 +367,15 @@ bool debian::next(int pos, trait::pointer_t format)
         erase(end);
     }
 
+    update_shape();
     return true;
 }
 
 
 bool debian::previous(int pos, trait::pointer_t format)
 {
+    VERSIONTHECA_PROBE_COUNT(*this, COUNTER_PREVIOUS);
+
     if(pos < 0)
     {
         throw invalid_parameter("position calling previous() cannot be a negative number.");
@@ -409,6 +393,7 @@ bool debian::previous(int pos, trait::pointer_t format)
 
     if(!get_upstream_positions(start, end))
     {
+        set_error(error_code_t::ERROR_CODE_DEBIAN_NO_PARTS);
         return false;
     }
 
@@ -432,11 +417,11 @@ bool debian::previous(int pos, trait::pointer_t format)
         {
             if(static_cast<std::size_t>(pos) <= start)
             {
-                f_last_error = "minimum limit reached; cannot decrement version any further.";
+                set_error(error_code_t::ERROR_CODE_MINIMUM_REACHED);
                 return false;
             }
             result = false;
-            part const p(get_format_part(format, pos, at(pos).is_integer()));
+            part const & p(get_format_part(format, pos, at(pos).is_integer()));
             if(p.is_integer())
             {
                 at(pos).set_integer(p.get_integer());
@@ -463,16 +448,16 @@ bool debian::previous(int pos, trait::pointer_t format)
             break;
         }
     }
+    update_shape();
     return true;
 }
 
 
-std::string debian::to_string() const
+bool debian::write_to(version_output & out) const
 {
     if(empty())
     {
-        f_last_error = "no parts to output.";
-        return std::string();
+        return false;
     }
 
     std::size_t start(0);
@@ -485,11 +470,10 @@ std::string debian::to_string() const
     {
         --max;
     }
-    std::string result;
     char32_t sep(U'\0');
     if(is_epoch_required())
     {
-        result += at(0).to_string();
+        at(0).write_to(out);
         sep = U':';
     }
     for(std::size_t idx(start); idx < max; ++idx)
@@ -500,13 +484,17 @@ std::string debian::to_string() const
         }
         if(sep != U'\0')
         {
-            result += sep;
+            out.append(sep);
+        }
+        at(idx).write_to(out);
+        if(out.full())
+        {
+            return true;
         }
-        result += at(idx).to_string();
     }
     if(max - start == 1)
     {
-        result += ".0";
+        out.append(".0");
     }
 
     // there can also be a release
@@ -516,12 +504,12 @@ std::string debian::to_string() const
         sep = at(end).get_separator();
         if(sep != '\0')
         {
-            result += sep;
+            out.append(sep);
         }
-        result += at(end).to_string();
+        at(end).write_to(out);
     }
 
-    return result;
+    return true;
 }
 
 
@@ -566,7 +554,7 @@ bool debian::is_epoch_required() const
         if(!at(idx).is_integer())
         {
             std::string const s(at(idx).get_string());
-            if(s.find(':') != std::string::npos)
+            if(s.find(':') != std::string_view::npos)
             {
                 // it is required
                 //
@@ -616,15 +604,16 @@ bool debian::is_epoch_required() const
  * hand side is considered smaller and 1 if the left hand side is considered
  * larger.
  *
- * \sa compare_characters()
+ * \sa detail::debian_compare_parts()
  */
-int debian::compare(trait::pointer_t rhs) const
+int debian::compare(trait::pointer_t const & rhs) const
 {
+    VERSIONTHECA_PROBE_COMPARE(*this);
+
     if(empty() || rhs == nullptr || rhs->empty())
     {
         throw empty_version("one or both of the input versions are empty.");
     }
-
     pointer_t deb(std::dynamic_pointer_cast<debian>(rhs));
     if(deb == nullptr)
     {
@@ -633,106 +622,130 @@ int debian::compare(trait::pointer_t rhs) const
         return trait::compare(rhs);
     }
 
-    std::size_t lpos(0);
-    std::size_t rpos(0);
+    detail::trait_parts<debian> const l(*this);
+    detail::trait_parts<debian> const r(*deb);
 
-    // compare epoch
+    // builds of the same package usually share the same shape
     //
-    int lepoch(0);
-    int repoch(0);
-    if(at(0).get_type() == ':')
+    if(get_shape() != 0
+    && get_shape() == deb->get_shape())
     {
-        lepoch = at(0).get_integer();
-        lpos = 1;
+        return detail::same_shape_compare_parts(l, r, detail::debian_string_scan_t());
     }
-    if(deb->at(0).get_type() == ':')
+
+    return detail::debian_compare_parts(l, r, detail::debian_string_scan_t());
+}
+
+
+/** \brief Compute a binary key to sort Debian versions.
+ *
+ * The Debian compare() function views each section (upstream and release)
+ * as a list of pairs: a string (possibly empty) followed by an integer
+ * (possibly zero). A missing pair is considered equal to `("", 0)`.
+ *
+ * The key is built as follow:
+ *
+ * \li the epoch as a signed 32 bit number (zero when not defined; compare()
+ * uses an `int`);
+ * \li the upstream section pairs;
+ * \li byte 0x02 to end the upstream section;
+ * \li the release section pairs;
+ * \li byte 0x02 to end the release section.
+ *
+ * Each pair's string is saved using the Debian order table, so `'~'` sorts
+ * before the end of the string, which is marked with the order of `'\0'`.
+ * The integer follows as a signed 32 bit number.
+ *
+ * Since missing pairs equal `("", 0)`, such pairs are not saved. Instead,
+ * the pair following them is prefixed with a byte saying whether that pair
+ * is smaller (0x01) or larger (0x03) than `("", 0)` and a count of the
+ * `("", 0)` pairs found before it (reversed for larger pairs). This is what
+ * makes "1.0~rc1" sort before "1.0" and "1" which sorts before "1.0.1".
+ *
+ * \exception empty_version
+ * The function raises this exception if the version is empty.
+ *
+ * \return The sort key of this Debian version.
+ */
+std::string debian::sort_key() const
+{
+    if(empty())
     {
-        repoch = deb->at(0).get_integer();
-        rpos = 1;
+        throw empty_version("cannot compute the sort key of an empty version.");
     }
-    if(lepoch != repoch)
+
+    std::string key;
+
+    // epoch; the XOR makes memcmp() order the values as an `int`
+    //
+    std::size_t pos(0);
+    part_integer_t epoch(0);
+    if(at(0).get_type() == ':')
     {
-        return lepoch < repoch ? -1 : 1;
+        epoch = at(0).get_integer();
+        pos = 1;
     }
+    append_sort_key_integer(key, epoch ^ 0x80000000U);
 
-    // compare upstream version, then switch to the release version
-    //
-    char type('\0');
-    for(;;)
+    std::size_t const max(size());
+    for(char type('\0');; type = '-')
     {
-        for(bool handle_strings(true);; handle_strings = !handle_strings)
+        std::size_t zeroes(0);
+        while(pos < max && at(pos).get_type() == type)
         {
-            if((lpos >= size() || at(lpos).get_type() != type)
-            && (rpos >= deb->size() || deb->at(rpos).get_type() != type))
+            std::string str;
+            part_integer_t integer(0);
+            if(!at(pos).is_integer())
             {
-                // we reached a different type on both sides
-                // we need to explicitly break
-                //
-                break;
+                str = at(pos).get_string();
+                ++pos;
             }
-
-            int lint(0);
-            std::string lstr;
-            int rint(0);
-            std::string rstr;
-
-            if(lpos < size()
-            && at(lpos).get_type() == type)
+            if(pos < max
+            && at(pos).get_type() == type
+            && at(pos).is_integer())
             {
-                if(handle_strings ^ at(lpos).is_integer())
-                {
-                    if(handle_strings)
-                    {
-                        lstr = at(lpos).get_string();
-                    }
-                    else
-                    {
-                        lint = at(lpos).get_integer();
-                    }
-                    ++lpos;
-                }
+                integer = at(pos).get_integer();
+                ++pos;
             }
 
-            if(rpos < deb->size()
-            && deb->at(rpos).get_type() == type)
+            int r(detail::debian_compare_strings(str, std::string_view()));
+            if(r == 0)
             {
-                if(handle_strings ^ deb->at(rpos).is_integer())
-                {
-                    if(handle_strings)
-                    {
-                        rstr = deb->at(rpos).get_string();
-                    }
-                    else
-                    {
-                        rint = deb->at(rpos).get_integer();
-                    }
-                    ++rpos;
-                }
+                int const signed_integer(integer);
+                r = signed_integer == 0 ? 0 : (signed_integer < 0 ? -1 : 1);
+            }
+            if(r == 0)
+            {
+                // a ("", 0) pair, count it
+                //
+                ++zeroes;
+                continue;
             }
 
-            if(handle_strings)
+            if(r < 0)
             {
-                int const r(compare_strings(lstr, rstr));
-                if(r != 0)
-                {
-                    return r;
-                }
+                key += '\x01';
+                key += static_cast<char>(zeroes);
             }
             else
             {
-                if(lint != rint)
-                {
-                    return lint < rint ? -1 : 1;
-                }
+                key += '\x03';
+                key += static_cast<char>(255 - zeroes);
             }
+            zeroes = 0;
+            for(auto const c : str)
+            {
+                key += static_cast<char>(detail::g_debian_compare_characters[static_cast<std::uint8_t>(c)]);
+            }
+            key += static_cast<char>(detail::g_debian_compare_characters[0]);
+            append_sort_key_integer(key, integer ^ 0x80000000U);
         }
+        key += '\x02';
+
         if(type == '-')
         {
-            // we are done
-            //
-            return 0;
+            return key;
         }
-        type = '-';
     }
 }
 
@@ -28,17 +28,19 @@
  * \li `A` to `Z` -- uppercase letters
  * \li `a` to `z` -- lowercase letters
  * \li `+`
+ * \li `-`
  * \li `:`
  *
- * The `-` defines a release and is never compared (it cannot otherwise appear
- * in the version strings).
+ * The last `-` defines the release. The other `-` characters are part of
+ * the upstream version and get compared like in dpkg, i.e. as per their
+ * ASCII code after all the letters.
  *
  * The `:` defines an epoch and it can appear in the upstream version when
  * the epoch is defined. It currently sorts last.
  *
  * The `.` is viewed as a separator in our system so it never gets compared.
  * Because of that, it is not necessary in our table. It would otherwise
- * sort between the `+` and `:` characters.
+ * sort between the `-` and `:` characters.
  *
  * \note
  * Digits form numbers that are a separate part and compared as integers
@@ -66,6 +68,7 @@ constexpr std::uint8_t const g_supported_characters[] =
     'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
     'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
     '+',
+    '-',
     ':',
 };
 
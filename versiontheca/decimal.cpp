@@ -26,21 +26,24 @@
  * \note
  * It is possible that the result will not be exactly correct when retrieved
  * as a floating point. Internally, though, the version is kept as two
- * separate integers which are always perfectly defined.
+ * separate integers which are always perfectly defined. Compares use
+ * the fixed-point representation of those integers.
  */
 
 // self
 //
 #include    <versiontheca/decimal.h>
 
+#include    <versiontheca/compare.h>
+#include    <versiontheca/exception.h>
+#include    <versiontheca/probe.h>
 
 
 // C++
 //
-#include    <cmath>
-#include    <iomanip>
+#include    <charconv>
 #include    <iostream>
-#include    <sstream>
+#include    <limits>
 
 
 // last include
@@ -54,8 +57,44 @@ namespace versiontheca
 
 
 
-bool decimal::parse(std::string const & v)
+namespace
 {
+
+
+
+constexpr character_classes_t const g_decimal_character_classes(make_character_classes(
+      [](char32_t c)
+      {
+          return c >= U'0' && c <= U'9';
+      }
+    , [](char32_t c)
+      {
+          return c == U'.';
+      }));
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Create a copy of this decimal trait.
+ *
+ * The copy includes the parts and the last error.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t decimal::clone() const
+{
+    return std::make_shared<decimal>(*this);
+}
+
+
+bool decimal::parse(std::string_view const & v)
+{
+    VERSIONTHECA_PROBE_PARSE(*this, v);
+
     if(!trait::parse(v))
     {
         return false;
@@ -70,10 +109,25 @@ bool decimal::parse(std::string const & v)
     // note: since we limit characters to only digits, clearly the parts
     //       should already be integers or an error occurred earlier
     //
-    return (size() == 1 || size() == 2)
-        && at(0).is_integer()
-        && (size() == 1
-            || (at(1).get_separator() == '.' && at(1).is_integer()));
+    if((size() != 1 && size() != 2)
+    || !at(0).is_integer()
+    || (size() == 2
+        && (at(1).get_separator() != '.' || !at(1).is_integer())))
+    {
+        return false;
+    }
+
+    // the fraction must fit in a fixed_decimal_t (the part width is
+    // limited to 8 bits so check the input instead)
+    //
+    if(size() == 2
+    && v.length() - v.find('.') - 1 > DECIMAL_PRECISION)
+    {
+        set_error(error_code_t::ERROR_CODE_INTEGER_TOO_LARGE, v.data() + v.find('.') + 1);
+        return false;
+    }
+
+    return true;
 }
 
 
@@ -83,34 +137,127 @@ bool decimal::is_valid_character(char32_t c) const
 }
 
 
-std::string decimal::to_string() const
+character_classes_t const * decimal::get_character_classes() const
+{
+    return &g_decimal_character_classes;
+}
+
+
+/** \brief Compare two decimal versions.
+ *
+ * The versions are compared as fixed-point numbers, so "1.5" and "1.50"
+ * are equal and "1.05" is smaller than "1.5".
+ *
+ * \note
+ * If the right hand side version is not a decimal version, then the
+ * default trait compare gets used.
+ *
+ * \param[in] rhs  The right hand side.
+ *
+ * \return -1, 0, or 1.
+ *
+ * \sa detail::decimal_compare_parts()
+ */
+int decimal::compare(trait::pointer_t const & rhs) const
+{
+    VERSIONTHECA_PROBE_COMPARE(*this);
+
+    if(empty() || rhs == nullptr || rhs->empty())
+    {
+        throw empty_version("one or both of the input versions are empty.");
+    }
+    pointer_t dec(std::dynamic_pointer_cast<decimal>(rhs));
+    if(dec == nullptr)
+    {
+        // mixed versions, use the default compare() function instead
+        //
+        return trait::compare(rhs);
+    }
+
+    detail::trait_parts<decimal> const l(*this);
+    detail::trait_parts<decimal> const r(*dec);
+    return detail::decimal_compare_parts(l, r);
+}
+
+
+bool decimal::write_to(version_output & out) const
 {
     // ignore all .0 at the end except for the minor version
     // (i.e. "1.0" keep that zero)
     //
     if(empty())
     {
-        f_last_error = "no parts to output.";
-        return std::string();
+        return false;
     }
 
 
     part_integer_t fraction(0);
-    int width(1);
+    std::size_t width(1);
     if(size() == 2)
     {
         fraction = at(1).get_integer();
         width = std::max(static_cast<std::uint8_t>(1), at(1).get_width());
     }
 
-    std::stringstream ss;
-    ss << at(0).get_integer()
-       << '.'
-       << std::setfill('0')
-       << std::setw(width)
-       << fraction;
+    at(0).write_to(out);
+    out.append('.');
+
+    // the fraction is padded with zeroes up to its width
+    //
+    std::size_t length(1);
+    for(part_integer_t f(fraction); f >= 10; f /= 10)
+    {
+        ++length;
+    }
+    if(length < width)
+    {
+        out.append(width - length, '0');
+    }
+    out.append_integer(fraction);
+
+    return true;
+}
+
+
+/** \brief Compute a sort key of this decimal version.
+ *
+ * The key is the integer followed by the fixed-point fraction, both in
+ * big endian, so keys sort like compare(). A zero fraction is omitted so
+ * "1" and "1.0" have the same key.
+ *
+ * \exception empty_version
+ * The version must not be empty.
+ *
+ * \return The sort key.
+ */
+std::string decimal::sort_key() const
+{
+    fixed_decimal_t value;
+    if(!get_fixed_decimal(value))
+    {
+        return trait::sort_key();
+    }
 
-    return ss.str();
+    std::string key;
+    append_sort_key_integer(key, value.f_integer);
+    if(value.f_fraction != 0)
+    {
+        append_sort_key_integer(key, static_cast<std::uint32_t>(value.f_fraction >> 32));
+        append_sort_key_integer(key, static_cast<std::uint32_t>(value.f_fraction));
+    }
+    return key;
+}
+
+
+/** \brief Get the version as a fixed-point number.
+ *
+ * \param[out] value  The version as an integer and a scaled fraction.
+ *
+ * \return false if the version is not a valid decimal version.
+ */
+bool decimal::get_fixed_decimal(fixed_decimal_t & value) const
+{
+    return detail::parts_to_fixed_decimal(detail::trait_parts<decimal>(*this), value);
 }
 
 
@@ -134,21 +281,10 @@ std::string decimal::to_string() const
  */
 double decimal::get_decimal_version() const
 {
-    if(size() > 0)
+    fixed_decimal_t value;
+    if(get_fixed_decimal(value))
     {
-        double version(at(0).get_integer());
-        if(size() == 2)
-        {
-            double const width(at(1).get_width());
-            double const fraction(at(1).get_integer());
-            //double digits(1 + significant_zeroes);
-            //if(fraction > 0)
-            //{
-            //    digits += static_cast<int>(log(fraction));
-            //}
-            version += fraction * pow(10, -width);
-        }
-        return version;
+        return value.to_double();
     }
 
     return std::numeric_limits<double>::quiet_NaN();
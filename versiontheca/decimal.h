@@ -24,10 +24,13 @@
  *
  * This trait is used to transform a simple version defined as two numbers
  * separated by one period in a decimal number (a double).
+ *
+ * The versions are compared as fixed-point numbers (see fixed_decimal.h).
  */
 
 // self
 //
+#include    <versiontheca/fixed_decimal.h>
 #include    <versiontheca/trait.h>
 
 
@@ -42,11 +45,18 @@ class decimal
 public:
     typedef std::shared_ptr<decimal>       pointer_t;
 
-    virtual bool        parse(std::string const & v) override;
+    virtual trait::pointer_t
+                        clone() const override;
+    virtual bool        parse(std::string_view const & v) override;
     virtual bool        is_valid_character(char32_t c) const override;
+    virtual character_classes_t const *
+                        get_character_classes() const override;
+    virtual int         compare(trait::pointer_t const & rhs) const override;
 
-    virtual std::string to_string() const;
+    virtual bool        write_to(version_output & out) const override;
+    virtual std::string sort_key() const override;
 
+    bool                get_fixed_decimal(fixed_decimal_t & value) const;
     double              get_decimal_version() const;
 };
 
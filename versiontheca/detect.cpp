@@ -0,0 +1,261 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the trait detection.
+ *
+ * The classification uses a table giving the class of each ASCII
+ * character. One pass over the input accumulates these classes and
+ * tracks the kind of each part (digits, Roman numeral, or mixed), which
+ * is enough to eliminate the traits which cannot accept the input.
+ */
+
+// self
+//
+#include    <versiontheca/detect.h>
+
+#include    <versiontheca/roman.h>
+
+
+// C++
+//
+#include    <array>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+constexpr std::uint8_t const    CLASS_DIGIT = 0x01;
+constexpr std::uint8_t const    CLASS_PERIOD = 0x02;
+constexpr std::uint8_t const    CLASS_ROMAN = 0x04;     // I, V, X, L, C, D, M in either case
+constexpr std::uint8_t const    CLASS_LETTER = 0x08;    // any other ASCII letter
+constexpr std::uint8_t const    CLASS_DEBIAN = 0x10;    // '+', '~', '-', ':'
+constexpr std::uint8_t const    CLASS_RPM = 0x20;       // '^', '_'
+constexpr std::uint8_t const    CLASS_OTHER = 0x40;     // anything else, including non-ASCII
+
+
+constexpr std::array<std::uint8_t, 256> make_detect_classes()
+{
+    std::array<std::uint8_t, 256> classes = {};
+    for(std::size_t c(0); c < 256; ++c)
+    {
+        classes[c] = CLASS_OTHER;
+    }
+    for(char c('0'); c <= '9'; ++c)
+    {
+        classes[static_cast<unsigned char>(c)] = CLASS_DIGIT;
+    }
+    for(char c('a'); c <= 'z'; ++c)
+    {
+        classes[static_cast<unsigned char>(c)] = CLASS_LETTER;
+        classes[static_cast<unsigned char>(c & ~0x20)] = CLASS_LETTER;
+    }
+    for(char const c : std::string_view("IVXLCDMivxlcdm"))
+    {
+        classes[static_cast<unsigned char>(c)] = CLASS_ROMAN;
+    }
+    classes[static_cast<unsigned char>('.')] = CLASS_PERIOD;
+    for(char const c : std::string_view("+~-:"))
+    {
+        classes[static_cast<unsigned char>(c)] = CLASS_DEBIAN;
+    }
+    for(char const c : std::string_view("^_"))
+    {
+        classes[static_cast<unsigned char>(c)] = CLASS_RPM;
+    }
+    return classes;
+}
+
+
+constexpr std::array<std::uint8_t, 256> const g_detect_classes = make_detect_classes();
+
+
+// the order in which detect_trait() tries the traits
+//
+constexpr trait_kind_t const g_detect_order[] =
+{
+    trait_kind_t::TRAIT_KIND_BASIC,
+    trait_kind_t::TRAIT_KIND_DECIMAL,
+    trait_kind_t::TRAIT_KIND_ROMAN,
+    trait_kind_t::TRAIT_KIND_DEBIAN,
+    trait_kind_t::TRAIT_KIND_RPM,
+    trait_kind_t::TRAIT_KIND_UNICODE,
+};
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Find the traits which may accept a version.
+ *
+ * This function scans \p v once and returns a mask with one bit per
+ * trait (see trait_kind_to_mask()) which may accept the version. The
+ * decision is based on the characters found in the version and the
+ * kind of each part:
+ *
+ * \li basic -- only digits and periods
+ * \li decimal -- only digits and at most one period
+ * \li roman -- only digits, Roman numerals, and periods, with at least
+ * one part being a valid Roman numeral
+ * \li debian -- letters, digits, and ".+~-:", starting with a digit
+ * \li rpm -- letters, digits, and ".+~-:^_"
+ * \li unicode -- any non-empty version
+ *
+ * A bit being set does not guarantee that the trait accepts the version.
+ * For example, the positions of the periods, the epoch, and the release
+ * are only verified by the parser. A bit which is not set, however,
+ * means the trait rejects the version. The roman trait is the exception:
+ * it accepts anything the unicode trait accepts, so its bit only tells
+ * that the version includes Roman numerals.
+ *
+ * \param[in] v  The version to classify.
+ *
+ * \return The mask of the candidate traits, 0 if \p v is empty.
+ */
+trait_kind_mask_t classify_version(std::string_view const & v)
+{
+    if(v.empty())
+    {
+        return 0;
+    }
+
+    std::uint8_t all(0);
+    std::uint8_t part(0);
+    std::size_t part_start(0);
+    std::size_t periods(0);
+    bool roman_part(false);
+    bool mixed_part(false);
+    std::size_t const max(v.length());
+    for(std::size_t idx(0); idx <= max; ++idx)
+    {
+        std::uint8_t const c(idx < max
+                    ? g_detect_classes[static_cast<unsigned char>(v[idx])]
+                    : CLASS_PERIOD);
+        if(c == CLASS_PERIOD)
+        {
+            if(part == CLASS_ROMAN)
+            {
+                roman_part = roman_part
+                    || from_roman_number(v.substr(part_start, idx - part_start)) != 0;
+            }
+            else if(part != CLASS_DIGIT)
+            {
+                mixed_part = true;
+            }
+            part = 0;
+            part_start = idx + 1;
+            if(idx < max)
+            {
+                ++periods;
+            }
+        }
+        else
+        {
+            part |= c;
+        }
+        all |= c;
+    }
+
+    trait_kind_mask_t result(trait_kind_to_mask(trait_kind_t::TRAIT_KIND_UNICODE));
+    if((all & ~(CLASS_DIGIT | CLASS_PERIOD)) == 0)
+    {
+        result |= trait_kind_to_mask(trait_kind_t::TRAIT_KIND_BASIC);
+        if(periods <= 1)
+        {
+            result |= trait_kind_to_mask(trait_kind_t::TRAIT_KIND_DECIMAL);
+        }
+    }
+    if(roman_part && !mixed_part)
+    {
+        result |= trait_kind_to_mask(trait_kind_t::TRAIT_KIND_ROMAN);
+    }
+    if((all & (CLASS_RPM | CLASS_OTHER)) == 0
+    && g_detect_classes[static_cast<unsigned char>(v[0])] == CLASS_DIGIT)
+    {
+        result |= trait_kind_to_mask(trait_kind_t::TRAIT_KIND_DEBIAN);
+    }
+    if((all & CLASS_OTHER) == 0)
+    {
+        result |= trait_kind_to_mask(trait_kind_t::TRAIT_KIND_RPM);
+    }
+    return result;
+}
+
+
+/** \brief Detect the trait of a version and parse it.
+ *
+ * This function classifies \p v with classify_version() and then parses
+ * it with the most specific candidate. If that trait rejects the
+ * version, the next candidate is tried. The result is the trait which
+ * accepted the version, already parsed, so the version does not need
+ * to be parsed again.
+ *
+ * \param[in] v  The version to detect and parse.
+ * \param[out] kind  If not nullptr, receives the kind of the trait.
+ * \param[in] resource  The memory resource used to allocate the trait,
+ * nullptr to use the heap.
+ *
+ * \return The parsed trait or nullptr if no trait accepts \p v.
+ */
+trait::pointer_t detect_trait(
+      std::string_view const & v
+    , trait_kind_t * kind
+    , std::pmr::memory_resource * resource)
+{
+    trait_kind_mask_t const candidates(classify_version(v));
+    for(trait_kind_t const k : g_detect_order)
+    {
+        if((candidates & trait_kind_to_mask(k)) == 0)
+        {
+            continue;
+        }
+        trait::pointer_t t(create_trait(k, resource));
+        if(t->parse(v))
+        {
+            if(kind != nullptr)
+            {
+                *kind = k;
+            }
+            return t;
+        }
+    }
+
+    return trait::pointer_t();
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,78 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Detect the trait of a version.
+ *
+ * A corpus of mixed versions (package metadata coming from various
+ * distributions, for example) does not say which trait each version
+ * follows. Trying to parse each version with one trait after another
+ * means parsing it up to six times.
+ *
+ * The classify_version() function scans the input once and returns the
+ * set of traits whose grammar can accept it, using only the characters
+ * found in the input. The detect_trait() function then parses the
+ * version with the most specific of those traits, in this order:
+ *
+ * \li basic -- digits separated by periods
+ * \li decimal -- one or two integers separated by a period
+ * \li roman -- parts made of digits or of Roman numerals only
+ * \li debian
+ * \li rpm
+ * \li unicode
+ *
+ * Since every decimal version is also a basic version, detect_trait()
+ * never returns a decimal trait; use the classify_version() mask to
+ * distinguish versions which could be read as decimal numbers.
+ *
+ * In nearly all cases, the first candidate parses the version so
+ * detect_trait() scans the input once and parses it once.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+typedef std::uint32_t           trait_kind_mask_t;
+
+
+constexpr trait_kind_mask_t trait_kind_to_mask(trait_kind_t kind)
+{
+    return static_cast<trait_kind_mask_t>(1) << static_cast<int>(kind);
+}
+
+
+trait_kind_mask_t       classify_version(std::string_view const & v);
+trait::pointer_t        detect_trait(
+                              std::string_view const & v
+                            , trait_kind_t * kind = nullptr
+                            , std::pmr::memory_resource * resource = nullptr);
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
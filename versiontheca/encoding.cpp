@@ -0,0 +1,577 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the binary encoding of parsed versions.
+ *
+ * The encoded_version_list file is organized as follow:
+ *
+ * \li the header (header_t);
+ * \li the encoded versions one after the other;
+ * \li padding to align the next field on 8 bytes;
+ * \li count + 1 64 bit offsets of the versions in the data.
+ *
+ * The header and the offsets use the byte order of the computer that
+ * created the file.
+ */
+
+// self
+//
+#include    <versiontheca/encoding.h>
+
+#include    <versiontheca/compare.h>
+#include    <versiontheca/exception.h>
+#include    <versiontheca/mapped_file.h>
+
+
+// C++
+//
+#include    <cstring>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+// "VTEV" -- also used to detect a file created with a different byte order
+//
+constexpr std::uint32_t const   ENCODED_LIST_MAGIC = 0x56455456;
+
+
+void append_varint(std::string & out, std::uint32_t value)
+{
+    while(value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+
+std::uint8_t read_byte(std::string_view const & data, std::size_t & pos)
+{
+    if(pos >= data.length())
+    {
+        throw invalid_encoding("encoded version is truncated.");
+    }
+    return static_cast<std::uint8_t>(data[pos++]);
+}
+
+
+std::uint32_t read_varint(std::string_view const & data, std::size_t & pos)
+{
+    std::uint32_t result(0);
+    for(int shift(0);; shift += 7)
+    {
+        std::uint8_t const c(read_byte(data, pos));
+        if(shift == 28 && c > 0x0F)
+        {
+            throw invalid_encoding("encoded version includes a varint which is too large.");
+        }
+        result |= static_cast<std::uint32_t>(c & 0x7F) << shift;
+        if((c & 0x80) == 0)
+        {
+            return result;
+        }
+    }
+}
+
+
+
+}
+// no name namespace
+
+
+
+struct encoded_version_list::header_t
+{
+    std::uint32_t       f_magic = ENCODED_LIST_MAGIC;
+    std::uint32_t       f_version = FILE_VERSION;
+    std::uint32_t       f_kind = 0;
+    std::uint32_t       f_reserved = 0;
+    std::uint64_t       f_count = 0;
+    std::uint64_t       f_data_size = 0;
+    std::uint64_t       f_offsets = 0;
+};
+
+
+
+/** \brief Encode the parts of a trait.
+ *
+ * The encoded version is appended to \p out.
+ *
+ * \param[in] t  The trait to encode.
+ * \param[in,out] out  The string where the encoded version is appended.
+ */
+void encode_parts(trait const & t, std::string & out)
+{
+    std::size_t const count(t.size());
+    out += static_cast<char>(count);
+    for(std::size_t idx(0); idx < count; ++idx)
+    {
+        part const & p(t.at(idx));
+        std::uint8_t flags(0);
+        if(p.is_integer())
+        {
+            flags |= ENCODED_PART_INTEGER;
+        }
+        if(p.get_separator() != NO_SEPARATOR)
+        {
+            flags |= ENCODED_PART_SEPARATOR;
+        }
+        if(p.get_type() != '\0')
+        {
+            flags |= ENCODED_PART_TYPE;
+        }
+        if(p.get_width() != 0)
+        {
+            flags |= ENCODED_PART_WIDTH;
+        }
+        out += static_cast<char>(flags);
+        if((flags & ENCODED_PART_SEPARATOR) != 0)
+        {
+            append_varint(out, p.get_separator());
+        }
+        if((flags & ENCODED_PART_TYPE) != 0)
+        {
+            out += p.get_type();
+        }
+        if((flags & ENCODED_PART_WIDTH) != 0)
+        {
+            out += static_cast<char>(p.get_width());
+        }
+        if(p.is_integer())
+        {
+            append_varint(out, p.get_integer());
+        }
+        else
+        {
+            std::string const & s(p.get_string());
+            append_varint(out, static_cast<std::uint32_t>(s.length()));
+            out += s;
+        }
+    }
+}
+
+
+std::string encode_parts(trait const & t)
+{
+    std::string result;
+    encode_parts(t, result);
+    return result;
+}
+
+
+/** \brief Replace the parts of a trait with an encoded version.
+ *
+ * \exception invalid_encoding
+ * The function raises this exception if \p data is not a valid encoded
+ * version.
+ *
+ * \param[in] data  The encoded version.
+ * \param[in,out] t  The trait receiving the parts.
+ */
+void decode_parts(std::string_view const & data, trait & t)
+{
+    encoded_parts const parts(data);
+    t.clear();
+    for(std::size_t idx(0); idx < parts.size(); ++idx)
+    {
+        part p;
+        p.set_separator(parts.get_separator(idx));
+        p.set_type(parts.get_type(idx));
+        p.set_width(parts.get_width(idx));
+        if(parts.is_integer(idx))
+        {
+            p.set_integer(parts.get_integer(idx));
+        }
+        else
+        {
+            p.set_string(parts.get_string(idx));
+        }
+        t.push_back(p);
+    }
+}
+
+
+
+/** \brief Create a view of an encoded version.
+ *
+ * The data is verified and the position of each part is saved in the
+ * view. The strings are not copied so \p data must remain valid as long
+ * as the view is used.
+ *
+ * The data may include more bytes than the encoded version. Use
+ * encoded_size() to know how many bytes were used.
+ *
+ * \exception invalid_encoding
+ * The function raises this exception if \p data is not a valid encoded
+ * version.
+ *
+ * \param[in] data  The encoded version.
+ */
+encoded_parts::encoded_parts(std::string_view const & data)
+    : f_data(data)
+{
+    std::size_t pos(0);
+    f_size = read_byte(data, pos);
+    if(f_size > MAX_PARTS)
+    {
+        throw invalid_encoding("encoded version has too many parts.");
+    }
+    for(std::size_t idx(0); idx < f_size; ++idx)
+    {
+        entry_t & e(f_entries[idx]);
+        std::uint8_t const flags(read_byte(data, pos));
+        if((flags & ~(ENCODED_PART_INTEGER | ENCODED_PART_SEPARATOR | ENCODED_PART_TYPE | ENCODED_PART_WIDTH)) != 0)
+        {
+            throw invalid_encoding("encoded version includes unknown flags.");
+        }
+        if((flags & ENCODED_PART_SEPARATOR) != 0)
+        {
+            e.f_separator = read_varint(data, pos);
+        }
+        if((flags & ENCODED_PART_TYPE) != 0)
+        {
+            e.f_type = static_cast<char>(read_byte(data, pos));
+        }
+        if((flags & ENCODED_PART_WIDTH) != 0)
+        {
+            e.f_width = read_byte(data, pos);
+        }
+        e.f_is_integer = (flags & ENCODED_PART_INTEGER) != 0;
+        e.f_integer = read_varint(data, pos);
+        if(!e.f_is_integer)
+        {
+            if(e.f_integer > data.length() - pos)
+            {
+                throw invalid_encoding("encoded version is truncated.");
+            }
+            e.f_offset = static_cast<std::uint32_t>(pos);
+            pos += e.f_integer;
+        }
+    }
+    f_encoded_size = pos;
+}
+
+
+std::size_t encoded_parts::size() const
+{
+    return f_size;
+}
+
+
+std::size_t encoded_parts::encoded_size() const
+{
+    return f_encoded_size;
+}
+
+
+char32_t encoded_parts::get_separator(std::size_t idx) const
+{
+    return f_entries[idx].f_separator;
+}
+
+
+std::uint8_t encoded_parts::get_width(std::size_t idx) const
+{
+    return f_entries[idx].f_width;
+}
+
+
+char encoded_parts::get_type(std::size_t idx) const
+{
+    return f_entries[idx].f_type;
+}
+
+
+bool encoded_parts::is_integer(std::size_t idx) const
+{
+    return f_entries[idx].f_is_integer;
+}
+
+
+part_integer_t encoded_parts::get_integer(std::size_t idx) const
+{
+    return f_entries[idx].f_is_integer ? f_entries[idx].f_integer : 0;
+}
+
+
+std::string_view encoded_parts::get_string(std::size_t idx) const
+{
+    entry_t const & e(f_entries[idx]);
+    if(e.f_is_integer)
+    {
+        return std::string_view();
+    }
+    return f_data.substr(e.f_offset, e.f_integer);
+}
+
+
+
+/** \brief Compare two encoded versions.
+ *
+ * The result is the same as the trait::compare() function of the
+ * specified kind of trait would return with the decoded versions.
+ *
+ * \exception empty_version
+ * The function raises this exception if one of the versions has no parts.
+ *
+ * \param[in] kind  The kind of trait which created the versions.
+ * \param[in] lhs  The left hand side version.
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1.
+ */
+int compare_encoded(
+      trait_kind_t kind
+    , encoded_parts const & lhs
+    , encoded_parts const & rhs)
+{
+    if(lhs.size() == 0 || rhs.size() == 0)
+    {
+        throw empty_version("one or both of the input versions are empty.");
+    }
+    return detail::compare_parts_by_kind(kind, lhs, rhs);
+}
+
+
+int compare_encoded(
+      trait_kind_t kind
+    , std::string_view const & lhs
+    , std::string_view const & rhs)
+{
+    return compare_encoded(kind, encoded_parts(lhs), encoded_parts(rhs));
+}
+
+
+
+/** \brief Create an empty list of encoded versions.
+ *
+ * \param[in] kind  The kind of trait used to create the versions.
+ */
+encoded_version_list::encoded_version_list(trait_kind_t kind)
+    : f_kind(kind)
+{
+}
+
+
+/** \brief Load a list saved with save().
+ *
+ * The file is mapped in memory. The versions are verified when accessed.
+ * A loaded list cannot be modified.
+ *
+ * \exception io_error
+ * The function raises this exception if the file cannot be opened or
+ * mapped in memory.
+ *
+ * \exception invalid_index
+ * The function raises this exception if the file is too small.
+ *
+ * \exception invalid_encoding
+ * The function raises this exception if the file is not a valid list.
+ *
+ * \param[in] filename  The name of the file to load.
+ *
+ * \return The loaded list.
+ */
+encoded_version_list encoded_version_list::load(std::string const & filename)
+{
+    std::size_t size(0);
+    std::shared_ptr<char const> data(detail::map_file(filename, "encoded versions", sizeof(header_t), size));
+
+    header_t const * h(reinterpret_cast<header_t const *>(data.get()));
+    if(h->f_magic != ENCODED_LIST_MAGIC)
+    {
+        throw invalid_encoding("this is not a list of encoded versions or it was created on a computer with a different byte order.");
+    }
+    if(h->f_version != FILE_VERSION)
+    {
+        throw invalid_encoding("unsupported encoded versions file version " + std::to_string(h->f_version) + ".");
+    }
+    if(h->f_kind > static_cast<std::uint32_t>(trait_kind_t::TRAIT_KIND_UNICODE))
+    {
+        throw invalid_encoding("unknown trait kind in encoded versions file.");
+    }
+    if(h->f_data_size > size - sizeof(header_t)
+    || h->f_offsets < sizeof(header_t) + h->f_data_size
+    || h->f_offsets % sizeof(std::uint64_t) != 0
+    || h->f_offsets > size
+    || h->f_count >= (size - h->f_offsets) / sizeof(std::uint64_t)
+    || h->f_offsets + (h->f_count + 1) * sizeof(std::uint64_t) != size)
+    {
+        throw invalid_encoding("the encoded versions file is corrupted (invalid header).");
+    }
+
+    encoded_version_list result(static_cast<trait_kind_t>(h->f_kind));
+    result.f_mapped = data;
+    result.f_mapped_data = data.get() + sizeof(header_t);
+    result.f_mapped_offsets = reinterpret_cast<std::uint64_t const *>(data.get() + h->f_offsets);
+    result.f_mapped_count = h->f_count;
+    if(result.f_mapped_offsets[h->f_count] != h->f_data_size)
+    {
+        throw invalid_encoding("the encoded versions file is corrupted (invalid header).");
+    }
+    return result;
+}
+
+
+/** \brief Save this list to a file.
+ *
+ * \exception io_error
+ * The function raises this exception if the file cannot be written.
+ *
+ * \param[in] filename  The name of the file to create.
+ */
+void encoded_version_list::save(std::string const & filename) const
+{
+    std::size_t const count(size());
+    std::string_view const data(f_mapped != nullptr
+            ? std::string_view(f_mapped_data, f_mapped_offsets[count])
+            : std::string_view(f_buffer));
+
+    header_t h;
+    h.f_kind = static_cast<std::uint32_t>(f_kind);
+    h.f_count = count;
+    h.f_data_size = data.length();
+    h.f_offsets = (sizeof(header_t) + data.length() + sizeof(std::uint64_t) - 1) & ~(sizeof(std::uint64_t) - 1);
+
+    std::string file(h.f_offsets + (count + 1) * sizeof(std::uint64_t), '\0');
+    memcpy(file.data(), &h, sizeof(h));
+    memcpy(file.data() + sizeof(h), data.data(), data.length());
+    for(std::size_t idx(0); idx <= count; ++idx)
+    {
+        std::uint64_t const offset(f_mapped != nullptr ? f_mapped_offsets[idx] : f_offsets[idx]);
+        memcpy(file.data() + h.f_offsets + idx * sizeof(std::uint64_t), &offset, sizeof(offset));
+    }
+
+    detail::save_file(filename, "encoded versions", file.data(), file.length());
+}
+
+
+trait_kind_t encoded_version_list::get_kind() const
+{
+    return f_kind;
+}
+
+
+/** \brief Encode and add a version to this list.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the list was loaded from a file.
+ *
+ * \param[in] t  The trait to encode.
+ *
+ * \return The index of the new version.
+ */
+std::size_t encoded_version_list::add(trait const & t)
+{
+    if(f_mapped != nullptr)
+    {
+        throw invalid_parameter("a list of encoded versions loaded from a file cannot be modified.");
+    }
+    encode_parts(t, f_buffer);
+    f_offsets.push_back(f_buffer.length());
+    return f_offsets.size() - 2;
+}
+
+
+std::size_t encoded_version_list::size() const
+{
+    return f_mapped != nullptr ? f_mapped_count : f_offsets.size() - 1;
+}
+
+
+bool encoded_version_list::empty() const
+{
+    return size() == 0;
+}
+
+
+/** \brief Retrieve the encoded version at \p idx.
+ *
+ * \exception invalid_encoding
+ * The function raises this exception if the offsets found in a loaded
+ * file are not valid.
+ *
+ * \param[in] idx  The index of the version.
+ *
+ * \return A view of the encoded bytes.
+ */
+std::string_view encoded_version_list::get_encoded(std::size_t idx) const
+{
+    verify_index(idx);
+    if(f_mapped == nullptr)
+    {
+        return std::string_view(f_buffer).substr(f_offsets[idx], f_offsets[idx + 1] - f_offsets[idx]);
+    }
+
+    std::uint64_t const start(f_mapped_offsets[idx]);
+    std::uint64_t const end(f_mapped_offsets[idx + 1]);
+    if(start > end
+    || end > f_mapped_offsets[f_mapped_count])
+    {
+        throw invalid_encoding("the encoded versions file is corrupted (invalid offset).");
+    }
+    return std::string_view(f_mapped_data + start, end - start);
+}
+
+
+encoded_parts encoded_version_list::get_parts(std::size_t idx) const
+{
+    return encoded_parts(get_encoded(idx));
+}
+
+
+int encoded_version_list::compare(std::size_t lhs, std::size_t rhs) const
+{
+    return compare_encoded(f_kind, get_parts(lhs), get_parts(rhs));
+}
+
+
+void encoded_version_list::verify_index(std::size_t idx) const
+{
+    if(idx >= size())
+    {
+        throw invalid_parameter(
+                  "index "
+                + std::to_string(idx)
+                + " is out of range for a list of "
+                + std::to_string(size())
+                + " encoded versions.");
+    }
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
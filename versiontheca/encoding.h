@@ -0,0 +1,169 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Compact binary encoding of parsed versions.
+ *
+ * A parsed version (the parts of a trait) can be saved in binary so it
+ * can be loaded back or compared without parsing the version string
+ * again. The encoding of one version is:
+ *
+ * \code
+ *     count           1 byte, the number of parts (0 to MAX_PARTS)
+ *     parts           count times:
+ *         flags           1 byte, a combination of the ENCODED_PART_... flags
+ *         separator       varint, only if ENCODED_PART_SEPARATOR is set
+ *         type            1 byte, only if ENCODED_PART_TYPE is set
+ *         width           1 byte, only if ENCODED_PART_WIDTH is set
+ *         value           if ENCODED_PART_INTEGER is set, a varint;
+ *                         otherwise a varint length followed by the
+ *                         bytes of the string
+ * \endcode
+ *
+ * A varint is an unsigned integer saved 7 bits at a time, least
+ * significant bits first (LEB128). Bit 7 is set in all the bytes except
+ * the last one. The encoding does not depend on the byte order of the
+ * computer.
+ *
+ * The encoded_parts class is a view of an encoded version. It does not
+ * copy the strings so it can be used directly on a mapped file and
+ * its functions are the ones expected by the compare functions (see
+ * compare.h). compare_encoded() uses them to compare two encoded
+ * versions the same way the traits compare them.
+ *
+ * The encoded_version_list class saves any number of encoded versions
+ * in a file which is mapped in memory on load.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <array>
+#include    <memory>
+
+
+
+namespace versiontheca
+{
+
+
+
+constexpr std::uint8_t const    ENCODED_PART_INTEGER    = 0x01;
+constexpr std::uint8_t const    ENCODED_PART_SEPARATOR  = 0x02;
+constexpr std::uint8_t const    ENCODED_PART_TYPE       = 0x04;
+constexpr std::uint8_t const    ENCODED_PART_WIDTH      = 0x08;
+
+
+void                    encode_parts(trait const & t, std::string & out);
+std::string             encode_parts(trait const & t);
+void                    decode_parts(std::string_view const & data, trait & t);
+
+
+class encoded_parts
+{
+public:
+                        encoded_parts(std::string_view const & data);
+
+    std::size_t         size() const;
+    std::size_t         encoded_size() const;
+    char32_t            get_separator(std::size_t idx) const;
+    std::uint8_t        get_width(std::size_t idx) const;
+    char                get_type(std::size_t idx) const;
+    bool                is_integer(std::size_t idx) const;
+    part_integer_t      get_integer(std::size_t idx) const;
+    std::string_view    get_string(std::size_t idx) const;
+
+private:
+    struct entry_t
+    {
+        char32_t            f_separator = NO_SEPARATOR;
+        part_integer_t      f_integer = 0;      // or the length of the string
+        std::uint32_t       f_offset = 0;       // offset of the string
+        char                f_type = '\0';
+        std::uint8_t        f_width = 0;
+        bool                f_is_integer = true;
+    };
+
+    std::string_view    f_data = std::string_view();
+    std::size_t         f_size = 0;
+    std::size_t         f_encoded_size = 0;
+    std::array<entry_t, MAX_PARTS>
+                        f_entries = std::array<entry_t, MAX_PARTS>();
+};
+
+
+int                     compare_encoded(
+                              trait_kind_t kind
+                            , encoded_parts const & lhs
+                            , encoded_parts const & rhs);
+int                     compare_encoded(
+                              trait_kind_t kind
+                            , std::string_view const & lhs
+                            , std::string_view const & rhs);
+
+
+class encoded_version_list
+{
+public:
+    static constexpr std::uint32_t const    FILE_VERSION = 1;
+
+                        encoded_version_list(trait_kind_t kind);
+
+    static encoded_version_list
+                        load(std::string const & filename);
+    void                save(std::string const & filename) const;
+
+    trait_kind_t        get_kind() const;
+    std::size_t         add(trait const & t);
+    std::size_t         size() const;
+    bool                empty() const;
+    std::string_view    get_encoded(std::size_t idx) const;
+    encoded_parts       get_parts(std::size_t idx) const;
+    int                 compare(std::size_t lhs, std::size_t rhs) const;
+
+private:
+    struct header_t;
+
+    void                verify_index(std::size_t idx) const;
+
+    trait_kind_t        f_kind = trait_kind_t::TRAIT_KIND_UNICODE;
+
+    // when built with add()
+    std::string         f_buffer = std::string();
+    std::vector<std::uint64_t>
+                        f_offsets = std::vector<std::uint64_t>{ 0 };
+
+    // when loaded from a file
+    std::shared_ptr<char const>
+                        f_mapped = std::shared_ptr<char const>();
+    char const *        f_mapped_data = nullptr;
+    std::uint64_t const *
+                        f_mapped_offsets = nullptr;
+    std::size_t         f_mapped_count = 0;
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
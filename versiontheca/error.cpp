@@ -0,0 +1,139 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the error messages.
+ *
+ * The messages are the ones the parsers used to build directly. They are
+ * now only built when get_last_error() gets called.
+ */
+
+// self
+//
+#include    <versiontheca/error.h>
+
+
+// snapdev
+//
+#include    <snapdev/hexadecimal_string.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+/** \brief Check whether the message of an error includes the input.
+ *
+ * A few messages include the whole version. When such an error occurs,
+ * the parser keeps a copy of the input so the message can be generated
+ * later.
+ *
+ * \param[in] code  The error code to check.
+ *
+ * \return true if error_message() needs the input for \p code.
+ */
+bool error_message_includes_input(error_code_t code)
+{
+    return code == error_code_t::ERROR_CODE_INVALID_SEPARATOR_POSITION
+        || code == error_code_t::ERROR_CODE_DEBIAN_NOT_NUMBER;
+}
+
+
+/** \brief Generate the message of an error.
+ *
+ * \param[in] error  The error to transform in a message.
+ * \param[in] input  The version that generated the error, only used when
+ * error_message_includes_input() returns true.
+ *
+ * \return The error message or an empty string for ERROR_CODE_NONE.
+ */
+std::string error_message(version_error_t const & error, std::string_view const & input)
+{
+    switch(error.f_code)
+    {
+    case error_code_t::ERROR_CODE_NONE:
+        break;
+
+    case error_code_t::ERROR_CODE_EMPTY_INPUT:
+        return "an empty input string cannot represent a valid version.";
+
+    case error_code_t::ERROR_CODE_INVALID_UTF8:
+        return "input string includes an invalid code not representing a valid UTF-8 character.";
+
+    case error_code_t::ERROR_CODE_EMPTY_VALUE:
+        return "a version value cannot be an empty string.";
+
+    case error_code_t::ERROR_CODE_INTEGER_TOO_LARGE:
+        return "integer too large for a valid version.";
+
+    case error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER:
+        return "found unexpected character: \\U"
+            + snapdev::int_to_hex(error.f_character, true, 6)
+            + " in input.";
+
+    case error_code_t::ERROR_CODE_BASIC_NOT_INTEGER:
+        return "basic versions only support integers separated by periods (.).";
+
+    case error_code_t::ERROR_CODE_INVALID_SEPARATOR_POSITION:
+        return "position of ':' and/or '-' is invalid in \""
+            + std::string(input)
+            + "\".";
+
+    case error_code_t::ERROR_CODE_INVALID_EPOCH:
+        return "epoch must be a valid integer.";
+
+    case error_code_t::ERROR_CODE_DEBIAN_NOT_NUMBER:
+        return "a Debian version must always start with a number \""
+            + std::string(input)
+            + "\".";
+
+    case error_code_t::ERROR_CODE_DEBIAN_NO_PARTS:
+        return "no parts in this Debian version; cannot compute upstream start/end.";
+
+    case error_code_t::ERROR_CODE_RPM_NO_PARTS:
+        return "no parts in this RPM version; cannot compute upstream start/end.";
+
+    case error_code_t::ERROR_CODE_MAXIMUM_REACHED:
+        return "maximum limit reached; cannot increment version any further.";
+
+    case error_code_t::ERROR_CODE_MINIMUM_REACHED:
+        return "minimum limit reached; cannot decrement version any further.";
+
+    case error_code_t::ERROR_CODE_NO_PARTS_TO_OUTPUT:
+        return "no parts to output.";
+
+    case error_code_t::ERROR_CODE_OUT_OF_RANGE:
+        return "the version is out of the generator range.";
+
+    }
+
+    return std::string();
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,86 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Errors found while parsing and handling versions.
+ *
+ * The parsers record errors as a small structure: an error code, the
+ * offset in the input where the error was found, and the offending
+ * character when there is one. The human readable message is only
+ * generated when requested, so an invalid version costs no more than a
+ * valid one.
+ *
+ * Only the functions which modify a version (parse(), next(),
+ * previous()...) record errors. The const functions report a failure
+ * with their return value so they never write to a version.
+ */
+
+// C++
+//
+#include    <cstdint>
+#include    <string>
+#include    <string_view>
+
+
+
+namespace versiontheca
+{
+
+
+
+enum class error_code_t : std::uint8_t
+{
+    ERROR_CODE_NONE,
+
+    ERROR_CODE_EMPTY_INPUT,
+    ERROR_CODE_INVALID_UTF8,
+    ERROR_CODE_EMPTY_VALUE,
+    ERROR_CODE_INTEGER_TOO_LARGE,
+    ERROR_CODE_UNEXPECTED_CHARACTER,
+    ERROR_CODE_BASIC_NOT_INTEGER,
+    ERROR_CODE_INVALID_SEPARATOR_POSITION,
+    ERROR_CODE_INVALID_EPOCH,
+    ERROR_CODE_DEBIAN_NOT_NUMBER,
+    ERROR_CODE_DEBIAN_NO_PARTS,
+    ERROR_CODE_RPM_NO_PARTS,
+    ERROR_CODE_MAXIMUM_REACHED,
+    ERROR_CODE_MINIMUM_REACHED,
+    ERROR_CODE_NO_PARTS_TO_OUTPUT,
+    ERROR_CODE_OUT_OF_RANGE,
+};
+
+
+struct version_error_t
+{
+    error_code_t        f_code = error_code_t::ERROR_CODE_NONE;
+    std::uint32_t       f_offset = 0;
+    char32_t            f_character = U'\0';
+};
+
+
+bool                    error_message_includes_input(error_code_t code);
+std::string             error_message(
+                              version_error_t const & error
+                            , std::string_view const & input = std::string_view());
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -33,6 +33,9 @@ DECLARE_LOGIC_ERROR(logic_error);
 DECLARE_MAIN_EXCEPTION(versiontheca_exception);
 
 DECLARE_EXCEPTION(versiontheca_exception, empty_version);
+DECLARE_EXCEPTION(versiontheca_exception, io_error);
+DECLARE_EXCEPTION(versiontheca_exception, invalid_encoding);
+DECLARE_EXCEPTION(versiontheca_exception, invalid_index);
 DECLARE_EXCEPTION(versiontheca_exception, invalid_parameter);
 DECLARE_EXCEPTION(versiontheca_exception, invalid_version);
 DECLARE_EXCEPTION(versiontheca_exception, missing_pointer);
@@ -0,0 +1,166 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the fixed-point decimal functions.
+ *
+ * The parser accepts exactly the versions accepted by the decimal trait:
+ * an integer optionally followed by a period and a second integer, both
+ * fitting in a part_integer_t, and at most DECIMAL_PRECISION digits
+ * after the period.
+ */
+
+// self
+//
+#include    <versiontheca/fixed_decimal.h>
+
+
+// C++
+//
+#include    <charconv>
+#include    <limits>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+/** \brief Convert the fixed-point value to a double.
+ *
+ * The conversion uses a single division so it is as precise as the
+ * double representation allows.
+ *
+ * \return The value as a double.
+ */
+double fixed_decimal_t::to_double() const
+{
+    return static_cast<double>(f_integer)
+         + static_cast<double>(f_fraction)
+                / static_cast<double>(detail::g_powers_of_ten[DECIMAL_PRECISION]);
+}
+
+
+/** \brief Parse a decimal version.
+ *
+ * This function parses \p v as the decimal trait does and saves the
+ * result in \p value. It does not allocate any memory.
+ *
+ * \param[in] v  The version to parse.
+ * \param[out] value  The resulting fixed-point value.
+ *
+ * \return true if \p v is a valid decimal version.
+ */
+bool parse_fixed_decimal(std::string_view const & v, fixed_decimal_t & value)
+{
+    char const * const start(v.data());
+    char const * const end(start + v.length());
+
+    part_integer_t integer(0);
+    std::from_chars_result r(std::from_chars(start, end, integer));
+    if(r.ec != std::errc())
+    {
+        return false;
+    }
+
+    part_integer_t fraction(0);
+    std::size_t width(0);
+    if(r.ptr != end)
+    {
+        if(*r.ptr != '.')
+        {
+            return false;
+        }
+        char const * const f(r.ptr + 1);
+        r = std::from_chars(f, end, fraction);
+        if(r.ec != std::errc()
+        || r.ptr != end)
+        {
+            return false;
+        }
+        width = end - f;
+    }
+
+    return make_fixed_decimal(integer, fraction, width, value);
+}
+
+
+/** \brief Convert a list of decimal versions to doubles.
+ *
+ * Invalid versions are converted to NaN, like
+ * decimal::get_decimal_version() does.
+ *
+ * \param[in] versions  The versions to convert.
+ *
+ * \return The values, in the same order as \p versions.
+ */
+std::vector<double> decimal_versions_to_double(std::vector<std::string> const & versions)
+{
+    std::vector<double> result;
+    result.reserve(versions.size());
+    for(auto const & v : versions)
+    {
+        fixed_decimal_t value;
+        result.push_back(parse_fixed_decimal(v, value)
+                ? value.to_double()
+                : std::numeric_limits<double>::quiet_NaN());
+    }
+    return result;
+}
+
+
+/** \brief Convert a list of decimal versions to fixed-point values.
+ *
+ * Invalid versions are converted to 0.0. When \p invalid is not null,
+ * the index of each invalid version is appended to it.
+ *
+ * \param[in] versions  The versions to convert.
+ * \param[out] invalid  The indexes of the invalid versions.
+ *
+ * \return The values, in the same order as \p versions.
+ */
+std::vector<fixed_decimal_t> decimal_versions_to_fixed(
+      std::vector<std::string> const & versions
+    , std::vector<std::size_t> * invalid)
+{
+    std::vector<fixed_decimal_t> result(versions.size());
+    for(std::size_t idx(0); idx < versions.size(); ++idx)
+    {
+        if(!parse_fixed_decimal(versions[idx], result[idx]))
+        {
+            result[idx] = fixed_decimal_t();
+            if(invalid != nullptr)
+            {
+                invalid->push_back(idx);
+            }
+        }
+    }
+    return result;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
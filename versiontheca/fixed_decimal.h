@@ -0,0 +1,178 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Decimal versions as fixed-point numbers.
+ *
+ * A decimal version ("1.5", "2.25", "10") is two integers separated by a
+ * period. The fixed_decimal_t structure holds the integer and the
+ * fraction, the latter scaled to DECIMAL_PRECISION digits so "1.5" and
+ * "1.50" have the same representation and "1.05" is smaller than "1.5".
+ * Comparing two values is then a comparison of two integer pairs.
+ *
+ * The parse_fixed_decimal() function reads a decimal version directly
+ * with std::from_chars(), without allocating a trait or any memory. The
+ * decimal_versions_to_double() and decimal_versions_to_fixed() functions
+ * convert a whole list of versions at once.
+ */
+
+// self
+//
+#include    <versiontheca/part.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <cstdint>
+#include    <string>
+#include    <string_view>
+#include    <vector>
+
+
+
+namespace versiontheca
+{
+
+
+
+// number of digits kept after the period; a double has about 17
+// significant digits so this is more than enough for the conversion
+//
+constexpr std::size_t const     DECIMAL_PRECISION = 18;
+
+
+struct fixed_decimal_t
+{
+    part_integer_t      f_integer = 0;
+    std::uint64_t       f_fraction = 0;     // scaled to DECIMAL_PRECISION digits
+
+    constexpr int       compare(fixed_decimal_t const & rhs) const
+                        {
+                            if(f_integer != rhs.f_integer)
+                            {
+                                return f_integer < rhs.f_integer ? -1 : 1;
+                            }
+                            if(f_fraction != rhs.f_fraction)
+                            {
+                                return f_fraction < rhs.f_fraction ? -1 : 1;
+                            }
+                            return 0;
+                        }
+
+    constexpr bool      operator == (fixed_decimal_t const & rhs) const { return compare(rhs) == 0; }
+    constexpr bool      operator != (fixed_decimal_t const & rhs) const { return compare(rhs) != 0; }
+    constexpr bool      operator <  (fixed_decimal_t const & rhs) const { return compare(rhs) < 0; }
+
+    double              to_double() const;
+};
+
+
+namespace detail
+{
+
+
+constexpr std::uint64_t const   g_powers_of_ten[DECIMAL_PRECISION + 1] =
+{
+                       1ULL,
+                      10ULL,
+                     100ULL,
+                   1'000ULL,
+                  10'000ULL,
+                 100'000ULL,
+               1'000'000ULL,
+              10'000'000ULL,
+             100'000'000ULL,
+           1'000'000'000ULL,
+          10'000'000'000ULL,
+         100'000'000'000ULL,
+       1'000'000'000'000ULL,
+      10'000'000'000'000ULL,
+     100'000'000'000'000ULL,
+   1'000'000'000'000'000ULL,
+  10'000'000'000'000'000ULL,
+ 100'000'000'000'000'000ULL,
+1'000'000'000'000'000'000ULL,
+};
+
+
+/** \brief Count the number of digits of an integer.
+ *
+ * \param[in] value  The value to check.
+ *
+ * \return The number of digits, at least 1.
+ */
+constexpr std::size_t decimal_digits(part_integer_t value)
+{
+    std::size_t digits(1);
+    while(digits <= DECIMAL_PRECISION
+       && value >= g_powers_of_ten[digits])
+    {
+        ++digits;
+    }
+    return digits;
+}
+
+
+} // namespace detail
+
+
+/** \brief Create a fixed-point decimal from its parts.
+ *
+ * The \p width is the number of digits found after the period,
+ * including leading zeroes, so "1.05" is (1, 5, 2). A fraction with more
+ * digits than \p width (after next() on "1.9", for example) uses its
+ * own number of digits, matching the string representation.
+ *
+ * \param[in] integer  The integer part of the version.
+ * \param[in] fraction  The fraction as an integer.
+ * \param[in] width  The number of digits of the fraction.
+ * \param[out] value  The resulting fixed-point value.
+ *
+ * \return false if the fraction has more than DECIMAL_PRECISION digits.
+ */
+constexpr bool make_fixed_decimal(
+      part_integer_t integer
+    , part_integer_t fraction
+    , std::size_t width
+    , fixed_decimal_t & value)
+{
+    std::size_t const digits(std::max(width, detail::decimal_digits(fraction)));
+    if(digits > DECIMAL_PRECISION)
+    {
+        return false;
+    }
+    value.f_integer = integer;
+    value.f_fraction = fraction * detail::g_powers_of_ten[DECIMAL_PRECISION - digits];
+    return true;
+}
+
+
+bool                    parse_fixed_decimal(std::string_view const & v, fixed_decimal_t & value);
+std::vector<double>     decimal_versions_to_double(std::vector<std::string> const & versions);
+std::vector<fixed_decimal_t>
+                        decimal_versions_to_fixed(
+                              std::vector<std::string> const & versions
+                            , std::vector<std::size_t> * invalid = nullptr);
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
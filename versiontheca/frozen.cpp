@@ -0,0 +1,273 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the frozen version.
+ *
+ * The snapshot is taken once, in the constructor. After that, the
+ * object is only read.
+ */
+
+// self
+//
+#include    <versiontheca/frozen.h>
+
+#include    <versiontheca/compare.h>
+#include    <versiontheca/exception.h>
+
+
+// C++
+//
+#include    <stdexcept>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+/** \brief Parse a version and freeze the result.
+ *
+ * The version is parsed with a trait of the specified \p kind. The trait
+ * is only used by the constructor and then released.
+ *
+ * If the version is not valid, the frozen version is still created. It
+ * is marked invalid and keeps the error so get_last_error() can report
+ * it.
+ *
+ * \param[in] kind  The kind of trait used to parse \p v.
+ * \param[in] v  The version to parse.
+ */
+frozen_version::frozen_version(trait_kind_t kind, std::string_view const & v)
+    : f_kind(kind)
+{
+    versiontheca const version(create_trait(kind), v);
+    freeze(version);
+}
+
+
+/** \brief Freeze an existing version.
+ *
+ * This constructor takes a snapshot of \p v. The \p kind must be the
+ * kind of the trait used by \p v since it defines how the frozen
+ * versions get compared.
+ *
+ * Later changes to \p v have no effect on the frozen version.
+ *
+ * \param[in] kind  The kind of the trait of \p v.
+ * \param[in] v  The version to freeze.
+ */
+frozen_version::frozen_version(trait_kind_t kind, versiontheca const & v)
+    : f_kind(kind)
+{
+    freeze(v);
+}
+
+
+/** \brief Copy the state of a version.
+ *
+ * The error message is generated here, once, so get_last_error() does
+ * not need to allocate anything or touch any shared state.
+ *
+ * \param[in] v  The version to copy.
+ */
+void frozen_version::freeze(versiontheca const & v)
+{
+    trait const & t(*v.get_trait());
+    f_valid = v.is_valid();
+    if(f_valid)
+    {
+        std::size_t const max(t.size());
+        f_parts.reserve(max);
+        for(std::size_t idx(0); idx < max; ++idx)
+        {
+            f_parts.push_back(t.at(idx));
+        }
+        f_version = v.get_version();
+    }
+    else
+    {
+        f_error = v.get_error();
+        f_error_message = v.get_last_error();
+    }
+}
+
+
+/** \brief Get the kind of trait used to parse this version.
+ *
+ * \return The trait kind.
+ */
+trait_kind_t frozen_version::get_kind() const
+{
+    return f_kind;
+}
+
+
+/** \brief Check whether this version is valid.
+ *
+ * \return true if the version was parsed successfully.
+ */
+bool frozen_version::is_valid() const
+{
+    return f_valid;
+}
+
+
+/** \brief Get the number of parts in this version.
+ *
+ * \return The number of parts, 0 if the version is not valid.
+ */
+std::size_t frozen_version::size() const
+{
+    return f_parts.size();
+}
+
+
+/** \brief Get one part of this version.
+ *
+ * \exception std::out_of_range
+ * The \p idx parameter must be smaller than size().
+ *
+ * \param[in] idx  The index of the part to retrieve.
+ *
+ * \return A reference to the part.
+ */
+part const & frozen_version::at(std::size_t idx) const
+{
+    if(idx >= f_parts.size())
+    {
+        throw std::out_of_range("frozen_version::at() index is out of range.");
+    }
+    return f_parts[idx];
+}
+
+
+/** \brief Get the canonical version string.
+ *
+ * The string is computed once by the constructor.
+ *
+ * \return The canonicalized version or an empty string if not valid.
+ */
+std::string const & frozen_version::get_version() const
+{
+    return f_version;
+}
+
+
+/** \brief Get the error found while parsing this version.
+ *
+ * Contrary to versiontheca::get_last_error(), the error is never
+ * cleared. It is part of the snapshot.
+ *
+ * \return The error message or an empty string if the version is valid.
+ */
+std::string const & frozen_version::get_last_error() const
+{
+    return f_error_message;
+}
+
+
+/** \brief Get the error found while parsing this version.
+ *
+ * \return The error, with code ERROR_CODE_NONE if the version is valid.
+ */
+version_error_t frozen_version::get_error() const
+{
+    return f_error;
+}
+
+
+/** \brief Compare two frozen versions.
+ *
+ * The parts are compared with the same rules as the trait of the
+ * version kind, giving the same result as versiontheca::compare().
+ *
+ * \exception invalid_version
+ * Both versions must be valid.
+ *
+ * \exception invalid_parameter
+ * Both versions must have been parsed with the same kind of trait.
+ *
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1.
+ */
+int frozen_version::compare(frozen_version const & rhs) const
+{
+    if(!f_valid || !rhs.f_valid)
+    {
+        throw invalid_version("one or both of the input versions are not valid.");
+    }
+    if(f_kind != rhs.f_kind)
+    {
+        throw invalid_parameter("cannot compare frozen versions of different kinds.");
+    }
+
+    return detail::compare_parts_by_kind(
+              f_kind
+            , detail::trait_parts<frozen_version>(*this)
+            , detail::trait_parts<frozen_version>(rhs));
+}
+
+
+bool frozen_version::operator == (frozen_version const & rhs) const
+{
+    return compare(rhs) == 0;
+}
+
+
+bool frozen_version::operator != (frozen_version const & rhs) const
+{
+    return compare(rhs) != 0;
+}
+
+
+bool frozen_version::operator < (frozen_version const & rhs) const
+{
+    return compare(rhs) < 0;
+}
+
+
+bool frozen_version::operator <= (frozen_version const & rhs) const
+{
+    return compare(rhs) <= 0;
+}
+
+
+bool frozen_version::operator > (frozen_version const & rhs) const
+{
+    return compare(rhs) > 0;
+}
+
+
+bool frozen_version::operator >= (frozen_version const & rhs) const
+{
+    return compare(rhs) >= 0;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
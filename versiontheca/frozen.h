@@ -0,0 +1,93 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Immutable snapshot of a parsed version.
+ *
+ * A versiontheca object holds a trait which can be modified (parse(),
+ * next(), previous(), set_major()...) and which records its errors. To
+ * share versions between threads, a frozen_version copies the parts of a
+ * parsed version, its canonical string, and its error in a plain value
+ * which never changes once constructed.
+ *
+ * All the functions of a frozen_version are const and none of them
+ * modify any state, so any number of threads can read and compare the
+ * same frozen versions without locks and without contention. The
+ * comparison uses the compare functions of compare.h directly, so no
+ * trait object (and no shared pointer reference counter) gets touched.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+#include    <versiontheca/versiontheca.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+class frozen_version
+{
+public:
+    typedef std::vector<frozen_version>     vector_t;
+
+                        frozen_version(trait_kind_t kind, std::string_view const & v);
+                        frozen_version(trait_kind_t kind, versiontheca const & v);
+
+    trait_kind_t        get_kind() const;
+    bool                is_valid() const;
+    std::size_t         size() const;
+    part const &        at(std::size_t idx) const;
+    std::string const & get_version() const;
+    std::string const & get_last_error() const;
+    version_error_t     get_error() const;
+
+    int                 compare(frozen_version const & rhs) const;
+    bool                operator == (frozen_version const & rhs) const;
+    bool                operator != (frozen_version const & rhs) const;
+    bool                operator <  (frozen_version const & rhs) const;
+    bool                operator <= (frozen_version const & rhs) const;
+    bool                operator >  (frozen_version const & rhs) const;
+    bool                operator >= (frozen_version const & rhs) const;
+
+private:
+    void                freeze(versiontheca const & v);
+
+    trait_kind_t        f_kind = trait_kind_t::TRAIT_KIND_UNICODE;
+    bool                f_valid = false;
+    part::vector_t      f_parts = part::vector_t();
+    std::string         f_version = std::string();
+    version_error_t     f_error = version_error_t();
+    std::string         f_error_message = std::string();
+};
+
+
+inline std::ostream & operator << (std::ostream & os, frozen_version const & v)
+{
+    return os << v.get_version();
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,237 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the version generator.
+ *
+ * Each step copies the parts of the current version in the work trait,
+ * which already has buffers for its strings, then calls next() or
+ * previous() on that work trait. The two traits get swapped only when
+ * the step succeeds.
+ */
+
+// self
+//
+#include    <versiontheca/generator.h>
+
+#include    <versiontheca/exception.h>
+#include    <versiontheca/probe.h>
+
+
+// C++
+//
+#include    <utility>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+/** \brief Initialize a generator.
+ *
+ * The generator starts with a copy of \p start. Modifying \p start
+ * afterward has no effect on the generator.
+ *
+ * \exception invalid_version
+ * The \p start version must be valid.
+ *
+ * \exception invalid_parameter
+ * The \p pos parameter must be a valid position for next() and previous().
+ *
+ * \param[in] start  The version to start from.
+ * \param[in] pos  The position of the part to increment or decrement.
+ * \param[in] direction  Whether to call next() or previous().
+ */
+version_range_generator::version_range_generator(
+          versiontheca const & start
+        , int pos
+        , step_direction_t direction)
+    : f_pos(pos)
+    , f_direction(direction)
+{
+    if(!start.is_valid())
+    {
+        throw invalid_version("the start version of a generator must be valid.");
+    }
+    if(pos < 0 || static_cast<std::size_t>(pos) >= MAX_PARTS)
+    {
+        throw invalid_parameter(
+              "the position of a generator must be between 0 and "
+            + std::to_string(MAX_PARTS - 1)
+            + ".");
+    }
+
+    f_current = start.get_trait()->clone();
+    f_work = f_current->clone();
+    VERSIONTHECA_PROBE_COUNT(*f_current, COUNTER_ALLOCATION);
+    VERSIONTHECA_PROBE_COUNT(*f_work, COUNTER_ALLOCATION);
+}
+
+
+/** \brief Define the maximum of each part.
+ *
+ * This is the same as versiontheca::set_format(). The format trait is
+ * shared, not copied, so it must not be modified while the generator
+ * is in use.
+ *
+ * \param[in] format  The version defining the format.
+ */
+void version_range_generator::set_format(versiontheca const & format)
+{
+    f_format = format.get_trait();
+}
+
+
+/** \brief Limit the generated versions to a range.
+ *
+ * Once a range is defined, a step which generates a version outside
+ * of \p range fails with ERROR_CODE_OUT_OF_RANGE and the current version
+ * is not changed.
+ *
+ * The range must be of the same kind as the start version.
+ *
+ * \param[in] range  The range the versions must be part of.
+ */
+void version_range_generator::set_range(version_range const & range)
+{
+    f_range = range;
+    f_has_range = true;
+}
+
+
+/** \brief Compute the next version.
+ *
+ * This function calls next() or previous() on a copy of the current
+ * version. If that works, the copy becomes the current version.
+ * Otherwise the current version is kept and get_last_error() returns
+ * the reason for the failure.
+ *
+ * \return true if the current version was updated.
+ */
+bool version_range_generator::step()
+{
+    f_work->assign_parts(*f_current);
+    bool const result(f_direction == step_direction_t::STEP_DIRECTION_NEXT
+                            ? f_work->next(f_pos, f_format)
+                            : f_work->previous(f_pos, f_format));
+    if(!result)
+    {
+        f_error = f_work->get_error();
+        return false;
+    }
+
+    if(f_has_range
+    && !f_range.contains_key(f_work->sort_key()))
+    {
+        f_error = version_error_t();
+        f_error.f_code = error_code_t::ERROR_CODE_OUT_OF_RANGE;
+        return false;
+    }
+
+    std::swap(f_current, f_work);
+    f_error = version_error_t();
+    ++f_steps;
+    return true;
+}
+
+
+/** \brief Generate up to \p count versions.
+ *
+ * This function calls step() up to \p count times and returns the
+ * canonical string of each version generated. It stops early on the
+ * first failure.
+ *
+ * \param[in] count  The maximum number of versions to generate.
+ *
+ * \return The generated versions.
+ */
+std::vector<std::string> version_range_generator::generate(std::size_t count)
+{
+    std::vector<std::string> result;
+    result.reserve(count);
+    while(result.size() < count && step())
+    {
+        result.push_back(f_current->to_string());
+    }
+    return result;
+}
+
+
+/** \brief Get the trait holding the current version.
+ *
+ * The reference remains valid until the next call to step().
+ *
+ * \return The trait of the current version.
+ */
+trait const & version_range_generator::get_trait() const
+{
+    return *f_current;
+}
+
+
+/** \brief Get the current version as a canonical string.
+ *
+ * \return The current version.
+ */
+std::string version_range_generator::get_version() const
+{
+    return f_current->to_string();
+}
+
+
+/** \brief Get the number of successful steps.
+ *
+ * \return The number of times step() succeeded.
+ */
+std::size_t version_range_generator::get_steps() const
+{
+    return f_steps;
+}
+
+
+/** \brief Get the error of the last step.
+ *
+ * \return The error message or an empty string if the last step worked.
+ */
+std::string version_range_generator::get_last_error() const
+{
+    return error_message(f_error);
+}
+
+
+/** \brief Get the error of the last step.
+ *
+ * \return The error, with code ERROR_CODE_NONE if the last step worked.
+ */
+version_error_t version_range_generator::get_error() const
+{
+    return f_error;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,100 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Generate a sequence of versions with next() or previous().
+ *
+ * The versiontheca::next() and versiontheca::previous() functions clear
+ * the version when they fail, since the trait may have been partially
+ * updated. The version_range_generator steps a copy of the version
+ * instead and only keeps the result when the step succeeds. On a
+ * failure, the current version is left untouched and the error gets
+ * reported by get_last_error().
+ *
+ * The generator works with two traits which it swaps after each
+ * successful step, so generating thousands of versions does not allocate
+ * new traits.
+ *
+ * \code
+ *     versiontheca::version_range_generator g(v, 2);
+ *     g.set_range(versiontheca::version_range(kind, "<< 1.3"));
+ *     while(g.step())
+ *     {
+ *         std::cout << g.get_version() << "\n";
+ *     }
+ * \endcode
+ */
+
+// self
+//
+#include    <versiontheca/range.h>
+#include    <versiontheca/versiontheca.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+enum class step_direction_t
+{
+    STEP_DIRECTION_NEXT,
+    STEP_DIRECTION_PREVIOUS,
+};
+
+
+class version_range_generator
+{
+public:
+                        version_range_generator(
+                                  versiontheca const & start
+                                , int pos
+                                , step_direction_t direction = step_direction_t::STEP_DIRECTION_NEXT);
+
+    void                set_format(versiontheca const & format);
+    void                set_range(version_range const & range);
+
+    bool                step();
+    std::vector<std::string>
+                        generate(std::size_t count);
+
+    trait const &       get_trait() const;
+    std::string         get_version() const;
+    std::size_t         get_steps() const;
+    std::string         get_last_error() const;
+    version_error_t     get_error() const;
+
+private:
+    trait::pointer_t    f_current = trait::pointer_t();
+    trait::pointer_t    f_work = trait::pointer_t();
+    trait::pointer_t    f_format = trait::pointer_t();
+    int                 f_pos = 0;
+    step_direction_t    f_direction = step_direction_t::STEP_DIRECTION_NEXT;
+    bool                f_has_range = false;
+    version_range       f_range = version_range(trait_kind_t::TRAIT_KIND_UNICODE);
+    std::size_t         f_steps = 0;
+    version_error_t     f_error = version_error_t();
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,563 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the sorted version index.
+ *
+ * The index is one buffer organized as follow:
+ *
+ * \li the header (header_t);
+ * \li the key offsets, count + 1 32 bit offsets in the keys blob;
+ * \li the version offsets, count + 1 32 bit offsets in the versions blob;
+ * \li the sources, count 32 bit indexes of the versions in the batch;
+ * \li the keys blob, all the sort keys one after the other;
+ * \li the versions blob, all the canonicalized versions.
+ *
+ * The entries are sorted by key. Two versions with the same key keep
+ * their batch order.
+ */
+
+// self
+//
+#include    <versiontheca/index.h>
+
+#include    <versiontheca/exception.h>
+#include    <versiontheca/mapped_file.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <cstring>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+// "VTIX" -- also used to detect a file created with a different byte order
+//
+constexpr std::uint32_t const   INDEX_MAGIC = 0x58495456;
+
+
+
+}
+// no name namespace
+
+
+
+struct version_index::header_t
+{
+    std::uint32_t       f_magic = INDEX_MAGIC;
+    std::uint32_t       f_version = FILE_VERSION;
+    std::uint32_t       f_kind = 0;
+    std::uint32_t       f_count = 0;
+    std::uint64_t       f_key_offsets = 0;
+    std::uint64_t       f_version_offsets = 0;
+    std::uint64_t       f_sources = 0;
+    std::uint64_t       f_keys = 0;
+    std::uint64_t       f_versions = 0;
+    std::uint64_t       f_size = 0;
+};
+
+
+
+/** \brief Build an index from a batch.
+ *
+ * The invalid versions of the batch are ignored. The index keeps the
+ * canonicalized version (batch::get_version()) and the index of each
+ * version in the batch (see get_source()).
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the index would be larger than
+ * what the 32 bit offsets support.
+ *
+ * \param[in] versions  The batch of versions to index.
+ */
+version_index::version_index(batch const & versions)
+{
+    struct entry_t
+    {
+        std::string         f_key = std::string();
+        std::size_t         f_source = 0;
+    };
+    std::vector<entry_t> entries;
+    for(std::size_t idx(0); idx < versions.size(); ++idx)
+    {
+        if(versions.is_valid(idx))
+        {
+            entries.push_back(entry_t{ versions.sort_key(idx), idx });
+        }
+    }
+    std::stable_sort(
+          entries.begin()
+        , entries.end()
+        , [](entry_t const & a, entry_t const & b)
+        {
+            return a.f_key < b.f_key;
+        });
+
+    // all the canonical versions are appended to one string
+    //
+    std::string canonical;
+    std::vector<std::size_t> canonical_ends;
+    canonical_ends.reserve(entries.size());
+    std::size_t keys_size(0);
+    for(auto const & e : entries)
+    {
+        versions.append_version(e.f_source, canonical);
+        canonical_ends.push_back(canonical.length());
+        keys_size += e.f_key.length();
+    }
+    std::size_t const versions_size(canonical.length());
+    if(keys_size > UINT32_MAX
+    || versions_size > UINT32_MAX
+    || versions.size() > UINT32_MAX)
+    {
+        throw invalid_parameter("too many versions to create a version index.");
+    }
+
+    std::size_t const count(entries.size());
+    header_t h;
+    h.f_kind = static_cast<std::uint32_t>(versions.get_kind());
+    h.f_count = static_cast<std::uint32_t>(count);
+    h.f_key_offsets = sizeof(header_t);
+    h.f_version_offsets = h.f_key_offsets + (count + 1) * sizeof(std::uint32_t);
+    h.f_sources = h.f_version_offsets + (count + 1) * sizeof(std::uint32_t);
+    h.f_keys = h.f_sources + count * sizeof(std::uint32_t);
+    h.f_versions = h.f_keys + keys_size;
+    h.f_size = h.f_versions + versions_size;
+
+    std::shared_ptr<std::vector<char>> buffer(std::make_shared<std::vector<char>>(h.f_size));
+    char * data(buffer->data());
+    memcpy(data, &h, sizeof(h));
+    memcpy(data + h.f_versions, canonical.data(), canonical.length());
+
+    std::uint32_t key_offset(0);
+    std::uint32_t version_offset(0);
+    for(std::size_t idx(0); idx <= count; ++idx)
+    {
+        memcpy(data + h.f_key_offsets + idx * sizeof(std::uint32_t), &key_offset, sizeof(key_offset));
+        memcpy(data + h.f_version_offsets + idx * sizeof(std::uint32_t), &version_offset, sizeof(version_offset));
+        if(idx == count)
+        {
+            break;
+        }
+
+        std::uint32_t const source(static_cast<std::uint32_t>(entries[idx].f_source));
+        memcpy(data + h.f_sources + idx * sizeof(std::uint32_t), &source, sizeof(source));
+        memcpy(data + h.f_keys + key_offset, entries[idx].f_key.data(), entries[idx].f_key.length());
+        key_offset += static_cast<std::uint32_t>(entries[idx].f_key.length());
+        version_offset = static_cast<std::uint32_t>(canonical_ends[idx]);
+    }
+
+    f_data = std::shared_ptr<char const>(buffer, data);
+    f_size = h.f_size;
+}
+
+
+version_index::version_index(std::shared_ptr<char const> data, std::size_t size)
+    : f_data(data)
+    , f_size(size)
+{
+    verify_data();
+}
+
+
+/** \brief Load an index saved with save().
+ *
+ * The file is mapped in memory, it is not read. Only the header and the
+ * last offsets are verified so loading is immediate whatever the size
+ * of the index. The other offsets are verified when accessed.
+ *
+ * \exception io_error
+ * The function raises this exception if the file cannot be opened or
+ * mapped in memory.
+ *
+ * \exception invalid_index
+ * The function raises this exception if the file is not a valid index.
+ *
+ * \param[in] filename  The name of the file to load.
+ *
+ * \return The loaded index.
+ */
+version_index version_index::load(std::string const & filename)
+{
+    std::size_t size(0);
+    std::shared_ptr<char const> data(detail::map_file(filename, "index", sizeof(header_t), size));
+    return version_index(data, size);
+}
+
+
+/** \brief Save this index to a file.
+ *
+ * \exception io_error
+ * The function raises this exception if the file cannot be written.
+ *
+ * \param[in] filename  The name of the file to create.
+ */
+void version_index::save(std::string const & filename) const
+{
+    detail::save_file(filename, "index", f_data.get(), f_size);
+}
+
+
+trait_kind_t version_index::get_kind() const
+{
+    return static_cast<trait_kind_t>(get_header()->f_kind);
+}
+
+
+std::size_t version_index::size() const
+{
+    return get_header()->f_count;
+}
+
+
+bool version_index::empty() const
+{
+    return size() == 0;
+}
+
+
+/** \brief Retrieve the canonicalized version at \p idx.
+ *
+ * \param[in] idx  The position of the version in the index.
+ *
+ * \return A view of the version in the index buffer.
+ */
+std::string_view version_index::get_version(std::size_t idx) const
+{
+    verify_index(idx);
+    header_t const * h(get_header());
+    return get_string(h->f_version_offsets, h->f_versions, h->f_size, idx);
+}
+
+
+/** \brief Retrieve the sort key at \p idx.
+ *
+ * \param[in] idx  The position of the version in the index.
+ *
+ * \return A view of the sort key in the index buffer.
+ */
+std::string_view version_index::get_key(std::size_t idx) const
+{
+    verify_index(idx);
+    header_t const * h(get_header());
+    return get_string(h->f_key_offsets, h->f_keys, h->f_versions, idx);
+}
+
+
+/** \brief Retrieve the position of the version at \p idx in the batch.
+ *
+ * \param[in] idx  The position of the version in the index.
+ *
+ * \return The index of the version in the batch used to build this index.
+ */
+std::size_t version_index::get_source(std::size_t idx) const
+{
+    verify_index(idx);
+    return get_array(get_header()->f_sources)[idx];
+}
+
+
+/** \brief Search the first version which is not less than \p version.
+ *
+ * \exception invalid_version
+ * The function raises this exception if \p version is not valid.
+ *
+ * \param[in] version  The version to search.
+ *
+ * \return The position of the version or size().
+ */
+std::size_t version_index::lower_bound(std::string_view const & version) const
+{
+    return lower_bound_key(compute_key(version));
+}
+
+
+/** \brief Search the first version which is greater than \p version.
+ *
+ * \exception invalid_version
+ * The function raises this exception if \p version is not valid.
+ *
+ * \param[in] version  The version to search.
+ *
+ * \return The position of the version or size().
+ */
+std::size_t version_index::upper_bound(std::string_view const & version) const
+{
+    return upper_bound_key(compute_key(version));
+}
+
+
+std::size_t version_index::lower_bound_key(std::string_view const & key) const
+{
+    std::size_t first(0);
+    std::size_t count(size());
+    while(count > 0)
+    {
+        std::size_t const step(count / 2);
+        if(get_key(first + step) < key)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+
+std::size_t version_index::upper_bound_key(std::string_view const & key) const
+{
+    std::size_t first(0);
+    std::size_t count(size());
+    while(count > 0)
+    {
+        std::size_t const step(count / 2);
+        if(!(key < get_key(first + step)))
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+
+/** \brief Search all the versions equal to \p version.
+ *
+ * \exception invalid_version
+ * The function raises this exception if \p version is not valid.
+ *
+ * \param[in] version  The version to search.
+ *
+ * \return The first position and the position after the last version.
+ */
+version_index::span_t version_index::equal_range(std::string_view const & version) const
+{
+    std::string const key(compute_key(version));
+    return span_t(lower_bound_key(key), upper_bound_key(key));
+}
+
+
+/** \brief Search all the versions included in a range.
+ *
+ * Each interval of the range gives one span of positions in the index.
+ * Empty spans are not included in the result.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the range is not of the same
+ * kind as the index.
+ *
+ * \param[in] range  The range of versions to search.
+ *
+ * \return The list of spans, in increasing order.
+ */
+version_index::span_vector_t version_index::find(version_range const & range) const
+{
+    if(range.get_kind() != get_kind())
+    {
+        throw invalid_parameter("the version range and index are not of the same kind.");
+    }
+
+    span_vector_t result;
+    for(auto const & i : range.get_intervals())
+    {
+        span_t const s(get_span(i));
+        if(s.first < s.second)
+        {
+            result.push_back(s);
+        }
+    }
+    return result;
+}
+
+
+/** \brief Search the largest version included in a range.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the range is not of the same
+ * kind as the index.
+ *
+ * \param[in] range  The range of versions to search.
+ *
+ * \return The position of the version or npos if no version matches.
+ */
+std::size_t version_index::newest(version_range const & range) const
+{
+    if(range.get_kind() != get_kind())
+    {
+        throw invalid_parameter("the version range and index are not of the same kind.");
+    }
+
+    auto const & intervals(range.get_intervals());
+    for(auto it(intervals.rbegin()); it != intervals.rend(); ++it)
+    {
+        span_t const s(get_span(*it));
+        if(s.first < s.second)
+        {
+            return s.second - 1;
+        }
+    }
+    return npos;
+}
+
+
+std::size_t version_index::newest(version_constraint const & constraint) const
+{
+    return newest(version_range(constraint));
+}
+
+
+version_index::header_t const * version_index::get_header() const
+{
+    return reinterpret_cast<header_t const *>(f_data.get());
+}
+
+
+std::uint32_t const * version_index::get_array(std::size_t offset) const
+{
+    return reinterpret_cast<std::uint32_t const *>(f_data.get() + offset);
+}
+
+
+std::string_view version_index::get_string(
+      std::size_t offsets
+    , std::size_t blob
+    , std::size_t blob_end
+    , std::size_t idx) const
+{
+    std::size_t const blob_size(blob_end - blob);
+    std::uint32_t const * o(get_array(offsets));
+    std::uint32_t const start(o[idx]);
+    std::uint32_t const end(o[idx + 1]);
+    if(start > end
+    || end > blob_size)
+    {
+        throw invalid_index("the version index is corrupted (invalid offset).");
+    }
+    return std::string_view(f_data.get() + blob + start, end - start);
+}
+
+
+std::string version_index::compute_key(std::string_view const & version) const
+{
+    trait::pointer_t t(create_trait(get_kind()));
+    if(!t->parse(version))
+    {
+        throw invalid_version(
+                  "version \""
+                + std::string(version)
+                + "\" is not valid: "
+                + t->get_last_error());
+    }
+    return t->sort_key();
+}
+
+
+version_index::span_t version_index::get_span(version_range::interval_t const & interval) const
+{
+    std::size_t first(0);
+    if(!interval.f_lower.f_infinite)
+    {
+        first = interval.f_lower.f_inclusive
+                    ? lower_bound_key(interval.f_lower.f_key)
+                    : upper_bound_key(interval.f_lower.f_key);
+    }
+    std::size_t last(size());
+    if(!interval.f_upper.f_infinite)
+    {
+        last = interval.f_upper.f_inclusive
+                    ? upper_bound_key(interval.f_upper.f_key)
+                    : lower_bound_key(interval.f_upper.f_key);
+    }
+    return span_t(first, std::max(first, last));
+}
+
+
+void version_index::verify_index(std::size_t idx) const
+{
+    if(idx >= size())
+    {
+        throw invalid_parameter(
+                  "index "
+                + std::to_string(idx)
+                + " is out of range for a version index of "
+                + std::to_string(size())
+                + " versions.");
+    }
+}
+
+
+void version_index::verify_data() const
+{
+    header_t const * h(get_header());
+    if(h->f_magic != INDEX_MAGIC)
+    {
+        throw invalid_index("this is not a version index or it was created on a computer with a different byte order.");
+    }
+    if(h->f_version != FILE_VERSION)
+    {
+        throw invalid_index("unsupported version index file version " + std::to_string(h->f_version) + ".");
+    }
+    if(h->f_kind > static_cast<std::uint32_t>(trait_kind_t::TRAIT_KIND_UNICODE))
+    {
+        throw invalid_index("unknown trait kind in version index.");
+    }
+
+    std::uint64_t const count(h->f_count);
+    if(h->f_size != f_size
+    || h->f_key_offsets != sizeof(header_t)
+    || h->f_version_offsets != h->f_key_offsets + (count + 1) * sizeof(std::uint32_t)
+    || h->f_sources != h->f_version_offsets + (count + 1) * sizeof(std::uint32_t)
+    || h->f_keys != h->f_sources + count * sizeof(std::uint32_t)
+    || h->f_versions < h->f_keys
+    || h->f_versions > h->f_size
+    || get_array(h->f_key_offsets)[count] != h->f_versions - h->f_keys
+    || get_array(h->f_version_offsets)[count] != h->f_size - h->f_versions)
+    {
+        throw invalid_index("the version index is corrupted (invalid header).");
+    }
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,117 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief An immutable sorted index of versions.
+ *
+ * The version_index class sorts the valid versions of a batch by sort
+ * key and saves everything in one contiguous buffer: a header, the key
+ * offsets, the version offsets, the batch indexes, and then the keys and
+ * the canonicalized versions. Searches are binary searches on the keys
+ * (memcmp()) and never parse or compare versions with a trait.
+ *
+ * \warning
+ * For the kinds where the keys disagree with trait::compare() on a few
+ * pairs (see sort_key_matches_compare()), the order of the index, and so
+ * the results of find() and newest(), follow the keys. For example, a
+ * Unicode index does not return "1.A" for `>= 1.1` even though
+ * version_range::contains() accepts it.
+ *
+ * The buffer is also the file format: save() writes it as is and load()
+ * maps the file in memory, so an index can be reused without parsing
+ * the versions again. The file uses the byte order of the computer that
+ * created it.
+ */
+
+// self
+//
+#include    <versiontheca/batch.h>
+#include    <versiontheca/range.h>
+
+
+// C++
+//
+#include    <memory>
+
+
+
+namespace versiontheca
+{
+
+
+
+class version_index
+{
+public:
+    static constexpr std::uint32_t const    FILE_VERSION = 1;
+    static constexpr std::size_t const      npos = static_cast<std::size_t>(-1);
+
+    typedef std::pair<std::size_t, std::size_t>     span_t;
+    typedef std::vector<span_t>                     span_vector_t;
+
+                        version_index(batch const & versions);
+
+    static version_index
+                        load(std::string const & filename);
+    void                save(std::string const & filename) const;
+
+    trait_kind_t        get_kind() const;
+    std::size_t         size() const;
+    bool                empty() const;
+    std::string_view    get_version(std::size_t idx) const;
+    std::string_view    get_key(std::size_t idx) const;
+    std::size_t         get_source(std::size_t idx) const;
+
+    std::size_t         lower_bound(std::string_view const & version) const;
+    std::size_t         upper_bound(std::string_view const & version) const;
+    std::size_t         lower_bound_key(std::string_view const & key) const;
+    std::size_t         upper_bound_key(std::string_view const & key) const;
+    span_t              equal_range(std::string_view const & version) const;
+    span_vector_t       find(version_range const & range) const;
+    std::size_t         newest(version_range const & range) const;
+    std::size_t         newest(version_constraint const & constraint) const;
+
+private:
+    struct header_t;
+
+                        version_index(std::shared_ptr<char const> data, std::size_t size);
+
+    header_t const *    get_header() const;
+    std::uint32_t const *
+                        get_array(std::size_t offset) const;
+    std::string_view    get_string(
+                              std::size_t offsets
+                            , std::size_t blob
+                            , std::size_t blob_end
+                            , std::size_t idx) const;
+    std::string         compute_key(std::string_view const & version) const;
+    span_t              get_span(version_range::interval_t const & interval) const;
+    void                verify_index(std::size_t idx) const;
+    void                verify_data() const;
+
+    std::shared_ptr<char const>
+                        f_data = std::shared_ptr<char const>();
+    std::size_t         f_size = 0;
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
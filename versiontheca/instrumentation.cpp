@@ -0,0 +1,490 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the instrumentation counters.
+ *
+ * The counters are global atomics updated with relaxed operations. The
+ * snapshot is therefore not taken atomically as a whole; each counter is
+ * exact but two counters may be read a few calls apart.
+ *
+ * When the library is compiled without VERSIONTHECA_INSTRUMENTATION, only
+ * the public functions are compiled and they return zeroes.
+ */
+
+// self
+//
+#include    <versiontheca/probe.h>
+
+#include    <versiontheca/basic.h>
+#include    <versiontheca/debian.h>
+#include    <versiontheca/decimal.h>
+#include    <versiontheca/roman.h>
+#include    <versiontheca/rpm.h>
+#include    <versiontheca/unicode.h>
+
+
+// C++
+//
+#include    <atomic>
+#include    <typeinfo>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+char const * const      g_slot_names[STATISTICS_SLOT_COUNT] =
+{
+    "basic",
+    "debian",
+    "decimal",
+    "roman",
+    "rpm",
+    "unicode",
+    "other",
+};
+
+
+#ifdef VERSIONTHECA_INSTRUMENTATION
+struct slot_counters_t
+{
+    std::atomic<std::uint64_t>  f_parses;
+    std::atomic<std::uint64_t>  f_parse_failures;
+    std::atomic<std::uint64_t>  f_parts;
+    std::atomic<std::uint64_t>  f_compares;
+    std::atomic<std::uint64_t>  f_nexts;
+    std::atomic<std::uint64_t>  f_previouses;
+    std::atomic<std::uint64_t>  f_allocations;
+    std::atomic<std::uint64_t>  f_errors[ERROR_CODE_COUNT];
+    std::atomic<std::uint64_t>  f_parse_times[TIMING_BUCKET_COUNT];
+    std::atomic<std::uint64_t>  f_compare_times[TIMING_BUCKET_COUNT];
+};
+
+
+// static storage, so all the counters start at zero
+//
+slot_counters_t                 g_counters[STATISTICS_SLOT_COUNT];
+std::atomic<bool>               g_timing(false);
+std::atomic<trace_callback_t>   g_trace_callback(nullptr);
+
+thread_local int                g_parse_depth = 0;
+thread_local error_code_t       g_parse_error = error_code_t::ERROR_CODE_NONE;
+thread_local int                g_compare_depth = 0;
+
+
+void add(std::atomic<std::uint64_t> & counter, std::uint64_t value = 1)
+{
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+
+std::uint64_t read(std::atomic<std::uint64_t> const & counter)
+{
+    return counter.load(std::memory_order_relaxed);
+}
+
+
+void reset(std::atomic<std::uint64_t> & counter)
+{
+    counter.store(0, std::memory_order_relaxed);
+}
+
+
+std::uint64_t elapsed(std::chrono::steady_clock::time_point const & start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+}
+
+
+std::size_t timing_bucket(std::uint64_t duration)
+{
+    std::size_t bucket(0);
+    while(duration != 0 && bucket < TIMING_BUCKET_COUNT - 1)
+    {
+        duration >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+#endif
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Check whether the counters are compiled in the library.
+ *
+ * \return true if the library was compiled with VERSIONTHECA_INSTRUMENTATION.
+ */
+bool is_instrumentation_enabled()
+{
+#ifdef VERSIONTHECA_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/** \brief Get the name of a statistics slot.
+ *
+ * The slots are numbered like the trait_kind_t enumeration. The last
+ * slot, STATISTICS_SLOT_OTHER, counts the traits which are not part of
+ * the library.
+ *
+ * \param[in] slot  The slot number.
+ *
+ * \return The name of the slot or nullptr if \p slot is out of range.
+ */
+char const * get_statistics_slot_name(std::size_t slot)
+{
+    if(slot >= STATISTICS_SLOT_COUNT)
+    {
+        return nullptr;
+    }
+    return g_slot_names[slot];
+}
+
+
+/** \brief Take a snapshot of all the counters.
+ *
+ * \return The statistics of each slot, all zeroes if the instrumentation
+ * is not compiled in.
+ */
+statistics_t get_statistics()
+{
+    statistics_t result;
+#ifdef VERSIONTHECA_INSTRUMENTATION
+    for(std::size_t slot(0); slot < STATISTICS_SLOT_COUNT; ++slot)
+    {
+        slot_counters_t const & c(g_counters[slot]);
+        trait_statistics_t & s(result.f_traits[slot]);
+        s.f_parses = read(c.f_parses);
+        s.f_parse_failures = read(c.f_parse_failures);
+        s.f_parts = read(c.f_parts);
+        s.f_compares = read(c.f_compares);
+        s.f_nexts = read(c.f_nexts);
+        s.f_previouses = read(c.f_previouses);
+        s.f_allocations = read(c.f_allocations);
+        for(std::size_t idx(0); idx < ERROR_CODE_COUNT; ++idx)
+        {
+            s.f_errors[idx] = read(c.f_errors[idx]);
+        }
+        for(std::size_t idx(0); idx < TIMING_BUCKET_COUNT; ++idx)
+        {
+            s.f_parse_times[idx] = read(c.f_parse_times[idx]);
+            s.f_compare_times[idx] = read(c.f_compare_times[idx]);
+        }
+    }
+#endif
+    return result;
+}
+
+
+/** \brief Reset all the counters to zero.
+ */
+void reset_statistics()
+{
+#ifdef VERSIONTHECA_INSTRUMENTATION
+    for(slot_counters_t & c : g_counters)
+    {
+        reset(c.f_parses);
+        reset(c.f_parse_failures);
+        reset(c.f_parts);
+        reset(c.f_compares);
+        reset(c.f_nexts);
+        reset(c.f_previouses);
+        reset(c.f_allocations);
+        for(auto & e : c.f_errors)
+        {
+            reset(e);
+        }
+        for(std::size_t idx(0); idx < TIMING_BUCKET_COUNT; ++idx)
+        {
+            reset(c.f_parse_times[idx]);
+            reset(c.f_compare_times[idx]);
+        }
+    }
+#endif
+}
+
+
+/** \brief Turn the timing histograms on or off.
+ *
+ * When on, each parse() and compare() reads the clock twice.
+ *
+ * \param[in] timing  Whether to measure the duration of the calls.
+ */
+void set_timing(bool timing)
+{
+#ifdef VERSIONTHECA_INSTRUMENTATION
+    g_timing.store(timing, std::memory_order_relaxed);
+#else
+    static_cast<void>(timing);
+#endif
+}
+
+
+/** \brief Check whether the timing histograms are on.
+ *
+ * \return true if set_timing(true) was called and the instrumentation is
+ * compiled in.
+ */
+bool get_timing()
+{
+#ifdef VERSIONTHECA_INSTRUMENTATION
+    return g_timing.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+
+/** \brief Install a function called on each parse() and compare().
+ *
+ * The callback is called after the counters were updated, by the thread
+ * which called parse() or compare(). It must be fast and thread safe.
+ * The input of a parse event is only valid for the duration of the call.
+ *
+ * \param[in] callback  The function to call or nullptr to remove it.
+ */
+void set_trace_callback(trace_callback_t callback)
+{
+#ifdef VERSIONTHECA_INSTRUMENTATION
+    g_trace_callback.store(callback, std::memory_order_release);
+#else
+    static_cast<void>(callback);
+#endif
+}
+
+
+
+#ifdef VERSIONTHECA_INSTRUMENTATION
+namespace detail
+{
+
+
+
+/** \brief Find the statistics slot of a trait.
+ *
+ * \param[in] t  The trait to check.
+ *
+ * \return The slot of the trait type or STATISTICS_SLOT_OTHER.
+ */
+std::size_t get_statistics_slot(trait const & t)
+{
+    std::type_info const & type(typeid(t));
+    if(type == typeid(debian))
+    {
+        return static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_DEBIAN);
+    }
+    if(type == typeid(rpm))
+    {
+        return static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_RPM);
+    }
+    if(type == typeid(unicode))
+    {
+        return static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_UNICODE);
+    }
+    if(type == typeid(basic))
+    {
+        return static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_BASIC);
+    }
+    if(type == typeid(decimal))
+    {
+        return static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_DECIMAL);
+    }
+    if(type == typeid(roman))
+    {
+        return static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_ROMAN);
+    }
+    return STATISTICS_SLOT_OTHER;
+}
+
+
+void count(trait const & t, counter_t counter)
+{
+    slot_counters_t & c(g_counters[get_statistics_slot(t)]);
+    switch(counter)
+    {
+    case counter_t::COUNTER_ALLOCATION:
+        add(c.f_allocations);
+        break;
+
+    case counter_t::COUNTER_NEXT:
+        add(c.f_nexts);
+        break;
+
+    case counter_t::COUNTER_PREVIOUS:
+        add(c.f_previouses);
+        break;
+
+    }
+}
+
+
+/** \brief Count an error.
+ *
+ * When the error happens while parsing, the parse gets counted as a
+ * failure once the outer parse() returns.
+ *
+ * \param[in] t  The trait which recorded the error.
+ * \param[in] code  The error code.
+ */
+void count_error(trait const & t, error_code_t code)
+{
+    std::size_t const idx(static_cast<std::size_t>(code));
+    if(idx < ERROR_CODE_COUNT)
+    {
+        add(g_counters[get_statistics_slot(t)].f_errors[idx]);
+    }
+    if(g_parse_depth > 0)
+    {
+        g_parse_error = code;
+    }
+}
+
+
+parse_probe::parse_probe(trait const & t, std::string_view const & input)
+    : f_trait(t)
+    , f_input(input)
+    , f_outer(g_parse_depth == 0)
+{
+    ++g_parse_depth;
+    if(f_outer)
+    {
+        g_parse_error = error_code_t::ERROR_CODE_NONE;
+        if(g_timing.load(std::memory_order_relaxed))
+        {
+            f_start = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+
+parse_probe::~parse_probe()
+{
+    --g_parse_depth;
+    if(!f_outer)
+    {
+        return;
+    }
+
+    bool const timed(f_start != std::chrono::steady_clock::time_point());
+    std::uint64_t const duration(timed ? elapsed(f_start) : 0);
+    std::size_t const slot(get_statistics_slot(f_trait));
+    slot_counters_t & c(g_counters[slot]);
+    bool const success(g_parse_error == error_code_t::ERROR_CODE_NONE);
+    add(c.f_parses);
+    if(success)
+    {
+        add(c.f_parts, f_trait.size());
+    }
+    else
+    {
+        add(c.f_parse_failures);
+    }
+    if(timed)
+    {
+        add(c.f_parse_times[timing_bucket(duration)]);
+    }
+
+    trace_callback_t const callback(g_trace_callback.load(std::memory_order_acquire));
+    if(callback != nullptr)
+    {
+        trace_event_t event;
+        event.f_operation = trace_operation_t::TRACE_OPERATION_PARSE;
+        event.f_slot = slot;
+        event.f_input = f_input;
+        event.f_success = success;
+        event.f_error = g_parse_error;
+        event.f_duration = duration;
+        callback(event);
+    }
+}
+
+
+compare_probe::compare_probe(trait const & t)
+    : f_trait(t)
+    , f_outer(g_compare_depth == 0)
+{
+    ++g_compare_depth;
+    if(f_outer
+    && g_timing.load(std::memory_order_relaxed))
+    {
+        f_start = std::chrono::steady_clock::now();
+    }
+}
+
+
+compare_probe::~compare_probe()
+{
+    --g_compare_depth;
+    if(!f_outer)
+    {
+        return;
+    }
+
+    bool const timed(f_start != std::chrono::steady_clock::time_point());
+    std::uint64_t const duration(timed ? elapsed(f_start) : 0);
+    std::size_t const slot(get_statistics_slot(f_trait));
+    slot_counters_t & c(g_counters[slot]);
+    add(c.f_compares);
+    if(timed)
+    {
+        add(c.f_compare_times[timing_bucket(duration)]);
+    }
+
+    trace_callback_t const callback(g_trace_callback.load(std::memory_order_acquire));
+    if(callback != nullptr)
+    {
+        trace_event_t event;
+        event.f_operation = trace_operation_t::TRACE_OPERATION_COMPARE;
+        event.f_slot = slot;
+        event.f_duration = duration;
+        callback(event);
+    }
+}
+
+
+
+} // namespace detail
+#endif
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,126 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Counters and tracing hooks of the library.
+ *
+ * When the library is compiled with the VERSIONTHECA_INSTRUMENTATION
+ * CMake option, its hot paths update a set of counters: the number of
+ * versions parsed, the errors found by code, the number of compares,
+ * next() and previous() calls, the number of parts per version, and
+ * the number of traits allocated. The counters are kept per trait type.
+ *
+ * The get_statistics() function returns a snapshot of all the counters
+ * so they can be exported to a metrics system. A trace callback can also
+ * be installed to receive one event per parse() and compare() call.
+ *
+ * Timing histograms are also available. Since reading the clock has a
+ * cost, they are turned off by default; call set_timing(true) to
+ * start measuring. Each bucket counts the calls which took up to 2^n
+ * nanoseconds.
+ *
+ * Without that option, the probes compile to nothing and the functions
+ * below return zeroed statistics, so code using them does not need to
+ * know how the library was compiled.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <array>
+#include    <cstdint>
+
+
+
+namespace versiontheca
+{
+
+
+
+// one slot per trait_kind_t plus one for other traits
+//
+constexpr std::size_t const     STATISTICS_SLOT_OTHER = static_cast<std::size_t>(trait_kind_t::TRAIT_KIND_UNICODE) + 1;
+constexpr std::size_t const     STATISTICS_SLOT_COUNT = STATISTICS_SLOT_OTHER + 1;
+constexpr std::size_t const     ERROR_CODE_COUNT = static_cast<std::size_t>(error_code_t::ERROR_CODE_OUT_OF_RANGE) + 1;
+constexpr std::size_t const     TIMING_BUCKET_COUNT = 32;
+
+
+enum class trace_operation_t : std::uint8_t
+{
+    TRACE_OPERATION_PARSE,
+    TRACE_OPERATION_COMPARE,
+};
+
+
+struct trace_event_t
+{
+    trace_operation_t   f_operation = trace_operation_t::TRACE_OPERATION_PARSE;
+    std::size_t         f_slot = STATISTICS_SLOT_OTHER;
+    std::string_view    f_input = std::string_view();
+    bool                f_success = true;
+    error_code_t        f_error = error_code_t::ERROR_CODE_NONE;
+    std::uint64_t       f_duration = 0;     // in ns, 0 unless timing is on
+};
+
+
+typedef void (*trace_callback_t)(trace_event_t const & event);
+
+
+struct trait_statistics_t
+{
+    std::uint64_t       f_parses = 0;
+    std::uint64_t       f_parse_failures = 0;
+    std::uint64_t       f_parts = 0;
+    std::uint64_t       f_compares = 0;
+    std::uint64_t       f_nexts = 0;
+    std::uint64_t       f_previouses = 0;
+    std::uint64_t       f_allocations = 0;
+    std::array<std::uint64_t, ERROR_CODE_COUNT>
+                        f_errors = {};
+    std::array<std::uint64_t, TIMING_BUCKET_COUNT>
+                        f_parse_times = {};
+    std::array<std::uint64_t, TIMING_BUCKET_COUNT>
+                        f_compare_times = {};
+};
+
+
+struct statistics_t
+{
+    std::array<trait_statistics_t, STATISTICS_SLOT_COUNT>
+                        f_traits = {};
+};
+
+
+bool                    is_instrumentation_enabled();
+char const *            get_statistics_slot_name(std::size_t slot);
+statistics_t            get_statistics();
+void                    reset_statistics();
+void                    set_timing(bool timing);
+bool                    get_timing();
+void                    set_trace_callback(trace_callback_t callback);
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
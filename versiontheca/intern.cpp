@@ -0,0 +1,429 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the intern pool.
+ *
+ * The pool keeps one entry per distinct version string. The entries are
+ * allocated on the heap so their address and the string used as the key
+ * of the index never change, even when the vector of entries grows.
+ *
+ * The compare cache is a direct mapped table of 64 bit words. Each word
+ * holds the identifiers of two entries and the result of their
+ * comparison. A collision simply overwrites the previous result.
+ */
+
+// self
+//
+#include    <versiontheca/intern.h>
+
+#include    <versiontheca/exception.h>
+
+
+// C++
+//
+#include    <mutex>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+// the identifiers are saved on 31 bits in the compare cache
+//
+constexpr std::uint32_t const   MAX_CACHED_ID = 0x7FFFFFFF;
+
+
+std::string const               g_empty_string = std::string();
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Create a handle.
+ *
+ * Only the intern_pool creates valid handles.
+ *
+ * \param[in] pool  The pool which owns the entry.
+ * \param[in] e  The entry this handle references.
+ */
+interned_version::interned_version(intern_pool const * pool, entry_t const * e)
+    : f_pool(pool)
+    , f_entry(e)
+{
+}
+
+
+/** \brief Check whether this version is valid.
+ *
+ * A default constructed handle is not valid.
+ *
+ * \return true if the version was parsed successfully.
+ */
+bool interned_version::is_valid() const
+{
+    return f_entry != nullptr && f_entry->f_valid;
+}
+
+
+/** \brief Get the identifier of this version in its pool.
+ *
+ * Each distinct version string interned in a pool is given a unique
+ * identifier starting at 1. A default constructed handle returns 0.
+ *
+ * \return The identifier of this version.
+ */
+std::uint32_t interned_version::get_id() const
+{
+    return f_entry == nullptr ? 0 : f_entry->f_id;
+}
+
+
+/** \brief Get the version string as it was interned.
+ *
+ * \return The version string.
+ */
+std::string const & interned_version::get_version() const
+{
+    return f_entry == nullptr ? g_empty_string : f_entry->f_version;
+}
+
+
+/** \brief Get the error found while parsing this version.
+ *
+ * The message is generated on each call.
+ *
+ * \return The error message or an empty string if the version is valid.
+ */
+std::string interned_version::get_last_error() const
+{
+    if(f_entry == nullptr)
+    {
+        return std::string();
+    }
+    return error_message(f_entry->f_error, f_entry->f_version);
+}
+
+
+/** \brief Get the error found while parsing this version.
+ *
+ * \return The error, with code ERROR_CODE_NONE if the version is valid.
+ */
+version_error_t interned_version::get_error() const
+{
+    return f_entry == nullptr ? version_error_t() : f_entry->f_error;
+}
+
+
+/** \brief Get the trait holding the parsed version.
+ *
+ * The trait is shared by all the handles of this version and must not
+ * be modified.
+ *
+ * \exception missing_pointer
+ * A default constructed handle has no trait.
+ *
+ * \return A reference to the trait.
+ */
+trait const & interned_version::get_trait() const
+{
+    if(f_entry == nullptr)
+    {
+        throw missing_pointer("this interned version is not attached to a pool.");
+    }
+    return *f_entry->f_trait;
+}
+
+
+/** \brief Get the pool this version was interned in.
+ *
+ * \return The pool or nullptr for a default constructed handle.
+ */
+intern_pool const * interned_version::get_pool() const
+{
+    return f_pool;
+}
+
+
+/** \brief Compare two interned versions.
+ *
+ * If both handles reference the same entry, the versions are equal and
+ * the trait is not called. Otherwise the pool compare cache is checked
+ * before calling the trait.
+ *
+ * Versions from different pools can be compared but the compare cache
+ * is not used.
+ *
+ * \exception invalid_version
+ * Both versions must be valid.
+ *
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1.
+ */
+int interned_version::compare(interned_version const & rhs) const
+{
+    if(!is_valid() || !rhs.is_valid())
+    {
+        throw invalid_version("one or both of the input versions are not valid.");
+    }
+    if(f_entry == rhs.f_entry)
+    {
+        return 0;
+    }
+    if(f_pool != rhs.f_pool)
+    {
+        return f_entry->f_trait->compare(rhs.f_entry->f_trait);
+    }
+    return f_pool->compare(f_entry, rhs.f_entry);
+}
+
+
+bool interned_version::operator == (interned_version const & rhs) const
+{
+    return compare(rhs) == 0;
+}
+
+
+bool interned_version::operator != (interned_version const & rhs) const
+{
+    return compare(rhs) != 0;
+}
+
+
+bool interned_version::operator < (interned_version const & rhs) const
+{
+    return compare(rhs) < 0;
+}
+
+
+bool interned_version::operator <= (interned_version const & rhs) const
+{
+    return compare(rhs) <= 0;
+}
+
+
+bool interned_version::operator > (interned_version const & rhs) const
+{
+    return compare(rhs) > 0;
+}
+
+
+bool interned_version::operator >= (interned_version const & rhs) const
+{
+    return compare(rhs) >= 0;
+}
+
+
+
+/** \brief Initialize an intern pool.
+ *
+ * The \p compare_cache_size is rounded up to a power of two. Use 0 to
+ * disable the compare cache.
+ *
+ * \param[in] kind  The kind of trait used to parse the versions.
+ * \param[in] compare_cache_size  The number of slots in the compare cache.
+ */
+intern_pool::intern_pool(trait_kind_t kind, std::size_t compare_cache_size)
+    : f_kind(kind)
+{
+    // verify the kind immediately
+    //
+    create_trait(kind);
+
+    if(compare_cache_size > 0)
+    {
+        std::size_t size(1);
+        while(size < compare_cache_size)
+        {
+            size <<= 1;
+        }
+        f_cache_mask = size - 1;
+        f_cache.reset(new std::atomic<std::uint64_t>[size]);
+        for(std::size_t idx(0); idx < size; ++idx)
+        {
+            f_cache[idx].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+
+/** \brief Retrieve the kind of trait used by this pool.
+ *
+ * \return The trait kind specified on construction.
+ */
+trait_kind_t intern_pool::get_kind() const
+{
+    return f_kind;
+}
+
+
+/** \brief Intern a version.
+ *
+ * If the version string was interned before, the existing entry is
+ * returned. Otherwise the version gets parsed and a new entry is added
+ * to the pool.
+ *
+ * Invalid versions are interned too so the error message is available
+ * on the returned handle.
+ *
+ * \param[in] v  The version to intern.
+ *
+ * \return A handle to the interned version.
+ */
+interned_version intern_pool::intern(std::string_view const & v)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(f_mutex);
+        auto const it(f_index.find(v));
+        if(it != f_index.end())
+        {
+            return interned_version(this, it->second);
+        }
+    }
+
+    // parse outside of the lock so other threads can still look up
+    // existing entries
+    //
+    std::unique_ptr<entry_t> e(std::make_unique<entry_t>());
+    e->f_version = v;
+    e->f_trait = create_trait(f_kind);
+    e->f_valid = e->f_trait->parse(v);
+    if(!e->f_valid)
+    {
+        e->f_error = e->f_trait->get_error();
+    }
+
+    std::unique_lock<std::shared_mutex> lock(f_mutex);
+    auto const it(f_index.find(v));
+    if(it != f_index.end())
+    {
+        // another thread added it in the meantime
+        //
+        return interned_version(this, it->second);
+    }
+    e->f_id = static_cast<std::uint32_t>(f_entries.size() + 1);
+    entry_t const * result(e.get());
+    f_index.emplace(result->f_version, result);
+    f_entries.push_back(std::move(e));
+    return interned_version(this, result);
+}
+
+
+/** \brief Get the number of distinct versions in this pool.
+ *
+ * \return The number of entries.
+ */
+std::size_t intern_pool::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(f_mutex);
+    return f_entries.size();
+}
+
+
+/** \brief Get the number of slots in the compare cache.
+ *
+ * \return The number of slots or 0 if the cache is disabled.
+ */
+std::size_t intern_pool::get_compare_cache_size() const
+{
+    return f_cache == nullptr ? 0 : f_cache_mask + 1;
+}
+
+
+/** \brief Get the number of comparisons found in the cache.
+ *
+ * \return The number of cache hits.
+ */
+std::size_t intern_pool::get_compare_cache_hits() const
+{
+    return f_hits.load(std::memory_order_relaxed);
+}
+
+
+/** \brief Get the number of comparisons which required the trait.
+ *
+ * \return The number of cache misses.
+ */
+std::size_t intern_pool::get_compare_cache_misses() const
+{
+    return f_misses.load(std::memory_order_relaxed);
+}
+
+
+/** \brief Compare two entries of this pool.
+ *
+ * The pair is ordered by identifier so comparing A with B and B with A
+ * use the same slot. The slot holds both identifiers and the result plus
+ * one on 2 bits, so a slot holding 0 is empty.
+ *
+ * \param[in] lhs  The left hand side entry.
+ * \param[in] rhs  The right hand side entry.
+ *
+ * \return -1, 0, or 1.
+ */
+int intern_pool::compare(entry_t const * lhs, entry_t const * rhs) const
+{
+    bool const swapped(lhs->f_id > rhs->f_id);
+    entry_t const * a(swapped ? rhs : lhs);
+    entry_t const * b(swapped ? lhs : rhs);
+    if(f_cache == nullptr
+    || b->f_id > MAX_CACHED_ID)
+    {
+        return lhs->f_trait->compare(rhs->f_trait);
+    }
+
+    std::uint64_t const key((static_cast<std::uint64_t>(a->f_id) << 33)
+                          | (static_cast<std::uint64_t>(b->f_id) << 2));
+    std::size_t const slot(((key * 0x9E3779B97F4A7C15ULL) >> 32) & f_cache_mask);
+    std::uint64_t const cached(f_cache[slot].load(std::memory_order_relaxed));
+    int r(0);
+    if((cached & ~3ULL) == key)
+    {
+        ++f_hits;
+        r = static_cast<int>(cached & 3) - 1;
+    }
+    else
+    {
+        ++f_misses;
+        r = a->f_trait->compare(b->f_trait);
+        f_cache[slot].store(key | static_cast<std::uint64_t>(r + 1), std::memory_order_relaxed);
+    }
+    return swapped ? -r : r;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
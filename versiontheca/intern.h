@@ -0,0 +1,148 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Intern pool of parsed versions.
+ *
+ * A package manager sees the same versions over and over (the same
+ * package is found in the index of many mirrors). The intern_pool class
+ * parses each distinct version string once and hands out lightweight
+ * interned_version handles referencing the one parsed copy.
+ *
+ * Two handles referencing the same entry are equal without calling the
+ * trait. Other comparisons go through the trait and the result is saved
+ * in a small lock free cache indexed by the pair of entry identifiers so
+ * comparing the same pair again is just one atomic load.
+ *
+ * The pool is thread safe. The handles are only valid as long as the
+ * pool they come from exists.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <atomic>
+#include    <memory>
+#include    <shared_mutex>
+#include    <unordered_map>
+#include    <vector>
+
+
+
+namespace versiontheca
+{
+
+
+
+class intern_pool;
+
+
+class interned_version
+{
+public:
+                        interned_version() = default;
+
+    bool                is_valid() const;
+    std::uint32_t       get_id() const;
+    std::string const & get_version() const;
+    std::string         get_last_error() const;
+    version_error_t     get_error() const;
+    trait const &       get_trait() const;
+    intern_pool const * get_pool() const;
+
+    int                 compare(interned_version const & rhs) const;
+    bool                operator == (interned_version const & rhs) const;
+    bool                operator != (interned_version const & rhs) const;
+    bool                operator <  (interned_version const & rhs) const;
+    bool                operator <= (interned_version const & rhs) const;
+    bool                operator >  (interned_version const & rhs) const;
+    bool                operator >= (interned_version const & rhs) const;
+
+private:
+    friend class intern_pool;
+
+    struct entry_t
+    {
+        std::uint32_t       f_id = 0;
+        bool                f_valid = false;
+        std::string         f_version = std::string();
+        version_error_t     f_error = version_error_t();
+        trait::pointer_t    f_trait = trait::pointer_t();
+    };
+
+                        interned_version(intern_pool const * pool, entry_t const * e);
+
+    intern_pool const * f_pool = nullptr;
+    entry_t const *     f_entry = nullptr;
+};
+
+
+class intern_pool
+{
+public:
+    typedef std::shared_ptr<intern_pool>    pointer_t;
+
+    static constexpr std::size_t const      DEFAULT_COMPARE_CACHE_SIZE = 64 * 1024;
+
+                        intern_pool(
+                                  trait_kind_t kind
+                                , std::size_t compare_cache_size = DEFAULT_COMPARE_CACHE_SIZE);
+                        intern_pool(intern_pool const &) = delete;
+    intern_pool &       operator = (intern_pool const &) = delete;
+
+    trait_kind_t        get_kind() const;
+    interned_version    intern(std::string_view const & v);
+    std::size_t         size() const;
+
+    std::size_t         get_compare_cache_size() const;
+    std::size_t         get_compare_cache_hits() const;
+    std::size_t         get_compare_cache_misses() const;
+
+private:
+    friend class interned_version;
+
+    typedef interned_version::entry_t       entry_t;
+
+    int                 compare(entry_t const * lhs, entry_t const * rhs) const;
+
+    trait_kind_t        f_kind = trait_kind_t::TRAIT_KIND_UNICODE;
+    mutable std::shared_mutex
+                        f_mutex = std::shared_mutex();
+    std::vector<std::unique_ptr<entry_t>>
+                        f_entries = std::vector<std::unique_ptr<entry_t>>();
+    std::unordered_map<std::string_view, entry_t const *>
+                        f_index = std::unordered_map<std::string_view, entry_t const *>();
+    std::size_t         f_cache_mask = 0;
+    std::unique_ptr<std::atomic<std::uint64_t>[]>
+                        f_cache = std::unique_ptr<std::atomic<std::uint64_t>[]>();
+    mutable std::atomic<std::size_t>
+                        f_hits = 0;
+    mutable std::atomic<std::size_t>
+                        f_misses = 0;
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,234 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Create a trait from its kind.
+ *
+ * This file implements the trait factory used by the functions which need
+ * to allocate their own trait objects.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+#include    <versiontheca/basic.h>
+#include    <versiontheca/debian.h>
+#include    <versiontheca/decimal.h>
+#include    <versiontheca/exception.h>
+#include    <versiontheca/probe.h>
+#include    <versiontheca/roman.h>
+#include    <versiontheca/rpm.h>
+#include    <versiontheca/unicode.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+template<typename T>
+trait::pointer_t allocate_trait(std::pmr::memory_resource * resource)
+{
+    if(resource == nullptr)
+    {
+        return std::make_shared<T>();
+    }
+    return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Allocate a trait of the specified kind.
+ *
+ * This function creates a new trait object of the type defined by \p kind.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p kind is not one of the
+ * trait_kind_t values.
+ *
+ * \param[in] kind  The kind of trait to allocate.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t create_trait(trait_kind_t kind)
+{
+    return create_trait(kind, nullptr);
+}
+
+
+/** \brief Allocate a trait of the specified kind from a memory resource.
+ *
+ * The trait and the shared pointer control block are allocated with one
+ * call to \p resource. When \p resource is nullptr, the trait is
+ * allocated on the heap like with create_trait(kind).
+ *
+ * The parts are stored inline in the trait, so parsing a version does
+ * not allocate more memory unless a part string is too long for the
+ * small string optimization.
+ *
+ * \warning
+ * The \p resource must outlive the trait. Note that clone() always
+ * allocates on the heap, so a copy of a versiontheca object created
+ * with such a trait does not depend on \p resource.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p kind is not one of the
+ * trait_kind_t values.
+ *
+ * \param[in] kind  The kind of trait to allocate.
+ * \param[in] resource  The memory resource to allocate the trait from.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t create_trait(trait_kind_t kind, std::pmr::memory_resource * resource)
+{
+    trait::pointer_t t;
+    switch(kind)
+    {
+    case trait_kind_t::TRAIT_KIND_BASIC:
+        t = allocate_trait<basic>(resource);
+        break;
+
+    case trait_kind_t::TRAIT_KIND_DEBIAN:
+        t = allocate_trait<debian>(resource);
+        break;
+
+    case trait_kind_t::TRAIT_KIND_DECIMAL:
+        t = allocate_trait<decimal>(resource);
+        break;
+
+    case trait_kind_t::TRAIT_KIND_ROMAN:
+        t = allocate_trait<roman>(resource);
+        break;
+
+    case trait_kind_t::TRAIT_KIND_RPM:
+        t = allocate_trait<rpm>(resource);
+        break;
+
+    case trait_kind_t::TRAIT_KIND_UNICODE:
+        t = allocate_trait<unicode>(resource);
+        break;
+
+    }
+
+    if(t == nullptr)
+    {
+        throw invalid_parameter(
+                  "unknown trait kind ("
+                + std::to_string(static_cast<int>(kind))
+                + ").");
+    }
+
+    VERSIONTHECA_PROBE_COUNT(*t, COUNTER_ALLOCATION);
+
+    return t;
+}
+
+
+/** \brief Get the name of a trait kind.
+ *
+ * The name is the name of the trait class ("basic", "debian", etc.)
+ *
+ * \param[in] kind  The kind to convert.
+ *
+ * \return The name of the kind or nullptr if \p kind is not valid.
+ */
+char const * trait_kind_to_string(trait_kind_t kind)
+{
+    switch(kind)
+    {
+    case trait_kind_t::TRAIT_KIND_BASIC:
+        return "basic";
+
+    case trait_kind_t::TRAIT_KIND_DEBIAN:
+        return "debian";
+
+    case trait_kind_t::TRAIT_KIND_DECIMAL:
+        return "decimal";
+
+    case trait_kind_t::TRAIT_KIND_ROMAN:
+        return "roman";
+
+    case trait_kind_t::TRAIT_KIND_RPM:
+        return "rpm";
+
+    case trait_kind_t::TRAIT_KIND_UNICODE:
+        return "unicode";
+
+    }
+
+    return nullptr;
+}
+
+
+/** \brief Check whether the sort keys of a kind always agree with compare().
+ *
+ * The basic, Debian, and decimal compare() functions define a total
+ * order and their sort keys give the exact same order.
+ *
+ * The Unicode, roman, and RPM compare() functions are not transitive
+ * so no key can agree with them on all the pairs. For example, a Unicode
+ * string of `'A'` is equal to a missing part but larger than any integer:
+ * "1" \< "1.1" \< "1.A" and yet "1.A" == "1". The key of "1.A" is
+ * the key of "1" so it sorts before "1.1". The functions working with
+ * keys (sort_version_indexes(), version_index, version_range::contains_key()...)
+ * use the key order for these kinds.
+ *
+ * \param[in] kind  The kind of versions to check.
+ *
+ * \return true if comparing the keys always gives the compare() result.
+ *
+ * \sa trait::sort_key()
+ */
+bool sort_key_matches_compare(trait_kind_t kind)
+{
+    switch(kind)
+    {
+    case trait_kind_t::TRAIT_KIND_BASIC:
+    case trait_kind_t::TRAIT_KIND_DEBIAN:
+    case trait_kind_t::TRAIT_KIND_DECIMAL:
+        return true;
+
+    default:
+        return false;
+
+    }
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
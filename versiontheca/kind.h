@@ -0,0 +1,67 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Enumeration of the traits offered by the library.
+ *
+ * The trait kind is used by functions which create traits on their own,
+ * such as the batch parser, so the caller does not have to allocate a
+ * trait object first.
+ *
+ * The traits can also be allocated from a memory resource such as a
+ * version_arena (see arena.h), in which case the resource must outlive
+ * the traits.
+ */
+
+// self
+//
+#include    <versiontheca/trait.h>
+
+
+// C++
+//
+#include    <memory_resource>
+
+
+namespace versiontheca
+{
+
+
+
+enum class trait_kind_t
+{
+    TRAIT_KIND_BASIC,
+    TRAIT_KIND_DEBIAN,
+    TRAIT_KIND_DECIMAL,
+    TRAIT_KIND_ROMAN,
+    TRAIT_KIND_RPM,
+    TRAIT_KIND_UNICODE,
+};
+
+
+trait::pointer_t        create_trait(trait_kind_t kind);
+trait::pointer_t        create_trait(trait_kind_t kind, std::pmr::memory_resource * resource);
+char const *            trait_kind_to_string(trait_kind_t kind);
+bool                    sort_key_matches_compare(trait_kind_t kind);
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
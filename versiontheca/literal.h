@@ -0,0 +1,248 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Versions parsed at compile time.
+ *
+ * The static_version<Policy> template parses a version in a constexpr
+ * context. It uses the same policies as basic_version<Policy> and the
+ * same compare functions as the traits so a version computed at compile
+ * time always sorts the same way as the same version parsed at runtime.
+ *
+ * The input is saved in a fixed buffer of MAX_LITERAL_LENGTH characters
+ * so the object has no dynamic allocation.
+ *
+ * \code
+ *     using namespace versiontheca::literals;
+ *
+ *     constexpr auto g_minimum = "1.2.3"_vbasic;
+ *     static_assert(g_minimum < "1.10"_vbasic);
+ *
+ *     if(versiontheca::numeric_version(version_from_peer) < g_minimum) ...
+ * \endcode
+ *
+ * A literal which is not a valid version fails to compile when used in a
+ * constant expression. At runtime it raises an invalid_version exception.
+ *
+ * In C++17 a class cannot be used directly as a non-type template
+ * parameter. Instead, use a reference to a constexpr variable:
+ *
+ * \code
+ *     template<versiontheca::static_numeric_version const & Minimum>
+ *     class feature;
+ *
+ *     feature<g_minimum> f;
+ * \endcode
+ */
+
+// self
+//
+#include    <versiontheca/basic_version.h>
+#include    <versiontheca/exception.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+constexpr std::size_t const     MAX_LITERAL_LENGTH = 64;
+
+
+template<std::size_t N>
+class fixed_string
+{
+public:
+    constexpr std::size_t       max_size() const { return N; }
+    constexpr std::size_t       length() const { return f_length; }
+    constexpr bool              empty() const { return f_length == 0; }
+    constexpr char const *      data() const { return f_data; }
+    constexpr char              operator [] (std::size_t idx) const { return f_data[idx]; }
+
+    constexpr void clear()
+    {
+        f_length = 0;
+    }
+
+    constexpr void assign(char const * s, std::size_t length)
+    {
+        for(std::size_t idx(0); idx < length; ++idx)
+        {
+            f_data[idx] = s[idx];
+        }
+        f_length = length;
+    }
+
+private:
+    char                        f_data[N] = {};
+    std::size_t                 f_length = 0;
+};
+
+
+template<typename Policy>
+class static_version
+{
+public:
+    typedef Policy      policy_t;
+    typedef basic_version_parts<fixed_string<MAX_LITERAL_LENGTH>>
+                        parts_t;
+
+    constexpr           static_version() = default;
+
+    constexpr explicit  static_version(std::string_view const & v)
+                        {
+                            f_valid = f_parts.assign(v) && Policy::parse(f_parts);
+                        }
+
+    constexpr bool      is_valid() const { return f_valid; }
+    constexpr std::size_t
+                        size() const { return f_valid ? f_parts.size() : 0; }
+    constexpr std::string_view
+                        get_version() const
+                        {
+                            return std::string_view(f_parts.get_input().data(), f_parts.get_input().length());
+                        }
+    constexpr parts_t const &
+                        get_parts() const { return f_parts; }
+    constexpr char const *
+                        get_last_error() const
+                        {
+                            return f_parts.get_last_error() == nullptr
+                                        ? ""
+                                        : f_parts.get_last_error();
+                        }
+
+    constexpr int compare(static_version const & rhs) const
+    {
+        if(!f_valid || !rhs.f_valid)
+        {
+            return compare_validity(rhs.f_valid);
+        }
+        return Policy::static_compare(f_parts, rhs.f_parts);
+    }
+
+    int compare(basic_version<Policy> const & rhs) const
+    {
+        if(!f_valid || !rhs.is_valid())
+        {
+            return compare_validity(rhs.is_valid());
+        }
+        return Policy::compare(f_parts, rhs.get_parts());
+    }
+
+    constexpr bool      operator == (static_version const & rhs) const { return compare(rhs) == 0; }
+    constexpr bool      operator != (static_version const & rhs) const { return compare(rhs) != 0; }
+    constexpr bool      operator <  (static_version const & rhs) const { return compare(rhs) <  0; }
+    constexpr bool      operator <= (static_version const & rhs) const { return compare(rhs) <= 0; }
+    constexpr bool      operator >  (static_version const & rhs) const { return compare(rhs) >  0; }
+    constexpr bool      operator >= (static_version const & rhs) const { return compare(rhs) >= 0; }
+
+private:
+    constexpr int compare_validity(bool rhs_valid) const
+    {
+        // same rules as basic_version::compare()
+        //
+        return f_valid == rhs_valid ? 0 : (f_valid ? 1 : -1);
+    }
+
+    parts_t             f_parts = parts_t();
+    bool                f_valid = false;
+};
+
+
+typedef static_version<basic_policy>    static_numeric_version;
+typedef static_version<debian_policy>   static_debian_version;
+
+
+template<typename Policy>
+bool operator == (basic_version<Policy> const & lhs, static_version<Policy> const & rhs) { return rhs.compare(lhs) == 0; }
+template<typename Policy>
+bool operator != (basic_version<Policy> const & lhs, static_version<Policy> const & rhs) { return rhs.compare(lhs) != 0; }
+template<typename Policy>
+bool operator <  (basic_version<Policy> const & lhs, static_version<Policy> const & rhs) { return rhs.compare(lhs) >  0; }
+template<typename Policy>
+bool operator <= (basic_version<Policy> const & lhs, static_version<Policy> const & rhs) { return rhs.compare(lhs) >= 0; }
+template<typename Policy>
+bool operator >  (basic_version<Policy> const & lhs, static_version<Policy> const & rhs) { return rhs.compare(lhs) <  0; }
+template<typename Policy>
+bool operator >= (basic_version<Policy> const & lhs, static_version<Policy> const & rhs) { return rhs.compare(lhs) <= 0; }
+
+
+
+namespace literals
+{
+
+
+
+/** \brief Parse a version literal as a basic version.
+ *
+ * A basic version is composed of integers separated by periods.
+ *
+ * \exception invalid_version
+ * The literal is not a valid basic version. In a constant expression,
+ * this is a compile time error.
+ *
+ * \param[in] s  The literal string.
+ * \param[in] length  The length of the literal.
+ *
+ * \return The parsed version.
+ */
+constexpr static_numeric_version operator ""_vbasic(char const * s, std::size_t length)
+{
+    static_numeric_version const v(std::string_view(s, length));
+    if(!v.is_valid())
+    {
+        throw invalid_version(std::string("invalid basic version literal: ") + v.get_last_error());
+    }
+    return v;
+}
+
+
+/** \brief Parse a version literal as a Debian version.
+ *
+ * \exception invalid_version
+ * The literal is not a valid Debian version. In a constant expression,
+ * this is a compile time error.
+ *
+ * \param[in] s  The literal string.
+ * \param[in] length  The length of the literal.
+ *
+ * \return The parsed version.
+ */
+constexpr static_debian_version operator ""_vdebian(char const * s, std::size_t length)
+{
+    static_debian_version const v(std::string_view(s, length));
+    if(!v.is_valid())
+    {
+        throw invalid_version(std::string("invalid Debian version literal: ") + v.get_last_error());
+    }
+    return v;
+}
+
+
+
+}
+// namespace literals
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
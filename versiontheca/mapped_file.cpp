@@ -0,0 +1,146 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the file mapping functions.
+ */
+
+// self
+//
+#include    <versiontheca/mapped_file.h>
+
+#include    <versiontheca/exception.h>
+
+
+// C++
+//
+#include    <fstream>
+
+
+// C
+//
+#include    <fcntl.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+namespace detail
+{
+
+
+
+/** \brief Map a file in memory.
+ *
+ * The file is mapped read-only. The mapping is released when the last
+ * copy of the returned pointer is.
+ *
+ * \exception io_error
+ * The function raises this exception if the file cannot be opened or
+ * mapped in memory.
+ *
+ * \exception invalid_index
+ * The function raises this exception if the file is smaller than
+ * \p min_size.
+ *
+ * \param[in] filename  The name of the file to load.
+ * \param[in] what  The type of file, used in error messages.
+ * \param[in] min_size  The minimum size of a valid file (not 0).
+ * \param[out] size  The size of the file.
+ *
+ * \return A pointer to the file data.
+ */
+std::shared_ptr<char const> map_file(
+      std::string const & filename
+    , char const * what
+    , std::size_t min_size
+    , std::size_t & size)
+{
+    int const fd(open(filename.c_str(), O_RDONLY | O_CLOEXEC));
+    if(fd < 0)
+    {
+        throw io_error(std::string("could not open ") + what + " file \"" + filename + "\".");
+    }
+    struct stat st = {};
+    if(fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw io_error(std::string("could not get the size of ") + what + " file \"" + filename + "\".");
+    }
+    std::size_t const file_size(st.st_size);
+    if(file_size < min_size)
+    {
+        close(fd);
+        throw invalid_index(std::string(what) + " file \"" + filename + "\" is too small.");
+    }
+    void * ptr(mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0));
+    close(fd);
+    if(ptr == MAP_FAILED)
+    {
+        throw io_error(std::string("could not map ") + what + " file \"" + filename + "\" in memory.");
+    }
+
+    size = file_size;
+    return std::shared_ptr<char const>(
+              static_cast<char const *>(ptr)
+            , [file_size](char const * p)
+            {
+                munmap(const_cast<char *>(p), file_size);
+            });
+}
+
+
+/** \brief Save a buffer to a file.
+ *
+ * \exception io_error
+ * The function raises this exception if the file cannot be written.
+ *
+ * \param[in] filename  The name of the file to create.
+ * \param[in] what  The type of file, used in error messages.
+ * \param[in] data  The data to save.
+ * \param[in] size  The number of bytes to save.
+ */
+void save_file(
+      std::string const & filename
+    , char const * what
+    , char const * data
+    , std::size_t size)
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(data, size);
+    out.close();
+    if(!out)
+    {
+        throw io_error(std::string("could not write ") + what + " file \"" + filename + "\".");
+    }
+}
+
+
+
+} // namespace detail
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
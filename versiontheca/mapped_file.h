@@ -0,0 +1,58 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Load binary files in memory.
+ *
+ * The version index and the encoded version lists are saved as is in
+ * files and mapped back in memory on load.
+ */
+
+// C++
+//
+#include    <memory>
+#include    <string>
+
+
+
+namespace versiontheca
+{
+namespace detail
+{
+
+
+
+std::shared_ptr<char const>
+                        map_file(
+                              std::string const & filename
+                            , char const * what
+                            , std::size_t min_size
+                            , std::size_t & size);
+void                    save_file(
+                              std::string const & filename
+                            , char const * what
+                            , char const * data
+                            , std::size_t size);
+
+
+
+} // namespace detail
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,256 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the version output.
+ *
+ * The output is either an std::string, which grows as required, or a
+ * buffer defined by a \c first and \c last pointer as with
+ * std::to_chars(). In the latter case, the output becomes full() the
+ * first time a write does not fit and any further write is ignored.
+ */
+
+// self
+//
+#include    <versiontheca/output.h>
+
+
+// C++
+//
+#include    <cstring>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+std::to_chars_result integer_to_chars(char * first, char * last, part_integer_t value)
+{
+    return std::to_chars(first, last, value);
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Append the output to a string.
+ *
+ * \param[in,out] result  The string where the output gets appended.
+ */
+version_output::version_output(std::string & result)
+    : f_string(&result)
+{
+}
+
+
+/** \brief Write the output in a buffer.
+ *
+ * The output gets written starting at \p first. Nothing gets written
+ * at or after \p last.
+ *
+ * \param[in] first  The start of the buffer.
+ * \param[in] last  The end of the buffer.
+ */
+version_output::version_output(char * first, char * last)
+    : f_next(first)
+    , f_last(last)
+{
+}
+
+
+void version_output::append(char c)
+{
+    if(f_string != nullptr)
+    {
+        *f_string += c;
+    }
+    else if(reserve(1))
+    {
+        *f_next++ = c;
+    }
+}
+
+
+/** \brief Append a character encoded in UTF-8.
+ *
+ * The separators are saved as char32_t. This function writes them in
+ * UTF-8, the same as libutf8 does when appending them to a string.
+ *
+ * \param[in] c  The character to append.
+ */
+void version_output::append(char32_t c)
+{
+    char buf[4];
+    std::size_t length(0);
+    if(c < 0x80)
+    {
+        buf[length++] = static_cast<char>(c);
+    }
+    else if(c < 0x800)
+    {
+        buf[length++] = static_cast<char>(0xC0 | (c >> 6));
+        buf[length++] = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else if(c < 0x10000)
+    {
+        buf[length++] = static_cast<char>(0xE0 | (c >> 12));
+        buf[length++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        buf[length++] = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else
+    {
+        buf[length++] = static_cast<char>(0xF0 | (c >> 18));
+        buf[length++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        buf[length++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        buf[length++] = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    append(std::string_view(buf, length));
+}
+
+
+void version_output::append(std::size_t count, char c)
+{
+    if(f_string != nullptr)
+    {
+        f_string->append(count, c);
+    }
+    else if(reserve(count))
+    {
+        memset(f_next, c, count);
+        f_next += count;
+    }
+}
+
+
+void version_output::append(std::string_view const & s)
+{
+    if(f_string != nullptr)
+    {
+        f_string->append(s.data(), s.length());
+    }
+    else if(reserve(s.length()))
+    {
+        memcpy(f_next, s.data(), s.length());
+        f_next += s.length();
+    }
+}
+
+
+/** \brief Append an integer written in decimal.
+ *
+ * \param[in] value  The integer to append.
+ */
+void version_output::append_integer(part_integer_t value)
+{
+    append_formatted(value, integer_to_chars);
+}
+
+
+/** \brief Append an integer written with a specific format.
+ *
+ * The \p format function works like std::to_chars(). When writing in
+ * a buffer, it gets called with the space left in the buffer so the
+ * integer is written in place. When appending to a string, it writes
+ * in a small buffer on the stack first.
+ *
+ * \param[in] value  The integer to append.
+ * \param[in] format  The function used to convert the integer.
+ */
+void version_output::append_formatted(part_integer_t value, format_t format)
+{
+    if(f_string != nullptr)
+    {
+        // large enough for any integer and any Roman numeral
+        //
+        char buf[16];
+        std::to_chars_result const r(format(buf, buf + sizeof(buf), value));
+        if(r.ec == std::errc())
+        {
+            f_string->append(buf, r.ptr - buf);
+        }
+    }
+    else if(!f_full)
+    {
+        std::to_chars_result const r(format(f_next, f_last, value));
+        if(r.ec == std::errc::value_too_large)
+        {
+            f_full = true;
+        }
+        else if(r.ec == std::errc())
+        {
+            f_next = r.ptr;
+        }
+    }
+}
+
+
+/** \brief Check whether the buffer was too small.
+ *
+ * Once full, the output ignores any further writes. A string output is
+ * never full.
+ *
+ * \return true if some of the output did not fit in the buffer.
+ */
+bool version_output::full() const
+{
+    return f_full;
+}
+
+
+/** \brief Get the end of the output written in the buffer.
+ *
+ * \return One past the last character written, or nullptr when writing
+ * to a string.
+ */
+char * version_output::end() const
+{
+    return f_next;
+}
+
+
+bool version_output::reserve(std::size_t length)
+{
+    if(f_full
+    || length > static_cast<std::size_t>(f_last - f_next))
+    {
+        f_full = true;
+        return false;
+    }
+    return true;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
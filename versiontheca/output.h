@@ -0,0 +1,76 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Destination of a canonicalized version.
+ *
+ * The traits write their canonicalized version through a version_output.
+ * The output either appends to an std::string or writes into a buffer
+ * owned by the caller, in which case nothing gets allocated and the
+ * writing stops as soon as the buffer is full.
+ */
+
+// self
+//
+#include    <versiontheca/part.h>
+
+
+// C++
+//
+#include    <charconv>
+
+
+
+namespace versiontheca
+{
+
+
+
+class version_output
+{
+public:
+    typedef std::to_chars_result (*format_t)(char * first, char * last, part_integer_t value);
+
+                        version_output(std::string & result);
+                        version_output(char * first, char * last);
+
+    void                append(char c);
+    void                append(char32_t c);
+    void                append(std::size_t count, char c);
+    void                append(std::string_view const & s);
+    void                append_integer(part_integer_t value);
+    void                append_formatted(part_integer_t value, format_t format);
+
+    bool                full() const;
+    char *              end() const;
+
+private:
+    bool                reserve(std::size_t length);
+
+    std::string *       f_string = nullptr;
+    char *              f_next = nullptr;
+    char *              f_last = nullptr;
+    bool                f_full = false;
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
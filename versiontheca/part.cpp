@@ -36,7 +36,9 @@
 //
 #include    <versiontheca/part.h>
 
+#include    <versiontheca/compare.h>
 #include    <versiontheca/exception.h>
+#include    <versiontheca/output.h>
 
 
 // libutf8
@@ -46,6 +48,7 @@
 
 // C++
 //
+#include    <charconv>
 #include    <iostream>
 #include    <limits>
 
@@ -144,17 +147,15 @@ void part::set_type(char type)
  * \return true if the value is considered valid and the part was properly
  * defined from it.
  */
-bool part::set_value(std::string const & value)
+bool part::set_value(std::string_view const & value)
 {
     part_integer_t integer(0);
-    for(char const * s(value.c_str()); *s != '\0'; ++s)
+    for(char const c : value)
     {
-        if(*s >= '0' && *s <= '9')
+        if(c >= '0' && c <= '9')
         {
-            part_integer_t const old(integer);
-            integer *= 10;
-            integer += *s - '0';
-            if(integer < old)
+            part_integer_t const digit(c - '0');
+            if(integer > (std::numeric_limits<part_integer_t>::max() - digit) / 10)
             {
                 // note: if you want to accept really large numbers as strings
                 //       then make sure to use the set_string() instead
@@ -162,6 +163,7 @@ bool part::set_value(std::string const & value)
                 f_last_error = "integer too large for a valid version.";
                 return false;
             }
+            integer = integer * 10 + digit;
         }
         else
         {
@@ -174,11 +176,11 @@ bool part::set_value(std::string const & value)
 }
 
 
-void part::set_string(std::string const & value)
+void part::set_string(std::string_view const & value)
 {
     f_is_integer = false;
     f_integer = 0;
-    f_string = value;
+    f_string.assign(value.data(), value.length());
 }
 
 
@@ -232,38 +234,45 @@ bool part::next()
     }
     else
     {
-        std::string s(f_string);
-        std::size_t pos(s.length());
+        // the string is updated in place; reaching the start without
+        // incrementing a letter means that all the letters were 'z'
+        //
+        std::size_t pos(f_string.length());
         while(pos > 0)
         {
             --pos;
-            if((s[pos] >= 'A' && s[pos] < 'Z')
-            || (s[pos] >= 'a' && s[pos] < 'z'))
+            char & c(f_string[pos]);
+            if((c >= 'A' && c < 'Z')
+            || (c >= 'a' && c < 'z'))
             {
-                ++s[pos];
-                break;
+                ++c;
+                return true;
             }
-            if(s[pos] == 'Z')
+            if(c == 'Z')
             {
-                s[pos] = 'a';
-                break;
+                c = 'a';
+                return true;
             }
-            if(s[pos] == 'z')
+            if(c == 'z')
             {
                 // wrap around + carry (continue)
                 //
-                s[pos] = 'A';
+                c = 'A';
             }
             // else -- no changes to that character (+ or :)
         }
-        if(s <= f_string)
+
+        // nothing good happened, restore the 'z' (all the 'A' were 'z'
+        // since an 'A' stops the loop)
+        //
+        for(auto & c : f_string)
         {
-            // nothing good happened
-            //
-            return false;
+            if(c == 'A')
+            {
+                c = 'z';
+            }
         }
-        f_string = s;
-        return true;
+        return false;
     }
 }
 
@@ -281,35 +290,42 @@ bool part::previous()
     }
     else
     {
-        std::string s(f_string);
-        std::size_t pos(s.length());
+        // the string is updated in place; reaching the start without
+        // decrementing a letter means that all the letters were 'A'
+        //
+        std::size_t pos(f_string.length());
         while(pos > 0)
         {
             --pos;
-            if((s[pos] > 'A' && s[pos] <= 'Z')
-            || (s[pos] > 'a' && s[pos] <= 'z'))
+            char & c(f_string[pos]);
+            if((c > 'A' && c <= 'Z')
+            || (c > 'a' && c <= 'z'))
             {
-                --s[pos];
-                break;
+                --c;
+                return true;
             }
-            if(s[pos] == 'a')
+            if(c == 'a')
             {
-                s[pos] = 'Z';
-                break;
+                c = 'Z';
+                return true;
             }
-            if(s[pos] == 'A')
+            if(c == 'A')
             {
-                s[pos] = 'z';
+                c = 'z';
             }
         }
-        if(s >= f_string)
+
+        // nothing good happened, restore the 'A' (all the 'z' were 'A'
+        // since a 'z' stops the loop)
+        //
+        for(auto & c : f_string)
         {
-            // nothing good happened
-            //
-            return false;
+            if(c == 'z')
+            {
+                c = 'A';
+            }
         }
-        f_string = s;
-        return true;
+        return false;
     }
 }
 
@@ -338,7 +354,7 @@ bool part::is_integer() const
 }
 
 
-std::string part::get_string() const
+std::string const & part::get_string() const
 {
     if(f_is_integer)
     {
@@ -361,25 +377,78 @@ part_integer_t part::get_integer() const
 
 
 std::string part::to_string() const
+{
+    std::string result;
+    append_to_string(result);
+    return result;
+}
+
+
+/** \brief Append this part to a string.
+ *
+ * Integers are converted with std::to_chars() so the only possible
+ * allocation is \p result growing.
+ *
+ * \param[in,out] result  The string where the part gets appended.
+ */
+void part::append_to_string(std::string & result) const
+{
+    version_output out(result);
+    write_to(out);
+}
+
+
+/** \brief Write this part to an output.
+ *
+ * \param[in,out] out  The output where the part gets written.
+ */
+void part::write_to(version_output & out) const
 {
     if(f_is_integer)
     {
-        return std::to_string(f_integer);
+        out.append_integer(f_integer);
     }
     else
     {
-        return f_string;
+        out.append(f_string);
     }
 }
 
 
-std::string part::get_last_error(bool clear) const
+/** \brief Retrieve the last error.
+ *
+ * The part only records static messages (i.e. the set_value() overflow
+ * error). Keeping a pointer instead of a string means that a part does
+ * not carry an extra std::string and that error reporting never allocates
+ * memory until this function gets called.
+ *
+ * This function does not clear the error so it can be used on a part
+ * shared between several threads. To also clear the error, use
+ * take_last_error().
+ *
+ * \return A copy of the last error or an empty string.
+ */
+std::string part::get_last_error() const
 {
-    std::string last_error(f_last_error);
-    if(clear)
+    if(f_last_error == nullptr)
     {
-        f_last_error.clear();
+        return std::string();
     }
+    return f_last_error;
+}
+
+
+/** \brief Retrieve and clear the last error.
+ *
+ * This function returns the same message as get_last_error() and
+ * resets the error.
+ *
+ * \return A copy of the last error or an empty string.
+ */
+std::string part::take_last_error()
+{
+    std::string const last_error(get_last_error());
+    f_last_error = nullptr;
     return last_error;
 }
 
@@ -421,19 +490,19 @@ int part::compare(part const & rhs) const
         return 0;
     }
 
-    // otherwise fallback to comparing as strings
+    // otherwise fallback to comparing as strings, without creating
+    // temporary strings
     //
-    std::string ls(to_string());
-    std::string rs(rhs.to_string());
-    if(ls < rs)
+    if(f_is_integer)
     {
-        return -1;
+        return detail::compare_integer_string(f_integer, rhs.f_string);
     }
-    if(ls > rs)
+    if(rhs.f_is_integer)
     {
-        return 1;
+        return -detail::compare_integer_string(rhs.f_integer, f_string);
     }
-    return 0;
+    int const r(f_string.compare(rhs.f_string));
+    return r == 0 ? 0 : (r < 0 ? -1 : 1);
 }
 
 
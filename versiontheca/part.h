@@ -19,8 +19,10 @@
 
 // C++
 //
+#include    <array>
 #include    <cstdint>
 #include    <string>
+#include    <string_view>
 #include    <vector>
 
 
@@ -30,6 +32,9 @@ namespace versiontheca
 
 
 
+class version_output;
+
+
 constexpr std::size_t const     MAX_PARTS = 25;
 constexpr char32_t const        NO_SEPARATOR = U'\0';
 
@@ -41,13 +46,15 @@ class part
 {
 public:
     typedef std::vector<part>       vector_t;
+    typedef std::array<part, MAX_PARTS>
+                                    array_t;
 
     void                set_separator(char32_t separator);
     void                set_width(std::uint8_t width);
     void                set_type(char type);
 
-    bool                set_value(std::string const & value);
-    void                set_string(std::string const & s);
+    bool                set_value(std::string_view const & value);
+    void                set_string(std::string_view const & s);
     void                set_integer(part_integer_t const i);
     void                set_to_max_string(std::size_t len = 1);
     void                set_to_max_integer();
@@ -60,10 +67,13 @@ public:
     char                get_type() const;
 
     bool                is_integer() const;
-    std::string         get_string() const;
+    std::string const & get_string() const;
     part_integer_t      get_integer() const;
     std::string         to_string() const;
-    std::string         get_last_error(bool clear = true) const;
+    void                append_to_string(std::string & result) const;
+    void                write_to(version_output & out) const;
+    std::string         get_last_error() const;
+    std::string         take_last_error();
 
     bool                is_zero() const;
     int                 compare(part const & rhs) const;    // change to <=> once available
@@ -75,7 +85,7 @@ protected:
     bool                f_is_integer = true;
     part_integer_t      f_integer = 0;
     std::string         f_string = std::string();
-    mutable std::string f_last_error = std::string();
+    char const *        f_last_error = nullptr;
 };
 
 
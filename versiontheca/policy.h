@@ -0,0 +1,596 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Policies used by basic_version<Policy>.
+ *
+ * A policy defines how a version gets parsed and compared at compile time.
+ * The policies are also used by the dynamic traits: the character class
+ * tables and the compare functions are shared so both APIs always agree.
+ *
+ * The basic_version_parts class holds the parts of a version parsed by a
+ * policy. It keeps a copy of the input string and each part is a small
+ * descriptor referencing that string so the whole object can be copied and
+ * stored by value. The input is kept in an std::string (version_parts) or
+ * in a fixed buffer when the parsing happens at compile time (see
+ * literal.h). All the parsing functions are constexpr for that reason.
+ */
+
+// self
+//
+#include    <versiontheca/character_class.h>
+#include    <versiontheca/compare.h>
+
+
+// C++
+//
+#include    <array>
+#include    <limits>
+#include    <string>
+
+
+
+namespace versiontheca
+{
+
+
+
+struct version_part_t
+{
+    part_integer_t      f_integer = 0;
+    std::uint16_t       f_offset = 0;
+    std::uint16_t       f_length = 0;
+    char                f_separator = '\0';
+    char                f_type = '\0';
+    bool                f_is_integer = false;
+};
+
+
+template<typename Input>
+class basic_version_parts
+{
+public:
+    typedef Input       input_t;
+
+    // parts reference the input string with 16 bit offsets
+    //
+    static constexpr std::size_t const
+                        MAX_LENGTH = std::numeric_limits<std::uint16_t>::max();
+
+    constexpr bool assign(std::string_view const & v)
+    {
+        f_size = 0;
+        f_last_error = nullptr;
+        if(v.length() > MAX_LENGTH
+        || v.length() > f_input.max_size())
+        {
+            f_input.clear();
+            f_last_error = "version string is too long.";
+            return false;
+        }
+        f_input.assign(v.data(), v.length());
+        return true;
+    }
+
+    constexpr Input const &       get_input() const { return f_input; }
+    constexpr std::size_t         size() const { return f_size; }
+    constexpr bool                empty() const { return f_size == 0; }
+    constexpr version_part_t const &
+                                  at(std::size_t idx) const { return f_parts[idx]; }
+    constexpr char                get_type(std::size_t idx) const { return f_parts[idx].f_type; }
+    constexpr char                get_separator(std::size_t idx) const { return f_parts[idx].f_separator; }
+    constexpr bool                is_integer(std::size_t idx) const { return f_parts[idx].f_is_integer; }
+    constexpr part_integer_t      get_integer(std::size_t idx) const { return f_parts[idx].f_integer; }
+    constexpr std::string_view    get_string(std::size_t idx) const
+                                  {
+                                      return std::string_view(
+                                                f_input.data() + f_parts[idx].f_offset
+                                              , f_parts[idx].f_length);
+                                  }
+    constexpr char const *        get_last_error() const { return f_last_error; }
+
+    constexpr bool error(char const * msg)
+    {
+        f_last_error = msg;
+        return false;
+    }
+
+    constexpr bool all_integers() const
+    {
+        for(std::size_t idx(0); idx < f_size; ++idx)
+        {
+            if(!f_parts[idx].f_is_integer)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr void set_type(std::size_t start, char type)
+    {
+        for(std::size_t idx(start); idx < f_size; ++idx)
+        {
+            f_parts[idx].f_type = type;
+        }
+    }
+
+    /** \brief Parse an epoch.
+     *
+     * The epoch is the integer found between the start of the input and
+     * \p end. It gets saved with type ':'.
+     *
+     * \param[in] end  The position of the ':' character.
+     *
+     * \return true if the epoch is a valid integer.
+     */
+    constexpr bool parse_epoch(std::size_t end)
+    {
+        for(std::size_t idx(0); idx < end; ++idx)
+        {
+            if(f_input[idx] < '0' || f_input[idx] > '9')
+            {
+                return error("epoch must be a valid integer.");
+            }
+        }
+        if(!push_number(0, end, '\0'))
+        {
+            return false;
+        }
+        f_parts[f_size - 1].f_type = ':';
+        return true;
+    }
+
+    /** \brief Parse a set of values separated by separators.
+     *
+     * The input between \p start and \p end is cut at each separator as
+     * defined in \p classes and each value is parsed by parse_value().
+     *
+     * \param[in] start  The start of the input to parse.
+     * \param[in] end  The end of the input to parse.
+     * \param[in] sep  The separator found before \p start.
+     * \param[in] classes  The character classes of the policy.
+     *
+     * \return true if all the values are valid.
+     */
+    constexpr bool parse_version(std::size_t start, std::size_t end, char sep, character_classes_t const & classes)
+    {
+        std::size_t value_start(start);
+        for(std::size_t idx(start); idx < end; ++idx)
+        {
+            std::uint8_t const c(f_input[idx]);
+            if(c < 0x80
+            && (classes.f_class[c] & CHARACTER_CLASS_SEPARATOR) != 0)
+            {
+                if(!parse_value(value_start, idx, sep, classes))
+                {
+                    return false;
+                }
+                sep = static_cast<char>(c);
+                value_start = idx + 1;
+            }
+        }
+        return parse_value(value_start, end, sep, classes);
+    }
+
+    /** \brief Parse one value.
+     *
+     * A value is a list of numbers and strings. The strings must only
+     * include characters marked valid in \p classes.
+     *
+     * \param[in] start  The start of the value.
+     * \param[in] end  The end of the value.
+     * \param[in] sep  The separator found before \p start.
+     * \param[in] classes  The character classes of the policy.
+     *
+     * \return true if the value is valid.
+     */
+    constexpr bool parse_value(std::size_t start, std::size_t end, char sep, character_classes_t const & classes)
+    {
+        if(start >= end)
+        {
+            return error("a version value cannot be an empty string.");
+        }
+        std::size_t pos(start);
+        while(pos < end)
+        {
+            if(!parse_part(pos, end, sep, classes))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** \brief Parse the next part of a value.
+     *
+     * This function parses the number or the string starting at \p pos
+     * and moves \p pos after it. parse_value() calls it until the end of
+     * the value is reached. It can also be used to parse a version one
+     * part at a time (see compare_strings()).
+     *
+     * The \p sep parameter is set to '\0' once the part was added since
+     * only the first part of a value is preceded by a separator.
+     *
+     * \param[in,out] pos  The start of the part, which must be before \p end.
+     * \param[in] end  The end of the value.
+     * \param[in,out] sep  The separator found before this part.
+     * \param[in] classes  The character classes of the policy.
+     *
+     * \return true if the part is valid.
+     */
+    constexpr bool parse_part(std::size_t & pos, std::size_t end, char & sep, character_classes_t const & classes)
+    {
+        std::size_t const start(pos);
+        if(f_input[pos] >= '0' && f_input[pos] <= '9')
+        {
+            do
+            {
+                ++pos;
+            }
+            while(pos < end && f_input[pos] >= '0' && f_input[pos] <= '9');
+            if(!push_number(start, pos, sep))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            do
+            {
+                std::uint8_t const c(f_input[pos]);
+                if(c >= 0x80
+                || (classes.f_class[c] & CHARACTER_CLASS_VALID) == 0)
+                {
+                    return error("found unexpected character in input.");
+                }
+                ++pos;
+            }
+            while(pos < end && (f_input[pos] < '0' || f_input[pos] > '9'));
+            if(!push(start, pos, sep, false, 0))
+            {
+                return false;
+            }
+        }
+        sep = '\0';
+        return true;
+    }
+
+private:
+    constexpr bool push_number(std::size_t start, std::size_t end, char sep)
+    {
+        part_integer_t value(0);
+        for(std::size_t idx(start); idx < end; ++idx)
+        {
+            part_integer_t const digit(f_input[idx] - '0');
+            if(value > (std::numeric_limits<part_integer_t>::max() - digit) / 10)
+            {
+                return error("integer too large for a valid version.");
+            }
+            value = value * 10 + digit;
+        }
+        return push(start, end, sep, true, value);
+    }
+
+    constexpr bool push(std::size_t start, std::size_t end, char sep, bool is_integer, part_integer_t value)
+    {
+        if(f_size >= MAX_PARTS)
+        {
+            return error("trying to append more parts when maximum was already reached.");
+        }
+        version_part_t & p(f_parts[f_size]);
+        p.f_integer = value;
+        p.f_offset = static_cast<std::uint16_t>(start);
+        p.f_length = static_cast<std::uint16_t>(end - start);
+        p.f_separator = sep;
+        p.f_type = '\0';
+        p.f_is_integer = is_integer;
+        ++f_size;
+        return true;
+    }
+
+    Input               f_input = Input();
+    std::array<version_part_t, MAX_PARTS>
+                        f_parts = std::array<version_part_t, MAX_PARTS>();
+    std::size_t         f_size = 0;
+    char const *        f_last_error = nullptr;
+};
+
+
+/** \brief Input referencing a string owned by the caller.
+ *
+ * This input is used to parse a version without copying it. The string
+ * must remain valid as long as the parts are used.
+ */
+class string_view_input
+{
+public:
+    constexpr std::size_t       max_size() const { return std::numeric_limits<std::size_t>::max(); }
+    constexpr std::size_t       length() const { return f_view.length(); }
+    constexpr bool              empty() const { return f_view.empty(); }
+    constexpr char const *      data() const { return f_view.data(); }
+    constexpr char              operator [] (std::size_t idx) const { return f_view[idx]; }
+
+    constexpr void clear()
+    {
+        f_view = std::string_view();
+    }
+
+    constexpr void assign(char const * s, std::size_t length)
+    {
+        f_view = std::string_view(s, length);
+    }
+
+private:
+    std::string_view            f_view = std::string_view();
+};
+
+
+typedef basic_version_parts<std::string>        version_parts;
+typedef basic_version_parts<string_view_input>  version_parts_view;
+
+
+
+namespace detail
+{
+
+
+constexpr bool is_digit(char32_t c)
+{
+    return c >= U'0' && c <= U'9';
+}
+
+
+constexpr bool is_period(char32_t c)
+{
+    return c == U'.';
+}
+
+
+constexpr bool is_basic_character(char32_t c)
+{
+    // same as trait::is_valid_character() for ASCII
+    //
+    return c >= U' ' && c != U'\x7F' && c != U'.';
+}
+
+
+constexpr bool is_debian_revision_character(char32_t c)
+{
+    return (c >= U'0' && c <= U'9')
+        || (c >= U'A' && c <= U'Z')
+        || (c >= U'a' && c <= U'z')
+        || c == U'+'
+        || c == U'.'
+        || c == U'~';
+}
+
+
+constexpr bool is_debian_upstream_character(char32_t c)
+{
+    return is_debian_revision_character(c)
+        || c == U'-'
+        || c == U':';
+}
+
+
+constexpr bool is_rpm_character(char32_t c)
+{
+    return (c >= U'0' && c <= U'9')
+        || (c >= U'A' && c <= U'Z')
+        || (c >= U'a' && c <= U'z')
+        || c == U'~'
+        || c == U'^'
+        || c == U'_';
+}
+
+
+constexpr bool is_rpm_separator(char32_t c)
+{
+    return c == U'+'
+        || c == U'.';
+}
+
+
+/** \brief Find the epoch and revision delimiters.
+ *
+ * Debian and RPM versions are written `[epoch:]upstream[-revision]`. The
+ * epoch ends at the first colon and the revision starts after the last
+ * dash.
+ *
+ * \param[in,out] parts  The parts where the epoch gets saved.
+ * \param[out] colon  The start of the upstream version.
+ * \param[out] dash  The end of the upstream version.
+ *
+ * \return true if the positions are valid and the epoch was parsed.
+ */
+template<typename Parts>
+constexpr bool parse_epoch_and_revision(Parts & parts, std::size_t & colon, std::size_t & dash)
+{
+    std::string_view const v(parts.get_input().data(), parts.get_input().length());
+    colon = v.find(':');
+    dash = v.rfind('-');
+    if((colon != std::string_view::npos && dash != std::string_view::npos && colon >= dash)
+    || colon == 0
+    || dash == 0)
+    {
+        return parts.error("position of ':' and/or '-' is invalid.");
+    }
+    if(colon != std::string_view::npos)
+    {
+        if(!parts.parse_epoch(colon))
+        {
+            return false;
+        }
+    }
+    ++colon;    // npos + 1 == 0
+    if(dash == std::string_view::npos)
+    {
+        dash = v.length();
+    }
+    return true;
+}
+
+
+}
+// namespace detail
+
+
+
+struct basic_policy
+{
+    static constexpr character_classes_t const
+                        classes = make_character_classes(detail::is_basic_character, detail::is_period);
+
+    template<typename Parts>
+    static constexpr bool parse(Parts & parts)
+    {
+        if(parts.get_input().empty())
+        {
+            return parts.error("an empty input string cannot represent a valid version.");
+        }
+        if(!parts.parse_version(0, parts.get_input().length(), '\0', classes))
+        {
+            return false;
+        }
+        if(!parts.all_integers())
+        {
+            return parts.error("basic versions only support integers separated by periods (.).");
+        }
+        return true;
+    }
+
+    template<typename L, typename R>
+    static constexpr int compare(L const & lhs, R const & rhs)
+    {
+        return detail::basic_compare_parts(lhs, rhs);
+    }
+
+    template<typename L, typename R>
+    static constexpr int static_compare(L const & lhs, R const & rhs)
+    {
+        return detail::basic_compare_parts(lhs, rhs);
+    }
+};
+
+
+struct debian_policy
+{
+    static constexpr character_classes_t const
+                        epoch_classes = make_character_classes(detail::is_digit, detail::is_period);
+    static constexpr character_classes_t const
+                        upstream_classes = make_character_classes(detail::is_debian_upstream_character, detail::is_period);
+    static constexpr character_classes_t const
+                        revision_classes = make_character_classes(detail::is_debian_revision_character, detail::is_period);
+
+    template<typename Parts>
+    static constexpr bool parse(Parts & parts)
+    {
+        std::size_t colon(0);
+        std::size_t dash(0);
+        if(!detail::parse_epoch_and_revision(parts, colon, dash))
+        {
+            return false;
+        }
+
+        if(!parts.parse_version(colon, dash, colon == 0 ? '\0' : ':', upstream_classes))
+        {
+            return false;
+        }
+        if(!parts.is_integer(colon == 0 ? 0 : 1))
+        {
+            return parts.error("a Debian version must always start with a number.");
+        }
+
+        if(dash < parts.get_input().length())
+        {
+            std::size_t const idx(parts.size());
+            if(!parts.parse_value(dash + 1, parts.get_input().length(), '-', revision_classes))
+            {
+                return false;
+            }
+            parts.set_type(idx, '-');
+        }
+        return true;
+    }
+
+    template<typename L, typename R>
+    static int compare(L const & lhs, R const & rhs)
+    {
+        return detail::debian_compare_parts(lhs, rhs, detail::debian_string_scan_t());
+    }
+
+    template<typename L, typename R>
+    static constexpr int static_compare(L const & lhs, R const & rhs)
+    {
+        return detail::debian_compare_parts(lhs, rhs);
+    }
+};
+
+
+struct rpm_policy
+{
+    static constexpr character_classes_t const
+                        classes = make_character_classes(detail::is_rpm_character, detail::is_rpm_separator);
+
+    template<typename Parts>
+    static constexpr bool parse(Parts & parts)
+    {
+        std::size_t colon(0);
+        std::size_t dash(0);
+        if(!detail::parse_epoch_and_revision(parts, colon, dash))
+        {
+            return false;
+        }
+
+        if(!parts.parse_version(colon, dash, colon == 0 ? '\0' : ':', classes))
+        {
+            return false;
+        }
+
+        if(dash < parts.get_input().length())
+        {
+            std::size_t const idx(parts.size());
+            if(!parts.parse_version(dash + 1, parts.get_input().length(), '-', classes))
+            {
+                return false;
+            }
+            parts.set_type(idx, '-');
+        }
+        return true;
+    }
+
+    template<typename L, typename R>
+    static int compare(L const & lhs, R const & rhs)
+    {
+        return detail::rpm_compare_parts(lhs, rhs, detail::rpm_string_scan_t());
+    }
+
+    template<typename L, typename R>
+    static constexpr int static_compare(L const & lhs, R const & rhs)
+    {
+        return detail::rpm_compare_parts(lhs, rhs);
+    }
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,123 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Probes updating the instrumentation counters.
+ *
+ * This header is private to the library. The macros defined here expand
+ * to nothing unless the library is compiled with VERSIONTHECA_INSTRUMENTATION
+ * defined, in which case they update the counters returned by
+ * get_statistics().
+ *
+ * The parse() and compare() functions of a trait often call the
+ * implementation of their base class. The probes count the outer call
+ * only, so a version parsed by the basic trait (which calls
+ * trait::parse()) is counted once.
+ */
+
+// self
+//
+#include    <versiontheca/instrumentation.h>
+
+
+#ifdef VERSIONTHECA_INSTRUMENTATION
+
+// C++
+//
+#include    <chrono>
+
+
+
+namespace versiontheca
+{
+namespace detail
+{
+
+
+
+enum class counter_t
+{
+    COUNTER_ALLOCATION,
+    COUNTER_NEXT,
+    COUNTER_PREVIOUS,
+};
+
+
+std::size_t             get_statistics_slot(trait const & t);
+void                    count(trait const & t, counter_t counter);
+void                    count_error(trait const & t, error_code_t code);
+
+
+class parse_probe
+{
+public:
+                        parse_probe(trait const & t, std::string_view const & input);
+                        parse_probe(parse_probe const &) = delete;
+                        ~parse_probe();
+    parse_probe &       operator = (parse_probe const &) = delete;
+
+private:
+    trait const &       f_trait;
+    std::string_view    f_input = std::string_view();
+    bool                f_outer = false;
+    std::chrono::steady_clock::time_point
+                        f_start = std::chrono::steady_clock::time_point();
+};
+
+
+class compare_probe
+{
+public:
+                        compare_probe(trait const & t);
+                        compare_probe(compare_probe const &) = delete;
+                        ~compare_probe();
+    compare_probe &     operator = (compare_probe const &) = delete;
+
+private:
+    trait const &       f_trait;
+    bool                f_outer = false;
+    std::chrono::steady_clock::time_point
+                        f_start = std::chrono::steady_clock::time_point();
+};
+
+
+
+} // namespace detail
+}
+// namespace versiontheca
+
+
+#define VERSIONTHECA_PROBE_PARSE(t, input) \
+            ::versiontheca::detail::parse_probe const versiontheca_parse_probe(t, input)
+#define VERSIONTHECA_PROBE_COMPARE(t) \
+            ::versiontheca::detail::compare_probe const versiontheca_compare_probe(t)
+#define VERSIONTHECA_PROBE_COUNT(t, counter) \
+            ::versiontheca::detail::count(t, ::versiontheca::detail::counter_t::counter)
+#define VERSIONTHECA_PROBE_ERROR(t, code) \
+            ::versiontheca::detail::count_error(t, code)
+
+#else
+
+#define VERSIONTHECA_PROBE_PARSE(t, input)      ((void)0)
+#define VERSIONTHECA_PROBE_COMPARE(t)           ((void)0)
+#define VERSIONTHECA_PROBE_COUNT(t, counter)    ((void)0)
+#define VERSIONTHECA_PROBE_ERROR(t, code)       ((void)0)
+
+#endif
+// vim: ts=4 sw=4 et
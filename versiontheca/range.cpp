@@ -0,0 +1,950 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the version constraints and ranges.
+ *
+ * The bounds are saved as sort keys. The keys of two versions compare
+ * with memcmp() the same way as trait::compare() compares the versions,
+ * so a range is a list of intervals of keys sorted in increasing order.
+ * The intervals never overlap and never touch each other (they would be
+ * merged in that case), so a binary search finds the only interval which
+ * can include a candidate.
+ *
+ * For the kinds where the keys and trait::compare() disagree on some
+ * pairs, each bound also keeps its parsed version so matches() and
+ * contains() can use compare() on the candidate instead.
+ */
+
+// self
+//
+#include    <versiontheca/range.h>
+
+#include    <versiontheca/exception.h>
+
+
+// snapdev
+//
+#include    <snapdev/not_reached.h>
+
+
+// C++
+//
+#include    <algorithm>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+std::string_view trim(std::string_view s)
+{
+    std::string_view::size_type const start(s.find_first_not_of(" \t\r\n"));
+    if(start == std::string_view::npos)
+    {
+        return std::string_view();
+    }
+    std::string_view::size_type const end(s.find_last_not_of(" \t\r\n"));
+    return s.substr(start, end - start + 1);
+}
+
+
+std::vector<std::string_view> split(std::string_view s, char separator)
+{
+    std::vector<std::string_view> result;
+    for(;;)
+    {
+        std::string_view::size_type const pos(s.find(separator));
+        result.push_back(s.substr(0, pos));
+        if(pos == std::string_view::npos)
+        {
+            return result;
+        }
+        s = s.substr(pos + 1);
+    }
+}
+
+
+/** \brief Compute the sort key of a version.
+ *
+ * \param[in] t  The trait used to parse the version.
+ * \param[in] version  The version to parse.
+ * \param[out] key  The resulting sort key.
+ *
+ * \return true if the version is valid and \p key was set.
+ */
+bool compute_key(trait::pointer_t const & t, std::string_view const & version, std::string & key)
+{
+    if(!t->parse(version))
+    {
+        return false;
+    }
+    key = t->sort_key();
+    return true;
+}
+
+
+/** \brief Compare two lower bounds.
+ *
+ * An infinite lower bound is the smallest. With equal keys, the
+ * inclusive bound starts first.
+ */
+int compare_lower(version_range::bound_t const & a, version_range::bound_t const & b)
+{
+    if(a.f_infinite || b.f_infinite)
+    {
+        return a.f_infinite == b.f_infinite ? 0 : (a.f_infinite ? -1 : 1);
+    }
+    int const r(a.f_key.compare(b.f_key));
+    if(r != 0)
+    {
+        return r < 0 ? -1 : 1;
+    }
+    return a.f_inclusive == b.f_inclusive ? 0 : (a.f_inclusive ? -1 : 1);
+}
+
+
+/** \brief Compare two upper bounds.
+ *
+ * An infinite upper bound is the largest. With equal keys, the
+ * exclusive bound ends first.
+ */
+int compare_upper(version_range::bound_t const & a, version_range::bound_t const & b)
+{
+    if(a.f_infinite || b.f_infinite)
+    {
+        return a.f_infinite == b.f_infinite ? 0 : (a.f_infinite ? 1 : -1);
+    }
+    int const r(a.f_key.compare(b.f_key));
+    if(r != 0)
+    {
+        return r < 0 ? -1 : 1;
+    }
+    return a.f_inclusive == b.f_inclusive ? 0 : (a.f_inclusive ? 1 : -1);
+}
+
+
+bool is_below_upper(std::string const & key, version_range::bound_t const & upper)
+{
+    if(upper.f_infinite)
+    {
+        return true;
+    }
+    int const r(key.compare(upper.f_key));
+    return r < 0 || (r == 0 && upper.f_inclusive);
+}
+
+
+bool is_above_lower(std::string const & key, version_range::bound_t const & lower)
+{
+    if(lower.f_infinite)
+    {
+        return true;
+    }
+    int const r(key.compare(lower.f_key));
+    return r > 0 || (r == 0 && lower.f_inclusive);
+}
+
+
+bool is_below_upper(trait::pointer_t const & t, version_range::bound_t const & upper)
+{
+    if(upper.f_infinite)
+    {
+        return true;
+    }
+    int const r(t->compare(upper.f_trait));
+    return r < 0 || (r == 0 && upper.f_inclusive);
+}
+
+
+bool is_above_lower(trait::pointer_t const & t, version_range::bound_t const & lower)
+{
+    if(lower.f_infinite)
+    {
+        return true;
+    }
+    int const r(t->compare(lower.f_trait));
+    return r > 0 || (r == 0 && lower.f_inclusive);
+}
+
+
+bool is_valid_interval(version_range::bound_t const & lower, version_range::bound_t const & upper)
+{
+    if(lower.f_infinite || upper.f_infinite)
+    {
+        return true;
+    }
+    int const r(lower.f_key.compare(upper.f_key));
+    return r < 0 || (r == 0 && lower.f_inclusive && upper.f_inclusive);
+}
+
+
+/** \brief Check whether two intervals can be merged.
+ *
+ * The \p a interval is expected to start before or at the same place
+ * as the interval \p b starts. The intervals can be merged if they
+ * overlap or touch each other (i.e. `[1, 2)` and `[2, 3]`).
+ */
+bool is_touching(version_range::interval_t const & a, version_range::interval_t const & b)
+{
+    if(a.f_upper.f_infinite || b.f_lower.f_infinite)
+    {
+        return true;
+    }
+    int const r(b.f_lower.f_key.compare(a.f_upper.f_key));
+    return r < 0 || (r == 0 && (a.f_upper.f_inclusive || b.f_lower.f_inclusive));
+}
+
+
+version_range::bound_t make_bound(
+      std::string const & key
+    , trait::pointer_t const & t
+    , bool inclusive)
+{
+    version_range::bound_t result;
+    result.f_key = key;
+    result.f_trait = t;
+    result.f_inclusive = inclusive;
+    result.f_infinite = false;
+    return result;
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Convert an operator string to an operator_t.
+ *
+ * The function recognizes the C-like operators (`==`, `!=`, `<`, `<=`,
+ * `>`, `>=`), the shell-like operators (`eq`, `ne`, `lt`, `le`, `gt`,
+ * `ge`), the Debian strict operators (`<<`, `>>`) and two extensions:
+ * `=` and `<>`.
+ *
+ * \note
+ * In old Debian control files `<` and `>` meant `<=` and `>=`. This
+ * function views them as strict operators like in C.
+ *
+ * \param[in] op  The operator to convert.
+ *
+ * \return The corresponding operator or OPERATOR_UNKNOWN.
+ */
+operator_t get_operator(std::string_view const & op)
+{
+    if(op == "=="
+    || op == "="        // extension, there is assignment so just one '=' is fine
+    || op == "eq")
+    {
+        return operator_t::OPERATOR_EQUAL;
+    }
+
+    if(op == "!="
+    || op == "<>"       // extension, like SQL
+    || op == "ne")
+    {
+        return operator_t::OPERATOR_NOT_EQUAL;
+    }
+
+    if(op == "<"
+    || op == "<<"       // Debian
+    || op == "lt")
+    {
+        return operator_t::OPERATOR_LESS;
+    }
+
+    if(op == "<="
+    || op == "le")
+    {
+        return operator_t::OPERATOR_LESS_OR_EQUAL;
+    }
+
+    if(op == ">"
+    || op == ">>"       // Debian
+    || op == "gt")
+    {
+        return operator_t::OPERATOR_GREATER;
+    }
+
+    if(op == ">="
+    || op == "ge")
+    {
+        return operator_t::OPERATOR_GREATER_OR_EQUAL;
+    }
+
+    return operator_t::OPERATOR_UNKNOWN;
+}
+
+
+/** \brief Convert an operator to a string.
+ *
+ * \param[in] op  The operator to convert.
+ *
+ * \return The C-like representation of the operator.
+ */
+char const * operator_to_string(operator_t op)
+{
+    switch(op)
+    {
+    case operator_t::OPERATOR_UNKNOWN:
+        return "?";
+
+    case operator_t::OPERATOR_EQUAL:
+        return "==";
+
+    case operator_t::OPERATOR_NOT_EQUAL:
+        return "!=";
+
+    case operator_t::OPERATOR_LESS:
+        return "<";
+
+    case operator_t::OPERATOR_LESS_OR_EQUAL:
+        return "<=";
+
+    case operator_t::OPERATOR_GREATER:
+        return ">";
+
+    case operator_t::OPERATOR_GREATER_OR_EQUAL:
+        return ">=";
+
+    }
+    snapdev::NOT_REACHED();
+}
+
+
+/** \brief Apply an operator to the result of a compare.
+ *
+ * \exception logic_error
+ * The function raises this exception if \p op is OPERATOR_UNKNOWN.
+ *
+ * \param[in] op  The operator to apply.
+ * \param[in] r  The result of a compare() function (-1, 0, or 1).
+ *
+ * \return true if the operator is satisfied.
+ */
+bool apply_operator(operator_t op, int r)
+{
+    switch(op)
+    {
+    case operator_t::OPERATOR_UNKNOWN:
+        throw logic_error("apply_operator() called with an unknown operator.");
+
+    case operator_t::OPERATOR_EQUAL:
+        return r == 0;
+
+    case operator_t::OPERATOR_NOT_EQUAL:
+        return r != 0;
+
+    case operator_t::OPERATOR_LESS:
+        return r < 0;
+
+    case operator_t::OPERATOR_LESS_OR_EQUAL:
+        return r <= 0;
+
+    case operator_t::OPERATOR_GREATER:
+        return r > 0;
+
+    case operator_t::OPERATOR_GREATER_OR_EQUAL:
+        return r >= 0;
+
+    }
+    snapdev::NOT_REACHED();
+}
+
+
+
+/** \brief Create a constraint from an operator and a version.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p op is OPERATOR_UNKNOWN.
+ *
+ * \exception invalid_version
+ * The function raises this exception if \p version is not valid.
+ *
+ * \param[in] kind  The kind of versions this constraint applies to.
+ * \param[in] op  The constraint operator.
+ * \param[in] version  The version on the right hand side of the operator.
+ */
+version_constraint::version_constraint(
+          trait_kind_t kind
+        , operator_t op
+        , std::string_view const & version)
+    : f_kind(kind)
+    , f_operator(op)
+{
+    if(f_operator == operator_t::OPERATOR_UNKNOWN)
+    {
+        throw invalid_parameter("a version constraint cannot use OPERATOR_UNKNOWN.");
+    }
+    init(version);
+}
+
+
+/** \brief Parse a constraint.
+ *
+ * The constraint is an optional operator followed by a version. The
+ * whole constraint may be written between parenthesis as in a Debian
+ * control file: `(>= 1.2~rc1)`. Without an operator, the constraint
+ * means equal.
+ *
+ * The shell-like operators (`eq`, `lt`, etc.) must be followed by at
+ * least one space.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the operator is not recognized.
+ *
+ * \exception invalid_version
+ * The function raises this exception if the version is missing or is
+ * not valid.
+ *
+ * \param[in] kind  The kind of versions this constraint applies to.
+ * \param[in] constraint  The constraint to parse.
+ */
+version_constraint::version_constraint(
+          trait_kind_t kind
+        , std::string_view const & constraint)
+    : f_kind(kind)
+    , f_operator(operator_t::OPERATOR_EQUAL)
+{
+    std::string_view c(trim(constraint));
+    if(c.length() >= 2
+    && c.front() == '('
+    && c.back() == ')')
+    {
+        c = trim(c.substr(1, c.length() - 2));
+    }
+
+    std::string_view::size_type const len(c.find_first_not_of("<>=!"));
+    if(len == 0)
+    {
+        std::string_view::size_type const space(c.find_first_of(" \t"));
+        if(space != std::string_view::npos)
+        {
+            operator_t const op(::versiontheca::get_operator(c.substr(0, space)));
+            if(op != operator_t::OPERATOR_UNKNOWN)
+            {
+                f_operator = op;
+                c = trim(c.substr(space));
+            }
+        }
+    }
+    else
+    {
+        f_operator = ::versiontheca::get_operator(c.substr(0, len));
+        if(f_operator == operator_t::OPERATOR_UNKNOWN)
+        {
+            throw invalid_parameter(
+                      "unknown operator \""
+                    + std::string(c.substr(0, len))
+                    + "\" in constraint \""
+                    + std::string(constraint)
+                    + "\".");
+        }
+        c = len == std::string_view::npos ? std::string_view() : trim(c.substr(len));
+    }
+
+    if(c.empty())
+    {
+        throw invalid_version(
+                  "constraint \""
+                + std::string(constraint)
+                + "\" is missing a version.");
+    }
+    init(c);
+}
+
+
+void version_constraint::init(std::string_view const & version)
+{
+    trait::pointer_t t(create_trait(f_kind));
+    if(!compute_key(t, version, f_key))
+    {
+        throw invalid_version(
+                  "version \""
+                + std::string(version)
+                + "\" is not valid: "
+                + t->get_last_error());
+    }
+    f_version = version;
+    f_trait = t;
+}
+
+
+trait_kind_t version_constraint::get_kind() const
+{
+    return f_kind;
+}
+
+
+operator_t version_constraint::get_operator() const
+{
+    return f_operator;
+}
+
+
+std::string const & version_constraint::get_version() const
+{
+    return f_version;
+}
+
+
+std::string const & version_constraint::get_key() const
+{
+    return f_key;
+}
+
+
+std::string version_constraint::to_string() const
+{
+    return std::string(operator_to_string(f_operator)) + ' ' + f_version;
+}
+
+
+/** \brief Check whether a version satisfies this constraint.
+ *
+ * This function parses \p version to compute its sort key. To check
+ * many versions, filter() reuses the same trait for all of them.
+ *
+ * When the keys of this kind do not always agree with compare()
+ * (see sort_key_matches_compare()), the parsed version is compared
+ * with compare() instead. For example, with Unicode versions,
+ * `>= 1.1` matches "1.A".
+ *
+ * \param[in] version  The version to check.
+ *
+ * \return true if the version is valid and satisfies the constraint.
+ */
+bool version_constraint::matches(std::string_view const & version) const
+{
+    trait::pointer_t t(create_trait(f_kind));
+    if(!t->parse(version))
+    {
+        return false;
+    }
+    return matches_trait(t);
+}
+
+
+/** \brief Check whether a sort key satisfies this constraint.
+ *
+ * The key order is used even for the kinds where it disagrees with
+ * compare() on a few pairs (see sort_key_matches_compare()).
+ *
+ * \param[in] key  The sort key of the version to check.
+ *
+ * \return true if the version satisfies the constraint.
+ */
+bool version_constraint::matches_key(std::string const & key) const
+{
+    return apply_operator(f_operator, key.compare(f_key));
+}
+
+
+/** \brief Search the candidates which satisfy this constraint.
+ *
+ * Invalid candidates are ignored.
+ *
+ * \param[in] candidates  The versions to check.
+ *
+ * \return The indexes of the candidates satisfying the constraint.
+ */
+index_vector_t version_constraint::filter(std::vector<std::string_view> const & candidates) const
+{
+    index_vector_t result;
+    trait::pointer_t t(create_trait(f_kind));
+    for(std::size_t idx(0); idx < candidates.size(); ++idx)
+    {
+        if(t->parse(candidates[idx])
+        && matches_trait(t))
+        {
+            result.push_back(idx);
+        }
+    }
+    return result;
+}
+
+
+bool version_constraint::matches_trait(trait::pointer_t const & t) const
+{
+    if(sort_key_matches_compare(f_kind))
+    {
+        return matches_key(t->sort_key());
+    }
+    return apply_operator(f_operator, t->compare(f_trait));
+}
+
+
+
+/** \brief Create an empty range.
+ *
+ * An empty range does not include any version. Use all() to create
+ * a range which includes all the versions.
+ *
+ * \param[in] kind  The kind of versions in this range.
+ */
+version_range::version_range(trait_kind_t kind)
+    : f_kind(kind)
+{
+}
+
+
+/** \brief Create the range of versions satisfying a constraint.
+ *
+ * \param[in] constraint  The constraint to convert to a range.
+ */
+version_range::version_range(version_constraint const & constraint)
+    : f_kind(constraint.get_kind())
+{
+    std::string const & key(constraint.get_key());
+    trait::pointer_t const & t(constraint.f_trait);
+    interval_t i;
+    switch(constraint.get_operator())
+    {
+    case operator_t::OPERATOR_UNKNOWN:
+        throw logic_error("a version constraint cannot use OPERATOR_UNKNOWN.");
+
+    case operator_t::OPERATOR_EQUAL:
+        i.f_lower = make_bound(key, t, true);
+        i.f_upper = make_bound(key, t, true);
+        break;
+
+    case operator_t::OPERATOR_NOT_EQUAL:
+        i.f_upper = make_bound(key, t, false);
+        f_intervals.push_back(i);
+        i.f_lower = make_bound(key, t, false);
+        i.f_upper = bound_t();
+        break;
+
+    case operator_t::OPERATOR_LESS:
+        i.f_upper = make_bound(key, t, false);
+        break;
+
+    case operator_t::OPERATOR_LESS_OR_EQUAL:
+        i.f_upper = make_bound(key, t, true);
+        break;
+
+    case operator_t::OPERATOR_GREATER:
+        i.f_lower = make_bound(key, t, false);
+        break;
+
+    case operator_t::OPERATOR_GREATER_OR_EQUAL:
+        i.f_lower = make_bound(key, t, true);
+        break;
+
+    }
+    f_intervals.push_back(i);
+}
+
+
+/** \brief Parse a list of constraints.
+ *
+ * The constraints are separated by commas, meaning that all of them
+ * must be satisfied, and by `|`, meaning that any one of the groups
+ * must be satisfied. The commas have priority. For example:
+ *
+ * \code
+ *     >= 1.0, << 2.0 | >= 3.0
+ * \endcode
+ *
+ * includes the versions from 1.0 to 2.0 (excluded) and 3.0 and over.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if an operator is not recognized.
+ *
+ * \exception invalid_version
+ * The function raises this exception if a version is missing or is
+ * not valid.
+ *
+ * \param[in] kind  The kind of versions in this range.
+ * \param[in] constraints  The constraints to parse.
+ */
+version_range::version_range(trait_kind_t kind, std::string_view const & constraints)
+    : f_kind(kind)
+{
+    for(auto const & alternative : split(constraints, '|'))
+    {
+        version_range group(all(kind));
+        for(auto const & c : split(alternative, ','))
+        {
+            group = group.intersect(version_range(version_constraint(kind, c)));
+        }
+        *this = unite(group);
+    }
+}
+
+
+/** \brief Create a range including all the versions.
+ *
+ * \param[in] kind  The kind of versions in this range.
+ *
+ * \return A range with one infinite interval.
+ */
+version_range version_range::all(trait_kind_t kind)
+{
+    version_range result(kind);
+    result.f_intervals.push_back(interval_t());
+    return result;
+}
+
+
+trait_kind_t version_range::get_kind() const
+{
+    return f_kind;
+}
+
+
+bool version_range::is_empty() const
+{
+    return f_intervals.empty();
+}
+
+
+bool version_range::is_all() const
+{
+    return f_intervals.size() == 1
+        && f_intervals[0].f_lower.f_infinite
+        && f_intervals[0].f_upper.f_infinite;
+}
+
+
+version_range::interval_vector_t const & version_range::get_intervals() const
+{
+    return f_intervals;
+}
+
+
+/** \brief Compute the intersection of two ranges.
+ *
+ * The result only includes the versions included in both ranges.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the ranges are not of the
+ * same kind.
+ *
+ * \param[in] rhs  The other range.
+ *
+ * \return The intersection of this range and \p rhs.
+ */
+version_range version_range::intersect(version_range const & rhs) const
+{
+    verify_kind(rhs);
+
+    version_range result(f_kind);
+    auto a(f_intervals.begin());
+    auto b(rhs.f_intervals.begin());
+    while(a != f_intervals.end() && b != rhs.f_intervals.end())
+    {
+        interval_t i;
+        i.f_lower = compare_lower(a->f_lower, b->f_lower) >= 0 ? a->f_lower : b->f_lower;
+        i.f_upper = compare_upper(a->f_upper, b->f_upper) <= 0 ? a->f_upper : b->f_upper;
+        if(is_valid_interval(i.f_lower, i.f_upper))
+        {
+            result.f_intervals.push_back(i);
+        }
+        if(compare_upper(a->f_upper, b->f_upper) < 0)
+        {
+            ++a;
+        }
+        else
+        {
+            ++b;
+        }
+    }
+    return result;
+}
+
+
+/** \brief Compute the union of two ranges.
+ *
+ * The result includes the versions included in either range.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if the ranges are not of the
+ * same kind.
+ *
+ * \param[in] rhs  The other range.
+ *
+ * \return The union of this range and \p rhs.
+ */
+version_range version_range::unite(version_range const & rhs) const
+{
+    verify_kind(rhs);
+
+    interval_vector_t all_intervals;
+    all_intervals.reserve(f_intervals.size() + rhs.f_intervals.size());
+    std::merge(
+          f_intervals.begin(), f_intervals.end()
+        , rhs.f_intervals.begin(), rhs.f_intervals.end()
+        , std::back_inserter(all_intervals)
+        , [](interval_t const & a, interval_t const & b)
+        {
+            return compare_lower(a.f_lower, b.f_lower) < 0;
+        });
+
+    version_range result(f_kind);
+    for(auto const & i : all_intervals)
+    {
+        if(!result.f_intervals.empty()
+        && is_touching(result.f_intervals.back(), i))
+        {
+            bound_t & upper(result.f_intervals.back().f_upper);
+            if(compare_upper(upper, i.f_upper) < 0)
+            {
+                upper = i.f_upper;
+            }
+        }
+        else
+        {
+            result.f_intervals.push_back(i);
+        }
+    }
+    return result;
+}
+
+
+version_range version_range::operator & (version_range const & rhs) const
+{
+    return intersect(rhs);
+}
+
+
+version_range version_range::operator | (version_range const & rhs) const
+{
+    return unite(rhs);
+}
+
+
+/** \brief Check whether a version is included in this range.
+ *
+ * When the keys of this kind do not always agree with compare()
+ * (see sort_key_matches_compare()), the version is compared against
+ * the bounds of each interval with compare() instead.
+ *
+ * \param[in] version  The version to check.
+ *
+ * \return true if the version is valid and included in this range.
+ */
+bool version_range::contains(std::string_view const & version) const
+{
+    trait::pointer_t t(create_trait(f_kind));
+    if(!t->parse(version))
+    {
+        return false;
+    }
+    return contains_trait(t);
+}
+
+
+/** \brief Check whether a sort key is included in this range.
+ *
+ * The key order is used even for the kinds where it disagrees with
+ * compare() on a few pairs (see sort_key_matches_compare()).
+ *
+ * \param[in] key  The sort key of the version to check.
+ *
+ * \return true if the version is included in this range.
+ */
+bool version_range::contains_key(std::string const & key) const
+{
+    auto const it(std::partition_point(
+              f_intervals.begin()
+            , f_intervals.end()
+            , [&key](interval_t const & i)
+            {
+                return !is_below_upper(key, i.f_upper);
+            }));
+    return it != f_intervals.end()
+        && is_above_lower(key, it->f_lower);
+}
+
+
+/** \brief Search the candidates included in this range.
+ *
+ * Invalid candidates are ignored.
+ *
+ * \param[in] candidates  The versions to check.
+ *
+ * \return The indexes of the candidates included in this range.
+ */
+index_vector_t version_range::filter(std::vector<std::string_view> const & candidates) const
+{
+    index_vector_t result;
+    if(f_intervals.empty())
+    {
+        return result;
+    }
+    trait::pointer_t t(create_trait(f_kind));
+    for(std::size_t idx(0); idx < candidates.size(); ++idx)
+    {
+        if(t->parse(candidates[idx])
+        && contains_trait(t))
+        {
+            result.push_back(idx);
+        }
+    }
+    return result;
+}
+
+
+bool version_range::contains_trait(trait::pointer_t const & t) const
+{
+    if(sort_key_matches_compare(f_kind))
+    {
+        return contains_key(t->sort_key());
+    }
+
+    // the intervals are sorted by key, which compare() may not follow,
+    // so check each of them
+    //
+    return std::any_of(
+              f_intervals.begin()
+            , f_intervals.end()
+            , [&t](interval_t const & i)
+            {
+                return is_above_lower(t, i.f_lower)
+                    && is_below_upper(t, i.f_upper);
+            });
+}
+
+
+void version_range::verify_kind(version_range const & rhs) const
+{
+    if(f_kind != rhs.f_kind)
+    {
+        throw invalid_parameter("version ranges of different kinds cannot be combined.");
+    }
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
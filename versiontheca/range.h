@@ -0,0 +1,164 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Version constraints and ranges.
+ *
+ * A version_constraint is an operator and a version such as `>= 1.2~rc1`
+ * or `<< 2:3.0-1`. The version is parsed once and saved as a sort key
+ * (see trait::sort_key()) so testing a candidate only requires computing
+ * its own key and one memcmp().
+ *
+ * A version_range is a set of disjoint intervals of sort keys. A range
+ * can be created from constraints and combined with other ranges using
+ * intersect() and unite() without comparing any candidate.
+ *
+ * For the kinds of versions where the keys do not always agree with
+ * trait::compare() (see sort_key_matches_compare()), matches() and
+ * contains() compare the candidate against the bounds with compare()
+ * instead. The *_key() functions always use the key order and so do
+ * intersect() and unite() when they sort and merge the bounds.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+#include    <versiontheca/sort.h>
+
+
+// C++
+//
+#include    <string>
+#include    <string_view>
+#include    <vector>
+
+
+
+namespace versiontheca
+{
+
+
+
+enum class operator_t
+{
+    OPERATOR_UNKNOWN,
+
+    OPERATOR_EQUAL,
+    OPERATOR_NOT_EQUAL,
+    OPERATOR_LESS,
+    OPERATOR_LESS_OR_EQUAL,
+    OPERATOR_GREATER,
+    OPERATOR_GREATER_OR_EQUAL,
+};
+
+
+operator_t              get_operator(std::string_view const & op);
+char const *            operator_to_string(operator_t op);
+bool                    apply_operator(operator_t op, int r);
+
+
+class version_constraint
+{
+public:
+                        version_constraint(
+                                  trait_kind_t kind
+                                , operator_t op
+                                , std::string_view const & version);
+                        version_constraint(
+                                  trait_kind_t kind
+                                , std::string_view const & constraint);
+
+    trait_kind_t        get_kind() const;
+    operator_t          get_operator() const;
+    std::string const & get_version() const;
+    std::string const & get_key() const;
+    std::string         to_string() const;
+
+    bool                matches(std::string_view const & version) const;
+    bool                matches_key(std::string const & key) const;
+    index_vector_t      filter(std::vector<std::string_view> const & candidates) const;
+
+private:
+    friend class version_range;
+
+    void                init(std::string_view const & version);
+    bool                matches_trait(trait::pointer_t const & t) const;
+
+    trait_kind_t        f_kind = trait_kind_t::TRAIT_KIND_UNICODE;
+    operator_t          f_operator = operator_t::OPERATOR_UNKNOWN;
+    std::string         f_version = std::string();
+    std::string         f_key = std::string();
+    trait::pointer_t    f_trait = trait::pointer_t();
+};
+
+
+class version_range
+{
+public:
+    struct bound_t
+    {
+        std::string         f_key = std::string();
+        trait::pointer_t    f_trait = trait::pointer_t();   // for compare() when the key is not enough
+        bool                f_inclusive = false;
+        bool                f_infinite = true;
+    };
+
+    struct interval_t
+    {
+        bound_t             f_lower = bound_t();
+        bound_t             f_upper = bound_t();
+    };
+
+    typedef std::vector<interval_t>     interval_vector_t;
+
+                        version_range(trait_kind_t kind);
+                        version_range(version_constraint const & constraint);
+                        version_range(trait_kind_t kind, std::string_view const & constraints);
+
+    static version_range
+                        all(trait_kind_t kind);
+
+    trait_kind_t        get_kind() const;
+    bool                is_empty() const;
+    bool                is_all() const;
+    interval_vector_t const &
+                        get_intervals() const;
+
+    version_range       intersect(version_range const & rhs) const;
+    version_range       unite(version_range const & rhs) const;
+    version_range       operator & (version_range const & rhs) const;
+    version_range       operator | (version_range const & rhs) const;
+
+    bool                contains(std::string_view const & version) const;
+    bool                contains_key(std::string const & key) const;
+    index_vector_t      filter(std::vector<std::string_view> const & candidates) const;
+
+private:
+    void                verify_kind(version_range const & rhs) const;
+    bool                contains_trait(trait::pointer_t const & t) const;
+
+    trait_kind_t        f_kind = trait_kind_t::TRAIT_KIND_UNICODE;
+    interval_vector_t   f_intervals = interval_vector_t();
+};
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
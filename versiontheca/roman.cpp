@@ -27,6 +27,7 @@
 #include    <versiontheca/roman.h>
 
 #include    <versiontheca/exception.h>
+#include    <versiontheca/probe.h>
 
 
 // libutf8
@@ -36,6 +37,7 @@
 
 // C++
 //
+#include    <array>
 #include    <iostream>
 #include    <type_traits>
 
@@ -55,14 +57,35 @@ namespace
 {
 
 
-constexpr char const * const g_thousands[4] = {
+
+// the value of each character as a Roman digit, 0 for any other character
+// (lowercase letters are accepted)
+//
+constexpr std::array<std::uint16_t, 256> make_roman_digits()
+{
+    std::array<std::uint16_t, 256> digits = {};
+    char const letters[] = "IVXLCDM";
+    std::uint16_t const values[] = { 1, 5, 10, 50, 100, 500, 1'000 };
+    for(std::size_t idx(0); idx < sizeof(values) / sizeof(values[0]); ++idx)
+    {
+        digits[static_cast<unsigned char>(letters[idx])] = values[idx];
+        digits[static_cast<unsigned char>(letters[idx] | 0x20)] = values[idx];
+    }
+    return digits;
+}
+
+
+constexpr std::array<std::uint16_t, 256> const g_roman_digits = make_roman_digits();
+
+
+constexpr std::string_view const g_thousands[4] = {
     "",
     "M",
     "MM",
     "MMM",
 };
 
-constexpr char const * const g_hundreds[10] = {
+constexpr std::string_view const g_hundreds[10] = {
     "",
     "C",
     "CC",
@@ -75,7 +98,7 @@ constexpr char const * const g_hundreds[10] = {
     "CM"
 };
 
-constexpr char const * const g_tens[10] = {
+constexpr std::string_view const g_tens[10] = {
     "",
     "X",
     "XX",
@@ -88,7 +111,7 @@ constexpr char const * const g_tens[10] = {
     "XC"
 };
 
-constexpr char const * const g_units[10] = {
+constexpr std::string_view const g_units[10] = {
     "",
     "I",
     "II",
@@ -102,6 +125,16 @@ constexpr char const * const g_units[10] = {
 };
 
 
+char * copy_digits(char * out, std::string_view const & digits)
+{
+    for(char const c : digits)
+    {
+        *out++ = c;
+    }
+    return out;
+}
+
+
 
 }
 // no name namespace
@@ -118,6 +151,11 @@ constexpr char const * const g_units[10] = {
  *
  * The function views lowercase and uppercase letters as the same thing.
  *
+ * The digits are read from right to left with a table lookup per
+ * character, so nothing gets allocated. A digit smaller than the one on
+ * its right is subtracted, a larger digit is added, and an equal digit
+ * repeats whatever was done to its right neighbor.
+ *
  * \note
  * The algorithm generally expects well formed Roman numbers and it may
  * fail on \em elaborated numbers. For example, "IIX" could be used to
@@ -125,125 +163,153 @@ constexpr char const * const g_units[10] = {
  * to work in this case, but there are certainly other cases that will
  * fail.
  *
+ * \param[in] value  The Roman numeral to convert.
+ *
  * \return 0 on error, the Roman number on success.
  */
-part_integer_t from_roman_number(std::string const & value)
+part_integer_t from_roman_number(std::string_view const & value)
 {
-    std::size_t const max(value.length());
-    if(max == 0)
+    std::size_t idx(value.length());
+    if(idx == 0)
     {
         // an empty string is not considered valid
         //
         return 0;
     }
-    std::vector<int> number(max);
-    for(std::size_t idx(0); idx < max; ++idx)
-    {
-        char c(value[idx]);
-        if(c >= 'a' && c <= 'z')
-        {
-            c -= 0x20; // uppercase
-        }
-        switch(c)
-        {
-        case 'I':
-            number[idx] = 1;
-            break;
-
-        case 'V':
-            number[idx] = 5;
-            break;
-
-        case 'X':
-            number[idx] = 10;
-            break;
-
-        case 'L':
-            number[idx] = 50;
-            break;
-
-        case 'C':
-            number[idx] = 100;
-            break;
-
-        case 'D':
-            number[idx] = 500;
-            break;
-
-        case 'M':
-            number[idx] = 1000;
-            break;
-
-        default:
-            // unknown Roman digit
-            //
-            return 0;
 
-        }
+    --idx;
+    part_integer_t previous(g_roman_digits[static_cast<unsigned char>(value[idx])]);
+    if(previous == 0)
+    {
+        // unknown Roman digit
+        //
+        return 0;
     }
-    part_integer_t result(number[max - 1]);
+    part_integer_t result(previous);
     bool subtract(false);
-    for(ssize_t idx(max - 2); idx >= 0; --idx)
+    while(idx > 0)
     {
-        if(number[idx] == number[idx + 1])
+        --idx;
+        part_integer_t const digit(g_roman_digits[static_cast<unsigned char>(value[idx])]);
+        if(digit == 0)
         {
-            if(subtract)
-            {
-                result -= number[idx];
-            }
-            else
-            {
-                result += number[idx];
-            }
+            return 0;
         }
-        else if(number[idx] < number[idx + 1])
+        if(digit < previous
+        || (digit == previous && subtract))
         {
-            result -= number[idx];
+            result -= digit;
             subtract = true;
         }
         else
         {
-            result += number[idx];
+            result += digit;
             subtract = false;
         }
+        previous = digit;
     }
 
     return result;
 }
 
 
-/** \brief Convert \p value to a Roman numeral.
+/** \brief Write \p value as a Roman numeral in a buffer.
  *
- * This function is the convese of the from_roman_number(). It converts a
+ * This function is the converse of the from_roman_number(). It converts a
  * number back to its Roman numeral form. The number output will be as per
  * the \em normalized version of the Roman numeral (there is not really such
  * a thing, although there are basic rules that are to be applied to get
  * what looks like a standardized Roman numeral).
  *
+ * The function works like std::to_chars(). The numeral is at most
+ * ROMAN_NUMBER_MAX_LENGTH characters. If the buffer is too small, the
+ * error is std::errc::value_too_large. If the number is out of bounds
+ * (0 or over 3999), the error is std::errc::invalid_argument.
+ *
+ * \param[in] first  The start of the output buffer.
+ * \param[in] last  The end of the output buffer.
  * \param[in] value  The integer to transform to Roman numeral.
  *
- * \return A string representing the number in Roman numerals or an empty
- * string if the number is out of bounds (0 or over 3999).
+ * \return The end of the numeral and an error code.
  */
-std::string to_roman_number(part_integer_t value)
+std::to_chars_result to_roman_chars(char * first, char * last, part_integer_t value)
 {
     if(value <= 0 || value > 3'999)
     {
         // out of bounds
         //
-        return std::string();
+        return std::to_chars_result{ first, std::errc::invalid_argument };
+    }
+
+    std::string_view const & thousands(g_thousands[value / 1'000]);
+    std::string_view const & hundreds(g_hundreds[(value / 100) % 10]);
+    std::string_view const & tens(g_tens[(value / 10) % 10]);
+    std::string_view const & units(g_units[value % 10]);
+    std::size_t const length(thousands.length() + hundreds.length() + tens.length() + units.length());
+    if(length > static_cast<std::size_t>(last - first))
+    {
+        return std::to_chars_result{ last, std::errc::value_too_large };
     }
-    std::string result(g_thousands[value / 1'000]);
-    result += g_hundreds[(value / 100) % 10];
-    result += g_tens[(value / 10) % 10];
-    result += g_units[value % 10];
+
+    char * out(copy_digits(first, thousands));
+    out = copy_digits(out, hundreds);
+    out = copy_digits(out, tens);
+    out = copy_digits(out, units);
+    return std::to_chars_result{ out, std::errc() };
+}
+
+
+/** \brief Append \p value as a Roman numeral to a string.
+ *
+ * The numeral is appended to \p result. Nothing gets appended if the
+ * number is out of bounds (0 or over 3999).
+ *
+ * \param[in,out] result  The string where the numeral gets appended.
+ * \param[in] value  The integer to transform to Roman numeral.
+ */
+void append_roman_number(std::string & result, part_integer_t value)
+{
+    char buf[ROMAN_NUMBER_MAX_LENGTH];
+    std::to_chars_result const r(to_roman_chars(buf, buf + sizeof(buf), value));
+    result.append(buf, r.ptr - buf);
+}
+
+
+/** \brief Convert \p value to a Roman numeral.
+ *
+ * This function returns the numeral generated by append_roman_number()
+ * in a new string.
+ *
+ * \param[in] value  The integer to transform to Roman numeral.
+ *
+ * \return A string representing the number in Roman numerals or an empty
+ * string if the number is out of bounds (0 or over 3999).
+ */
+std::string to_roman_number(part_integer_t value)
+{
+    std::string result;
+    append_roman_number(result, value);
     return result;
 }
 
 
 
-bool roman::parse(std::string const & v)
+/** \brief Create a copy of this Roman trait.
+ *
+ * The copy includes the parts and the last error.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t roman::clone() const
 {
+    return std::make_shared<roman>(*this);
+}
+
+
+bool roman::parse(std::string_view const & v)
+{
+    VERSIONTHECA_PROBE_PARSE(*this, v);
+
     if(!trait::parse(v))
     {
         return false;
@@ -278,19 +344,17 @@ bool roman::parse(std::string const & v)
 }
 
 
-std::string roman::to_string() const
+bool roman::write_to(version_output & out) const
 {
     std::size_t max(size());
     if(max == 0)
     {
-        f_last_error = "no parts to output.";
-        return std::string();
+        return false;
     }
     while(max > 1 && at(max - 1).is_zero())
     {
         --max;
     }
-    std::string result;
     for(std::size_t idx(0); idx < max; ++idx)
     {
         char32_t const sep(at(idx).get_separator());
@@ -300,15 +364,19 @@ std::string roman::to_string() const
             {
                 throw logic_error("the very first part should not have a separator defined (it is not supported)."); // LCOV_EXCL_LINE
             }
-            result += sep;
+            out.append(sep);
         }
         if(at(idx).get_type() == 'R')
         {
-            result += to_roman_number(at(idx).get_integer());
+            out.append_formatted(at(idx).get_integer(), to_roman_chars);
         }
         else
         {
-            result += at(idx).to_string();
+            at(idx).write_to(out);
+        }
+        if(out.full())
+        {
+            return true;
         }
     }
     if(max == 1)
@@ -316,14 +384,14 @@ std::string roman::to_string() const
         if(size() >= 2
         && !at(1).is_integer())
         {
-            result += ".A";
+            out.append(".A");
         }
         else
         {
-            result += ".0";
+            out.append(".0");
         }
     }
-    return result;
+    return true;
 }
 
 
@@ -47,8 +47,14 @@ namespace versiontheca
 
 
 
-part_integer_t  from_roman_number(std::string const & value);
-std::string     to_roman_number(part_integer_t value);
+// "MMMDCCCLXXXVIII" (3888)
+constexpr std::size_t   ROMAN_NUMBER_MAX_LENGTH = 15;
+
+
+part_integer_t          from_roman_number(std::string_view const & value);
+std::string             to_roman_number(part_integer_t value);
+std::to_chars_result    to_roman_chars(char * first, char * last, part_integer_t value);
+void                    append_roman_number(std::string & result, part_integer_t value);
 
 
 
@@ -58,8 +64,10 @@ class roman
 public:
     typedef std::shared_ptr<roman>       pointer_t;
 
-    virtual bool        parse(std::string const & v) override;
-    virtual std::string to_string() const override;
+    virtual trait::pointer_t
+                        clone() const override;
+    virtual bool        parse(std::string_view const & v) override;
+    virtual bool        write_to(version_output & out) const override;
 };
 
 
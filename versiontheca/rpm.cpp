@@ -36,6 +36,8 @@
 #include    <versiontheca/rpm.h>
 
 #include    <versiontheca/exception.h>
+#include    <versiontheca/policy.h>
+#include    <versiontheca/probe.h>
 
 
 // C++
@@ -60,92 +62,18 @@ namespace versiontheca
 
 
 
-namespace
-{
-
-
-
-#include    <versiontheca/rpm_order_table.ci>
-
-int compare_characters(char32_t a, char32_t b)
+/** \brief Create a copy of this RPM trait.
+ *
+ * The copy includes the parts and the last error.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t rpm::clone() const
 {
-    // see order in rpm_order.cpp
-    //
-    int const lidx(static_cast<int>(static_cast<std::uint8_t>(a)));
-    int const ridx(static_cast<int>(static_cast<std::uint8_t>(b)));
-#ifdef _DEBUG
-    if(g_rpm_compare_characters[lidx] == 0
-    || g_rpm_compare_characters[ridx] == 0)
-    {
-        // LCOV_EXCL_START
-        throw logic_error("index ("
-            + std::to_string(lidx)
-            + " and/or "
-            + std::to_string(ridx)
-            + ") in rpm/compare_characters() hit a 0, which means it represents an invalid character.");
-        // LCOV_EXCL_STOP
-    }
-#endif
-    int const r(g_rpm_compare_characters[lidx] - g_rpm_compare_characters[ridx]);
-    return r == 0 ? 0 : (r < 0 ? -1 : 1);
+    return std::make_shared<rpm>(*this);
 }
 
 
-int compare_strings(std::string const & lhs, std::string const & rhs)
-{
-    // because of the '~' we have to compare everything ('~' is before
-    // '\0'...)
-    //
-    std::size_t const max(std::max(lhs.length(), rhs.length()));
-    std::size_t lidx(0);
-    std::size_t ridx(0);
-    while(lidx < max || ridx < max)
-    {
-        char a('\0');
-        do
-        {
-            if(lidx < lhs.length())
-            {
-                a = lhs[lidx];
-            }
-            ++lidx;
-        }
-        while(a == '_' && lidx < lhs.length());
-        if(a == '_')
-        {
-            a = '\0';
-        }
-
-        char b('\0');
-        do
-        {
-            if(ridx < rhs.length())
-            {
-                b = rhs[ridx];
-            }
-            ++ridx;
-        }
-        while(b == '_' && ridx < rhs.length());
-        if(b == '_')
-        {
-            b = '\0';
-        }
-
-        int const r(compare_characters(a, b));
-        if(r != 0)
-        {
-            return r;
-        }
-    }
-    return 0;
-}
-
-
-
-}
-// no name namespace
-
-
 /** \brief Parse an RPM version string.
  *
  * A RPM version string is composed of three parts:
@@ -166,38 +94,42 @@ int compare_strings(std::string const & lhs, std::string const & rhs)
  *
  * \return true if the parser succeeded.
  */
-bool rpm::parse(std::string const & v)
+bool rpm::parse(std::string_view const & v)
 {
-    std::string::size_type colon(v.find(':'));
-    std::string::size_type dash(v.rfind('-'));
-    if((colon != std::string::npos && dash != std::string::npos && colon >= dash)
+    VERSIONTHECA_PROBE_PARSE(*this, v);
+
+    clear();
+    f_input = v;
+
+    std::string_view::size_type colon(v.find(':'));
+    std::string_view::size_type dash(v.rfind('-'));
+    if((colon != std::string_view::npos && dash != std::string_view::npos && colon >= dash)
     || colon == 0ULL
     || dash == 0ULL)
     {
         // if there is a ':' then there has to be an epoch and a dash
         // cannot appear in the epoch
         //
-        f_last_error =
-              "position of ':' and/or '-' is invalid in \""
-            + v
-            + "\".";
+        set_error(
+                  error_code_t::ERROR_CODE_INVALID_SEPARATOR_POSITION
+                , v.data() + (colon == 0 || dash == 0 ? 0 : dash));
         return false;
     }
 
     // if there is a colon we must have an epoch (there may be more colons
     // later in the version in which case "0:..." is required in that case)
     //
-    if(colon != std::string::npos)
+    if(colon != std::string_view::npos)
     {
         part p;
         if(!p.set_value(v.substr(0, colon)))
         {
-            f_last_error = p.get_last_error();
+            set_error(error_code_t::ERROR_CODE_INTEGER_TOO_LARGE, v.data());
             return false;
         }
         if(!p.is_integer())
         {
-            f_last_error = "epoch must be a valid integer.";
+            set_error(error_code_t::ERROR_CODE_INVALID_EPOCH, v.data());
             return false;
         }
         p.set_type(':');
@@ -205,14 +137,14 @@ bool rpm::parse(std::string const & v)
     }
     ++colon;
 
-    if(dash == std::string::npos)
+    if(dash == std::string_view::npos)
     {
         dash = v.length();
     }
 
     // the upstream can be parsed as is with parts separated by periods
     //
-    std::string const upstream_version(v.substr(colon, dash - colon));
+    std::string_view const upstream_version(v.substr(colon, dash - colon));
     if(!trait::parse_version(upstream_version, colon == 0 ? U'\0' : U':'))
     {
         return false;
@@ -237,6 +169,7 @@ bool rpm::parse(std::string const & v)
         }
     }
 
+    update_shape();
     return true;
 }
 
@@ -259,12 +192,17 @@ bool rpm::is_separator(char32_t c) const
 }
 
 
+character_classes_t const * rpm::get_character_classes() const
+{
+    return &rpm_policy::classes;
+}
+
+
 bool rpm::get_upstream_positions(std::size_t & start, std::size_t & end) const
 {
     std::size_t const max(size());
     if(max == 0ULL)
     {
-        f_last_error = "no parts in this RPM version; cannot compute upstream start/end.";
         return false;
     }
 
@@ -298,6 +236,8 @@ bool rpm::get_upstream_positions(std::size_t & start, std::size_t & end) const
 
 bool rpm::next(int pos, trait::pointer_t format)
 {
+    VERSIONTHECA_PROBE_COUNT(*this, COUNTER_NEXT);
+
     if(pos < 0)
     {
         throw invalid_parameter("position calling next() cannot be a negative number.");
@@ -315,6 +255,7 @@ bool rpm::next(int pos, trait::pointer_t format)
 
     if(!get_upstream_positions(start, end))
     {
+        set_error(error_code_t::ERROR_CODE_RPM_NO_PARTS);
         return false;
     }
 
@@ -325,7 +266,7 @@ bool rpm::next(int pos, trait::pointer_t format)
         part alpha;
         do
         {
-            part const f(get_format_part(format, end, true));
+            part const & f(get_format_part(format, end, true));
             if(f.is_integer())
             {
                 zero.set_separator(f.get_separator());
@@ -347,7 +288,7 @@ bool rpm::next(int pos, trait::pointer_t format)
         {
             if(static_cast<std::size_t>(pos - 1) <= start)
             {
-                f_last_error = "maximum limit reached; cannot increment version any further.";
+                set_error(error_code_t::ERROR_CODE_MAXIMUM_REACHED);
                 return false;
             }
             erase(pos);
@@ -378,12 +319,15 @@ bool rpm::next(int pos, trait::pointer_t format)
         erase(end);
     }
 
+    update_shape();
     return true;
 }
 
 
 bool rpm::previous(int pos, trait::pointer_t format)
 {
+    VERSIONTHECA_PROBE_COUNT(*this, COUNTER_PREVIOUS);
+
     if(pos < 0)
     {
         throw invalid_parameter("position calling previous() cannot be a negative number.");
@@ -401,6 +345,7 @@ bool rpm::previous(int pos, trait::pointer_t format)
 
     if(!get_upstream_positions(start, end))
     {
+        set_error(error_code_t::ERROR_CODE_RPM_NO_PARTS);
         return false;
     }
 
@@ -411,7 +356,7 @@ bool rpm::previous(int pos, trait::pointer_t format)
         part alpha;
         do
         {
-            part const f(get_format_part(format, end, true));
+            part const & f(get_format_part(format, end, true));
             if(f.is_integer())
             {
                 zero.set_separator(f.get_separator());
@@ -435,11 +380,11 @@ bool rpm::previous(int pos, trait::pointer_t format)
         {
             if(static_cast<std::size_t>(pos) <= start)
             {
-                f_last_error = "minimum limit reached; cannot decrement version any further.";
+                set_error(error_code_t::ERROR_CODE_MINIMUM_REACHED);
                 return false;
             }
             result = false;
-            part const p(get_format_part(format, pos, at(pos).is_integer()));
+            part const & p(get_format_part(format, pos, at(pos).is_integer()));
             if(p.is_integer())
             {
                 at(pos).set_integer(p.get_integer());
@@ -466,16 +411,16 @@ bool rpm::previous(int pos, trait::pointer_t format)
             break;
         }
     }
+    update_shape();
     return true;
 }
 
 
-std::string rpm::to_string() const
+bool rpm::write_to(version_output & out) const
 {
     if(empty())
     {
-        f_last_error = "no parts to output.";
-        return std::string();
+        return false;
     }
 
     std::size_t start(0);
@@ -488,12 +433,11 @@ std::string rpm::to_string() const
     {
         --max;
     }
-    std::string result;
     char32_t sep(U'\0');
     if(at(0).get_type() == ':'
     && !at(0).is_zero())
     {
-        result += at(0).to_string();
+        at(0).write_to(out);
         sep = U':';
     }
     for(std::size_t idx(start); idx < max; ++idx)
@@ -504,13 +448,17 @@ std::string rpm::to_string() const
         }
         if(sep != U'\0')
         {
-            result += sep;
+            out.append(sep);
+        }
+        at(idx).write_to(out);
+        if(out.full())
+        {
+            return true;
         }
-        result += at(idx).to_string();
     }
     if(max - start == 1)
     {
-        result += ".0";
+        out.append(".0");
     }
 
     // there can also be a release
@@ -520,12 +468,12 @@ std::string rpm::to_string() const
         sep = at(end).get_separator();
         if(sep != '\0')
         {
-            result += sep;
+            out.append(sep);
         }
-        result += at(end).to_string();
+        at(end).write_to(out);
     }
 
-    return result;
+    return true;
 }
 
 
@@ -570,15 +518,16 @@ std::string rpm::to_string() const
  * hand side is considered smaller and 1 if the left hand side is considered
  * larger.
  *
- * \sa compare_characters()
+ * \sa detail::rpm_compare_parts()
  */
-int rpm::compare(trait::pointer_t rhs) const
+int rpm::compare(trait::pointer_t const & rhs) const
 {
+    VERSIONTHECA_PROBE_COMPARE(*this);
+
     if(empty() || rhs == nullptr || rhs->empty())
     {
         throw empty_version("one or both of the input versions are empty.");
     }
-
     pointer_t right(std::dynamic_pointer_cast<rpm>(rhs));
     if(right == nullptr)
     {
@@ -587,128 +536,155 @@ int rpm::compare(trait::pointer_t rhs) const
         return trait::compare(rhs);
     }
 
-    std::size_t lpos(0);
-    std::size_t rpos(0);
+    detail::trait_parts<rpm> const l(*this);
+    detail::trait_parts<rpm> const r(*right);
 
-    // compare epoch
+    // builds of the same package usually share the same shape
     //
-    int lepoch(0);
-    int repoch(0);
-    if(at(0).get_type() == ':')
+    if(get_shape() != 0
+    && get_shape() == right->get_shape())
     {
-        lepoch = at(0).get_integer();
-        lpos = 1;
+        return detail::same_shape_compare_parts(l, r, detail::rpm_string_scan_t());
     }
-    if(right->at(0).get_type() == ':')
+
+    return detail::rpm_compare_parts(l, r, detail::rpm_string_scan_t());
+}
+
+
+/** \brief Compute a binary key to sort RPM versions.
+ *
+ * The RPM compare() function compares each section (upstream and release)
+ * part by part. A missing part is viewed as an empty string which is equal
+ * to an integer zero. Integers sort after all strings.
+ *
+ * The key is built as follow:
+ *
+ * \li the epoch as a signed 32 bit number (zero when not defined; compare()
+ * uses an `int`);
+ * \li the upstream section parts;
+ * \li byte 0x02 to end the upstream section;
+ * \li the release section parts;
+ * \li byte 0x02 to end the release section.
+ *
+ * Strings are saved using the RPM order table without the `'_'` (which
+ * compare() ignores) and end with the order of `'\0'`. Integers are saved
+ * as signed 32 bit numbers.
+ *
+ * Integer zeroes are counted instead of being saved. The count is saved
+ * in front of the next part along with a byte defining whether that part
+ * sorts before the end of a section (0x01, i.e. a string starting with
+ * `'~'`), after it (0x03, other strings and negative integers) or is a
+ * positive integer (0x04, in which case the count is reversed). Trailing
+ * zeroes are not saved at all. This is what makes "1.0~rc1" sort before
+ * "1" which sorts before "1.0.1".
+ *
+ * \note
+ * The RPM compare() is not transitive when strings which sort before or
+ * equal to a missing part (starting with `'~'` or `'^'`, or made of
+ * characters that compare() ignores such as `'_'`) face integers. For
+ * example, "1.a" \< "1.0~" \< "1" \< "1.a". In such cases the key still
+ * gives a stable order, "1.0~" \< "1" \< "1.a", but it disagrees with
+ * compare() on some of the pairs: "1^A~" \< "1.0" with compare() yet the
+ * key sorts "1^A~" after "1.0" (see sort_key_matches_compare()).
+ *
+ * \exception empty_version
+ * The function raises this exception if the version is empty.
+ *
+ * \return The sort key of this RPM version.
+ */
+std::string rpm::sort_key() const
+{
+    if(empty())
     {
-        repoch = right->at(0).get_integer();
-        rpos = 1;
+        throw empty_version("cannot compute the sort key of an empty version.");
     }
-    if(lepoch != repoch)
+
+    std::string key;
+
+    // epoch; the XOR makes memcmp() order the values as an `int`
+    //
+    std::size_t pos(0);
+    part_integer_t epoch(0);
+    if(at(0).get_type() == ':')
     {
-        return lepoch < repoch ? -1 : 1;
+        epoch = at(0).get_integer();
+        pos = 1;
     }
+    append_sort_key_integer(key, epoch ^ 0x80000000U);
 
-    // compare upstream version, then switch to the release version
-    //
-    char type('\0');
-    for(;;)
+    std::size_t const max(size());
+    for(char type('\0');; type = '-')
     {
-        for(;;)
+        // find the end of this section ignoring parts equal to a missing part
+        //
+        std::size_t end(pos);
+        std::size_t last(pos);
+        while(end < max && at(end).get_type() == type)
         {
-            if((lpos >= size() || at(lpos).get_type() != type)
-            && (rpos >= right->size() || right->at(rpos).get_type() != type))
-            {
-                // we reached a different type on both sides
-                // we need to explicitly break
-                //
-                break;
-            }
-
-            int lint(0);
-            int rint(0);
-            bool linteger(false);
-            bool rinteger(false);
-            std::string lstr;
-            std::string rstr;
-
-            if(lpos < size()
-            && at(lpos).get_type() == type)
+            part const & p(at(end));
+            ++end;
+            if(p.is_integer())
             {
-                linteger = at(lpos).is_integer();
-                if(linteger)
-                {
-                    lint = at(lpos).get_integer();
-                }
-                else
+                if(p.get_integer() != 0)
                 {
-                    lstr = at(lpos).get_string();
+                    last = end;
                 }
-                ++lpos;
             }
-
-            if(rpos < right->size()
-            && right->at(rpos).get_type() == type)
+            else if(detail::rpm_compare_strings(p.get_string(), std::string_view()) != 0)
             {
-                rinteger = right->at(rpos).is_integer();
-                if(rinteger)
-                {
-                    rint = right->at(rpos).get_integer();
-                }
-                else
-                {
-                    rstr = right->at(rpos).get_string();
-                }
-                ++rpos;
+                last = end;
             }
+        }
 
-            if(linteger == rinteger)
+        std::size_t zeroes(0);
+        for(; pos < last; ++pos)
+        {
+            part const & p(at(pos));
+            if(p.is_integer())
             {
-                if(linteger)
+                int const signed_integer(p.get_integer());
+                if(signed_integer == 0)
                 {
-                    if(lint < rint)
-                    {
-                        return -1;
-                    }
-                    if(lint > rint)
-                    {
-                        return 1;
-                    }
+                    ++zeroes;
+                    continue;
+                }
+                if(signed_integer < 0)
+                {
+                    key += '\x03';
+                    key += static_cast<char>(zeroes);
                 }
                 else
                 {
-                    int const r(compare_strings(lstr, rstr));
-                    if(r != 0)
-                    {
-                        return r;
-                    }
+                    key += '\x04';
+                    key += static_cast<char>(255 - zeroes);
                 }
+                key += '\x02';
+                append_sort_key_integer(key, p.get_integer() ^ 0x80000000U);
             }
             else
             {
-                if(linteger)
+                std::string const str(p.get_string());
+                key += detail::rpm_compare_strings(str, std::string_view()) < 0 ? '\x01' : '\x03';
+                key += static_cast<char>(zeroes);
+                key += '\x01';
+                for(auto const c : str)
                 {
-                    if(lint != 0 || !rstr.empty())
+                    if(c != '_')
                     {
-                        return 1;
-                    }
-                }
-                else
-                {
-                    if(rint != 0 || !lstr.empty())
-                    {
-                        return -1;
+                        key += static_cast<char>(detail::g_rpm_compare_characters[static_cast<std::uint8_t>(c)]);
                     }
                 }
+                key += static_cast<char>(detail::g_rpm_compare_characters[0]);
             }
+            zeroes = 0;
         }
+        pos = end;
+        key += '\x02';
+
         if(type == '-')
         {
-            // we are done
-            //
-            return 0;
+            return key;
         }
-        type = '-';
     }
 }
 
@@ -42,16 +42,21 @@ class rpm
 public:
     typedef std::shared_ptr<rpm>       pointer_t;
 
-    virtual bool        parse(std::string const & v) override;
+    virtual trait::pointer_t
+                        clone() const override;
+    virtual bool        parse(std::string_view const & v) override;
     virtual bool        is_valid_character(char32_t c) const override;
     virtual bool        is_separator(char32_t c) const override;
+    virtual character_classes_t const *
+                        get_character_classes() const override;
     bool                is_epoch_required() const;
-    virtual int         compare(trait::pointer_t rhs) const override;
+    virtual int         compare(trait::pointer_t const & rhs) const override;
 
     virtual bool        next(int pos, trait::pointer_t format) override;
     virtual bool        previous(int pos, trait::pointer_t format) override;
 
-    virtual std::string to_string() const override;
+    virtual bool        write_to(version_output & out) const override;
+    virtual std::string sort_key() const override;
 
 private:
     bool                get_upstream_positions(std::size_t & start, std::size_t & end) const;
@@ -0,0 +1,367 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/** \file
+ * \brief Implementation of the sort functions.
+ *
+ * The input is cut in chunks, one per thread. Each thread allocates its
+ * own trait, computes the sort keys of its chunk, and sorts the chunk.
+ * The sorted chunks are then merged two by two, also in parallel, until
+ * only one remains.
+ *
+ * The threads are created with std::async() so an exception raised by a
+ * thread (i.e. an invalid version) is raised again in the caller.
+ */
+
+// self
+//
+#include    <versiontheca/sort.h>
+
+#include    <versiontheca/exception.h>
+
+
+// C++
+//
+#include    <algorithm>
+#include    <future>
+#include    <thread>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+namespace versiontheca
+{
+
+
+
+namespace
+{
+
+
+
+typedef std::vector<std::string>    key_vector_t;
+
+
+std::size_t get_thread_count(std::size_t count, std::size_t threads)
+{
+    if(count < PARALLEL_SORT_THRESHOLD)
+    {
+        return 1;
+    }
+    if(threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // avoid chunks that are too small to be worth a thread
+    //
+    return std::max<std::size_t>(1, std::min(threads, count / (PARALLEL_SORT_THRESHOLD / 4)));
+}
+
+
+/** \brief Run \p f on \p chunks chunks of [0, \p count).
+ *
+ * The chunk boundaries are saved in \p bounds (chunks + 1 entries).
+ *
+ * \param[in] count  The number of items.
+ * \param[in] chunks  The number of chunks.
+ * \param[out] bounds  The boundaries of the chunks.
+ * \param[in] f  The function called with the chunk number, start, and end.
+ */
+template<typename F>
+void for_each_chunk(std::size_t count, std::size_t chunks, index_vector_t & bounds, F f)
+{
+    bounds.resize(chunks + 1);
+    for(std::size_t idx(0); idx <= chunks; ++idx)
+    {
+        bounds[idx] = count * idx / chunks;
+    }
+
+    if(chunks == 1)
+    {
+        f(0, 0, count);
+        return;
+    }
+
+    std::vector<std::future<void>> results;
+    results.reserve(chunks);
+    for(std::size_t idx(0); idx < chunks; ++idx)
+    {
+        results.push_back(std::async(std::launch::async, f, idx, bounds[idx], bounds[idx + 1]));
+    }
+
+    // wait for all the threads before raising an exception
+    //
+    for(auto & r : results)
+    {
+        r.wait();
+    }
+    for(auto & r : results)
+    {
+        r.get();
+    }
+}
+
+
+void compute_keys(
+      trait_kind_t kind
+    , std::vector<std::string_view> const & versions
+    , key_vector_t & keys
+    , std::size_t start
+    , std::size_t end)
+{
+    trait::pointer_t t(create_trait(kind));
+    for(std::size_t idx(start); idx < end; ++idx)
+    {
+        if(!t->parse(versions[idx]))
+        {
+            throw invalid_version(
+                      "version \""
+                    + std::string(versions[idx])
+                    + "\" is not valid: "
+                    + t->get_last_error());
+        }
+        keys[idx] = t->sort_key();
+    }
+}
+
+
+index_vector_t sort_keys(
+      trait_kind_t kind
+    , std::vector<std::string_view> const & versions
+    , key_vector_t & keys
+    , std::size_t threads)
+{
+    std::size_t const count(versions.size());
+    keys.resize(count);
+    index_vector_t order(count);
+    for(std::size_t idx(0); idx < count; ++idx)
+    {
+        order[idx] = idx;
+    }
+
+    // the index breaks ties so equal versions keep their input order
+    //
+    auto const less([&keys](std::size_t a, std::size_t b)
+        {
+            int const r(keys[a].compare(keys[b]));
+            return r == 0 ? a < b : r < 0;
+        });
+
+    index_vector_t bounds;
+    for_each_chunk(
+          count
+        , get_thread_count(count, threads)
+        , bounds
+        , [&](std::size_t, std::size_t start, std::size_t end)
+        {
+            compute_keys(kind, versions, keys, start, end);
+            std::sort(order.begin() + start, order.begin() + end, less);
+        });
+
+    // merge the sorted chunks two by two
+    //
+    while(bounds.size() > 2)
+    {
+        std::size_t const merges((bounds.size() - 1) / 2);
+        std::vector<std::future<void>> results;
+        results.reserve(merges);
+        for(std::size_t idx(0); idx < merges; ++idx)
+        {
+            auto const first(order.begin() + bounds[idx * 2]);
+            auto const middle(order.begin() + bounds[idx * 2 + 1]);
+            auto const last(order.begin() + bounds[idx * 2 + 2]);
+            results.push_back(std::async(
+                  std::launch::async
+                , [first, middle, last, &less]()
+                {
+                    std::inplace_merge(first, middle, last, less);
+                }));
+        }
+        for(auto & r : results)
+        {
+            r.get();
+        }
+
+        index_vector_t next;
+        for(std::size_t idx(0); idx < bounds.size(); idx += 2)
+        {
+            next.push_back(bounds[idx]);
+        }
+        if(next.back() != count)
+        {
+            next.push_back(count);
+        }
+        bounds.swap(next);
+    }
+
+    return order;
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Sort a set of versions.
+ *
+ * This function parses each version with a trait of the specified \p kind
+ * and returns the indexes of the versions in increasing order.
+ *
+ * \exception invalid_version
+ * All the versions must be valid.
+ *
+ * \param[in] kind  The kind of versions to sort.
+ * \param[in] versions  The versions to sort.
+ * \param[in] threads  The maximum number of threads, or 0 to use one per
+ * processor.
+ *
+ * \return The indexes of \p versions sorted.
+ */
+index_vector_t sort_version_indexes(
+      trait_kind_t kind
+    , std::vector<std::string_view> const & versions
+    , std::size_t threads)
+{
+    key_vector_t keys;
+    return sort_keys(kind, versions, keys, threads);
+}
+
+
+/** \brief Search the largest version.
+ *
+ * This function does not sort the versions. Each thread only keeps the
+ * key of the largest version in its chunk.
+ *
+ * If multiple versions are equal to the largest, the first one is
+ * returned.
+ *
+ * \exception empty_version
+ * The set of versions cannot be empty.
+ *
+ * \exception invalid_version
+ * All the versions must be valid.
+ *
+ * \param[in] kind  The kind of versions to search.
+ * \param[in] versions  The versions to search.
+ * \param[in] threads  The maximum number of threads, or 0 to use one per
+ * processor.
+ *
+ * \return The index of the largest version.
+ */
+std::size_t max_version_index(
+      trait_kind_t kind
+    , std::vector<std::string_view> const & versions
+    , std::size_t threads)
+{
+    std::size_t const count(versions.size());
+    if(count == 0)
+    {
+        throw empty_version("cannot search the largest version of an empty set.");
+    }
+
+    std::size_t const chunks(get_thread_count(count, threads));
+    index_vector_t best(chunks);
+    key_vector_t best_keys(chunks);
+
+    index_vector_t bounds;
+    for_each_chunk(
+          count
+        , chunks
+        , bounds
+        , [&](std::size_t chunk, std::size_t start, std::size_t end)
+        {
+            trait::pointer_t t(create_trait(kind));
+            for(std::size_t idx(start); idx < end; ++idx)
+            {
+                if(!t->parse(versions[idx]))
+                {
+                    throw invalid_version(
+                              "version \""
+                            + std::string(versions[idx])
+                            + "\" is not valid: "
+                            + t->get_last_error());
+                }
+                std::string key(t->sort_key());
+                if(idx == start
+                || key > best_keys[chunk])
+                {
+                    best[chunk] = idx;
+                    best_keys[chunk].swap(key);
+                }
+            }
+        });
+
+    std::size_t result(0);
+    for(std::size_t chunk(1); chunk < chunks; ++chunk)
+    {
+        if(best_keys[chunk] > best_keys[result])
+        {
+            result = chunk;
+        }
+    }
+    return best[result];
+}
+
+
+/** \brief Sort a set of versions and remove duplicates.
+ *
+ * Versions which compare equal are duplicates, even if written
+ * differently (i.e. "1.0" and "1.0.0"). Only the first one found in the
+ * input is kept.
+ *
+ * \exception invalid_version
+ * All the versions must be valid.
+ *
+ * \param[in] kind  The kind of versions to sort.
+ * \param[in] versions  The versions to sort.
+ * \param[in] threads  The maximum number of threads, or 0 to use one per
+ * processor.
+ *
+ * \return The indexes of the unique versions sorted.
+ */
+index_vector_t unique_version_indexes(
+      trait_kind_t kind
+    , std::vector<std::string_view> const & versions
+    , std::size_t threads)
+{
+    key_vector_t keys;
+    index_vector_t order(sort_keys(kind, versions, keys, threads));
+    order.erase(
+          std::unique(
+                  order.begin()
+                , order.end()
+                , [&keys](std::size_t a, std::size_t b)
+                {
+                    return keys[a] == keys[b];
+                })
+        , order.end());
+    return order;
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
@@ -0,0 +1,140 @@
+// Copyright (c) 2023  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/versiontheca
+// contact@m2osw.com
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+/** \file
+ * \brief Sort large sets of versions.
+ *
+ * These functions sort, search the largest, and remove duplicates from
+ * a set of version strings. Each version is parsed only once to compute
+ * its sort key (see trait::sort_key()) and the keys are then compared
+ * with memcmp() instead of trait::compare().
+ *
+ * When the set includes at least PARALLEL_SORT_THRESHOLD versions, the
+ * work is split between multiple threads: each thread computes the keys
+ * of one chunk and sorts it and then the chunks get merged.
+ *
+ * Two versions which compare equal keep their input order.
+ *
+ * \warning
+ * The Unicode, roman, and RPM compare() functions are not transitive
+ * (see sort_key_matches_compare()) so no sort can follow them on every
+ * pair. These functions then use the key order, which is total, and
+ * which disagrees with compare() on such pairs. For example, Unicode
+ * "1.A" sorts before "1.1" (as "1" does) although compare() says it is
+ * larger.
+ */
+
+// self
+//
+#include    <versiontheca/kind.h>
+
+
+// C++
+//
+#include    <string>
+#include    <string_view>
+#include    <vector>
+
+
+
+namespace versiontheca
+{
+
+
+
+constexpr std::size_t const     PARALLEL_SORT_THRESHOLD = 10'000;
+
+
+typedef std::vector<std::size_t>        index_vector_t;
+
+
+index_vector_t          sort_version_indexes(
+                              trait_kind_t kind
+                            , std::vector<std::string_view> const & versions
+                            , std::size_t threads = 0);
+std::size_t             max_version_index(
+                              trait_kind_t kind
+                            , std::vector<std::string_view> const & versions
+                            , std::size_t threads = 0);
+index_vector_t          unique_version_indexes(
+                              trait_kind_t kind
+                            , std::vector<std::string_view> const & versions
+                            , std::size_t threads = 0);
+
+
+template<typename Iterator>
+std::vector<std::string> sort_versions(trait_kind_t kind, Iterator begin, Iterator end, std::size_t threads = 0)
+{
+    std::vector<std::string_view> const versions(begin, end);
+    std::vector<std::string> result;
+    result.reserve(versions.size());
+    for(auto const idx : sort_version_indexes(kind, versions, threads))
+    {
+        result.emplace_back(versions[idx]);
+    }
+    return result;
+}
+
+
+template<typename Container>
+std::vector<std::string> sort_versions(trait_kind_t kind, Container const & versions, std::size_t threads = 0)
+{
+    return sort_versions(kind, std::begin(versions), std::end(versions), threads);
+}
+
+
+template<typename Iterator>
+std::string max_version(trait_kind_t kind, Iterator begin, Iterator end, std::size_t threads = 0)
+{
+    std::vector<std::string_view> const versions(begin, end);
+    return std::string(versions[max_version_index(kind, versions, threads)]);
+}
+
+
+template<typename Container>
+std::string max_version(trait_kind_t kind, Container const & versions, std::size_t threads = 0)
+{
+    return max_version(kind, std::begin(versions), std::end(versions), threads);
+}
+
+
+template<typename Iterator>
+std::vector<std::string> unique_versions(trait_kind_t kind, Iterator begin, Iterator end, std::size_t threads = 0)
+{
+    std::vector<std::string_view> const versions(begin, end);
+    std::vector<std::string> result;
+    for(auto const idx : unique_version_indexes(kind, versions, threads))
+    {
+        result.emplace_back(versions[idx]);
+    }
+    return result;
+}
+
+
+template<typename Container>
+std::vector<std::string> unique_versions(trait_kind_t kind, Container const & versions, std::size_t threads = 0)
+{
+    return unique_versions(kind, std::begin(versions), std::end(versions), threads);
+}
+
+
+
+}
+// namespace versiontheca
+// vim: ts=4 sw=4 et
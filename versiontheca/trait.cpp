@@ -20,19 +20,19 @@
 //
 #include    <versiontheca/trait.h>
 
+#include    <versiontheca/compare.h>
 #include    <versiontheca/exception.h>
+#include    <versiontheca/probe.h>
 
 
 // libutf8
 //
 #include    <libutf8/base.h>
-#include    <libutf8/iterator.h>
 #include    <libutf8/libutf8.h> // for the std::string += char32_t
 
 
 // snapdev
 //
-#include    <snapdev/hexadecimal_string.h>
 #include    <snapdev/not_reached.h>
 
 
@@ -43,7 +43,18 @@
 
 // C++
 //
+#include    <algorithm>
+#include    <cstring>
 #include    <iostream>
+#include    <stdexcept>
+#include    <utility>
+
+
+// C
+//
+#ifdef __SSE2__
+#include    <emmintrin.h>
+#endif
 
 
 // last include
@@ -57,71 +68,177 @@ namespace versiontheca
 
 
 
+namespace
+{
+
+
+
+part make_maximum_part(bool integer, bool separator)
+{
+    part maximum;
+    if(integer)
+    {
+        maximum.set_to_max_integer();
+        if(separator)
+        {
+            maximum.set_separator(U'.');
+        }
+    }
+    else
+    {
+        maximum.set_to_max_string();
+    }
+    return maximum;
+}
+
+
+
+}
+// no name namespace
+
+
+
 trait::~trait()
 {
 }
 
 
+/** \brief Create a copy of this trait.
+ *
+ * This function returns a new trait with the same parts and error as
+ * this trait. It is used to copy versiontheca objects without having to
+ * canonicalize and parse the version again.
+ *
+ * Each trait overrides this function so the copy has the same type as
+ * the original.
+ *
+ * \return A pointer to the new trait.
+ */
+trait::pointer_t trait::clone() const
+{
+    return std::make_shared<trait>(*this);
+}
+
+
 void trait::clear()
 {
-    f_parts.clear();
+    // the parts are not released, this way their string buffers can be
+    // reused by the next parse() call
+    //
+    f_size = 0;
+    f_shape = 0;
+}
+
+
+/** \brief Copy the parts of another trait.
+ *
+ * This function replaces the parts of this trait with the parts of
+ * \p rhs. Contrary to clone(), nothing gets allocated as long as the
+ * string parts fit in the buffers already allocated by this trait.
+ *
+ * The error and the state used while parsing are not copied. Both
+ * traits are expected to be of the same type.
+ *
+ * \param[in] rhs  The trait to copy the parts from.
+ */
+void trait::assign_parts(trait const & rhs)
+{
+    std::copy_n(rhs.f_parts.begin(), rhs.f_size, f_parts.begin());
+    f_size = rhs.f_size;
+    f_shape = rhs.f_shape;
 }
 
 
+/** \brief Get a part which can be modified.
+ *
+ * Since the caller may modify the part, this function invalidates the
+ * shape of this trait. To only read a part, make sure to call the const
+ * version of this function.
+ *
+ * \param[in] index  The index of the part.
+ *
+ * \return A reference to the part.
+ */
 part & trait::at(int index)
 {
-    return f_parts.at(index);
+    if(static_cast<std::size_t>(index) >= f_size)
+    {
+        throw std::out_of_range("trait::at() index is out of range.");
+    }
+    f_shape = 0;
+    return f_parts[index];
 }
 
 
 part const & trait::at(int index) const
 {
-    return f_parts.at(index);
+    if(static_cast<std::size_t>(index) >= f_size)
+    {
+        throw std::out_of_range("trait::at() index is out of range.");
+    }
+    return f_parts[index];
 }
 
 
 void trait::push_back(part const & p)
 {
-    if(f_parts.size() >= MAX_PARTS)
+    if(f_size >= MAX_PARTS)
     {
         throw invalid_parameter("trying to append more parts when maximum was already reached.");
     }
 
-    f_parts.push_back(p);
+    f_parts[f_size] = p;
+    ++f_size;
+    f_shape = 0;
 }
 
 
 void trait::insert(int index, part const & p)
 {
-    if(f_parts.size() >= MAX_PARTS)
+    if(f_size >= MAX_PARTS)
     {
         throw invalid_parameter("trying to insert more parts when maximum was already reached.");
     }
+    if(static_cast<std::size_t>(index) > f_size)
+    {
+        throw std::out_of_range("trait::insert() index is out of range.");
+    }
 
-    f_parts.insert(f_parts.begin() + index, p);
+    std::move_backward(
+              f_parts.begin() + index
+            , f_parts.begin() + f_size
+            , f_parts.begin() + f_size + 1);
+    f_parts[index] = p;
+    ++f_size;
+    f_shape = 0;
 }
 
 
 void trait::erase(int index)
 {
-    if(static_cast<std::size_t>(index) >= f_parts.size())
+    if(static_cast<std::size_t>(index) >= f_size)
     {
         throw invalid_parameter("trying to erase a non-existant part.");
     }
 
-    f_parts.erase(f_parts.begin() + index);
+    std::move(
+              f_parts.begin() + index + 1
+            , f_parts.begin() + f_size
+            , f_parts.begin() + index);
+    --f_size;
+    f_shape = 0;
 }
 
 
 std::size_t trait::size() const
 {
-    return f_parts.size();
+    return f_size;
 }
 
 
 bool trait::empty() const
 {
-    return f_parts.empty();
+    return f_size == 0;
 }
 
 
@@ -132,7 +249,14 @@ void trait::resize(std::size_t sz)
         throw invalid_parameter("requested too many parts.");
     }
 
-    f_parts.resize(sz);
+    // like std::vector, new parts are default parts
+    //
+    for(std::size_t idx(f_size); idx < sz; ++idx)
+    {
+        f_parts[idx] = part();
+    }
+    f_size = sz;
+    f_shape = 0;
 }
 
 
@@ -181,12 +305,15 @@ void trait::resize(std::size_t sz)
  * \return true if all the parts were parsed successfully and the input was
  * not an empty string.
  */
-bool trait::parse(std::string const & v)
+bool trait::parse(std::string_view const & v)
 {
+    VERSIONTHECA_PROBE_PARSE(*this, v);
+
     clear();
+    f_input = v;
     if(v.empty())
     {
-        f_last_error = "an empty input string cannot represent a valid version.";
+        set_error(error_code_t::ERROR_CODE_EMPTY_INPUT, v.data());
         return false;
     }
 
@@ -194,114 +321,392 @@ bool trait::parse(std::string const & v)
 }
 
 
-bool trait::parse_version(std::string const & v, char32_t sep)
+/** \brief Check whether a string is only composed of ASCII characters.
+ *
+ * Nearly all versions are pure ASCII. When that is the case, the parser
+ * tokenizes the bytes directly instead of decoding UTF-8 characters.
+ *
+ * The test is done 16 bytes at a time with SSE2 when available, then
+ * 8 bytes at a time, and finally one byte at a time for the remainder.
+ *
+ * \param[in] v  The string to check.
+ *
+ * \return true if none of the bytes has its high bit set.
+ */
+bool trait::is_ascii(std::string_view const & v)
 {
-    libutf8::utf8_iterator it(v);
-    std::string value;
-    for(char32_t c(*it); c != libutf8::EOS; ++it, c = *it)
+    char const * s(v.data());
+    std::size_t len(v.length());
+
+#ifdef __SSE2__
+    for(; len >= 16; s += 16, len -= 16)
+    {
+        __m128i const chunk(_mm_loadu_si128(reinterpret_cast<__m128i const *>(s)));
+        if(_mm_movemask_epi8(chunk) != 0)
+        {
+            return false;
+        }
+    }
+#endif
+
+    for(; len >= sizeof(std::uint64_t); s += sizeof(std::uint64_t), len -= sizeof(std::uint64_t))
+    {
+        std::uint64_t word(0);
+        std::memcpy(&word, s, sizeof(word));
+        if((word & 0x8080808080808080ULL) != 0)
+        {
+            return false;
+        }
+    }
+
+    for(; len > 0; ++s, --len)
     {
-        if(c == libutf8::NOT_A_CHARACTER)
+        if(static_cast<std::uint8_t>(*s) >= 0x80)
         {
-            f_last_error = "input string includes an invalid code not representing a valid UTF-8 character.";
             return false;
         }
-        if(is_separator(c))
+    }
+
+    return true;
+}
+
+
+/** \brief Read the next character from a version string.
+ *
+ * This function decodes one UTF-8 character at \p pos and moves \p pos
+ * to the following character. Working with positions lets the parser
+ * create views of the input instead of copying it character by character.
+ *
+ * \param[in] v  The version being parsed.
+ * \param[in,out] pos  The position of the character to read.
+ *
+ * \return The character, libutf8::EOS at the end of the string, or
+ * libutf8::NOT_A_CHARACTER if the UTF-8 encoding is invalid.
+ */
+char32_t trait::get_character(std::string_view const & v, std::size_t & pos)
+{
+    if(pos >= v.length())
+    {
+        return libutf8::EOS;
+    }
+
+    char const * s(v.data() + pos);
+    std::size_t len(v.length() - pos);
+    char32_t c(U'\0');
+    int const r(libutf8::mbstowc(c, s, len));
+    pos = s - v.data();
+    return r < 0 ? libutf8::NOT_A_CHARACTER : c;
+}
+
+
+bool trait::parse_version(std::string_view const & v, char32_t sep)
+{
+    // when the input is pure ASCII, each byte is a character
+    //
+    bool const ascii(is_ascii(v));
+    character_classes_t const * classes(ascii ? get_character_classes() : nullptr);
+    if(classes != nullptr
+    && v.length() <= MAX_CLASSIFIED_LENGTH)
+    {
+        // classify all the characters at once and then use the masks
+        // to find the separators, digits, and invalid characters
+        //
+        character_masks_t masks;
+        classify_characters(v, *classes, masks);
+        std::size_t start(0);
+        for(std::uint64_t separators(masks.f_separators); separators != 0; separators &= separators - 1)
         {
-            if(!parse_value(value, sep))
+            std::size_t const end(__builtin_ctzll(separators));
+            if(!parse_classified_value(v.substr(start, end - start), sep, masks, start))
             {
                 return false;
             }
-            sep = c;
-            value.clear();
+            sep = static_cast<std::uint8_t>(v[end]);
+            start = end + 1;
+        }
+        return parse_classified_value(v.substr(start), sep, masks, start);
+    }
+
+    std::size_t const max(v.length());
+    std::size_t start(0);
+    std::size_t pos(0);
+    for(;;)
+    {
+        std::size_t const end(pos);
+        char32_t c(U'\0');
+        bool separator(false);
+        if(ascii)
+        {
+            if(pos >= max)
+            {
+                break;
+            }
+            c = static_cast<std::uint8_t>(v[pos]);
+            ++pos;
+            separator = classes != nullptr
+                    ? (classes->f_class[c] & CHARACTER_CLASS_SEPARATOR) != 0
+                    : is_separator(c);
         }
         else
         {
-            value += c;
+            c = get_character(v, pos);
+            if(c == libutf8::EOS)
+            {
+                break;
+            }
+            if(c == libutf8::NOT_A_CHARACTER)
+            {
+                set_error(error_code_t::ERROR_CODE_INVALID_UTF8, v.data() + end);
+                return false;
+            }
+            separator = is_separator(c);
+        }
+        if(separator)
+        {
+            if(!parse_value(v.substr(start, end - start), sep, ascii))
+            {
+                return false;
+            }
+            sep = c;
+            start = pos;
         }
     }
-    return parse_value(value, sep);
+    return parse_value(v.substr(start), sep, ascii);
+}
+
+
+bool trait::parse_value(std::string_view const & value, char32_t sep)
+{
+    return parse_value(value, sep, is_ascii(value));
 }
 
 
-bool trait::parse_value(std::string const & value, char32_t sep)
+bool trait::parse_value(std::string_view const & value, char32_t sep, bool ascii)
 {
+    character_classes_t const * classes(ascii ? get_character_classes() : nullptr);
+    if(classes != nullptr
+    && value.length() <= MAX_CLASSIFIED_LENGTH)
+    {
+        character_masks_t masks;
+        classify_characters(value, *classes, masks);
+        return parse_classified_value(value, sep, masks, 0);
+    }
+
     if(value.empty())
     {
         // this happens in cases such as two periods one after the
         // other ("1..3"); with a debian version, it happens when
         // you pass a string without an upstream version ("3:-ubuntu3")
         //
-        f_last_error = "a version value cannot be an empty string.";
+        set_error(error_code_t::ERROR_CODE_EMPTY_VALUE, value.data());
         return false;
     }
-    libutf8::utf8_iterator it(value);
-    char32_t c(*it);
-    while(c != libutf8::EOS)
+    std::size_t const max(value.length());
+    std::size_t pos(0);
+    while(pos < max)
     {
-        if(c >= '0' && c <= '9')
+        if(value[pos] >= '0' && value[pos] <= '9')
         {
             // read one number (digits)
             //
-            std::string n;
-            for(; c >= '0' && c <= '9'; c = *++it)
+            std::size_t const start(pos);
+            do
             {
-                n += c;
+                ++pos;
             }
-            part p;
-            if(!p.set_value(n))
+            while(pos < max && value[pos] >= '0' && value[pos] <= '9');
+            if(!push_number(value.substr(start, pos - start), sep))
             {
-                f_last_error = p.get_last_error();
                 return false;
             }
-            p.set_width(n.length());    // TODO: use format length when available
-            p.set_separator(sep);
-            push_back(p);
-            sep = '\0';
         }
 
         {
             // read "letters" (anything but a number in the base parser)
             //
-            std::string n;
-            while(c != libutf8::EOS && (c < '0' || c > '9'))
+            std::size_t const start(pos);
+            while(pos < max && (value[pos] < '0' || value[pos] > '9'))
             {
-                if(c == libutf8::NOT_A_CHARACTER)
+                std::size_t const character_pos(pos);
+                char32_t c(U'\0');
+                bool valid(false);
+                if(ascii)
                 {
-                    f_last_error = "input string includes an invalid code not representing a valid UTF-8 character.";
-                    return false;
+                    c = static_cast<std::uint8_t>(value[pos]);
+                    ++pos;
+                    valid = classes != nullptr
+                            ? (classes->f_class[c] & CHARACTER_CLASS_VALID) != 0
+                            : is_valid_character(c);
                 }
-                if(!is_valid_character(c))
+                else
+                {
+                    c = get_character(value, pos);
+                    if(c == libutf8::NOT_A_CHARACTER)
+                    {
+                        set_error(error_code_t::ERROR_CODE_INVALID_UTF8, value.data() + character_pos);
+                        return false;
+                    }
+                    valid = is_valid_character(c);
+                }
+                if(!valid)
                 {
                     // trait can prevent any characters
                     //
-                    f_last_error = "found unexpected character: \\U"
-                        + snapdev::int_to_hex(c, true, 6)
-                        + " in input.";
+                    set_error(error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER, value.data() + character_pos, c);
                     return false;
                 }
-                n += c;
-                ++it;
-                c = *it;
             }
 
             // note: this may be empty if we just read a number not
             //       followed by any letters and in that case we ignore
             //
-            if(!n.empty())
+            if(pos > start)
+            {
+                push_string(value.substr(start, pos - start), sep);
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/** \brief Parse a value using the masks computed by classify_characters().
+ *
+ * This function does the same work as parse_value() except that the
+ * digits and invalid characters are found using the \p masks instead
+ * of testing each character one by one.
+ *
+ * \param[in] value  The value to parse.
+ * \param[in] sep  The separator that appeared before this value.
+ * \param[in] masks  The masks of the entire string.
+ * \param[in] offset  The position of \p value in the classified string.
+ *
+ * \return true if the value was parsed successfully.
+ */
+bool trait::parse_classified_value(
+      std::string_view const & value
+    , char32_t sep
+    , character_masks_t const & masks
+    , std::size_t offset)
+{
+    if(value.empty())
+    {
+        set_error(error_code_t::ERROR_CODE_EMPTY_VALUE, value.data());
+        return false;
+    }
+
+    // offset < 64 since value is not empty
+    //
+    std::uint64_t const digits(masks.f_digits >> offset);
+    std::uint64_t const invalid(masks.f_invalid >> offset);
+    std::size_t const max(value.length());
+    std::size_t pos(0);
+    while(pos < max)
+    {
+        std::uint64_t run(digits >> pos);
+        if((run & 1) != 0)
+        {
+            std::size_t const length(std::min(
+                      run == ~0ULL
+                        ? MAX_CLASSIFIED_LENGTH
+                        : static_cast<std::size_t>(__builtin_ctzll(~run))
+                    , max - pos));
+            if(!push_number(value.substr(pos, length), sep))
+            {
+                return false;
+            }
+            pos += length;
+            if(pos >= max)
             {
-                part p;
-                p.set_separator(sep);
-                p.set_string(n);
-                push_back(p);
-                sep = U'\0';
+                break;
             }
+            run = digits >> pos;
         }
+
+        std::size_t const length(std::min(
+                  run == 0
+                    ? MAX_CLASSIFIED_LENGTH
+                    : static_cast<std::size_t>(__builtin_ctzll(run))
+                , max - pos));
+        std::uint64_t const bad((invalid >> pos)
+                & (length >= 64 ? ~0ULL : (1ULL << length) - 1));
+        if(bad != 0)
+        {
+            std::size_t const bad_pos(pos + __builtin_ctzll(bad));
+            set_error(
+                  error_code_t::ERROR_CODE_UNEXPECTED_CHARACTER
+                , value.data() + bad_pos
+                , static_cast<std::uint8_t>(value[bad_pos]));
+            return false;
+        }
+        push_string(value.substr(pos, length), sep);
+        pos += length;
     }
 
     return true;
 }
 
 
+bool trait::push_number(std::string_view const & n, char32_t & sep)
+{
+    part p;
+    if(!p.set_value(n))
+    {
+        set_error(error_code_t::ERROR_CODE_INTEGER_TOO_LARGE, n.data());
+        return false;
+    }
+    p.set_width(n.length());    // TODO: use format length when available
+    p.set_separator(sep);
+    push_back(p);
+    sep = U'\0';
+    return true;
+}
+
+
+void trait::push_string(std::string_view const & s, char32_t & sep)
+{
+    part p;
+    p.set_separator(sep);
+    p.set_string(s);
+    push_back(p);
+    sep = U'\0';
+}
+
+
+/** \brief Record an error.
+ *
+ * The error is saved as a code, an offset, and a character. The message
+ * is only generated by get_last_error().
+ *
+ * The offset is computed from \p where, a pointer in the input of the
+ * parse() call in progress. When \p where is nullptr or does not point
+ * in that input, the offset is set to 0.
+ *
+ * \param[in] code  The error code.
+ * \param[in] where  A pointer to the position of the error in the input.
+ * \param[in] c  The offending character, if any.
+ */
+void trait::set_error(error_code_t code, char const * where, char32_t c)
+{
+    VERSIONTHECA_PROBE_ERROR(*this, code);
+
+    version_error_t error;
+    error.f_code = code;
+    error.f_offset = where != nullptr
+                    && where >= f_input.data()
+                    && where <= f_input.data() + f_input.length()
+                            ? static_cast<std::uint32_t>(where - f_input.data())
+                            : 0;
+    error.f_character = c;
+    if(error_message_includes_input(code))
+    {
+        f_error_input.assign(f_input.data(), f_input.length());
+    }
+    f_error = error;
+}
+
+
 bool trait::is_valid_character(char32_t c) const
 {
     if(!libutf8::is_valid_unicode(c, false))
@@ -319,37 +724,136 @@ bool trait::is_separator(char32_t c) const
 }
 
 
-int trait::compare(trait::pointer_t rhs) const
+/** \brief Get the table of character classes of this trait.
+ *
+ * When a trait returns a table, the parser classifies ASCII characters
+ * using that table instead of calling is_valid_character() and
+ * is_separator() on each character. The table must give the same results
+ * as those two functions.
+ *
+ * The default trait returns nullptr so a trait deriving from it and
+ * overriding is_valid_character() or is_separator() keeps working as
+ * expected.
+ *
+ * \return A pointer to the character classes or nullptr.
+ */
+character_classes_t const * trait::get_character_classes() const
+{
+    return nullptr;
+}
+
+
+/** \brief Compute the shape of this version.
+ *
+ * The shape is a signature of the structure of the version: the number
+ * of parts, whether the first part is an epoch, which parts are in the
+ * release section, and which parts are integers. Two versions with the
+ * same shape have their parts aligned, which allows for a simpler
+ * compare loop.
+ *
+ * The traits call this function once a version was successfully parsed
+ * or modified by next() or previous(). The shape is reset to 0 (unknown)
+ * by all the functions which can modify the parts. A version with a part
+ * of another type also gets a shape of 0.
+ */
+void trait::update_shape()
+{
+    static_assert(MAX_PARTS * 2 <= 50, "the shape needs two bits per part below the epoch bit.");
+
+    std::uint64_t shape(static_cast<std::uint64_t>(1) << 63);
+    shape |= static_cast<std::uint64_t>(f_size) << 51;
+    for(std::size_t idx(0); idx < f_size; ++idx)
+    {
+        part const & p(f_parts[idx]);
+        if(p.is_integer())
+        {
+            shape |= static_cast<std::uint64_t>(1) << idx;
+        }
+        switch(p.get_type())
+        {
+        case '\0':
+            break;
+
+        case '-':
+            shape |= static_cast<std::uint64_t>(1) << (idx + MAX_PARTS);
+            break;
+
+        case ':':
+            if(idx != 0)
+            {
+                f_shape = 0;
+                return;
+            }
+            shape |= static_cast<std::uint64_t>(1) << 50;
+            break;
+
+        default:
+            f_shape = 0;
+            return;
+
+        }
+    }
+    f_shape = shape;
+}
+
+
+/** \brief Get the shape of this version.
+ *
+ * \return The shape computed by update_shape() or 0 if unknown.
+ */
+std::uint64_t trait::get_shape() const
 {
+    return f_shape;
+}
+
+
+/** \brief Compare two versions.
+ *
+ * The default compare goes through the parts one by one. Missing parts
+ * are viewed as zeroes so "1.0" and "1" are equal.
+ *
+ * \exception empty_version
+ * The function raises this exception if either version is empty.
+ *
+ * \param[in] rhs  The right hand side version.
+ *
+ * \return -1, 0, or 1 depending on the order of this version and \p rhs.
+ */
+int trait::compare(trait::pointer_t const & rhs) const
+{
+    VERSIONTHECA_PROBE_COMPARE(*this);
+
     if(empty() || rhs == nullptr || rhs->empty())
     {
         throw empty_version("one or both of the input versions are empty.");
     }
 
-    std::size_t const max(std::max(size(), rhs->size()));
+    trait const & r(*rhs);
+    std::size_t const lsize(size());
+    std::size_t const rsize(r.size());
+    std::size_t const max(std::max(lsize, rsize));
     for(std::size_t idx(0); idx < max; ++idx)
     {
-        if(idx >= size())
+        if(idx >= lsize)
         {
-            if(idx < rhs->size()
-            && !rhs->f_parts[idx].is_zero())
+            if(!r.at(idx).is_zero())
             {
                 return -1;
             }
         }
-        else if(idx >= rhs->size())
+        else if(idx >= rsize)
         {
-            if(!f_parts[idx].is_zero())
+            if(!at(idx).is_zero())
             {
                 return 1;
             }
         }
         else
         {
-            int const r(f_parts[idx].compare(rhs->f_parts[idx]));
-            if(r != 0)
+            int const c(at(idx).compare(r.at(idx)));
+            if(c != 0)
             {
-                return r;
+                return c;
             }
         }
     }
@@ -357,6 +861,129 @@ int trait::compare(trait::pointer_t rhs) const
 }
 
 
+/** \brief Compare the first parts of two versions.
+ *
+ * This function compares at most the first \p limit parts of both
+ * versions and ignores the other parts, so checking whether two versions
+ * have the same "major.minor" is a compare with a \p limit of 2.
+ *
+ * The limit applies to the upstream version only. An epoch is not
+ * counted in the limit; it is always compared. With a Debian or RPM
+ * version, the release is never compared under a limit and the missing
+ * upstream parts are viewed as zeroes, so "2.0-1" and "2-9" have the
+ * same "major.minor". A \p limit of MAX_PARTS or more compares
+ * everything, like compare(rhs).
+ *
+ * This function is not virtual. When a version has more parts than the
+ * limit, it compares copies of the versions reduced to their first
+ * parts (see detail::limited_size()) with the virtual compare(), so
+ * every trait, including traits defined outside of the library, gets
+ * the limit for free.
+ *
+ * \exception empty_version
+ * The function raises this exception if either version is empty.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p limit is 0.
+ *
+ * \param[in] rhs  The right hand side version.
+ * \param[in] limit  The maximum number of parts to compare.
+ *
+ * \return -1, 0, or 1 depending on the order of the first parts of
+ * this version and \p rhs.
+ */
+int trait::compare_prefix(trait::pointer_t const & rhs, std::size_t limit) const
+{
+    if(empty() || rhs == nullptr || rhs->empty())
+    {
+        throw empty_version("one or both of the input versions are empty.");
+    }
+    if(limit == 0)
+    {
+        throw invalid_parameter("the compare limit must be at least 1.");
+    }
+
+    std::size_t const lsize(detail::limited_size(detail::trait_parts<trait>(*this), limit));
+    std::size_t const rsize(detail::limited_size(detail::trait_parts<trait>(*rhs), limit));
+    if(lsize == size()
+    && rsize == rhs->size())
+    {
+        return compare(rhs);
+    }
+
+    pointer_t l(clone());
+    l->resize(lsize);
+    pointer_t r(rhs->clone());
+    r->resize(rsize);
+    return l->compare(r);
+}
+
+
+/** \brief Canonicalize this version.
+ *
+ * This function returns the version appended to an empty string by
+ * append_to_string().
+ *
+ * \return The canonicalized version returned as a string.
+ */
+std::string trait::to_string() const
+{
+    std::string result;
+    append_to_string(result);
+    return result;
+}
+
+
+/** \brief Write the canonicalized version in a buffer.
+ *
+ * This function works like std::to_chars(): the version gets written
+ * between \p first and \p last and the returned pointer is one past
+ * the last character written. No '\0' gets added.
+ *
+ * The parts are written directly in the buffer by write_to() so no
+ * memory gets allocated. Nothing is written at or after \p last.
+ *
+ * If the buffer is too small, the writing stops right away, the error is set to
+ * std::errc::value_too_large and the pointer to \p last. If the trait
+ * is empty, the error is set to std::errc::invalid_argument.
+ *
+ * \param[in] first  The start of the buffer.
+ * \param[in] last  The end of the buffer.
+ *
+ * \return The end of the version and an error code.
+ */
+std::to_chars_result trait::to_chars(char * first, char * last) const
+{
+    version_output out(first, last);
+    if(!write_to(out))
+    {
+        return std::to_chars_result{ first, std::errc::invalid_argument };
+    }
+    if(out.full())
+    {
+        return std::to_chars_result{ last, std::errc::value_too_large };
+    }
+    return std::to_chars_result{ out.end(), std::errc() };
+}
+
+
+/** \brief Append the canonicalized version to a string.
+ *
+ * The canonicalized version gets appended to \p result so the caller
+ * can reuse the same buffer for many versions. Nothing else gets
+ * allocated once \p result is large enough.
+ *
+ * \param[in,out] result  The string where the version gets appended.
+ *
+ * \return true if the version was appended, false if the trait is empty.
+ */
+bool trait::append_to_string(std::string & result) const
+{
+    version_output out(result);
+    return write_to(out);
+}
+
+
 /** \brief Default canonicalization of a version.
  *
  * By default, we generate a string with is composed of each part separated
@@ -365,25 +992,30 @@ int trait::compare(trait::pointer_t rhs) const
  * \li an epoch requires a colon after
  * \li a release requires a tilde before
  *
+ * This function is used by to_string(), append_to_string(), and
+ * to_chars(). A trait with a different canonical form overrides it.
+ * When \p out is a buffer, the function stops as soon as the buffer
+ * is full.
+ *
  * \note
  * If the version represents "0.0" then it is likely this function
- * will return an empty string.
+ * will append an empty string.
  *
- * \return The canonicalized version returned as a string.
+ * \param[in,out] out  The output where the version gets written.
+ *
+ * \return true if the version was written, false if the trait is empty.
  */
-std::string trait::to_string() const
+bool trait::write_to(version_output & out) const
 {
     std::size_t max(size());
     if(max == 0)
     {
-        f_last_error = "no parts to output.";
-        return std::string();
+        return false;
     }
     while(max > 1 && at(max - 1).is_zero())
     {
         --max;
     }
-    std::string result;
     for(std::size_t idx(0); idx < max; ++idx)
     {
         char32_t const sep(at(idx).get_separator());
@@ -393,48 +1025,152 @@ std::string trait::to_string() const
             {
                 throw logic_error("the very first part should not have a separator defined (it is not supported)."); // LCOV_EXCL_LINE
             }
-            result += sep;
+            out.append(sep);
+        }
+        at(idx).write_to(out);
+        if(out.full())
+        {
+            return true;
         }
-        result += at(idx).to_string();
     }
     if(max == 1)
     {
         if(size() >= 2
         && !at(1).is_integer())
         {
-            result += ".A";
+            out.append(".A");
         }
         else
         {
-            result += ".0";
+            out.append(".0");
         }
     }
-    return result;
+    return true;
 }
 
 
-part trait::get_format_part(pointer_t format, int pos, bool integer)
+/** \brief Compute a binary key representing this version.
+ *
+ * The sort key is a string of bytes which, when compared with memcmp()
+ * (or the std::string comparison operators, which behave the same way),
+ * sorts in the same order as the compare() function. This allows for
+ * versions to be sorted, indexed, and saved in a database without having
+ * to parse them again or call the virtual compare() function.
+ *
+ * The default key encodes each part one after the other:
+ *
+ * \li an integer is saved as `'0'` followed by its four bytes in big
+ * endian; since string parts never include digits, the `'0'` sorts
+ * integers exactly where compare() puts them against strings;
+ * \li a string is saved as is, followed by `"\0\x01"` (a `'\0'` within
+ * the string is saved as `"\0\xFF"` so the end of the string sorts first).
+ *
+ * The trailing zero parts are not included in the key since compare()
+ * views missing parts as zeroes (i.e. "1.0" and "1" are equal).
+ *
+ * \note
+ * compare() is not transitive whenever a string of all `'A'` is
+ * involved: such a string is equal to a missing part, yet larger than
+ * any integer. So "1" \< "1.1" \< "1.A" while "1.A" == "1". No key can
+ * follow such a cycle. The key views the `'A'` strings as zeroes like
+ * the missing parts so "1.A" sorts as "1", before "1.1", even though
+ * compare() returns 1. The Unicode and roman traits use this key and
+ * the RPM key has similar exceptions; the Debian, decimal, and
+ * basic keys always agree with compare() (see sort_key_matches_compare()).
+ *
+ * \exception empty_version
+ * The function raises this exception if the version is empty.
+ *
+ * \return The sort key of this version.
+ */
+std::string trait::sort_key() const
 {
-    if(format != nullptr
-    && static_cast<std::size_t>(pos) < format->size())
+    if(empty())
     {
-        return format->f_parts[pos];
+        throw empty_version("cannot compute the sort key of an empty version.");
     }
 
-    part maximum;
-    if(integer)
+    std::size_t max(size());
+    while(max > 0 && at(max - 1).is_zero())
     {
-        maximum.set_to_max_integer();
-        if(pos != 0)
+        --max;
+    }
+
+    std::string key;
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        part const & p(at(idx));
+        if(p.is_integer())
         {
-            maximum.set_separator(U'.');
+            key += '0';
+            append_sort_key_integer(key, p.get_integer());
+        }
+        else
+        {
+            std::string const s(p.get_string());
+            for(auto const c : s)
+            {
+                key += c;
+                if(c == '\0')
+                {
+                    key += '\xFF';
+                }
+            }
+            key += '\0';
+            key += '\x01';
         }
     }
-    else
+
+    return key;
+}
+
+
+/** \brief Append a 32 bit integer to a sort key.
+ *
+ * The integer is saved in big endian so that memcmp() sorts it as a number.
+ *
+ * \param[in,out] key  The key where the integer gets appended.
+ * \param[in] value  The value to append.
+ */
+void trait::append_sort_key_integer(std::string & key, std::uint32_t value)
+{
+    key += static_cast<char>(value >> 24);
+    key += static_cast<char>(value >> 16);
+    key += static_cast<char>(value >>  8);
+    key += static_cast<char>(value);
+}
+
+
+/** \brief Get the maximum a part can reach.
+ *
+ * When a \p format is specified and it has a part at \p pos, that part
+ * is returned. Otherwise one of the default maximums is returned. These
+ * are created once so next() and previous() do not allocate a new part
+ * each time they check a position.
+ *
+ * \param[in] format  The format defining the maximum of each part or nullptr.
+ * \param[in] pos  The position of the part.
+ * \param[in] integer  Whether the part at \p pos is an integer.
+ *
+ * \return A reference to the maximum part, valid as long as \p format is.
+ */
+part const & trait::get_format_part(pointer_t const & format, int pos, bool integer)
+{
+    if(format != nullptr
+    && static_cast<std::size_t>(pos) < format->size())
     {
-        maximum.set_to_max_string();
+        return std::as_const(*format).at(pos);
     }
-    return maximum;
+
+    static part const g_max_first_integer(make_maximum_part(true, false));
+    static part const g_max_integer(make_maximum_part(true, true));
+    static part const g_max_string(make_maximum_part(false, false));
+
+    if(integer)
+    {
+        return pos == 0 ? g_max_first_integer : g_max_integer;
+    }
+    return g_max_string;
 }
 
 
@@ -464,6 +1200,8 @@ part trait::get_format_part(pointer_t format, int pos, bool integer)
  */
 bool trait::next(int pos, pointer_t format)
 {
+    VERSIONTHECA_PROBE_COUNT(*this, COUNTER_NEXT);
+
     if(pos < 0)
     {
         throw invalid_parameter("position calling next() cannot be a negative number.");
@@ -476,34 +1214,34 @@ bool trait::next(int pos, pointer_t format)
             + ".");
     }
 
-    if(static_cast<std::size_t>(pos) >= f_parts.size())
+    if(static_cast<std::size_t>(pos) >= f_size)
     {
         part zero;
         part alpha;
         do
         {
-            part const f(get_format_part(format, f_parts.size(), true));
+            part const & f(get_format_part(format, f_size, true));
             if(f.is_integer())
             {
                 zero.set_separator(f.get_separator());
-                f_parts.push_back(zero);
+                push_back(zero);
             }
             else
             {
                 alpha.set_string(std::string(f.get_string().length(), 'A'));
                 alpha.set_separator(f.get_separator());
-                f_parts.push_back(alpha);
+                push_back(alpha);
             }
         }
-        while(static_cast<std::size_t>(pos) >= f_parts.size());
+        while(static_cast<std::size_t>(pos) >= f_size);
     }
     for(;;)
     {
-        if(f_parts[pos].compare(get_format_part(format, pos, f_parts[pos].is_integer())) == 0)
+        if(at(pos).compare(get_format_part(format, pos, at(pos).is_integer())) == 0)
         {
             if(pos == 0)
             {
-                f_last_error = "maximum limit reached; cannot increment version any further.";
+                set_error(error_code_t::ERROR_CODE_MAXIMUM_REACHED);
                 return false;
             }
             erase(pos);
@@ -511,7 +1249,7 @@ bool trait::next(int pos, pointer_t format)
         }
         else
         {
-            f_parts[pos].next();
+            at(pos).next();
             break;
         }
     }
@@ -520,13 +1258,13 @@ bool trait::next(int pos, pointer_t format)
     // was part 0
     //
     if(pos == 0
-    && f_parts.size() >= 2
-    && f_parts[1].is_integer())
+    && f_size >= 2
+    && at(1).is_integer())
     {
-        f_parts[1].set_integer(0U);
+        at(1).set_integer(0U);
         ++pos;
     }
-    f_parts.resize(pos + 1);
+    resize(pos + 1);
 
     return true;
 }
@@ -557,6 +1295,8 @@ bool trait::next(int pos, pointer_t format)
  */
 bool trait::previous(int pos, pointer_t format)
 {
+    VERSIONTHECA_PROBE_COUNT(*this, COUNTER_PREVIOUS);
+
     if(pos < 0)
     {
         throw invalid_parameter("position calling previous() cannot be a negative number.");
@@ -569,7 +1309,7 @@ bool trait::previous(int pos, pointer_t format)
             + ".");
     }
 
-    if(static_cast<std::size_t>(pos) >= f_parts.size())
+    if(static_cast<std::size_t>(pos) >= f_size)
     {
         // we do not need the format because it's all going to be
         // zeroes and thus the loop below will take care of fixing
@@ -579,30 +1319,30 @@ bool trait::previous(int pos, pointer_t format)
         zero.set_separator(U'.');
         do
         {
-            f_parts.push_back(zero);
+            push_back(zero);
         }
-        while(static_cast<std::size_t>(pos) >= f_parts.size());
+        while(static_cast<std::size_t>(pos) >= f_size);
     }
 
     for(;;)
     {
-        if(f_parts[pos].is_zero())
+        if(at(pos).is_zero())
         {
             if(pos == 0)
             {
-                f_last_error = "minimum limit reached; cannot decrement version any further.";
+                set_error(error_code_t::ERROR_CODE_MINIMUM_REACHED);
                 return false;
             }
-            f_parts[pos] = get_format_part(format, pos, f_parts[pos].is_integer());
+            at(pos) = get_format_part(format, pos, at(pos).is_integer());
             --pos;
         }
         else
         {
-            f_parts[pos].previous();
+            at(pos).previous();
 
             while(pos > 1
-               && f_parts[pos].is_zero()
-               && static_cast<std::size_t>(pos + 1) == f_parts.size())
+               && at(pos).is_zero()
+               && static_cast<std::size_t>(pos + 1) == f_size)
             {
                 erase(pos);
                 --pos;
@@ -614,14 +1354,52 @@ bool trait::previous(int pos, pointer_t format)
 }
 
 
-std::string trait::get_last_error(bool clear) const
+/** \brief Get the last error.
+ *
+ * The error message is generated from the error recorded by the last
+ * function that failed. The error is not cleared; see take_last_error().
+ *
+ * \note
+ * API change: this function used to clear the error. It is now const
+ * and has no side effect so several threads can call it at the same
+ * time. Use take_last_error() to also clear the error.
+ *
+ * Only the functions which modify the trait record errors. A const
+ * function such as to_string() reports its failure with its return
+ * value and leaves the error untouched.
+ *
+ * \return The error message or an empty string.
+ */
+std::string trait::get_last_error() const
 {
-    std::string const result(f_last_error);
-    if(clear)
-    {
-        f_last_error.clear();
-    }
-    return result;
+    return error_message(f_error, f_error_input);
+}
+
+
+/** \brief Get the last error and clear it.
+ *
+ * This function returns the same message as get_last_error() and resets
+ * the error. This is what get_last_error() used to do.
+ *
+ * \return The error message or an empty string.
+ */
+std::string trait::take_last_error()
+{
+    return error_message(std::exchange(f_error, version_error_t()), f_error_input);
+}
+
+
+/** \brief Get the last error as a code.
+ *
+ * This function gives access to the error without generating a message.
+ * The offset is the position of the error in the string passed to
+ * parse(). The character is defined for unexpected character errors.
+ *
+ * \return The last error.
+ */
+version_error_t trait::get_error() const
+{
+    return f_error;
 }
 
 
@@ -26,16 +26,44 @@
  *
  * This file describes the necessary functions to parse a version and then
  * compare two versions together.
+ *
+ * Thread safety: once parsed, a trait can be read by any number of
+ * threads at the same time. The const functions (at(), size(),
+ * compare(), to_string(), sort_key(), get_error()...) do not modify the
+ * trait at all, not even the error: when they fail, they say so with
+ * their return value. The functions which are not const (parse(),
+ * next(), previous(), push_back(), take_last_error()...) must not be
+ * called while other threads read the trait. To share versions between
+ * threads without such restrictions, see frozen_version.
+ *
+ * \note
+ * API change: get_last_error() used to clear the error. It is now a
+ * const accessor which leaves the error in place. Code which relied on
+ * the clearing must call take_last_error() instead.
+ *
+ * A trait deriving from another must override clone() so copies of a
+ * versiontheca object keep the correct type.
+ *
+ * The Debian and RPM traits save the shape of a version once parsed: the
+ * presence of an epoch, the section and the integer or string kind of
+ * each part. Two versions with the same shape are compared with a
+ * simpler loop. Any function which may modify the parts, including the
+ * non-const at(), resets the shape.
  */
 
 // self
 //
+#include    <versiontheca/character_class.h>
+#include    <versiontheca/error.h>
+#include    <versiontheca/output.h>
 #include    <versiontheca/part.h>
 
 
 // C++
 //
+#include    <charconv>
 #include    <memory>
+#include    <string_view>
 
 
 
@@ -51,7 +79,10 @@ public:
 
     virtual             ~trait();
 
+    virtual pointer_t   clone() const;
+
     void                clear();
+    void                assign_parts(trait const & rhs);
     part &              at(int index);
     part const &        at(int index) const;
     void                push_back(part const & p);
@@ -61,27 +92,67 @@ public:
     std::size_t         size() const;
     void                resize(std::size_t sz);
 
-    virtual bool        parse(std::string const & v);
+    virtual bool        parse(std::string_view const & v);
     virtual bool        is_valid_character(char32_t c) const;
     virtual bool        is_separator(char32_t c) const;
-    virtual int         compare(trait::pointer_t rhs) const;
+    virtual character_classes_t const *
+                        get_character_classes() const;
+    virtual int         compare(trait::pointer_t const & rhs) const;
+    int                 compare_prefix(trait::pointer_t const & rhs, std::size_t limit) const;
 
     virtual bool        next(int pos, pointer_t format);
     virtual bool        previous(int pos, pointer_t format);
 
     virtual std::string to_string() const;
+    virtual bool        write_to(version_output & out) const;
+    bool                append_to_string(std::string & result) const;
+    std::to_chars_result
+                        to_chars(char * first, char * last) const;
+    virtual std::string sort_key() const;
 
-    std::string         get_last_error(bool clear = true) const;
+    std::string         get_last_error() const;
+    std::string         take_last_error();
+    version_error_t     get_error() const;
 
 protected:
-    bool                parse_version(std::string const & v, char32_t sep);
-    bool                parse_value(std::string const & value, char32_t sep);
-    part                get_format_part(pointer_t format, int pos, bool integer);
-
-    mutable std::string f_last_error = std::string();
+    static void         append_sort_key_integer(std::string & key, std::uint32_t value);
+    static bool         is_ascii(std::string_view const & v);
+    static char32_t     get_character(std::string_view const & v, std::size_t & pos);
+    bool                parse_version(std::string_view const & v, char32_t sep);
+    bool                parse_value(std::string_view const & value, char32_t sep);
+    bool                parse_value(std::string_view const & value, char32_t sep, bool ascii);
+    static part const & get_format_part(pointer_t const & format, int pos, bool integer);
+    void                set_error(
+                              error_code_t code
+                            , char const * where = nullptr
+                            , char32_t c = U'\0');
+    void                update_shape();
+    std::uint64_t       get_shape() const;
+
+    // the input of the parse() call in progress, used to compute the
+    // offset of errors; only valid while parsing
+    //
+    std::string_view    f_input = std::string_view();
 
 private:
-    part::vector_t      f_parts = part::vector_t();
+    bool                parse_classified_value(
+                              std::string_view const & value
+                            , char32_t sep
+                            , character_masks_t const & masks
+                            , std::size_t offset);
+    bool                push_number(std::string_view const & n, char32_t & sep);
+    void                push_string(std::string_view const & s, char32_t & sep);
+
+    // the parts are kept inline since MAX_PARTS is a hard limit; the
+    // strings of the parts are std::string so a string longer than the
+    // SSO capacity still allocates, except when parse() reuses a part
+    // which already had a buffer that large
+    //
+    part::array_t       f_parts = part::array_t();
+    std::size_t         f_size = 0;
+    std::uint64_t       f_shape = 0;
+    version_error_t     f_error = version_error_t();
+    std::string         f_error_input = std::string();
 };
 
 
@@ -47,6 +47,12 @@ class unicode
 {
 public:
     typedef std::shared_ptr<unicode>       pointer_t;
+
+    virtual trait::pointer_t
+                        clone() const override
+                        {
+                            return std::make_shared<unicode>(*this);
+                        }
 };
 
 
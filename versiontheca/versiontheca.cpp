@@ -61,6 +61,7 @@
 
 #include    <versiontheca/basic.h>
 #include    <versiontheca/exception.h>
+#include    <versiontheca/probe.h>
 
 
 // libutf8
@@ -77,6 +78,7 @@
 // C++
 //
 #include    <iostream>
+#include    <utility>
 
 
 // last include
@@ -92,9 +94,13 @@ namespace versiontheca
 
 versiontheca::versiontheca(
           trait::pointer_t const & t
-        , std::string const & v)
+        , std::string_view const & v)
     : f_trait(t == nullptr ? std::make_shared<basic>() : t)
 {
+    if(t == nullptr)
+    {
+        VERSIONTHECA_PROBE_COUNT(*f_trait, COUNTER_ALLOCATION);
+    }
     if(!v.empty())
     {
         set_version(v);
@@ -102,13 +108,55 @@ versiontheca::versiontheca(
 }
 
 
+/** \brief Copy a version.
+ *
+ * The trait of \p rhs is cloned so the copy can be modified without
+ * affecting \p rhs. The version is not parsed again.
+ *
+ * The format, if any, is shared since it is only read.
+ *
+ * A moved versiontheca object has no trait. It can only be assigned
+ * a new version or destroyed.
+ *
+ * \param[in] rhs  The version to copy.
+ */
+versiontheca::versiontheca(versiontheca const & rhs)
+    : f_trait(rhs.f_trait->clone())
+    , f_valid(rhs.f_valid)
+    , f_format(rhs.f_format)
+{
+    VERSIONTHECA_PROBE_COUNT(*f_trait, COUNTER_ALLOCATION);
+}
+
+
+/** \brief Copy a version.
+ *
+ * See the copy constructor for details.
+ *
+ * \param[in] rhs  The version to copy.
+ *
+ * \return A reference to this version.
+ */
+versiontheca & versiontheca::operator = (versiontheca const & rhs)
+{
+    if(this != &rhs)
+    {
+        f_trait = rhs.f_trait->clone();
+        VERSIONTHECA_PROBE_COUNT(*f_trait, COUNTER_ALLOCATION);
+        f_valid = rhs.f_valid;
+        f_format = rhs.f_format;
+    }
+    return *this;
+}
+
+
 void versiontheca::set_format(versiontheca const & format)
 {
     f_format = format.f_trait;
 }
 
 
-bool versiontheca::set_version(std::string const & v)
+bool versiontheca::set_version(std::string_view const & v)
 {
     f_valid = f_trait->parse(v);
     if(!f_valid)
@@ -161,6 +209,22 @@ std::string versiontheca::get_version() const
 }
 
 
+/** \brief Append the canonicalized version to a string.
+ *
+ * This is the same as get_version() except that the version is appended
+ * to \p result. Reusing the same string for many versions avoids one
+ * allocation per version.
+ *
+ * \param[in,out] result  The string where the version gets appended.
+ *
+ * \return true if something was appended, false if the version is empty.
+ */
+bool versiontheca::append_version(std::string & result) const
+{
+    return f_trait->append_to_string(result);
+}
+
+
 void versiontheca::set_major(part_integer_t value)
 {
     part p;
@@ -182,7 +246,7 @@ part_integer_t versiontheca::get_major() const
     {
         return 0;
     }
-    part const & p(f_trait->at(0));
+    part const & p(std::as_const(*f_trait).at(0));
     if(!p.is_integer())
     {
         return 0;
@@ -217,7 +281,7 @@ part_integer_t versiontheca::get_minor() const
     {
         return 0;
     }
-    part const & p(f_trait->at(1));
+    part const & p(std::as_const(*f_trait).at(1));
     if(!p.is_integer())
     {
         return 0;
@@ -252,7 +316,7 @@ part_integer_t versiontheca::get_patch() const
     {
         return 0;
     }
-    part const & p(f_trait->at(2));
+    part const & p(std::as_const(*f_trait).at(2));
     if(!p.is_integer())
     {
         return 0;
@@ -287,7 +351,7 @@ part_integer_t versiontheca::get_build() const
     {
         return 0;
     }
-    part const & p(f_trait->at(3));
+    part const & p(std::as_const(*f_trait).at(3));
     if(!p.is_integer())
     {
         return 0;
@@ -296,9 +360,21 @@ part_integer_t versiontheca::get_build() const
 }
 
 
-std::string versiontheca::get_last_error(bool clear) const
+std::string versiontheca::get_last_error() const
+{
+    return f_trait->get_last_error();
+}
+
+
+std::string versiontheca::take_last_error()
+{
+    return f_trait->take_last_error();
+}
+
+
+version_error_t versiontheca::get_error() const
 {
-    return f_trait->get_last_error(clear);
+    return f_trait->get_error();
 }
 
 
@@ -308,6 +384,53 @@ trait::pointer_t versiontheca::get_trait() const
 }
 
 
+/** \brief Get a binary key to sort this version.
+ *
+ * This function returns the sort key of this version as computed by
+ * its trait. Two keys of versions using the same trait compared with
+ * memcmp() (or std::string::compare()) give the same result as the
+ * compare() function.
+ *
+ * \exception invalid_version
+ * The version must be valid to compute its key.
+ *
+ * \return The binary sort key.
+ *
+ * \sa trait::sort_key()
+ */
+std::string versiontheca::sort_key() const
+{
+    if(!f_valid)
+    {
+        throw invalid_version("cannot compute the sort key of an invalid version.");
+    }
+
+    return f_trait->sort_key();
+}
+
+
+/** \brief Compute a hash of this version.
+ *
+ * The hash is computed from the sort key so two versions which compare
+ * equal (i.e. "1.0" and "1.0.0") get the same hash. This is what
+ * std::hash<versiontheca> returns, which allows for versions to be
+ * used as keys in an std::unordered_map.
+ *
+ * An invalid version has no sort key; its hash is 0.
+ *
+ * \return The hash of this version.
+ */
+std::size_t versiontheca::hash() const
+{
+    if(!f_valid)
+    {
+        return 0;
+    }
+
+    return std::hash<std::string>()(f_trait->sort_key());
+}
+
+
 int versiontheca::compare(versiontheca const & rhs) const
 {
     if(!f_valid || !rhs.f_valid)
@@ -319,6 +442,36 @@ int versiontheca::compare(versiontheca const & rhs) const
 }
 
 
+/** \brief Compare the first \p limit parts of two versions.
+ *
+ * This is useful to check whether two versions share the same
+ * "major.minor" (\p limit of 2) without having to extract the parts.
+ * The comparison stops after \p limit parts.
+ *
+ * \exception invalid_version
+ * The function raises this exception if either version is not valid.
+ *
+ * \exception invalid_parameter
+ * The function raises this exception if \p limit is 0.
+ *
+ * \param[in] rhs  The right hand side version.
+ * \param[in] limit  The number of parts to compare.
+ *
+ * \return -1, 0, or 1.
+ *
+ * \sa trait::compare_prefix()
+ */
+int versiontheca::compare(versiontheca const & rhs, std::size_t limit) const
+{
+    if(!f_valid || !rhs.f_valid)
+    {
+        throw invalid_version("one or both of the input versions are not valid.");
+    }
+
+    return f_trait->compare_prefix(rhs.f_trait, limit);
+}
+
+
 bool versiontheca::operator == (versiontheca const & rhs) const
 {
     return compare(rhs) == 0;
@@ -25,6 +25,7 @@
 
 // C++
 //
+#include    <functional>
 #include    <memory>
 
 
@@ -41,25 +42,22 @@ public:
 
                         versiontheca(
                                   trait::pointer_t const & t
-                                , std::string const & v = std::string());
+                                , std::string_view const & v = std::string_view());
 
-                        // note: because of the trait pointer requirement
-                        // copy is not possible without a clone() function
-                        // instead, you can use:
-                        //
-                        //   versiontheca copy(<your trait>, rhs.get_version());
-                        //
-                        versiontheca(versiontheca const &) = delete;
-    versiontheca &      operator = (versiontheca const &) = delete;
+                        versiontheca(versiontheca const & rhs);
+                        versiontheca(versiontheca && rhs) = default;
+    versiontheca &      operator = (versiontheca const & rhs);
+    versiontheca &      operator = (versiontheca && rhs) = default;
 
     void                set_format(versiontheca const & format);
-    bool                set_version(std::string const & v);
+    bool                set_version(std::string_view const & v);
     bool                next(int pos);
     bool                previous(int pos);
 
     bool                is_valid() const;
     std::size_t         size() const;
     std::string         get_version() const;
+    bool                append_version(std::string & result) const;
     void                set_major(part_integer_t value);
     part_integer_t      get_major() const;
     void                set_minor(part_integer_t value);
@@ -68,10 +66,15 @@ public:
     part_integer_t      get_patch() const;
     void                set_build(part_integer_t value);
     part_integer_t      get_build() const;
-    std::string         get_last_error(bool clear = true) const;
+    std::string         get_last_error() const;
+    std::string         take_last_error();
+    version_error_t     get_error() const;
     trait::pointer_t    get_trait() const;
+    std::string         sort_key() const;
+    std::size_t         hash() const;
 
     int                 compare(versiontheca const & rhs) const;
+    int                 compare(versiontheca const & rhs, std::size_t limit) const;
     bool                operator == (versiontheca const & rhs) const;
     bool                operator != (versiontheca const & rhs) const;
     bool                operator <  (versiontheca const & rhs) const;
@@ -95,4 +98,20 @@ inline std::ostream & operator << (std::ostream & os, versiontheca const & v)
 
 }
 // namespace versiontheca
+
+
+namespace std
+{
+
+template<>
+struct hash<versiontheca::versiontheca>
+{
+    std::size_t operator () (versiontheca::versiontheca const & v) const
+    {
+        return v.hash();
+    }
+};
+
+}
+// namespace std
 // vim: ts=4 sw=4 et